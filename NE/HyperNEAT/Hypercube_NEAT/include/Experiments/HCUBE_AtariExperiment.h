@@ -21,6 +21,21 @@ namespace HCUBE
         int numObjClasses;
 
         int outputLayerIndx; // The index of the substrate layer at which the output nodes are located
+        vector<NEAT::NodeHandle> outputHandles; // The output node of each action
+
+        // The node index of each substrate cell in the input layers, indexed by
+        // y*substrate_width+x. All input layers of a substrate_width x substrate_height
+        // share it.
+        vector<int> inputCellIndices;
+        NEAT::NodeHandle biasHandle; // Invalid if the substrate has no bias layer
+
+        // Propagate only the inputs that changed since the last frame (AtariIncrementalUpdate,
+        // default off). This pays off when most inputs are set every frame but few of them
+        // change (raw pixels); with a few objects per frame the plain update is already as fast.
+        bool incrementalUpdate;
+
+        // Each selected action is repeated for this many frames (AtariFrameSkip, default 1)
+        int frameSkip;
 
     public: // TODO: Make this protected 
         NEAT::LayeredSubstrate<float> substrate;
@@ -42,9 +57,17 @@ namespace HCUBE
         virtual void processGroup(shared_ptr<NEAT::GeneticGeneration> generation);
         // Runs the atari episode using the specified individual
         virtual float runAtariEpisode(NEAT::LayeredSubstrate<float>* substrate);
+        // Resolves the output node of each action on the substrate
+        virtual void resolveOutputHandles(NEAT::LayeredSubstrate<float>* substrate);
+        // Resolves the input cells and the bias node of the substrate
+        virtual void resolveInputHandles(NEAT::LayeredSubstrate<float>* substrate);
         // Prints the activations at each layer of the substrate
         virtual void printLayerInfo(NEAT::LayeredSubstrate<float>* substrate);
 
+        // Called with the screen of every frame an action is repeated for but the last.
+        // framesLeft is the number of frames the action is still repeated for.
+        virtual void skipScreen(int framesLeft) {}
+
         // Sets the activations on the input layer of the substrates
         virtual void setSubstrateValues(NEAT::LayeredSubstrate<float>* substrate);
 
@@ -26,6 +26,9 @@ namespace HCUBE
     public:
         NEAT::FastNetwork<float> substrate;
         map<Node,string> nameLookup; // Name lookup table
+        vector<NEAT::NodeHandle> inputHandles; // Input layer handles, indexed by y*inputRowWidth+x
+        vector<NEAT::NodeHandle> outputHandles; // Output layer handles, indexed by x
+        int inputRowWidth;
 
         virtual void initializeExperiment(string rom_file);
 
@@ -37,6 +40,13 @@ namespace HCUBE
         AtariFTNeatExperiment(string _experimentName,int _threadID);
         virtual ~AtariFTNeatExperiment() {};
 
+        // Resolves the input and output handles of a freshly spawned substrate
+        virtual void resolveSubstrateHandles();
+
+        inline const NEAT::NodeHandle &getInputHandle(int x,int y) const {
+            return inputHandles[y*inputRowWidth+x];
+        }
+
         virtual NEAT::GeneticPopulation* createInitialPopulation(int populationSize);
 
         // This method converts HyperNEAT individuals into FT-NEAT individuals
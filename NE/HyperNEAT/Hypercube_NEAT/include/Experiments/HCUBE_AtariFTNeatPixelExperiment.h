@@ -5,6 +5,7 @@
 #include "ale_interface.hpp"
 #include "common/visual_processor.h"
 #include "HCUBE_AtariFTNeatExperiment.h"
+#include "HCUBE_AtariFramePreprocessor.h"
 #include "Experiments/HCUBE_AtariExperiment.h"
 
 namespace HCUBE
@@ -18,6 +19,7 @@ namespace HCUBE
         void initializeExperiment(string rom_file);
         virtual void initializeTopology();
         virtual void setSubstrateValues();
+        virtual void resolveSubstrateHandles();
 
         virtual NEAT::GeneticPopulation* createInitialPopulation(int populationSize);
 
@@ -26,6 +28,16 @@ namespace HCUBE
         const static int numColors = 8;
 
         static uInt32 eightBitPallete[256];
+
+        AtariFramePreprocessor framePreprocessor;
+        // The values of all input nodes for the current frame, indexed by
+        // (color*substrate_height+y)*substrate_width+x
+        vector<float> frameInputs;
+        // The node index of each value in frameInputs
+        vector<int> inputNodeIndices;
+
+        // Sets up the frame preprocessor for the screen and substrate sizes
+        void initializePixelInputs();
     };
 }
 
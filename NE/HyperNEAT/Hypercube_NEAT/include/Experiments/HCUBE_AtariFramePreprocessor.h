@@ -0,0 +1,62 @@
+#ifndef HCUBE_ATARIFRAMEPREPROCESSOR_H_INCLUDED
+#define HCUBE_ATARIFRAMEPREPROCESSOR_H_INCLUDED
+
+#include "HCUBE_Defines.h"
+#include "ale_interface.hpp"
+
+namespace HCUBE
+{
+    // Downsamples Atari screens to the raw pixel inputs: one plane of cells per color, where
+    // a cell is 1 if any pixel of its color is inside it and 0 otherwise. Screens can be
+    // pooled before they are written, so a cell is set if its color was in any of them.
+    class AtariFramePreprocessor
+    {
+    public:
+        AtariFramePreprocessor();
+
+        // Sets up the cells for a screen size. palette gives the color of each of the 256
+        // screen values, and must be below numColors (at most 32).
+        void initialize(int screenWidth, int screenHeight, int cellsWide, int cellsHigh,
+                        const uInt32 *palette, int numColors);
+
+        // Where each cell goes within its color's plane in the inputs, indexed by
+        // y*cellsWide+x. Defaults to that index.
+        void setCellIndices(const vector<int> &cellIndices);
+
+        // Drops the pooled screens
+        void clear();
+
+        // Adds the colors of a screen to the pooled cells
+        void poolScreen(const IntMatrix &screen);
+
+        // Adds the colors of a screen to the pooled cells and writes every plane to inputs,
+        // color by color. Clears the pooled cells for the next frame.
+        void writeInputs(const IntMatrix &screen, float *inputs);
+
+        // The number of values writeInputs() writes
+        inline int getInputCount() const
+        {
+            return numColors*cellsWide*cellsHigh;
+        }
+
+    protected:
+        int screenWidth, screenHeight;
+        int cellsWide, cellsHigh;
+        int numColors;
+
+        // The bit of each screen value's color
+        uInt32 colorBits[256];
+        // The cell column of each screen column
+        vector<int> columnCells;
+        // The screen row after the last row of each cell row
+        vector<int> cellRowEnds;
+        vector<int> cellIndices;
+
+        // The colors in each screen column of the current cell row
+        vector<uInt32> columnColors;
+        // The colors in each cell, indexed by y*cellsWide+x
+        vector<uInt32> cellColors;
+    };
+}
+
+#endif // HCUBE_ATARIFRAMEPREPROCESSOR_H_INCLUDED
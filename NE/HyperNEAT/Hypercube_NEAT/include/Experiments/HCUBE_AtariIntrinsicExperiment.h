@@ -49,12 +49,22 @@ namespace HCUBE
     public:
         NEAT::FastNetwork<double> substrate;
         map<Node,string> nameLookup; // Name lookup table
+        vector<NEAT::NodeHandle> inputHandles; // Input layer handles, indexed by y*inputRowWidth+x
+        vector<NEAT::NodeHandle> outputHandles; // Output layer handles, indexed by x
+        int inputRowWidth;
 
         void initializeExperiment(string rom_file);
 
         AtariIntrinsicExperiment(string _experimentName,int _threadID);
         virtual ~AtariIntrinsicExperiment() { if (agent) delete agent; };
 
+        // Resolves the input and output handles of a freshly spawned substrate
+        void resolveSubstrateHandles();
+
+        inline const NEAT::NodeHandle &getInputHandle(int x,int y) const {
+            return inputHandles[y*inputRowWidth+x];
+        }
+
         virtual NEAT::GeneticPopulation* createInitialPopulation(int populationSize);
         virtual void processGroup(shared_ptr<NEAT::GeneticGeneration> generation);
         void runAtariEpisode(shared_ptr<NEAT::GeneticIndividual> individual);
@@ -25,6 +25,9 @@ namespace HCUBE
     public:
         NEAT::FastNetwork<double> substrate;
         map<Node,string> nameLookup; // Name lookup table
+        vector<NEAT::NodeHandle> inputHandles; // Input layer handles, indexed by y*inputRowWidth+x
+        vector<NEAT::NodeHandle> outputHandles; // Output layer handles, indexed by x
+        int inputRowWidth;
 
         virtual void initializeExperiment(string rom_file);
         virtual void initializeALE(string rom_file, bool processScreen);
@@ -33,6 +36,13 @@ namespace HCUBE
         AtariNoGeomExperiment(string _experimentName,int _threadID);
         virtual ~AtariNoGeomExperiment() {};
 
+        // Resolves the input and output handles of a freshly spawned substrate
+        virtual void resolveSubstrateHandles();
+
+        inline const NEAT::NodeHandle &getInputHandle(int x,int y) const {
+            return inputHandles[y*inputRowWidth+x];
+        }
+
         virtual NEAT::GeneticPopulation* createInitialPopulation(int populationSize);
         virtual void processGroup(shared_ptr<NEAT::GeneticGeneration> generation);
         void runAtariEpisode(shared_ptr<NEAT::GeneticIndividual> individual);
@@ -4,6 +4,7 @@
 #include "HCUBE_Experiment.h"
 #include "ale_interface.hpp"
 #include "HCUBE_AtariNoGeomExperiment.h"
+#include "HCUBE_AtariFramePreprocessor.h"
 #include "common/visual_processor.h"
 
 namespace HCUBE
@@ -19,12 +20,23 @@ namespace HCUBE
         virtual NEAT::GeneticPopulation* createInitialPopulation(int populationSize);
         virtual void setSubstrateValues();
         virtual void initializeTopology();
+        virtual void resolveSubstrateHandles();
 
     protected:
         // The number of different colors in the color representation
         const static int numColors = 8;
 
         static uInt32 eightBitPallete[256];
+
+        AtariFramePreprocessor framePreprocessor;
+        // The values of all input nodes for the current frame, indexed by
+        // (color*substrate_height+y)*substrate_width+x
+        vector<float> frameInputs;
+        // The node index of each value in frameInputs
+        vector<int> inputNodeIndices;
+
+        // Sets up the frame preprocessor for the screen and substrate sizes
+        void initializePixelInputs();
     };
 }
 
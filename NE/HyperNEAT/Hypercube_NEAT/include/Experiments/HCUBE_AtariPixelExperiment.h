@@ -3,6 +3,7 @@
 
 #include "HCUBE_Experiment.h"
 #include "HCUBE_AtariExperiment.h"
+#include "HCUBE_AtariFramePreprocessor.h"
 #include "ale_interface.hpp"
 #include "common/visual_processor.h"
 
@@ -19,12 +20,22 @@ namespace HCUBE
 
         virtual NEAT::GeneticPopulation* createInitialPopulation(int populationSize);
         virtual void setSubstrateValues(NEAT::LayeredSubstrate<float>* substrate);
+        virtual void resolveInputHandles(NEAT::LayeredSubstrate<float>* substrate);
+        virtual void skipScreen(int framesLeft);
 
     protected:
         // The number of different colors in the color representation
         const static int numColors = 8;
 
         static uInt32 eightBitPallete[256];
+
+        // The number of last frames of each action whose screens are pooled into the
+        // inputs (AtariPoolFrames, default 1)
+        int poolFrames;
+
+        AtariFramePreprocessor framePreprocessor;
+        // The values of all input layers for the current frame, as setInputValues() reads them
+        vector<float> frameInputs;
     };
 }
 
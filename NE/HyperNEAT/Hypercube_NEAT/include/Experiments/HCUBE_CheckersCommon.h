@@ -96,13 +96,121 @@ namespace HCUBE
 
     typedef vector<CheckersMove>::iterator MoveListIterator;
 
+    //The most moves a position may have, for both move generators
+    #define CHECKERS_MAX_MOVES (128)
+
+    //A man has at most 12 pieces to jump, so a path has at most 13 squares
+    #define CHECKERS_MAX_PATH_SQUARES (13)
+
+    /**
+     * CheckersBitMove: A move on a CheckersBitboard.  from, to and captured are square
+     * masks, path holds every square the piece stops on (path[0] is the start square)
+     */
+    class CheckersBitMove
+    {
+    public:
+        uint from,to;
+        uint captured;
+        uchar path[CHECKERS_MAX_PATH_SQUARES];
+        uchar numJumps;
+    };
+
+    /**
+     * CheckersBitMoveList: A fixed capacity move list, meant to live on the stack of the
+     * search function that uses it
+     */
+    class CheckersBitMoveList
+    {
+    public:
+        CheckersBitMove moves[CHECKERS_MAX_MOVES];
+        int numMoves;
+        bool foundJump;
+    };
+
+    /**
+     * CheckersBitboard: The 32 dark squares of a board as bits, numbered like cake's
+     * POSITION (square = y*4 + x/2, so bit 0 is (0,0) and bit 31 is (7,7))
+     */
+    class CheckersBitboard
+    {
+    public:
+        uint black,white,kings;
+
+        CheckersBitboard()
+                :
+                black(0),
+                white(0),
+                kings(0)
+        {}
+
+        CheckersBitboard(uchar b[8][8]);
+
+        /**
+         * toBoard: Writes the position as a uchar board, with the piece counts filled in
+         */
+        void toBoard(uchar b[8][8]) const;
+
+        inline uint getPieces(int color) const
+        {
+            return (color==BLACK) ? black : white;
+        }
+
+        inline uint getEmpty() const
+        {
+            return ~(black|white);
+        }
+
+        /**
+         * makeMove: Plays a move generated for this position by the given color
+         */
+        void makeMove(const CheckersBitMove &move,int color);
+
+        inline bool operator==(const CheckersBitboard &other) const
+        {
+            return black==other.black && white==other.white && kings==other.kings;
+        }
+
+        static inline int getSquare(int x,int y)
+        {
+            return y*4 + x/2;
+        }
+
+        static inline int getSquareX(int square)
+        {
+            return ((square&3)<<1) + ((square>>2)&1);
+        }
+
+        static inline int getSquareY(int square)
+        {
+            return square>>2;
+        }
+
+        static inline int getLowestSquare(uint mask)
+        {
+            //De Bruijn bit scan, mask must be non-zero
+            static const int deBruijnSquares[32] =
+            {
+                0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+                31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+            };
+            return deBruijnSquares[((mask&(0-mask))*0x077CB531U)>>27];
+        }
+
+        static inline int countSquares(uint mask)
+        {
+            mask = mask - ((mask>>1)&0x55555555);
+            mask = (mask&0x33333333) + ((mask>>2)&0x33333333);
+            return int((((mask+(mask>>4))&0x0F0F0F0F)*0x01010101)>>24);
+        }
+    };
+
     class CheckersCommon
     {
 	protected:
         uchar gameLog[1024][8][8];
 		uchar moveLog[1024][64];
         int moves;
-        boost::shared_ptr<CheckersMovePool> checkersMovePoolPtr;
+        boost::shared_ptr<CheckersMovePool> checkersMovePoolPtr;
 
     public:
         CheckersCommon();
@@ -160,6 +268,30 @@ namespace HCUBE
             bool &foundJump
         );
 
+        /**
+         * generateMoveList: The bitboard move generator.  It produces the same moves as the
+         * uchar version, in the same order, without touching the heap.
+         */
+        int generateMoveList(
+            const CheckersBitboard &board,
+            int color,
+            CheckersBitMoveList &moveList
+        );
+
+        bool hasJump(const CheckersBitboard &board,int color);
+
+        bool hasAnyMove(const CheckersBitboard &board,int color);
+
+        /**
+         * getCheckersMove: Converts a bitboard move to a (possibly chained) CheckersMove
+         */
+        CheckersMove getCheckersMove(const CheckersBitMove &move);
+
+        /**
+         * perft: Counts the positions at the given depth below the board
+         */
+        ulong perft(const CheckersBitboard &board,int color,int depth);
+
         bool hasMove(
             uchar b[8][8],
             int color,
@@ -195,6 +327,17 @@ namespace HCUBE
 		int gridToIndex(int x,int y);
 
 		string gameLogToPDN();
+
+    protected:
+        bool addBitJumps(
+            CheckersBitMoveList &moveList,
+            CheckersBitMove &moveInProgress,
+            uint own,
+            uint other,
+            int color,
+            bool isKing,
+            int square
+        );
 	};
 
     class CheckersBoardState
@@ -507,6 +650,40 @@ namespace HCUBE
     typedef pair<CheckersBoardState,CheckersBoardStateData> BoardStatePair;
     typedef vector<BoardStatePair> BoardStateList;
 
+    /**
+     * CakeSearchContext: Owns the tables of one cake player, so players on different
+     * threads can call cake_getmove at the same time.  A copy starts without tables of
+     * its own, so cloned experiments never search with the same hashtable.
+     */
+    class CakeSearchContext
+    {
+    protected:
+        SEARCHCONTEXT *context;
+
+    public:
+        CakeSearchContext()
+                :
+                context(NULL)
+        {}
+
+        CakeSearchContext(const CakeSearchContext &other)
+                :
+                context(NULL)
+        {}
+
+        const CakeSearchContext &operator=(const CakeSearchContext &other)
+        {
+            return *this;
+        }
+
+        ~CakeSearchContext();
+
+        /**
+         * get: The context for si->context, made (and cake initialized) on the first call
+         */
+        SEARCHCONTEXT *get();
+    };
+
     class CheckersStats
     {
     public:
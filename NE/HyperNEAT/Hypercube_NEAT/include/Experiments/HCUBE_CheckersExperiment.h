@@ -3,6 +3,7 @@
 
 #include "Experiments/HCUBE_Experiment.h"
 #include "Experiments/HCUBE_CheckersCommon.h"
+#include "Experiments/HCUBE_CheckersTranspositionTable.h"
 
 #define MAX_CACHED_BOARDS (8192)
 
@@ -12,6 +13,23 @@
 
 namespace HCUBE
 {
+    /**
+     * CheckersGameResult: How one game ended and the rewards it earned, in the order they
+     * were earned
+     */
+    class CheckersGameResult
+    {
+    public:
+        int winner;
+        vector<double> rewards;
+
+        CheckersGameResult()
+                :
+                winner(-1)
+        {
+        }
+    };
+
     class CheckersExperiment : public Experiment, public CheckersCommon
     {
     public:
@@ -24,6 +42,10 @@ namespace HCUBE
 
         int numNodesX[3];
         int numNodesY[3];
+
+        //Substrate nodes resolved once from the layer info (both substrates share it)
+        NEAT::NodeHandle boardInputHandles[8][8];
+        NEAT::NodeHandle boardOutputHandle;
         //int numGames;
         //CheckersTreeSearch searchTree;
 
@@ -42,9 +64,25 @@ namespace HCUBE
         uchar userEvaluationBoard[8][8];
         int userEvaluationRound;
 
-        BoardCacheList boardEvaluationCaches[2][65336];
+        BoardCacheList boardEvaluationCaches[2][65536];
 
-        BoardStateList boardStateLists[3][3][65536];
+        //Built on first use, so clones get a table of their own
+        shared_ptr<CheckersTranspositionTable> transpositionTable;
+        const CheckersExperiment *transpositionTableOwner;
+
+        //The individual each substrate held when its entries were stored
+        shared_ptr<const NEAT::GeneticIndividual> transpositionTableIndividuals[2];
+        ulong transpositionTableEpochs[2];
+        ulong transpositionTableEpochCount;
+
+        //Mixed into the board keys of the current search
+        ulong searchKey;
+
+        //Clones that search root moves on other threads, made on first use like the
+        //transposition table so a clone of this experiment gets helpers of its own
+        vector<shared_ptr<CheckersExperiment> > searchHelpers;
+        const CheckersExperiment *searchHelpersOwner;
+        int numSearchThreads;
 
         Vector2<uchar> from;
 
@@ -63,6 +101,7 @@ namespace HCUBE
 
 		int cakeRandomSeed;
         SEARCHINFO searchInfo;
+        CakeSearchContext cakeSearchContext;
 
         int currentRound;
 
@@ -91,6 +130,38 @@ namespace HCUBE
 
         virtual pair<CheckersNEATDatatype,int> evaluateLeafHyperNEAT(uchar b[8][8]);
 
+        /**
+         * beginTranspositionTableSearch: Called at the root of each search, to set the
+         * search key for the current evaluation function and age the old entries
+         */
+        void beginTranspositionTableSearch();
+
+        inline shared_ptr<CheckersTranspositionTable> getTranspositionTable()
+        {
+            return transpositionTable;
+        }
+
+        /**
+         * getSearchThreadCount: The threads a root search may use.  1 (a serial search)
+         * unless the SearchThreads parameter is set.
+         */
+        int getSearchThreadCount();
+
+        /**
+         * searchRootMoves: Searches the root moves after the first one on the search
+         * threads, each against the bound the first move left.  Results are stored by the
+         * order the moves are searched in, results[0] is left alone.
+         */
+        void searchRootMoves(
+            const CheckersBitboard &board,
+            const CheckersBitMoveList &moveList,
+            int firstMove,
+            int color,
+            CheckersNEATDatatype bound,
+            int maxDepth,
+            pair<CheckersNEATDatatype,int> *results
+        );
+
         virtual pair<CheckersNEATDatatype,int> evaluatemax(
             uchar b[8][8],
             CheckersNEATDatatype parentBeta,
@@ -105,6 +176,24 @@ namespace HCUBE
             int maxDepth
         );
 
+        /**
+         * evaluatemax/evaluatemin: The search itself runs on bitboards, the uchar versions
+         * above convert the board and call these
+         */
+        pair<CheckersNEATDatatype,int> evaluatemax(
+            const CheckersBitboard &board,
+            CheckersNEATDatatype parentBeta,
+            int depth,
+            int maxDepth
+        );
+
+        pair<CheckersNEATDatatype,int> evaluatemin(
+            const CheckersBitboard &board,
+            CheckersNEATDatatype parentAlpha,
+            int depth,
+            int maxDepth
+        );
+
         virtual pair<CheckersNEATDatatype,int> firstevaluatemax(
             uchar b[8][8],
             int maxDepth,
@@ -121,6 +210,20 @@ namespace HCUBE
 
 		void makeMoveCake(uchar b[8][8],int colorToMove,int* retval);
 
+        /**
+         * playGameAsBlack: Plays HyperNEAT as black against opponent number gameIndex and
+         * stores the rewards in result instead of giving them to the individual.  With
+         * fromEmptyTable, the transposition table is cleared first so the game does not
+         * depend on the games played before it.
+         */
+        void playGameAsBlack(int gameIndex,CheckersGameResult &result,bool fromEmptyTable);
+
+        /**
+         * playGames: Plays one game per result, on several threads if the GameThreads
+         * parameter is set
+         */
+        void playGames(vector<CheckersGameResult> &results);
+
         virtual void processGroup(shared_ptr<NEAT::GeneticGeneration> generation);
 
         virtual void processIndividualPostHoc(shared_ptr<NEAT::GeneticIndividual> individual);
@@ -0,0 +1,127 @@
+#ifndef HCUBE_CHECKERSTRANSPOSITIONTABLE_H_INCLUDED
+#define HCUBE_CHECKERSTRANSPOSITIONTABLE_H_INCLUDED
+
+#include "Experiments/HCUBE_CheckersCommon.h"
+
+namespace HCUBE
+{
+    /**
+     * CheckersTranspositionTable: A fixed size table of search results, keyed by the
+     * Zobrist hash of the position.  Each entry keeps the value, the depth that was
+     * searched below the position, whether the value is exact or a bound, and the index
+     * of the best move in the position's generated move list.
+     *
+     * Entries are stored as (key^data,data) pairs, so a probe that races a store on another
+     * thread sees a key mismatch instead of a torn entry and the table needs no locks.
+     * The counters are plain integers and only approximate when the table is shared.
+     */
+    class CheckersTranspositionTable
+    {
+    public:
+        enum BoundType
+        {
+            BOUND_NONE=0,
+            BOUND_EXACT,
+            BOUND_LOWER,
+            BOUND_UPPER
+        };
+
+        //The best move of an entry that has none
+        static const int NO_MOVE = 255;
+
+        class Entry
+        {
+        public:
+            CheckersNEATDatatype value;
+            int depth;
+            BoundType bound;
+            int bestMove;
+        };
+
+    protected:
+        class Slot
+        {
+        public:
+            ulong check;
+            ulong data;
+        };
+
+        //Slots are grouped in buckets that fill one cache line
+        static const int BUCKET_SIZE = 4;
+
+        vector<Slot> slots;
+        size_t bucketMask;
+
+        uchar generation;
+
+        ulong probes,hits,stores;
+
+    public:
+        CheckersTranspositionTable(int megabytes);
+
+        /**
+         * resize: Reallocates the table to the largest power of two buckets that fits the
+         * budget, and clears it
+         */
+        void resize(int megabytes);
+
+        void clear();
+
+        /**
+         * newSearch: Ages the current entries, so they are the first to be replaced
+         */
+        inline void newSearch()
+        {
+            generation++;
+        }
+
+        /**
+         * getBoardKey: The Zobrist hash of a board and the color to move
+         */
+        static ulong getBoardKey(uchar b[8][8],int colorToMove);
+
+        static ulong getBoardKey(const CheckersBitboard &board,int colorToMove);
+
+        /**
+         * getSearchKey: A key to mix into the board keys of one evaluation function, so
+         * positions searched with different evaluations don't share entries
+         */
+        static ulong getSearchKey(ulong evaluator);
+
+        bool probe(ulong key,Entry &entry);
+
+        void store(ulong key,CheckersNEATDatatype value,int depth,BoundType bound,int bestMove);
+
+        inline size_t getSizeInBytes() const
+        {
+            return slots.size()*sizeof(Slot);
+        }
+
+        inline ulong getProbes() const
+        {
+            return probes;
+        }
+
+        inline ulong getHits() const
+        {
+            return hits;
+        }
+
+        inline ulong getStores() const
+        {
+            return stores;
+        }
+
+        inline double getHitRate() const
+        {
+            return probes ? double(hits)/probes : 0.0;
+        }
+
+        inline void resetCounters()
+        {
+            probes = hits = stores = 0;
+        }
+    };
+}
+
+#endif // HCUBE_CHECKERSTRANSPOSITIONTABLE_H_INCLUDED
@@ -185,7 +185,17 @@ namespace HCUBE
         bool uctEnabled;
         int numGamesPerOpponent;
 
-        GoBook goBook;
+        //Input layer index of every board point, [r*goBoardSize+c]
+        vector<int> boardInputIndices;
+
+        //Output node of every board point, [r*goBoardSize+c]
+        vector<NEAT::NodeHandle> boardOutputHandles;
+
+        //The piece layers as they were last written to the substrate, and scratch space
+        //to encode the next board in
+        vector<GoNEATDatatype> boardInputValues[2];
+        vector<GoNEATDatatype> newBoardInputValues[2];
+        bool boardInputsValid;
 
     public:
         GoExperiment(string _experimentName,int _threadID);
@@ -238,6 +248,13 @@ namespace HCUBE
 
 		void generateMoves(SgEvaluatedMoves& eval);
 
+        /**
+         * writeBoardInputs: Encodes a board into the piece layers of the substrate, writing
+         * each layer in one go if it differs from what the substrate holds.  Returns
+         * whether the inputs changed.
+         */
+        bool writeBoardInputs(const GoBoard &boardToWrite,bool &boardEmpty);
+
         float getMoveHeuristic(const GoBoard *board, SgPoint p);
 
         inline int getGoBoardSize()
@@ -88,6 +88,86 @@ namespace HCUBE
     typedef boost::singleton_pool<OthelloMovePoolTag, sizeof(OthelloMove)> checkersMovePool;
 #endif
 
+    /**
+     * OthelloBitboard: The 64 squares of a board as bits, numbered like the memory of a
+     * ushort b[8][8] (square = x*8 + y), so walking the set bits from the lowest visits
+     * squares in the same order as the x then y loops over the board
+     */
+    class OthelloBitboard
+    {
+    public:
+        ulong black,white;
+
+        OthelloBitboard()
+                :
+                black(0),
+                white(0)
+        {}
+
+        OthelloBitboard(ushort b[8][8]);
+
+        /**
+         * toBoard: Writes the position as a ushort board, with the piece counts filled in
+         */
+        void toBoard(ushort b[8][8]) const;
+
+        inline ulong getPieces(int color) const
+        {
+            return (color==OTHELLO_BLACK) ? black : white;
+        }
+
+        inline ulong getEmpty() const
+        {
+            return ~(black|white);
+        }
+
+        /**
+         * makeMove: Places a piece of the given color and flips the pieces it captures.
+         * Returns the mask of flipped pieces.
+         */
+        ulong makeMove(int square,int color);
+
+        inline bool operator==(const OthelloBitboard &other) const
+        {
+            return black==other.black && white==other.white;
+        }
+
+        static inline int getSquare(int x,int y)
+        {
+            return (x<<3) + y;
+        }
+
+        static inline int getSquareX(int square)
+        {
+            return square>>3;
+        }
+
+        static inline int getSquareY(int square)
+        {
+            return square&7;
+        }
+
+        static inline int getLowestSquare(ulong mask)
+        {
+            //De Bruijn bit scan, mask must be non-zero
+            static const int deBruijnSquares[64] =
+            {
+                0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+                62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+                63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+                46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+            };
+            return deBruijnSquares[((mask&(0-mask))*0x03F79D71B4CB0A89ULL)>>58];
+        }
+
+        static inline int countSquares(ulong mask)
+        {
+            mask = mask - ((mask>>1)&0x5555555555555555ULL);
+            mask = (mask&0x3333333333333333ULL) + ((mask>>2)&0x3333333333333333ULL);
+            return int((((mask+(mask>>4))&0x0F0F0F0F0F0F0F0FULL)*0x0101010101010101ULL)>>56);
+        }
+    };
+
     class OthelloCommon
     {
     protected:
@@ -119,6 +199,33 @@ namespace HCUBE
         );
 
         int getWinner(ushort b[8][8]);
+
+        /**
+         * getMoves: The mask of squares where the given color can move
+         */
+        static ulong getMoves(const OthelloBitboard &board,int color);
+
+        /**
+         * getFlips: The mask of pieces a move by the given color on the square flips.
+         * Empty if the move is not legal.
+         */
+        static ulong getFlips(const OthelloBitboard &board,int color,int square);
+
+        static bool hasAnyMove(const OthelloBitboard &board);
+
+        static int getWinner(const OthelloBitboard &board);
+
+        /**
+         * getOthelloMove: Converts a move on a bitboard to an OthelloMove for the ushort
+         * board functions, with the flipped pieces filled in
+         */
+        static OthelloMove getOthelloMove(const OthelloBitboard &board,int color,int square);
+
+        /**
+         * perft: Counts the leaves of the game tree below a position, where a pass is a
+         * move and the tree ends when neither side can move
+         */
+        static ulong perft(const OthelloBitboard &board,int color,int depth);
     };
 
 }
@@ -117,6 +117,10 @@ namespace HCUBE
         NodeMap nameLookup;
         map<Node,NEAT::NetworkNode*> nodeLookup;
 
+        //Substrate nodes resolved once the substrate is generated
+        NEAT::NodeHandle boardInputHandles[8][8];
+        NEAT::NodeHandle boardOutputHandle;
+
         OthelloMove moveToMake;
 
         ushort userEvaluationBoard[8][8];
@@ -135,6 +139,12 @@ namespace HCUBE
 
         int randomMoveChance;
 
+        //Copies that search root moves on other threads, made on first use so a clone of
+        //this experiment gets helpers of its own
+        vector<shared_ptr<OthelloExperiment> > searchHelpers;
+        const OthelloExperiment *searchHelpersOwner;
+        int numSearchThreads;
+
 #if OTHELLO_EXPERIMENT_LOG_EVALUATIONS
         ushort gameLog[1024][8][8];
 #endif
@@ -173,6 +183,34 @@ namespace HCUBE
 
         OthelloNEATDatatype evaluatemin(ushort b[8][8],  OthelloNEATDatatype parentAlpha, int depth,int maxDepth);
 
+        /**
+         * The search itself, which copies bitboards instead of making and unmaking moves
+         * on the ushort board
+         */
+        OthelloNEATDatatype evaluatemax(const OthelloBitboard &board,  OthelloNEATDatatype parentBeta, int depth,int maxDepth);
+
+        OthelloNEATDatatype evaluatemin(const OthelloBitboard &board,  OthelloNEATDatatype parentAlpha, int depth,int maxDepth);
+
+        /**
+         * getSearchThreadCount: The threads a root search splits its moves over, 1 unless
+         * the SearchThreads parameter is set
+         */
+        int getSearchThreadCount();
+
+        /**
+         * searchRootMoves: Searches each move in the mask below the root against the same
+         * bound, on getSearchThreadCount() threads.  The results are stored in the order
+         * the moves come out of the mask.
+         */
+        void searchRootMoves(
+            const OthelloBitboard &board,
+            ulong moves,
+            int color,
+            OthelloNEATDatatype bound,
+            int maxDepth,
+            OthelloNEATDatatype *results
+        );
+
         virtual void processGroup(shared_ptr<NEAT::GeneticGeneration> generation);
 
         virtual void processIndividualPostHoc(shared_ptr<NEAT::GeneticIndividual> individual);
@@ -107,6 +107,7 @@ namespace HCUBE
     /** class Prototypes **/
     class Experiment;
     class ExperimentRun;
+    class EvaluationPool;
 
     class MainFrame;
     class ExperimentPanel;
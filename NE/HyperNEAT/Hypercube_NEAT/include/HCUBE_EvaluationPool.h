@@ -0,0 +1,95 @@
+#ifndef HCUBE_EVALUATIONPOOL_H_INCLUDED
+#define HCUBE_EVALUATIONPOOL_H_INCLUDED
+
+#include "HCUBE_Defines.h"
+
+#include "Experiments/HCUBE_Experiment.h"
+
+#include <boost/thread/condition.hpp>
+
+namespace HCUBE
+{
+    /**
+    * EvaluationPool keeps one worker thread per experiment alive for the whole run.  Each
+    * evaluate() call puts the individuals in a shared queue, and every worker takes one
+    * group (getGroupCapacity() individuals) at a time, so a thread that finishes its
+    * groups early keeps taking work instead of waiting on a slow part of the population.
+    */
+    class EvaluationPool
+    {
+    protected:
+        boost::thread_group threads;
+
+        boost::mutex poolMutex;
+
+        //Signalled when a new job is posted or the pool shuts down
+        boost::condition workCondition;
+
+        //Signalled when the last group of a job is done
+        boost::condition doneCondition;
+
+        int numThreads;
+
+        bool shuttingDown;
+
+        //Bumped for every job so a worker can tell a new job from the one it just finished
+        int jobNumber;
+
+        vector<shared_ptr<Experiment> > jobExperiments;
+        shared_ptr<NEAT::GeneticGeneration> jobGeneration;
+        vector<shared_ptr<NEAT::GeneticIndividual> >::iterator jobIndividuals;
+        int jobIndividualCount;
+        int jobGroupCapacity;
+
+        int nextIndividual;
+        int busyWorkers;
+        string error;
+
+    public:
+        EvaluationPool(int _numThreads);
+
+        virtual ~EvaluationPool();
+
+        inline int getThreadCount()
+        {
+            return numThreads;
+        }
+
+        /**
+        * Evaluates the individuals, worker 'a' using experiments[a].  Blocks until every
+        * group is processed and throws if any of the workers hit an error.
+        */
+        void evaluate(
+            const vector<shared_ptr<Experiment> > &experiments,
+            shared_ptr<NEAT::GeneticGeneration> generation,
+            vector<shared_ptr<NEAT::GeneticIndividual> >::iterator individualIterator,
+            int individualCount
+        );
+
+    protected:
+        void runWorker(int workerIndex);
+
+        void processGroup(
+            shared_ptr<Experiment> experiment,
+            shared_ptr<NEAT::GeneticGeneration> generation,
+            vector<shared_ptr<NEAT::GeneticIndividual> >::iterator individualIterator,
+            int individualCount
+        );
+
+        /**
+        * This class cannot be copied
+        */
+        EvaluationPool(const EvaluationPool &other)
+        {}
+
+        /**
+        * This class cannot be copied
+        */
+        const EvaluationPool &operator=(const EvaluationPool &other)
+        {
+            return *this;
+        }
+    };
+}
+
+#endif // HCUBE_EVALUATIONPOOL_H_INCLUDED
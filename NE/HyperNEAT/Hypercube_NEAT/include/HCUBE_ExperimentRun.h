@@ -24,6 +24,10 @@ namespace HCUBE
 
         vector<shared_ptr<Experiment> > experiments;
 
+        int numEvaluationThreads;
+
+        shared_ptr<EvaluationPool> evaluationPool;
+
         mutex* populationMutex;
 
         MainFrame *frame;
@@ -155,6 +159,12 @@ namespace HCUBE
         virtual float evaluateIndividual(unsigned int individualId);
         virtual void evaluatePopulation();
 
+        /**
+        * This function evaluates an individual that may not be part of the population,
+        * such as one read by loadIndividualIndexed.
+        */
+        virtual float evaluateIndividual(shared_ptr<NEAT::GeneticIndividual> individual);
+
         /**
         * This function performs speciation and sorts the invidiuals by fitness
         */
@@ -171,11 +181,22 @@ namespace HCUBE
             return populationMutex;
         }
 
-        // Saves and loads the population using boost serialization
+        // Saves and loads the population using boost serialization.  Loading also
+        // accepts an indexed population file and reads the archive inside it.
         void loadPopulationBoost(string filename);
         void savePopulationBoost(string filename);
 
+        // Saves the population as an indexed population file (see NEAT_IndexedPopulationFile.h)
+        void savePopulationIndexed(string filename);
+
+        // Reads one individual of an indexed population file without loading the population.
+        // The Globals parameters saved with the population are restored as well.
+        shared_ptr<NEAT::GeneticIndividual> loadIndividualIndexed(string filename,int individualId);
+
     protected:
+        string serializePopulationBoost();
+        void deserializePopulationBoost(const char *data,size_t size);
+
         /**
         * This class cannot be copied
         */
@@ -7,10 +7,12 @@
 
 #include "Experiments/HCUBE_Experiment.h"
 
+//Genomes go out as a testCount, an individualCount and then the length-prefixed genomes
+//(see GeneticIndividual::dump(GenomeWriter&)).  Results come back as a packed array of
+//individualCount fitness values followed by the individuals' user data strings.
 #define INDIVIDUAL_GENOMES_TAG 1000
-//#define NEW_FITNESSES_TAG 1001
+#define NEW_FITNESSES_TAG 1001
 #define DIE_TAG 1002
-#define NEW_INDIVIDUALS_TAG 1003
 
 namespace HCUBE
 {
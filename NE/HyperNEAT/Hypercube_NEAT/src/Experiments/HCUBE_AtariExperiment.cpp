@@ -99,7 +99,8 @@ struct pair_sort_pred {
 
     AtariExperiment::AtariExperiment(string _experimentName,int _threadID):
         Experiment(_experimentName,_threadID), substrate_width(8), substrate_height(10), visProc(NULL),
-        rom_file(""), numActions(0), numObjClasses(0), display_active(false), outputLayerIndx(-1)
+        rom_file(""), numActions(0), numObjClasses(0), display_active(false), outputLayerIndx(-1),
+        incrementalUpdate(false), frameSkip(1)
     {
     }
 
@@ -124,6 +125,16 @@ struct pair_sort_pred {
             exit(-1);
         }
 
+        if (NEAT::Globals::getSingleton()->hasParameterValue("AtariFrameSkip")) {
+            frameSkip = max(1, int(NEAT::Globals::getSingleton()->getParameterValue("AtariFrameSkip")+0.1));
+        }
+
+        // Off unless asked for, since the incremental outputs can differ from update() in
+        // the last bits and so change the selected action
+        if (NEAT::Globals::getSingleton()->hasParameterValue("AtariIncrementalUpdate")) {
+            incrementalUpdate = NEAT::Globals::getSingleton()->getParameterValue("AtariIncrementalUpdate") > 0.5;
+        }
+
         //JOEL TODO: use minimal actions instead of legal actions?
         numActions = ale.legal_actions.size();
 
@@ -307,6 +318,8 @@ struct pair_sort_pred {
 
     float AtariExperiment::runAtariEpisode(NEAT::LayeredSubstrate<float>* substrate) {
         ale.reset_game();
+        resolveOutputHandles(substrate);
+        resolveInputHandles(substrate);
         
         while (!ale.game_over()) {
             // Set value of all nodes to zero
@@ -316,7 +329,10 @@ struct pair_sort_pred {
             setSubstrateValues(substrate);
 
             // Propagate values through the ANN
-            substrate->getNetwork()->update();
+            if (incrementalUpdate)
+                substrate->getNetwork()->updateIncremental();
+            else
+                substrate->getNetwork()->update();
 
             // Print the Activations of the different layers
             //printLayerInfo(substrate);
@@ -325,6 +341,10 @@ struct pair_sort_pred {
             Action action = selectAction(substrate, outputLayerIndx);
 	    //cout << "Action: " << action << endl;
             ale.act(action);
+            for (int framesLeft=frameSkip-1; framesLeft>0 && !ale.game_over(); framesLeft--) {
+                skipScreen(framesLeft);
+                ale.act(action);
+            }
         }
         cout << "Game ended in " << ale.frame << " frames with score " << ale.game_score << endl;
  
@@ -339,7 +359,7 @@ struct pair_sort_pred {
         setSubstrateSelfValue(*visProc, substrate);
        
         // Set substrate value for bias 
-        substrate->setValue((Node(0,0,numObjClasses+1)),0.5f);
+        substrate->setValue(biasHandle,0.5f);
     }
 
     void AtariExperiment::setSubstrateObjectValues(VisualProcessor& visProc,
@@ -367,8 +387,36 @@ struct pair_sort_pred {
             //         substrate->setValue(Node(x,y,i),substrate->getValue(Node(x,y,i))+val);
             //     }
             // }
-            substrate->setValue((Node(adj_x,adj_y,substrateIndx)),assigned_value);
+            substrate->setValue(NEAT::NodeHandle(substrateIndx,inputCellIndices[adj_y*substrate_width+adj_x]),
+                                assigned_value);
+        }
+    }
+
+    void AtariExperiment::resolveOutputHandles(NEAT::LayeredSubstrate<float>* substrate) {
+        outputHandles.clear();
+#ifndef CON_ACTION
+        for (int i=0; i < numActions; i++) {
+            #ifdef SN_ACTION
+            outputHandles.push_back(substrate->resolve(Node(0,0,outputLayerIndx+i)));
+            #else
+            outputHandles.push_back(substrate->resolve(Node(i,0,outputLayerIndx)));
+            #endif
         }
+#endif
+    }
+
+    void AtariExperiment::resolveInputHandles(NEAT::LayeredSubstrate<float>* substrate) {
+        inputCellIndices.resize(substrate_width*substrate_height);
+        for (int y=0; y<substrate_height; y++) {
+            for (int x=0; x<substrate_width; x++) {
+                inputCellIndices[y*substrate_width+x] = substrate->resolve(Node(x,y,0)).index;
+            }
+        }
+
+        biasHandle = NEAT::NodeHandle();
+        int biasLayer = substrate->getLayerIndex("InputBias");
+        if (biasLayer >= 0)
+            biasHandle = substrate->resolve(Node(0,0,biasLayer));
     }
 
     void AtariExperiment::printLayerInfo(NEAT::LayeredSubstrate<float>* substrate) {
@@ -447,11 +495,7 @@ struct pair_sort_pred {
 	#else
 
         for (int i=0; i < numActions; i++) {
-            #ifdef SN_ACTION
-            float output = substrate->getValue(Node(0,0,outputLayerIndx+i));
-	    #else
-            float output = substrate->getValue(Node(i,0,outputLayerIndx));
-            #endif
+            float output = substrate->getValue(outputHandles[i]);
 
             if (output == max_val)
                 max_inds.push_back(i);
@@ -0,0 +1,128 @@
+#include "HCUBE_Defines.h"
+
+#include "Experiments/HCUBE_AtariFramePreprocessor.h"
+
+//Skip the parts of a screen row that repeat the row above with SSE2 compares.  Only
+//where the compiler targets SSE2; otherwise every pixel goes through the scalar loop.
+#ifndef ATARI_FRAME_PREPROCESSOR_SIMD_COMPARE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#define ATARI_FRAME_PREPROCESSOR_SIMD_COMPARE (1)
+#else
+#define ATARI_FRAME_PREPROCESSOR_SIMD_COMPARE (0)
+#endif
+#endif
+
+#if ATARI_FRAME_PREPROCESSOR_SIMD_COMPARE
+#include <emmintrin.h>
+#endif
+
+namespace HCUBE
+{
+    AtariFramePreprocessor::AtariFramePreprocessor():
+        screenWidth(0), screenHeight(0), cellsWide(0), cellsHigh(0), numColors(0)
+    {
+    }
+
+    void AtariFramePreprocessor::initialize(int _screenWidth, int _screenHeight, int _cellsWide,
+                                            int _cellsHigh, const uInt32 *palette, int _numColors) {
+        if (_numColors > 32) {
+            throw CREATE_LOCATEDEXCEPTION_INFO("A frame can only have up to 32 colors");
+        }
+
+        screenWidth = _screenWidth;
+        screenHeight = _screenHeight;
+        cellsWide = _cellsWide;
+        cellsHigh = _cellsHigh;
+        numColors = _numColors;
+
+        for (int i=0; i<256; i++) {
+            assert(palette[i] < uInt32(numColors));
+            colorBits[i] = uInt32(1) << palette[i];
+        }
+
+        // Screen row y is in cell row y*cellsHigh/screenHeight, and likewise for the
+        // columns, so every cell covers a block of whole rows and columns
+        columnCells.resize(screenWidth);
+        for (int x=0; x<screenWidth; x++) {
+            columnCells[x] = x*cellsWide/screenWidth;
+        }
+        cellRowEnds.resize(cellsHigh);
+        for (int y=0; y<cellsHigh; y++) {
+            cellRowEnds[y] = ((y+1)*screenHeight + cellsHigh-1)/cellsHigh;
+        }
+
+        cellIndices.resize(cellsWide*cellsHigh);
+        for (int i=0; i<int(cellIndices.size()); i++) {
+            cellIndices[i] = i;
+        }
+
+        columnColors.assign(screenWidth, 0);
+        cellColors.assign(cellsWide*cellsHigh, 0);
+    }
+
+    void AtariFramePreprocessor::setCellIndices(const vector<int> &_cellIndices) {
+        assert(_cellIndices.size() == cellIndices.size());
+        cellIndices = _cellIndices;
+    }
+
+    void AtariFramePreprocessor::clear() {
+        fill(cellColors.begin(), cellColors.end(), 0);
+    }
+
+    void AtariFramePreprocessor::poolScreen(const IntMatrix &screen) {
+        uInt32 *colors = &columnColors[0];
+        int y = 0;
+        for (int cellY=0; cellY<cellsHigh; cellY++) {
+            // Gather the colors of each column over the rows of the cell row first, so the
+            // pass over the pixels has no dependency between them
+#if ATARI_FRAME_PREPROCESSOR_SIMD_COMPARE
+            int firstRow = y;
+#endif
+            for (; y<cellRowEnds[cellY]; y++) {
+                const int *row = &screen[y][0];
+                int x = 0;
+#if ATARI_FRAME_PREPROCESSOR_SIMD_COMPARE
+                if (y > firstRow) {
+                    // Most rows repeat the row above in most places, and those pixels
+                    // are already in the column colors
+                    const int *rowAbove = &screen[y-1][0];
+                    for (; x+4<=screenWidth; x+=4) {
+                        __m128i same = _mm_cmpeq_epi32(
+                            _mm_loadu_si128((const __m128i*)(row+x)),
+                            _mm_loadu_si128((const __m128i*)(rowAbove+x))
+                            );
+                        if (_mm_movemask_epi8(same) != 0xFFFF) {
+                            colors[x] |= colorBits[row[x]];
+                            colors[x+1] |= colorBits[row[x+1]];
+                            colors[x+2] |= colorBits[row[x+2]];
+                            colors[x+3] |= colorBits[row[x+3]];
+                        }
+                    }
+                }
+#endif
+                for (; x<screenWidth; x++) {
+                    colors[x] |= colorBits[row[x]];
+                }
+            }
+
+            uInt32 *cells = &cellColors[cellY*cellsWide];
+            for (int x=0; x<screenWidth; x++) {
+                cells[columnCells[x]] |= colors[x];
+                colors[x] = 0;
+            }
+        }
+    }
+
+    void AtariFramePreprocessor::writeInputs(const IntMatrix &screen, float *inputs) {
+        poolScreen(screen);
+
+        int numCells = cellsWide*cellsHigh;
+        for (int color=0; color<numColors; color++) {
+            float *plane = inputs + color*numCells;
+            for (int i=0; i<numCells; i++) {
+                plane[cellIndices[i]] = float((cellColors[i]>>color)&1);
+            }
+        }
+        clear();
+    }
+}
@@ -13,7 +13,7 @@ namespace HCUBE
 {
     AtariNoGeomExperiment::AtariNoGeomExperiment(string _experimentName,int _threadID):
         Experiment(_experimentName,_threadID), visProc(NULL), rom_file(""),
-        numActions(0), numObjClasses(0), display_active(false)
+        numActions(0), numObjClasses(0), display_active(false), inputRowWidth(0)
     {
     }
 
@@ -115,10 +115,39 @@ namespace HCUBE
         individual->setFitness(0);
 
         substrate = individual->spawnFastPhenotypeStack<double>();
+        resolveSubstrateHandles();
 
         runAtariEpisode(individual);
     }
 
+    void AtariNoGeomExperiment::resolveSubstrateHandles()
+    {
+        // Node indices differ between individuals, so this runs once per spawned
+        // substrate instead of hashing node names for every frame
+        inputRowWidth = 0;
+        int inputRows = 0, outputCount = 0;
+        for (map<Node,string>::iterator it=nameLookup.begin(); it!=nameLookup.end(); it++) {
+            const Node &node = it->first;
+            if (node.z == 0) {
+                inputRowWidth = max(inputRowWidth, node.x+1);
+                inputRows = max(inputRows, node.y+1);
+            } else if (node.z == 2) {
+                outputCount = max(outputCount, node.x+1);
+            }
+        }
+
+        inputHandles.assign(inputRowWidth*inputRows, NEAT::NodeHandle());
+        outputHandles.assign(outputCount, NEAT::NodeHandle());
+        for (map<Node,string>::iterator it=nameLookup.begin(); it!=nameLookup.end(); it++) {
+            const Node &node = it->first;
+            if (node.z == 0) {
+                inputHandles[node.y*inputRowWidth+node.x] = substrate.resolve(it->second);
+            } else if (node.z == 2) {
+                outputHandles[node.x] = substrate.resolve(it->second);
+            }
+        }
+    }
+
     void AtariNoGeomExperiment::runAtariEpisode(shared_ptr<NEAT::GeneticIndividual> individual) {
         // Reset the game
         ale.reset_game();
@@ -171,7 +200,7 @@ namespace HCUBE
             point obj_centroid = visProc.composite_objs[obj_id].get_centroid();
             int adj_x = obj_centroid.x * substrate_width / visProc.screen_width;
             int adj_y = obj_centroid.y * substrate_height / visProc.screen_height;
-            substrate.setValue(nameLookup[Node(substrate_width*substrateIndx+adj_x,adj_y,0)], assigned_value);
+            substrate.setValue(getInputHandle(substrate_width*substrateIndx+adj_x,adj_y), assigned_value);
         }
     }
 
@@ -185,7 +214,7 @@ namespace HCUBE
         vector<int> max_inds;
         float max_val = -1e37;
         for (int i=0; i < numActions; i++) {
-            float output = substrate.getValue(nameLookup[Node(i,0,2)]);
+            float output = substrate.getValue(outputHandles[i]);
             if (output == max_val)
                 max_inds.push_back(i);
             else if (output > max_val) {
@@ -77,7 +77,7 @@ namespace HCUBE
         NEAT::Random& random = NEAT::Globals::getSingleton()->getRandom();
         for (int y=0; y<substrate_height; y++) {
             for (int x=0; x<substrate_width; x++) {
-                substrate.setValue(nameLookup[Node(x,y,0)], random.getRandomDouble());
+                substrate.setValue(getInputHandle(x,y), random.getRandomDouble());
             }
         }
     }
@@ -76,6 +76,8 @@ namespace HCUBE
             Node node(i,0,2);
             nameLookup[node] = (toString(i) + string("/") + toString("0") + string("/") + toString("2"));
         }
+
+        initializePixelInputs();
     }
 
     NEAT::GeneticPopulation* AtariNoGeomPixelExperiment::createInitialPopulation(int populationSize) {
@@ -114,17 +116,28 @@ namespace HCUBE
         return population;
     }
 
-    void AtariNoGeomPixelExperiment::setSubstrateValues() {
-        for (int y=0; y<ale.screen_height; y++) {
-            for (int x=0; x<ale.screen_width; x++) {
-                int substrate_y = min(int((y / float(ale.screen_height)) * substrate_width), substrate_height-1);
-                int substrate_x = min(int((x / float(ale.screen_width)) * substrate_width), substrate_width-1);
-                uInt32 eightBitVal = eightBitPallete[ale.screen_matrix[y][x]];
-                assert(eightBitVal < numColors);
-                assert(substrate_x < substrate_width);
-                assert(substrate_y < substrate_height);
-                substrate.setValue(nameLookup[Node(substrate_width*eightBitVal+substrate_x,substrate_y,0)], 1.0);
+    void AtariNoGeomPixelExperiment::initializePixelInputs() {
+        framePreprocessor.initialize(ale.screen_width, ale.screen_height, substrate_width,
+                                     substrate_height, eightBitPallete, numColors);
+        frameInputs.resize(framePreprocessor.getInputCount());
+    }
+
+    void AtariNoGeomPixelExperiment::resolveSubstrateHandles() {
+        AtariNoGeomExperiment::resolveSubstrateHandles();
+
+        inputNodeIndices.resize(frameInputs.size());
+        for (int i=0; i<numColors; i++) {
+            for (int y=0; y<substrate_height; y++) {
+                for (int x=0; x<substrate_width; x++) {
+                    inputNodeIndices[(i*substrate_height+y)*substrate_width+x] =
+                        getInputHandle(substrate_width*i+x,y).index;
+                }
             }
         }
     }
+
+    void AtariNoGeomPixelExperiment::setSubstrateValues() {
+        framePreprocessor.writeInputs(ale.screen_matrix, &frameInputs[0]);
+        substrate.scatterValues(&inputNodeIndices[0], &frameInputs[0], int(frameInputs.size()));
+    }
 }
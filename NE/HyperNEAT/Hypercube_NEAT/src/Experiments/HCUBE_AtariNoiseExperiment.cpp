@@ -95,7 +95,8 @@ namespace HCUBE
         NEAT::Random& random = NEAT::Globals::getSingleton()->getRandom();
         for (int y=0; y<substrate_height; y++) {
             for (int x=0; x<substrate_width; x++) {
-                substrate->setValue((Node(x, y, 0)), random.getRandomDouble());
+                substrate->setValue(NEAT::NodeHandle(0,inputCellIndices[y*substrate_width+x]),
+                                    random.getRandomDouble());
             }
         }
     }
@@ -47,8 +47,9 @@ namespace HCUBE
 
 
     AtariPixelExperiment::AtariPixelExperiment(string _experimentName,int _threadID):
-        AtariExperiment(_experimentName,_threadID)
-    {}
+        AtariExperiment(_experimentName,_threadID), poolFrames(1)
+    {
+    }
 
     void AtariPixelExperiment::initializeExperiment(string rom_file) {
         initializeALE(rom_file, false); // No screen processing necessary
@@ -57,6 +58,12 @@ namespace HCUBE
         substrate_width = ale.screen_width / 10;
         substrate_height = ale.screen_height / 10;
 
+        if (NEAT::Globals::getSingleton()->hasParameterValue("AtariPoolFrames")) {
+            poolFrames = max(1, int(NEAT::Globals::getSingleton()->getParameterValue("AtariPoolFrames")+0.1));
+        }
+        framePreprocessor.initialize(ale.screen_width, ale.screen_height, substrate_width,
+                                     substrate_height, eightBitPallete, numColors);
+
         initializeTopology();
     }
 
@@ -137,17 +144,24 @@ namespace HCUBE
         return population;
     }
 
-    void AtariPixelExperiment::setSubstrateValues(NEAT::LayeredSubstrate<float>* substrate) {
-        for (int y=0; y<ale.screen_height; y++) {
-            for (int x=0; x<ale.screen_width; x++) {
-                int substrate_y = min(int((y / float(ale.screen_height)) * substrate_width), substrate_height-1);
-                int substrate_x = min(int((x / float(ale.screen_width)) * substrate_width), substrate_width-1);
-                uInt32 eightBitVal = eightBitPallete[ale.screen_matrix[y][x]];
-                assert(eightBitVal < numColors);
-                assert(substrate_x < substrate_width);
-                assert(substrate_y < substrate_height);
-                substrate->setValue((Node(substrate_x, substrate_y, eightBitVal)), 1.0);
-            }
+    void AtariPixelExperiment::resolveInputHandles(NEAT::LayeredSubstrate<float>* substrate) {
+        AtariExperiment::resolveInputHandles(substrate);
+
+        framePreprocessor.setCellIndices(inputCellIndices);
+        framePreprocessor.clear();
+
+        frameInputs.resize(substrate->getInputValueCount());
+        assert(int(frameInputs.size()) == framePreprocessor.getInputCount());
+    }
+
+    void AtariPixelExperiment::skipScreen(int framesLeft) {
+        if (framesLeft < poolFrames) {
+            framePreprocessor.poolScreen(ale.screen_matrix);
         }
     }
+
+    void AtariPixelExperiment::setSubstrateValues(NEAT::LayeredSubstrate<float>* substrate) {
+        framePreprocessor.writeInputs(ale.screen_matrix, &frameInputs[0]);
+        substrate->setInputValues(&frameInputs[0]);
+    }
 }
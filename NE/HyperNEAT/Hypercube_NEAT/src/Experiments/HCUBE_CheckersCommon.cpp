@@ -858,6 +858,456 @@ namespace HCUBE
         return numMoves;
     }
 
+    //Square masks for the bitboard generator
+    static const uint EVEN_ROW_SQUARES = 0x0F0F0F0FU;
+    static const uint ODD_ROW_SQUARES = 0xF0F0F0F0U;
+    static const uint LEFT_COLUMN_SQUARES = 0x11111111U; //x/2==0
+    static const uint RIGHT_COLUMN_SQUARES = 0x88888888U; //x/2==3
+    static const uint BLACK_KING_ROW_SQUARES = 0xF0000000U; //y==7
+    static const uint WHITE_KING_ROW_SQUARES = 0x0000000FU; //y==0
+
+    //Neighbors of every square in a mask, one per direction
+    static inline uint shiftUpRight(uint mask)
+    {
+        return ((mask&EVEN_ROW_SQUARES)<<4) | ((mask&ODD_ROW_SQUARES&~RIGHT_COLUMN_SQUARES)<<5);
+    }
+
+    static inline uint shiftUpLeft(uint mask)
+    {
+        return ((mask&EVEN_ROW_SQUARES&~LEFT_COLUMN_SQUARES)<<3) | ((mask&ODD_ROW_SQUARES)<<4);
+    }
+
+    static inline uint shiftDownRight(uint mask)
+    {
+        return ((mask&EVEN_ROW_SQUARES)>>4) | ((mask&ODD_ROW_SQUARES&~RIGHT_COLUMN_SQUARES)>>3);
+    }
+
+    static inline uint shiftDownLeft(uint mask)
+    {
+        return ((mask&EVEN_ROW_SQUARES&~LEFT_COLUMN_SQUARES)>>5) | ((mask&ODD_ROW_SQUARES)>>4);
+    }
+
+    static const uchar NO_SQUARE = 255;
+
+    class CheckersSquareTables
+    {
+    public:
+        //Directions in the order the uchar generator tries them:
+        //(+1,+1), (-1,+1), (+1,-1), (-1,-1)
+        uchar neighbors[32][4];
+        uchar jumpLandings[32][4];
+
+        //Squares in the order the uchar generator visits them (x, then y)
+        uchar squareOrder[32];
+
+        CheckersSquareTables()
+        {
+            static const int deltas[4][2] = { {1,1}, {-1,1}, {1,-1}, {-1,-1} };
+
+            int index=0;
+            for (int x=0;x<8;x++)
+            {
+                for (int y=(x%2);y<8;y+=2)
+                {
+                    int square = CheckersBitboard::getSquare(x,y);
+                    squareOrder[index++] = uchar(square);
+
+                    for (int d=0;d<4;d++)
+                    {
+                        int nx = x+deltas[d][0];
+                        int ny = y+deltas[d][1];
+                        int jx = x+deltas[d][0]*2;
+                        int jy = y+deltas[d][1]*2;
+
+                        neighbors[square][d] =
+                            IS_IN_BOUNDS(nx,ny) ? uchar(CheckersBitboard::getSquare(nx,ny)) : NO_SQUARE;
+                        jumpLandings[square][d] =
+                            IS_IN_BOUNDS(jx,jy) ? uchar(CheckersBitboard::getSquare(jx,jy)) : NO_SQUARE;
+                    }
+                }
+            }
+        }
+    };
+
+    static const CheckersSquareTables squareTables;
+
+    static inline bool canMoveInDirection(int color,bool isKing,int direction)
+    {
+        //Black men move in +y (directions 0 and 1), white men in -y
+        return isKing || ((color==BLACK) == (direction<2));
+    }
+
+    CheckersBitboard::CheckersBitboard(uchar b[8][8])
+        :
+    black(0),
+        white(0),
+        kings(0)
+    {
+        for (int square=0;square<32;square++)
+        {
+            uchar piece = b[getSquareX(square)][getSquareY(square)];
+
+            if (piece&BLACK)
+            {
+                black |= (1U<<square);
+            }
+            else if (piece&WHITE)
+            {
+                white |= (1U<<square);
+            }
+
+            if ((piece&KING) && (piece&(BLACK|WHITE)))
+            {
+                kings |= (1U<<square);
+            }
+        }
+    }
+
+    void CheckersBitboard::toBoard(uchar b[8][8]) const
+    {
+        for (int y=0;y<8;y++)
+        {
+            for (int x=0;x<8;x++)
+            {
+                if ((x+y)%2==1)
+                {
+                    b[x][y] = FREE;
+                }
+                else
+                {
+                    uint squareMask = (1U<<getSquare(x,y));
+                    uchar pieceType = (kings&squareMask) ? KING : MAN;
+
+                    if (black&squareMask)
+                    {
+                        b[x][y] = BLACK|pieceType;
+                    }
+                    else if (white&squareMask)
+                    {
+                        b[x][y] = WHITE|pieceType;
+                    }
+                    else
+                    {
+                        b[x][y] = 0;
+                    }
+                }
+            }
+        }
+
+        NUM_BLACK_PIECES(b) = uchar(countSquares(black));
+        NUM_WHITE_PIECES(b) = uchar(countSquares(white));
+    }
+
+    void CheckersBitboard::makeMove(const CheckersBitMove &move,int color)
+    {
+        uint &own = (color==BLACK) ? black : white;
+        uint &other = (color==BLACK) ? white : black;
+
+        own ^= (move.from|move.to);
+        other &= ~move.captured;
+
+        if (kings&move.from)
+        {
+            kings ^= (move.from|move.to);
+        }
+        else if (move.to & ((color==BLACK) ? BLACK_KING_ROW_SQUARES : WHITE_KING_ROW_SQUARES))
+        {
+            kings |= move.to;
+        }
+
+        kings &= ~move.captured;
+    }
+
+    static inline void addBitMove(CheckersBitMoveList &moveList,const CheckersBitMove &move,int toSquare)
+    {
+        if (moveList.numMoves==CHECKERS_MAX_MOVES)
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("Too many possible moves for a given board state! Oh shiz!");
+        }
+
+        CheckersBitMove &newMove = moveList.moves[moveList.numMoves++];
+        newMove = move;
+        newMove.to = (1U<<toSquare);
+    }
+
+    bool CheckersCommon::addBitJumps(
+        CheckersBitMoveList &moveList,
+        CheckersBitMove &moveInProgress,
+        uint own,
+        uint other,
+        int color,
+        bool isKing,
+        int square
+        )
+    {
+        //Same direction order as tryMoreJumps
+        static const int jumpDirections[4] = {1,0,3,2};
+
+        uint kingRow = (color==BLACK) ? BLACK_KING_ROW_SQUARES : WHITE_KING_ROW_SQUARES;
+        bool hasMoreJumps=false;
+
+        for (int a=0;a<4;a++)
+        {
+            int direction = jumpDirections[a];
+            if (!canMoveInDirection(color,isKing,direction))
+            {
+                continue;
+            }
+
+            int landing = squareTables.jumpLandings[square][direction];
+            if (landing==NO_SQUARE)
+            {
+                continue;
+            }
+
+            uint overMask = (1U<<squareTables.neighbors[square][direction]);
+            uint landingMask = (1U<<landing);
+
+            if (
+                !(other&overMask) ||
+                ((own|other)&landingMask) ||
+                landing==moveInProgress.path[0] //tryMoreJumps never returns to the start square
+            )
+            {
+                continue;
+            }
+
+            hasMoreJumps=true;
+
+            int numJumps = moveInProgress.numJumps;
+            if (numJumps+2>CHECKERS_MAX_PATH_SQUARES)
+            {
+                throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Jump path is too long!");
+            }
+
+            uint oldCaptured = moveInProgress.captured;
+            moveInProgress.path[numJumps+1] = uchar(landing);
+            moveInProgress.numJumps = uchar(numJumps+1);
+            moveInProgress.captured |= overMask;
+
+            bool moreJumps=false;
+            if (isKing || !(landingMask&kingRow))
+            {
+                //"A piece that has just kinged, cannot continue jumping pieces, until the next move."
+                moreJumps = addBitJumps(
+                                moveList,
+                                moveInProgress,
+                                own^(1U<<square)^landingMask,
+                                other^overMask,
+                                color,
+                                isKing,
+                                landing
+                            );
+            }
+
+            if (!moreJumps)
+            {
+                addBitMove(moveList,moveInProgress,landing);
+            }
+
+            moveInProgress.numJumps = uchar(numJumps);
+            moveInProgress.captured = oldCaptured;
+        }
+
+        return hasMoreJumps;
+    }
+
+    int CheckersCommon::generateMoveList(
+        const CheckersBitboard &board,
+        int color,
+        CheckersBitMoveList &moveList
+        )
+    {
+        uint own = board.getPieces(color);
+        uint other = board.getPieces((color==BLACK) ? WHITE : BLACK);
+        uint empty = board.getEmpty();
+
+        moveList.numMoves=0;
+        moveList.foundJump=hasJump(board,color);
+
+        CheckersBitMove move;
+
+        for (int a=0;a<32;a++)
+        {
+            int square = squareTables.squareOrder[a];
+            uint squareMask = (1U<<square);
+
+            if (!(own&squareMask))
+            {
+                continue;
+            }
+
+            bool isKing = (board.kings&squareMask)!=0;
+
+            move.from = squareMask;
+            move.captured = 0;
+            move.path[0] = uchar(square);
+            move.numJumps = 0;
+
+            for (int direction=0;direction<4;direction++)
+            {
+                if (!canMoveInDirection(color,isKing,direction))
+                {
+                    continue;
+                }
+
+                if (moveList.foundJump)
+                {
+                    //The uchar generator keeps only the jumps once it finds one
+                    int landing = squareTables.jumpLandings[square][direction];
+                    if (
+                        landing==NO_SQUARE ||
+                        !(other&(1U<<squareTables.neighbors[square][direction])) ||
+                        !(empty&(1U<<landing))
+                    )
+                    {
+                        continue;
+                    }
+
+                    uint overMask = (1U<<squareTables.neighbors[square][direction]);
+                    uint landingMask = (1U<<landing);
+                    uint kingRow = (color==BLACK) ? BLACK_KING_ROW_SQUARES : WHITE_KING_ROW_SQUARES;
+
+                    move.path[1] = uchar(landing);
+                    move.numJumps = 1;
+                    move.captured = overMask;
+
+                    bool moreJumps=false;
+                    if (isKing || !(landingMask&kingRow))
+                    {
+                        moreJumps = addBitJumps(
+                                        moveList,
+                                        move,
+                                        own^squareMask^landingMask,
+                                        other^overMask,
+                                        color,
+                                        isKing,
+                                        landing
+                                    );
+                    }
+
+                    if (!moreJumps)
+                    {
+                        addBitMove(moveList,move,landing);
+                    }
+
+                    move.numJumps = 0;
+                    move.captured = 0;
+                }
+                else
+                {
+                    int target = squareTables.neighbors[square][direction];
+                    if (target!=NO_SQUARE && (empty&(1U<<target)))
+                    {
+                        move.path[1] = uchar(target);
+                        addBitMove(moveList,move,target);
+                    }
+                }
+            }
+        }
+
+        return moveList.numMoves;
+    }
+
+    bool CheckersCommon::hasJump(const CheckersBitboard &board,int color)
+    {
+        uint own = board.getPieces(color);
+        uint other = board.getPieces((color==BLACK) ? WHITE : BLACK);
+        uint empty = board.getEmpty();
+
+        uint upMovers = (color==BLACK) ? own : (own&board.kings);
+        uint downMovers = (color==WHITE) ? own : (own&board.kings);
+
+        return
+            (
+                (shiftUpRight(shiftUpRight(upMovers)&other)&empty) |
+                (shiftUpLeft(shiftUpLeft(upMovers)&other)&empty) |
+                (shiftDownRight(shiftDownRight(downMovers)&other)&empty) |
+                (shiftDownLeft(shiftDownLeft(downMovers)&other)&empty)
+            )!=0;
+    }
+
+    bool CheckersCommon::hasAnyMove(const CheckersBitboard &board,int color)
+    {
+        uint own = board.getPieces(color);
+        uint empty = board.getEmpty();
+
+        uint upMovers = (color==BLACK) ? own : (own&board.kings);
+        uint downMovers = (color==WHITE) ? own : (own&board.kings);
+
+        if (
+            (
+                shiftUpRight(upMovers) |
+                shiftUpLeft(upMovers) |
+                shiftDownRight(downMovers) |
+                shiftDownLeft(downMovers)
+            )&empty
+        )
+        {
+            return true;
+        }
+
+        return hasJump(board,color);
+    }
+
+    CheckersMove CheckersCommon::getCheckersMove(const CheckersBitMove &move)
+    {
+        CheckersMove checkersMove(
+            Vector2<uchar>(
+                CheckersBitboard::getSquareX(move.path[0]),
+                CheckersBitboard::getSquareY(move.path[0])
+            ),
+            Vector2<uchar>(
+                CheckersBitboard::getSquareX(move.path[1]),
+                CheckersBitboard::getSquareY(move.path[1])
+            ),
+            checkersMovePoolPtr
+        );
+
+        for (int a=1;a<move.numJumps;a++)
+        {
+            checkersMove.addJump(
+                Vector2<uchar>(
+                    CheckersBitboard::getSquareX(move.path[a]),
+                    CheckersBitboard::getSquareY(move.path[a])
+                ),
+                Vector2<uchar>(
+                    CheckersBitboard::getSquareX(move.path[a+1]),
+                    CheckersBitboard::getSquareY(move.path[a+1])
+                )
+            );
+        }
+
+        return checkersMove;
+    }
+
+    ulong CheckersCommon::perft(const CheckersBitboard &board,int color,int depth)
+    {
+        if (depth<=0)
+        {
+            return 1;
+        }
+
+        CheckersBitMoveList moveList;
+        generateMoveList(board,color,moveList);
+
+        if (depth==1)
+        {
+            return ulong(moveList.numMoves);
+        }
+
+        int otherColor = (color==BLACK) ? WHITE : BLACK;
+        ulong nodes=0;
+        for (int a=0;a<moveList.numMoves;a++)
+        {
+            CheckersBitboard child = board;
+            child.makeMove(moveList.moves[a],color);
+            nodes += perft(child,otherColor,depth-1);
+        }
+
+        return nodes;
+    }
+
     bool CheckersCommon::hasMove(
         uchar b[8][8],
         int color,
@@ -1301,4 +1751,22 @@ namespace HCUBE
             }
         }
     }
+
+    //newsearchcontext initializes cake the first time, which must not run on two threads
+    static mutex cakeInitMutex;
+
+    CakeSearchContext::~CakeSearchContext()
+    {
+        deletesearchcontext(context);
+    }
+
+    SEARCHCONTEXT *CakeSearchContext::get()
+    {
+        if (!context)
+        {
+            boost::mutex::scoped_lock lock(cakeInitMutex);
+            context = newsearchcontext();
+        }
+        return context;
+    }
 }
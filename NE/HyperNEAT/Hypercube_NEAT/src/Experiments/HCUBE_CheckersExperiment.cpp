@@ -16,7 +16,10 @@
 
 #define DEBUG_USE_DELTAS (1)
 
-#define DEBUG_DO_ITERATIVE_DEEPENING (0)
+#define DEBUG_DO_ITERATIVE_DEEPENING (1)
+
+//Searches shallower than this stay on one thread, starting the threads would cost more
+#define PARALLEL_SEARCH_MIN_DEPTH (4)
 
 #define BASE_EVOLUTION_SEARCH_DEPTH (4)
 
@@ -93,20 +96,30 @@ namespace HCUBE
 
     using namespace NEAT;
 
-    mutex cakeMutex;
+    //cake keeps its search state in each player's CakeSearchContext, but cliche is
+    //still one global engine
+    mutex clicheMutex;
 
     CheckersExperiment::CheckersExperiment(string _experimentName,int _threadID)
         :
     Experiment(_experimentName,_threadID),
         currentSubstrateIndex(0),
+        chanceToMakeSecondBestMove(0.0),
+        transpositionTableOwner(NULL),
+        transpositionTableEpochCount(0),
+        searchKey(0),
+        searchHelpersOwner(NULL),
+        numSearchThreads(0),
         from(255,255),
         DEBUG_USE_HANDCODED_EVALUATION(0),
         DEBUG_USE_HYPERNEAT_EVALUATION(0),
-        chanceToMakeSecondBestMove(0.0),
 		dumpEvaluationImages(false),
 		cakeRandomSeed(1000)
     {
+        transpositionTableEpochs[0] = transpositionTableEpochs[1] = 0;
+
         searchInfo.repcheck = NULL;
+        searchInfo.context = NULL;
         //boardEvaluationCaches[0].resize(10000);
         //boardEvaluationCaches[1].resize(10000);
 
@@ -145,6 +158,15 @@ namespace HCUBE
         {
             substrates[a].setLayerInfo(layerInfo);
         }
+
+        for (int y=0;y<numNodesY[0];y++)
+        {
+            for (int x=0;x<numNodesX[0];x++)
+            {
+                boardInputHandles[y][x] = substrates[0].resolve(Node(x,y,0));
+            }
+        }
+        boardOutputHandle = substrates[0].resolve(Node(0,0,2));
     }
 
     CheckersExperiment::~CheckersExperiment()
@@ -223,18 +245,6 @@ namespace HCUBE
             boardEvaluationCaches[substrateNum][a].reserve(0);
         }
 
-        //Clear the state list caches
-        for (int a=0;a<65536;a++)
-        {
-            boardStateLists[substrateNum][BLACK][a].clear();
-            boardStateLists[substrateNum][BLACK][a].reserve(0);
-        }
-        for (int a=0;a<65536;a++)
-        {
-            boardStateLists[substrateNum][WHITE][a].clear();
-            boardStateLists[substrateNum][WHITE][a].reserve(0);
-        }
-
         substrate->populateSubstrate(individual);
     }
 
@@ -1161,11 +1171,11 @@ namespace HCUBE
                         //cout << "FOUND WHITE\n";
                         if ( (b[boardx][boardy]&KING) )
                         {
-                            substrate->setValue( (Node(x,y,0)) , -0.75 );
+                            substrate->setValue( boardInputHandles[y][x] , -0.75 );
                         }
                         else if ( (b[boardx][boardy]&MAN) )
                         {
-                            substrate->setValue( (Node(x,y,0)) , -0.5 );
+                            substrate->setValue( boardInputHandles[y][x] , -0.5 );
                         }
                         else
                         {
@@ -1177,11 +1187,11 @@ namespace HCUBE
                         //cout << "FOUND BLACK\n";
                         if ( (b[boardx][boardy]&KING) )
                         {
-                            substrate->setValue( (Node(x,y,0)) , 0.75 );
+                            substrate->setValue( boardInputHandles[y][x] , 0.75 );
                         }
                         else if ( (b[boardx][boardy]&MAN) )
                         {
-                            substrate->setValue( (Node(x,y,0)) , 0.5 );
+                            substrate->setValue( boardInputHandles[y][x] , 0.5 );
                         }
                         else
                         {
@@ -1191,14 +1201,14 @@ namespace HCUBE
                     else
                     {
                         //cout << "FOUND NOTHING\n";
-                        substrate->setValue( (Node(x,y,0)) , 0.0 );
+                        substrate->setValue( boardInputHandles[y][x] , 0.0 );
                     }
 
                 }
             }
 
             substrate->getNetwork()->update();
-            output = substrate->getValue((Node(0,0,2)));
+            output = substrate->getValue(boardOutputHandle);
 
 #if CHECKERS_EXPERIMENT_DEBUG
             static CheckersNEATDatatype prevOutput;
@@ -1327,194 +1337,263 @@ namespace HCUBE
         {}
     };
 
-    pair<CheckersNEATDatatype,int> CheckersExperiment::evaluatemax(uchar b[8][8],  CheckersNEATDatatype parentBeta, int depth,int maxDepth)
+    void CheckersExperiment::beginTranspositionTableSearch()
     {
-        if (depth==0)
+        if (!transpositionTable || transpositionTableOwner!=this)
         {
-            totalMoveList.clear();
-#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
-            cout << "Creating new outfile\n";
-            if (outfile) delete outfile;
-            outfile = new ofstream("BoardEvaluations.txt");
-#endif
+            int megabytes = 16;
+            if (NEAT::Globals::getSingleton()->hasParameterValue("CheckersTranspositionTableMB"))
+            {
+                megabytes = int(NEAT::Globals::getSingleton()->getParameterValue("CheckersTranspositionTableMB"));
+            }
 
+            transpositionTable.reset(new CheckersTranspositionTable(megabytes));
+            transpositionTableOwner = this;
+            for (int a=0;a<2;a++)
+            {
+                transpositionTableIndividuals[a].reset();
+                transpositionTableEpochs[a] = 0;
+            }
         }
 
-        int moveListCount;
-
-        pair<CheckersNEATDatatype,int> alpha=pair<CheckersNEATDatatype,int>(CheckersNEATDatatype(INT_MIN),-1);
-
-        bool foundJump;
-        int bestMoveSoFarIndex=-1;
-
-		int oldMoveListSize = (int)totalMoveList.size();
-
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        bool useCachedTable=false;
-
-        CheckersBoardState bState(b,BLACK);
+        //Subclasses repopulate substrates on their own, so watch the individual instead of
+        //clearing the table in populateSubstrate().  Holding on to it keeps a new
+        //individual from reusing its address.
+        if (substrateIndividuals[currentSubstrateIndex]!=transpositionTableIndividuals[currentSubstrateIndex])
+        {
+            transpositionTableIndividuals[currentSubstrateIndex] = substrateIndividuals[currentSubstrateIndex];
+            transpositionTableEpochs[currentSubstrateIndex] = ++transpositionTableEpochCount;
+        }
 
-        if (depth==0)
+        ulong evaluator = 0;
+        if (DEBUG_USE_HYPERNEAT_EVALUATION)
         {
+            evaluator ^= 1 | (ulong(currentSubstrateIndex)<<4) | (transpositionTableEpochs[currentSubstrateIndex]<<16);
         }
-        else
+        if (DEBUG_USE_HANDCODED_EVALUATION)
         {
-            vector<BoardStatePair> &bsVector = boardStateLists[currentSubstrateIndex][BLACK][bState.getShortHash()];
-            vector<BoardStatePair>::iterator stateIterator = bsVector.begin();
-            vector<BoardStatePair>::iterator stateEnd = bsVector.end();
+            evaluator ^= 2 | (ulong(handCodedType&0xFF)<<8);
+        }
+        searchKey = CheckersTranspositionTable::getSearchKey(evaluator);
 
-            for (;stateIterator != stateEnd;stateIterator++)
-            {
-                if (stateIterator->first==bState)
-                {
-                    //We have a match
-                    int depthSearched =
-                        stateIterator->second.maxDepth - stateIterator->second.depth;
+        transpositionTable->newSearch();
+    }
 
-                    int depthToSearch = maxDepth - depth;
+    //Visits firstMove first and the rest of the move list in generated order
+    static inline int getOrderedMoveIndex(int a,int firstMove)
+    {
+        if (firstMove<0 || a>firstMove)
+        {
+            return a;
+        }
+        return (a==0) ? firstMove : (a-1);
+    }
 
-                    if (depthSearched >= depthToSearch)
-                    {
-                        //We've been down this path before (or we are currently
-                        //going down it in another branch of the tree),
-                        //just return the best score
-                        if (stateIterator->second.getNumMoves()==0)
-                        {
-                            //No moves possible, return the min score
-                            return INT_MIN/2;
-                        }
+    /**
+     * CheckersRootSearch: Hands the root moves of a parallel search out to the search
+     * threads one at a time
+     */
+    class CheckersRootSearch
+    {
+        const vector<CheckersBitboard> &children;
 
-                        return stateIterator->second.getHighestScore();
-                    }
-                    else
-                    {
-                        //We've been down this path before, but not to this level of detail.
-                        //Use the previous alpha values, but continue
-                        useCachedTable=true;
+        pair<CheckersNEATDatatype,int> *results;
 
-                        moveListCount = stateIterator->second.getNumMoves();
+        int childColor;
 
-                        /* FOR evaluatemin() FUNCTION!
-                        int index=0;
-                        for(int a=(moveListCount-1);a>=0;a--)
-                        {
-                        //We have to iterate backwards because they are sorted lowest
-                        //to highest score
-                        moveList[index] = stateIterator->second.moves.getIndexData[a];
-                        index++;
-                        }
-                        */
+        CheckersNEATDatatype bound;
 
-                        for (int a=0;a<moveListCount;a++)
-                        {
-                            totalMoveList.push_back(stateIterator->second.getMove(a));
-                        }
+        int maxDepth;
 
-                        foundJump = stateIterator->second.foundJump;
+        boost::mutex queueMutex;
 
-                        //Erase this, because it will get replaced.
-                        bsVector.erase(stateIterator);
+        int nextChild;
 
-                        //Break out of the loop so we do not keep searching
-                        //(especially because the vector has now been invalidated with
-                        //the erase)
-                        break;
-                    }
-                }
-            }
-        }
-#endif
+        string error;
 
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        if (!useCachedTable)
-#endif
+    public:
+        CheckersRootSearch(
+            const vector<CheckersBitboard> &_children,
+            pair<CheckersNEATDatatype,int> *_results,
+            int _childColor,
+            CheckersNEATDatatype _bound,
+            int _maxDepth
+        )
+                :
+                children(_children),
+                results(_results),
+                childColor(_childColor),
+                bound(_bound),
+                maxDepth(_maxDepth),
+                nextChild(1)
         {
-            moveListCount = generateMoveList(totalMoveList,int(totalMoveList.size()),b,BLACK,foundJump);
         }
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        else
-        {
-#if CHECKERS_DEBUG
-            //Run a test to cross-verify moves
-            HCUBE::CheckersMove tmpMoves[128];
-            bool tmpFoundJump;
 
-            int tmpMoveListCount = generateMoveList(b,tmpMoves,BLACK,tmpFoundJump);
-
-            if (moveListCount != tmpMoveListCount)
+        void run(CheckersExperiment *experiment)
+        {
+            while (true)
             {
-                for (int b=0;b<moveListCount;b++)
+                int childIndex;
                 {
-                    cout << (int)moveList[b].from.x << ',' << (int)moveList[b].from.y << " -> ";
-                    cout << (int)moveList[b].to.x << ',' << (int)moveList[b].to.y << endl;
+                    boost::mutex::scoped_lock lock(queueMutex);
+                    if (nextChild>=(int)children.size() || error.length())
+                    {
+                        return;
+                    }
+                    childIndex = nextChild++;
                 }
 
-                cout << "***" << endl;
-
-                for (int a=0;a<tmpMoveListCount;a++)
+                try
                 {
-                    cout << (int)tmpMoves[a].from.x << ',' << (int)tmpMoves[a].from.y << " -> ";
-                    cout << (int)tmpMoves[a].to.x << ',' << (int)tmpMoves[a].to.y << endl;
+                    if (childColor==WHITE)
+                    {
+                        results[childIndex] = experiment->evaluatemin(children[childIndex],bound,1,maxDepth);
+                    }
+                    else
+                    {
+                        results[childIndex] = experiment->evaluatemax(children[childIndex],bound,1,maxDepth);
+                    }
+                }
+                catch (const std::exception &ex)
+                {
+                    boost::mutex::scoped_lock lock(queueMutex);
+                    if (!error.length())
+                    {
+                        error = ex.what();
+                    }
+                    return;
                 }
-
-                throw CREATE_LOCATEDEXCEPTION_INFO("FOUND A DIFFERING NUMBER OF MOVES!");
             }
+        }
+
+        inline const string &getError()
+        {
+            return error;
+        }
+    };
 
-            if (foundJump != tmpFoundJump)
+    int CheckersExperiment::getSearchThreadCount()
+    {
+        if (!numSearchThreads)
+        {
+            NEAT::Globals *globals = NEAT::Globals::getSingleton();
+            if (globals->hasParameterValue("SearchThreads"))
+            {
+                numSearchThreads = globals->getThreadCount("SearchThreads");
+            }
+            else
             {
-                throw CREATE_LOCATEDEXCEPTION_INFO("FOUND A DIFFERING JUMP VALUE!");
+                numSearchThreads = 1;
             }
+        }
+        return numSearchThreads;
+    }
+
+    void CheckersExperiment::searchRootMoves(
+        const CheckersBitboard &board,
+        const CheckersBitMoveList &moveList,
+        int firstMove,
+        int color,
+        CheckersNEATDatatype bound,
+        int maxDepth,
+        pair<CheckersNEATDatatype,int> *results
+        )
+    {
+        if (searchHelpersOwner!=this)
+        {
+            searchHelpers.clear();
+            searchHelpersOwner = this;
+        }
+        searchHelpers.resize(getSearchThreadCount()-1);
 
-            for (int a=0;a<moveListCount;a++)
+        for (int a=0;a<(int)searchHelpers.size();a++)
+        {
+            //A helper is a clone, so it evaluates with whatever networks a subclass keeps.
+            //It is cloned again when this experiment moves on to other individuals.
+            if (
+                !searchHelpers[a] ||
+                searchHelpers[a]->substrateIndividuals[0]!=substrateIndividuals[0] ||
+                searchHelpers[a]->substrateIndividuals[1]!=substrateIndividuals[1]
+            )
             {
-                for (int b=0;b<=moveListCount;b++)
-                {
-                    if (b==moveListCount)
-                    {
-                        cout << tmpMoves[a].from.x << ',' << tmpMoves[a].from.y << endl;
-                        cout << tmpMoves[a].to.x << ',' << tmpMoves[a].to.y << endl;
+                CheckersExperiment *helper = (CheckersExperiment*)clone();
+                helper->searchInfo.repcheck = NULL;
+                helper->searchHelpers.clear();
+                helper->searchHelpersOwner = helper;
+                searchHelpers[a].reset(helper);
+            }
 
-                        cout << "***" << endl;
+            CheckersExperiment *helper = searchHelpers[a].get();
+            helper->currentSubstrateIndex = currentSubstrateIndex;
+            helper->handCodedType = handCodedType;
+            helper->DEBUG_USE_HANDCODED_EVALUATION = DEBUG_USE_HANDCODED_EVALUATION;
+            helper->DEBUG_USE_HYPERNEAT_EVALUATION = DEBUG_USE_HYPERNEAT_EVALUATION;
+            helper->transpositionTable = transpositionTable;
+            helper->searchKey = searchKey;
+            helper->numHyperNEATEvaluations = 0;
+        }
 
-                        for (int b=0;b<moveListCount;b++)
-                        {
-                            cout << moveList[b].from.x << ',' << moveList[b].from.y << endl;
-                            cout << moveList[b].to.x << ',' << moveList[b].to.y << endl;
+        vector<CheckersBitboard> children(moveList.numMoves);
+        for (int a=1;a<moveList.numMoves;a++)
+        {
+            children[a] = board;
+            children[a].makeMove(moveList.moves[getOrderedMoveIndex(a,firstMove)],color);
+        }
 
-                        }
+        CheckersRootSearch search(children,results,(color==BLACK) ? WHITE : BLACK,bound,maxDepth);
 
-                        throw CREATE_LOCATEDEXCEPTION_INFO("ERROR! MISSING A MOVE!");
-                    }
+        boost::thread_group threads;
+        for (int a=0;a<(int)searchHelpers.size();a++)
+        {
+            threads.create_thread(boost::bind(&CheckersRootSearch::run,&search,searchHelpers[a].get()));
+        }
+        search.run(this);
+        threads.join_all();
 
-                    if (moveList[b]==tmpMoves[a])
-                    {
-                        break;
-                    }
-                }
-            }
-#endif
+        for (int a=0;a<(int)searchHelpers.size();a++)
+        {
+            numHyperNEATEvaluations += searchHelpers[a]->numHyperNEATEvaluations;
         }
-#endif
 
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        //We have a movelist, let's cache it.
-        CheckersBoardStateData bStateData;
+        if (search.getError().length())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(search.getError());
+        }
+    }
+
+    pair<CheckersNEATDatatype,int> CheckersExperiment::evaluatemax(uchar b[8][8],  CheckersNEATDatatype parentBeta, int depth,int maxDepth)
+    {
+        return evaluatemax(CheckersBitboard(b),parentBeta,depth,maxDepth);
+    }
 
-        bStateData.depth = depth;
-        bStateData.maxDepth = maxDepth;
-        bStateData.foundJump = foundJump;
+    pair<CheckersNEATDatatype,int> CheckersExperiment::evaluatemin(uchar b[8][8],  CheckersNEATDatatype parentAlpha, int depth,int maxDepth)
+    {
+        return evaluatemin(CheckersBitboard(b),parentAlpha,depth,maxDepth);
+    }
 
-        /*
-        for(int a=0;a<moveListCount;a++)
+    pair<CheckersNEATDatatype,int> CheckersExperiment::evaluatemax(const CheckersBitboard &board,  CheckersNEATDatatype parentBeta, int depth,int maxDepth)
+    {
+        if (depth==0)
         {
-        bStateData.moves.insert(CheckersNEATDatatype(INT_MIN/2.0),moveList[a]);
+            beginTranspositionTableSearch();
+#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
+            cout << "Creating new outfile\n";
+            if (outfile) delete outfile;
+            outfile = new ofstream("BoardEvaluations.txt");
+#endif
+
         }
 
-        boardStateLists[currentSubstrateIndex][BLACK][bState.getShortHash()].push_back(
-        BoardStatePair(bState,bStateData)
-        );
-        */
-#endif
+        int moveListCount;
+
+        pair<CheckersNEATDatatype,int> alpha=pair<CheckersNEATDatatype,int>(CheckersNEATDatatype(INT_MIN),-1);
+
+        bool foundJump;
+        int bestMoveSoFarIndex=-1;
+
+        CheckersBitMoveList moveList;
+        moveListCount = generateMoveList(board,BLACK,moveList);
+        foundJump = moveList.foundJump;
 
         if (!moveListCount)
         {
@@ -1525,45 +1604,15 @@ namespace HCUBE
         if (depth==0 && moveListCount==1)
         {
             //Forced move, don't bother doing any evaluations
-            secondBestMoveToMake = moveToMake = totalMoveList.at(oldMoveListSize);
-            totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
+            secondBestMoveToMake = moveToMake = getCheckersMove(moveList.moves[0]);
             return pair<CheckersNEATDatatype,int>(0,-1);
         }
 
-#if 0
-        //Check for duplicate moves
-        for (int a=0;a<moveListCount;a++)
-        {
-            for (int b=0;b<moveListCount;b++)
-            {
-                if (a==b)
-                    continue;
-
-                if (moveList[a]==moveList[b])
-                {
-                    throw CREATE_LOCATEDEXCEPTION_INFO("OOPS!");
-                }
-            }
-        }
-#endif
-
-
-#if CHECKERS_EXPERIMENT_DEBUG
-        printBoard(b);
-        cout << "Moves for black: " << endl;
-        for (int a=0;a<moveListCount;a++)
-        {
-            cout << "MOVE: (" << ((int)moveList[a].from.x) << ',' << ((int)moveList[a].from.y) << ") -> "
-                << "(" << ((int)moveList[a].to.x) << ',' << ((int)moveList[a].to.y) << ")" << endl;
-        }
-        CREATE_PAUSE("Done listing moves");
-#endif
-
         if (depth >= maxDepth && DEBUG_USE_HYPERNEAT_EVALUATION && foundJump == false)
         {
             //This is a leaf node, return the neural network's evaluation
-            totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
-
+            uchar b[8][8];
+            board.toBoard(b);
 			pair<CheckersNEATDatatype,int> retval = evaluateLeafHyperNEAT(b);
 
 			if(dumpEvaluationImages)
@@ -1579,11 +1628,48 @@ namespace HCUBE
 			return retval;
         }
 
+        //The root always searches so it can choose a move, but every node searches the
+        //stored best move first
+        ulong transpositionKey = CheckersTranspositionTable::getBoardKey(board,BLACK)^searchKey;
+        int depthToSearch = maxDepth-depth;
+        int transpositionMove = -1;
+        CheckersTranspositionTable::Entry transpositionEntry;
+
+        if (transpositionTable->probe(transpositionKey,transpositionEntry))
+        {
+            if (
+                depth>0 &&
+                transpositionEntry.depth>=depthToSearch &&
+                (
+                    transpositionEntry.bound==CheckersTranspositionTable::BOUND_EXACT ||
+                    (transpositionEntry.bound==CheckersTranspositionTable::BOUND_LOWER && transpositionEntry.value>=parentBeta)
+                )
+            )
+            {
+				if(dumpEvaluationImages)
+				{
+					for(int a=0;a<depth;a++)
+					{
+						handCodedTreeStream << ">";
+					}
+					handCodedTreeStream << " ";
+					handCodedTreeStream << "[TRANSPOSITION] " << transpositionEntry.value << endl;
+				}
+
+                return pair<CheckersNEATDatatype,int>(transpositionEntry.value,-1);
+            }
+
+            if (transpositionEntry.bestMove<moveListCount)
+            {
+                transpositionMove = transpositionEntry.bestMove;
+            }
+        }
+
         pair<CheckersNEATDatatype,int> childBeta;
 
         if (depth==0)
         {
-            secondBestMoveToMake = moveToMake = totalMoveList.at(oldMoveListSize);
+            secondBestMoveToMake = moveToMake = getCheckersMove(moveList.moves[0]);
             childBetaForSecondBestMove = (CheckersNEATDatatype)(INT_MIN/2.0);
         }
 
@@ -1597,21 +1683,31 @@ namespace HCUBE
             handCodedTreeStream << "[# MOVES] " << moveListCount << endl;
 		}
 
+        //At the root, the moves after the first can be searched on other threads against
+        //the bound the first move leaves.  The loop below goes over their results in order,
+        //so it picks the same move a serial search would.
+        bool searchRootInParallel =
+            depth==0 &&
+            moveListCount>2 &&
+            maxDepth>=PARALLEL_SEARCH_MIN_DEPTH &&
+            !dumpEvaluationImages &&
+            getSearchThreadCount()>1;
+        vector<pair<CheckersNEATDatatype,int> > rootResults;
+
         for (int a=0;a<moveListCount;a++)
         {
-            CheckersMove currentMove = totalMoveList.at(oldMoveListSize+a);
+            int moveIndex = getOrderedMoveIndex(a,transpositionMove);
+            const CheckersBitMove &currentMove = moveList.moves[moveIndex];
 
-            makeMove(currentMove,b);
+            CheckersBitboard childBoard = board;
+            childBoard.makeMove(currentMove,BLACK);
 
-            int winner = getWinner(b);
-
-            if (winner==BLACK)
+            if (!childBoard.getPieces(WHITE))
             {
                 //CREATE_PAUSE("FOUND WIN FOR BLACK!");
-                reverseMove(currentMove,b);
 
                 if (depth==0)
-                    secondBestMoveToMake = moveToMake = currentMove;
+                    secondBestMoveToMake = moveToMake = getCheckersMove(currentMove);
 
 				if(dumpEvaluationImages)
 				{
@@ -1623,16 +1719,30 @@ namespace HCUBE
 					handCodedTreeStream << "[FOUND WIN] " << (INT_MAX/2) << endl;
 				}
 
-				totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
+                transpositionTable->store(
+                    transpositionKey,
+                    CheckersNEATDatatype(INT_MAX/2),
+                    depthToSearch,
+                    CheckersTranspositionTable::BOUND_EXACT,
+                    moveIndex
+                );
                 return pair<CheckersNEATDatatype,int>(CheckersNEATDatatype(INT_MAX/2),-1);
             }
 
-            childBeta = evaluatemin(b,alpha.first,depth+1,maxDepth);
-            reverseMove(currentMove,b);
+            if (searchRootInParallel && a>0)
+            {
+                if (a==1)
+                {
+                    rootResults.resize(moveListCount);
+                    searchRootMoves(board,moveList,transpositionMove,BLACK,alpha.first,maxDepth,&rootResults[0]);
+                }
+                childBeta = rootResults[a];
+            }
+            else
+            {
+                childBeta = evaluatemin(childBoard,alpha.first,depth+1,maxDepth);
+            }
 
-#if DEBUG_DO_ITERATIVE_DEEPENING
-            bStateData.insertMove(childBeta,currentMove);
-#endif
 
 #if CHECKERS_EXPERIMENT_DEBUG
             for (int dd=0;dd<depth;dd++)
@@ -1654,17 +1764,12 @@ namespace HCUBE
                 }
 
                 alpha = childBeta;
-                bestMoveSoFarIndex = a;
+                bestMoveSoFarIndex = moveIndex;
                 if (depth==0)
                 {
                     //This means that this is the root max, so store the best move.
-#if CHECKERS_EXPERIMENT_DEBUG
-                    cout << "BLACK: MOVE_TO_MAKE: (" << moveList[a].from.x << ',' << moveList[a].from.y << ") -> "
-                        << "(" << moveList[a].to.x << ',' << moveList[a].to.y << ")" << endl;
-                    CREATE_PAUSE("SETTING MOVE_TO_MAKE");
-#endif
 
-                    moveToMake = currentMove;
+                    moveToMake = getCheckersMove(currentMove);
                 }
                 else
                 {
@@ -1679,21 +1784,6 @@ namespace HCUBE
                         //because we are ending prematurely, we have to fill the rest of the cached
                         //data
 
-#if DEBUG_DO_ITERATIVE_DEEPENING
-                        for (int restOfList=(a+1);restOfList<moveListCount;restOfList++)
-                        {
-                            bStateData.insertMove(CheckersNEATDatatype(INT_MIN/2.0),totalMoveList.at(oldMoveListSize+restOfList));
-                        }
-
-                        if (memcmp(bState.b,b,sizeof(uchar)*8*8))
-                        {
-                            throw CREATE_LOCATEDEXCEPTION_INFO("BOARD STATE CHANGED SOMEHOW!");
-                        }
-
-                        boardStateLists[currentSubstrateIndex][BLACK][bState.getShortHash()].push_back(
-                            BoardStatePair(bState,bStateData)
-                            );
-#endif
 
 						if(dumpEvaluationImages)
 						{
@@ -1705,7 +1795,13 @@ namespace HCUBE
 							handCodedTreeStream << "PRUNED BECAUSE OF VALUE: " << parentBeta << endl;
 						}
 
-						totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
+                        transpositionTable->store(
+                            transpositionKey,
+                            childBeta.first,
+                            depthToSearch,
+                            CheckersTranspositionTable::BOUND_LOWER,
+                            moveIndex
+                        );
                         return childBeta;
                     }
                 }
@@ -1714,18 +1810,12 @@ namespace HCUBE
             {
                 if (depth==0 && childBeta.first>childBetaForSecondBestMove)
                 {
-                    secondBestMoveToMake = currentMove;
+                    secondBestMoveToMake = getCheckersMove(currentMove);
                     childBetaForSecondBestMove = childBeta.first;
                 }
             }
         }
 
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        ushort shortHash = bState.getShortHash();
-        boardStateLists[currentSubstrateIndex][BLACK][shortHash].push_back(
-            BoardStatePair(bState,bStateData)
-            );
-#endif
 
 		if(dumpEvaluationImages)
 		{
@@ -1737,15 +1827,21 @@ namespace HCUBE
 			handCodedTreeStream << "RETURNING VALUE: " << alpha.first << "/" << alpha.second << endl;
 		}
 
-        totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
+        transpositionTable->store(
+            transpositionKey,
+            alpha.first,
+            depthToSearch,
+            CheckersTranspositionTable::BOUND_EXACT,
+            bestMoveSoFarIndex
+        );
         return alpha;
     }
 
-    pair<CheckersNEATDatatype,int> CheckersExperiment::evaluatemin(uchar b[8][8],  CheckersNEATDatatype parentAlpha, int depth,int maxDepth)
+    pair<CheckersNEATDatatype,int> CheckersExperiment::evaluatemin(const CheckersBitboard &board,  CheckersNEATDatatype parentAlpha, int depth,int maxDepth)
     {
         if (depth==0)
         {
-            totalMoveList.clear();
+            beginTranspositionTableSearch();
 #if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
             cout << "Creating new outfile\n";
             if (outfile) delete outfile;
@@ -1761,222 +1857,31 @@ namespace HCUBE
         bool foundJump;
         int bestMoveSoFarIndex=-1;
 
-		int oldMoveListSize = (int)totalMoveList.size();
-
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        bool useCachedTable=false;
-
-        CheckersBoardState bState(b,WHITE);
+        CheckersBitMoveList moveList;
+        moveListCount = generateMoveList(board,WHITE,moveList);
+        foundJump = moveList.foundJump;
 
-        if (depth==0)
+        if (!moveListCount)
         {
+            //No possible moves, this is a loss!
+            return pair<CheckersNEATDatatype,int>(CheckersNEATDatatype(INT_MAX/2.0),-1);
         }
-        else
-        {
-            vector<BoardStatePair> &bsVector = boardStateLists[currentSubstrateIndex][WHITE][bState.getShortHash()];
-            vector<BoardStatePair>::iterator stateIterator = bsVector.begin();
-            vector<BoardStatePair>::iterator stateEnd = bsVector.end();
-
-            for (;stateIterator != stateEnd;stateIterator++)
-            {
-                if (stateIterator->first==bState)
-                {
-                    //We have a match
-                    int depthSearched =
-                        stateIterator->second.maxDepth - stateIterator->second.depth;
-
-                    int depthToSearch = maxDepth - depth;
 
-                    if (depthSearched >= depthToSearch)
-                    {
-                        //We've been down this path before (or we are currently
-                        //going down it in another branch of the tree),
-                        //just return the best score
-                        if (stateIterator->second.getNumMoves()==0)
-                        {
-                            //No moves possible, return the worst score
-                            return CheckersNEATDatatype(INT_MAX/2.0);
-                        }
+        if (depth==0 && moveListCount==1)
+        {
+            //Forced move, don't bother doing any evaluations
+            secondBestMoveToMake = moveToMake = getCheckersMove(moveList.moves[0]);
+            return pair<CheckersNEATDatatype,int>(0,-1);
+        }
 
-                        return stateIterator->second.getLowestScore();
-                    }
-                    else
-                    {
-                        //We've been down this path before, but not to this level of detail.
-                        //Use the previous alpha values, but continue
-                        useCachedTable=true;
 
-                        moveListCount = stateIterator->second.getNumMoves();
 
-                        /* FOR evaluatemin() FUNCTION!
-                        int index=0;
-                        for(int a=(moveListCount-1);a>=0;a--)
-                        {
-                        //We have to iterate backwards because they are sorted lowest
-                        //to highest score
-                        moveList[index] = stateIterator->second.moves.getIndexData[a];
-                        index++;
-                        }
-                        */
-
-                        for (int a=0;a<moveListCount;a++)
-                        {
-                            totalMoveList.push_back(stateIterator->second.getMove(a));
-                        }
-
-                        foundJump = stateIterator->second.foundJump;
-
-                        //Erase this, because it will get replaced.
-                        bsVector.erase(stateIterator);
-
-                        //Break out of the loop so we do not keep searching
-                        //(especially because the vector has now been invalidated with
-                        //the erase)
-                        break;
-                    }
-                }
-            }
-        }
-#endif
-
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        if (!useCachedTable)
-#endif
-        {
-            moveListCount = generateMoveList(totalMoveList,int(totalMoveList.size()),b,WHITE,foundJump);
-        }
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        else
-        {
-#if CHECKERS_DEBUG
-            //Run a test to cross-verify moves
-            HCUBE::CheckersMove tmpMoves[128];
-            bool tmpFoundJump;
-
-            int tmpMoveListCount = generateMoveList(b,tmpMoves,WHITE,tmpFoundJump);
-
-            if (moveListCount != tmpMoveListCount)
-            {
-                for (int b=0;b<moveListCount;b++)
-                {
-                    cout << (int)moveList[b].from.x << ',' << (int)moveList[b].from.y << " -> ";
-                    cout << (int)moveList[b].to.x << ',' << (int)moveList[b].to.y << endl;
-                }
-
-                cout << "***" << endl;
-
-                for (int a=0;a<tmpMoveListCount;a++)
-                {
-                    cout << (int)tmpMoves[a].from.x << ',' << (int)tmpMoves[a].from.y << " -> ";
-                    cout << (int)tmpMoves[a].to.x << ',' << (int)tmpMoves[a].to.y << endl;
-                }
-
-                throw CREATE_LOCATEDEXCEPTION_INFO("FOUND A DIFFERING NUMBER OF MOVES!");
-            }
-
-            if (foundJump != tmpFoundJump)
-            {
-                throw CREATE_LOCATEDEXCEPTION_INFO("FOUND A DIFFERING JUMP VALUE!");
-            }
-
-            for (int a=0;a<moveListCount;a++)
-            {
-                for (int b=0;b<=moveListCount;b++)
-                {
-                    if (b==moveListCount)
-                    {
-                        cout << tmpMoves[a].from.x << ',' << tmpMoves[a].from.y << endl;
-                        cout << tmpMoves[a].to.x << ',' << tmpMoves[a].to.y << endl;
-
-                        cout << "***" << endl;
-
-                        for (int b=0;b<moveListCount;b++)
-                        {
-                            cout << moveList[b].from.x << ',' << moveList[b].from.y << endl;
-                            cout << moveList[b].to.x << ',' << moveList[b].to.y << endl;
-
-                        }
-
-                        throw CREATE_LOCATEDEXCEPTION_INFO("ERROR! MISSING A MOVE!");
-                    }
-
-                    if (moveList[b]==tmpMoves[a])
-                    {
-                        break;
-                    }
-                }
-            }
-#endif
-        }
-#endif
-
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        //We have a movelist, let's cache it.
-        CheckersBoardStateData bStateData;
-
-        bStateData.depth = depth;
-        bStateData.maxDepth = maxDepth;
-        bStateData.foundJump = foundJump;
-
-        /*
-        for(int a=0;a<moveListCount;a++)
-        {
-        bStateData.moves.insert(CheckersNEATDatatype(INT_MIN/2.0),moveList[a]);
-        }
-
-        boardStateLists[currentSubstrateIndex][BLACK][bState.getShortHash()].push_back(
-        BoardStatePair(bState,bStateData)
-        );
-        */
-#endif
-
-        if (!moveListCount)
-        {
-            //No possible moves, this is a loss!
-            return pair<CheckersNEATDatatype,int>(CheckersNEATDatatype(INT_MAX/2.0),-1);
-        }
-
-        if (depth==0 && moveListCount==1)
-        {
-            //Forced move, don't bother doing any evaluations
-            secondBestMoveToMake = moveToMake = totalMoveList.at(oldMoveListSize);
-            totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
-            return pair<CheckersNEATDatatype,int>(0,-1);
-        }
-
-#if 0
-        //Check for duplicate moves
-        for (int a=0;a<moveListCount;a++)
-        {
-            for (int b=0;b<moveListCount;b++)
-            {
-                if (a==b)
-                    continue;
-
-                if (moveList[a]==moveList[b])
-                {
-                    throw CREATE_LOCATEDEXCEPTION_INFO("OOPS!");
-                }
-            }
-        }
-#endif
-
-#if CHECKERS_EXPERIMENT_DEBUG
-        printBoard(b);
-        cout << "Moves for black: " << endl;
-        for (int a=0;a<moveListCount;a++)
-        {
-            cout << "MOVE: (" << ((int)moveList[a].from.x) << ',' << ((int)moveList[a].from.y) << ") -> "
-                << "(" << ((int)moveList[a].to.x) << ',' << ((int)moveList[a].to.y) << ")" << endl;
-        }
-        CREATE_PAUSE("Done listing moves");
-#endif
-
-        if (depth>=maxDepth && DEBUG_USE_HANDCODED_EVALUATION && foundJump==false)
-        {
-            //This is a leaf node, return the hand-coded evaluation
-            totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
-            pair<CheckersNEATDatatype,int> retval = evaluateLeafWhite(b);
+        if (depth>=maxDepth && DEBUG_USE_HANDCODED_EVALUATION && foundJump==false)
+        {
+            //This is a leaf node, return the hand-coded evaluation
+            uchar b[8][8];
+            board.toBoard(b);
+            pair<CheckersNEATDatatype,int> retval = evaluateLeafWhite(b);
 
 			if(dumpEvaluationImages)
 			{
@@ -1991,11 +1896,48 @@ namespace HCUBE
 			return retval;
         }
 
+        //The root always searches so it can choose a move, but every node searches the
+        //stored best move first
+        ulong transpositionKey = CheckersTranspositionTable::getBoardKey(board,WHITE)^searchKey;
+        int depthToSearch = maxDepth-depth;
+        int transpositionMove = -1;
+        CheckersTranspositionTable::Entry transpositionEntry;
+
+        if (transpositionTable->probe(transpositionKey,transpositionEntry))
+        {
+            if (
+                depth>0 &&
+                transpositionEntry.depth>=depthToSearch &&
+                (
+                    transpositionEntry.bound==CheckersTranspositionTable::BOUND_EXACT ||
+                    (transpositionEntry.bound==CheckersTranspositionTable::BOUND_UPPER && transpositionEntry.value<=parentAlpha)
+                )
+            )
+            {
+				if(dumpEvaluationImages)
+				{
+					for(int a=0;a<depth;a++)
+					{
+						handCodedTreeStream << ">";
+					}
+					handCodedTreeStream << " ";
+					handCodedTreeStream << "[TRANSPOSITION] " << transpositionEntry.value << endl;
+				}
+
+                return pair<CheckersNEATDatatype,int>(transpositionEntry.value,-1);
+            }
+
+            if (transpositionEntry.bestMove<moveListCount)
+            {
+                transpositionMove = transpositionEntry.bestMove;
+            }
+        }
+
         pair<CheckersNEATDatatype,int> childAlpha;
 
         if (depth==0)
         {
-            secondBestMoveToMake = moveToMake = totalMoveList.at(oldMoveListSize);
+            secondBestMoveToMake = moveToMake = getCheckersMove(moveList.moves[0]);
             childAlphaForSecondBestMove = (CheckersNEATDatatype)(INT_MAX/2.0);
         }
 
@@ -2009,23 +1951,29 @@ namespace HCUBE
             handCodedTreeStream << "[# MOVES] " << moveListCount << endl;
 		}
 
+        bool searchRootInParallel =
+            depth==0 &&
+            moveListCount>2 &&
+            maxDepth>=PARALLEL_SEARCH_MIN_DEPTH &&
+            !dumpEvaluationImages &&
+            getSearchThreadCount()>1;
+        vector<pair<CheckersNEATDatatype,int> > rootResults;
+
         for (int a=0;a<moveListCount;a++)
         {
-            CheckersMove currentMove = totalMoveList.at(oldMoveListSize+a);
+            int moveIndex = getOrderedMoveIndex(a,transpositionMove);
+            const CheckersBitMove &currentMove = moveList.moves[moveIndex];
 
-            makeMove(currentMove,b);
+            CheckersBitboard childBoard = board;
+            childBoard.makeMove(currentMove,WHITE);
 
-            int winner = getWinner(b);
-
-            if (winner==WHITE)
+            if (!childBoard.getPieces(BLACK))
             {
                 //CREATE_PAUSE("FOUND WIN FOR WHITE!");
-                reverseMove(currentMove,b);
 
                 if (depth==0)
-                    secondBestMoveToMake = moveToMake = currentMove;
+                    secondBestMoveToMake = moveToMake = getCheckersMove(currentMove);
 
-				totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
 
 				if(dumpEvaluationImages)
 				{
@@ -2037,15 +1985,30 @@ namespace HCUBE
 					handCodedTreeStream << "[FOUND WIN] " << (INT_MIN/2) << endl;
 				}
 
+                transpositionTable->store(
+                    transpositionKey,
+                    CheckersNEATDatatype(INT_MIN/2),
+                    depthToSearch,
+                    CheckersTranspositionTable::BOUND_EXACT,
+                    moveIndex
+                );
 				return pair<CheckersNEATDatatype,int>(CheckersNEATDatatype(INT_MIN/2),-1);
             }
 
-            childAlpha = evaluatemax(b,beta.first,depth+1,maxDepth);
-            reverseMove(currentMove,b);
+            if (searchRootInParallel && a>0)
+            {
+                if (a==1)
+                {
+                    rootResults.resize(moveListCount);
+                    searchRootMoves(board,moveList,transpositionMove,WHITE,beta.first,maxDepth,&rootResults[0]);
+                }
+                childAlpha = rootResults[a];
+            }
+            else
+            {
+                childAlpha = evaluatemax(childBoard,beta.first,depth+1,maxDepth);
+            }
 
-#if DEBUG_DO_ITERATIVE_DEEPENING
-            bStateData.insertMove(childAlpha,currentMove);
-#endif
 
 #if CHECKERS_EXPERIMENT_DEBUG
             for (int dd=0;dd<depth;dd++)
@@ -2068,17 +2031,12 @@ namespace HCUBE
                 }
 
                 beta = childAlpha;
-                bestMoveSoFarIndex = a;
+                bestMoveSoFarIndex = moveIndex;
                 if (depth==0)
                 {
                     //This means that this is the root max, so store the best move.
-#if CHECKERS_EXPERIMENT_DEBUG
-                    cout << "WHITE: MOVE_TO_MAKE: (" << moveList[a].from.x << ',' << moveList[a].from.y << ") -> "
-                        << "(" << moveList[a].to.x << ',' << moveList[a].to.y << ")" << endl;
-                    CREATE_PAUSE("SETTING MOVE_TO_MAKE");
-#endif
 
-                    moveToMake = currentMove;
+                    moveToMake = getCheckersMove(currentMove);
                 }
                 else
                 {
@@ -2093,21 +2051,6 @@ namespace HCUBE
                         //because we are ending prematurely, we have to fill the rest of the cached
                         //data
 
-#if DEBUG_DO_ITERATIVE_DEEPENING
-                        for (int restOfList=(a+1);restOfList<moveListCount;restOfList++)
-                        {
-                            bStateData.insertMove(CheckersNEATDatatype(INT_MAX/2.0),totalMoveList.at(oldMoveListSize+restOfList));
-                        }
-
-                        if (memcmp(bState.b,b,sizeof(uchar)*8*8))
-                        {
-                            throw CREATE_LOCATEDEXCEPTION_INFO("BOARD STATE CHANGED SOMEHOW!");
-                        }
-
-                        boardStateLists[currentSubstrateIndex][WHITE][bState.getShortHash()].push_back(
-                            BoardStatePair(bState,bStateData)
-                            );
-#endif
 
 						if(dumpEvaluationImages)
 						{
@@ -2119,7 +2062,13 @@ namespace HCUBE
 							handCodedTreeStream << "PRUNED BECAUSE OF VALUE: " << parentAlpha << endl;
 						}
 
-						totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
+                        transpositionTable->store(
+                            transpositionKey,
+                            beta.first,
+                            depthToSearch,
+                            CheckersTranspositionTable::BOUND_UPPER,
+                            moveIndex
+                        );
                         return beta;
                     }
                 }
@@ -2128,18 +2077,12 @@ namespace HCUBE
             {
                 if (depth==0 && childAlpha.first<childAlphaForSecondBestMove)
                 {
-                    secondBestMoveToMake = currentMove;
+                    secondBestMoveToMake = getCheckersMove(currentMove);
                     childAlphaForSecondBestMove = childAlpha.first;
                 }
             }
         }
 
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        ushort shortHash = bState.getShortHash();
-        boardStateLists[currentSubstrateIndex][WHITE][shortHash].push_back(
-            BoardStatePair(bState,bStateData)
-            );
-#endif
 
 		if(dumpEvaluationImages)
 		{
@@ -2151,7 +2094,13 @@ namespace HCUBE
 			handCodedTreeStream << "RETURNING VALUE: " << beta.first << "/" << beta.second << endl;
 		}
 
-        totalMoveList.erase(totalMoveList.begin()+oldMoveListSize,totalMoveList.end());
+        transpositionTable->store(
+            transpositionKey,
+            beta.first,
+            depthToSearch,
+            CheckersTranspositionTable::BOUND_EXACT,
+            bestMoveSoFarIndex
+        );
         return beta;
     }
 
@@ -2161,42 +2110,34 @@ namespace HCUBE
         double timeLimit
         )
     {
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        /*
-        for(int a=0;a<65536;a++)
-        {
-        boardStateLists[currentSubstrateIndex][BLACK][a].clear();
-        }
-        for(int a=0;a<65536;a++)
-        {
-        boardStateLists[currentSubstrateIndex][WHITE][a].clear();
-        }
-        */
+        numHyperNEATEvaluations=0;
+		if(dumpEvaluationImages)
+		{
+			string filename3 = string("HyperNEATEvalStream") + toString(numHyperNEATStreams) + string(".txt");
+			hyperNEATEvalStream.open(filename3.c_str());
+			string filename2 = string("HandCodedTreeStream") + toString(numHandCodedStreams) + string(".txt");
+			hyperNEATTreeStream.open(filename2.c_str());
+		}
 
+#if DEBUG_DO_ITERATIVE_DEEPENING
+        //Each search leaves its best moves in the transposition table, where the next,
+        //deeper search picks them up to order its moves
         int useOdd = maxDepth%2;
-        CheckersNEATDatatype retval;
+        pair<CheckersNEATDatatype,int> retval;
         timer t;
         for (int a=2-useOdd;;a+=2)
         {
-            retval = evaluatemax(b,CheckersNEATDatatype(INT_MAX/2.0),0,a);
+            retval = evaluatemax(b,CheckersNEATDatatype(INT_MAX/2),0,a);
 
             if (a+2>maxDepth || t.elapsed()>timeLimit)
             {
                 //cout << "Ran to depth " << a << " (" << t.elapsed() << " sec.)" << endl;
-                return retval;
+                break;
             }
         }
 #else
-        numHyperNEATEvaluations=0;
-		if(dumpEvaluationImages)
-		{
-			string filename3 = string("HyperNEATEvalStream") + toString(numHyperNEATStreams) + string(".txt");
-			hyperNEATEvalStream.open(filename3.c_str());
-			string filename2 = string("HandCodedTreeStream") + toString(numHandCodedStreams) + string(".txt");
-			hyperNEATTreeStream.open(filename2.c_str());
-		}
-
 		pair<CheckersNEATDatatype,int> retval = evaluatemax(b,CheckersNEATDatatype(INT_MAX/2),0,maxDepth);
+#endif
 
 		if(dumpEvaluationImages)
 		{
@@ -2205,7 +2146,6 @@ namespace HCUBE
 		}
 
         return retval;
-#endif
     }
 
     CheckersNEATDatatype CheckersExperiment::firstevaluatemin(
@@ -2214,42 +2154,32 @@ namespace HCUBE
         double timeLimit
         )
     {
-#if DEBUG_DO_ITERATIVE_DEEPENING
-        /*
-        for(int a=0;a<65536;a++)
-        {
-        boardStateLists[currentSubstrateIndex][BLACK][a].clear();
-        }
-        for(int a=0;a<65536;a++)
-        {
-        boardStateLists[currentSubstrateIndex][WHITE][a].clear();
-        }
-        */
+		if(dumpEvaluationImages)
+		{
+			numHandCodedEvaluations=0;
+			string filename = string("HandCodedEvalStream") + toString(numHandCodedStreams) + string(".txt");
+			handCodedEvalStream.open(filename.c_str());
+			string filename2 = string("HandCodedTreeStream") + toString(numHandCodedStreams) + string(".txt");
+			handCodedTreeStream.open(filename2.c_str());
+		}
 
-        int useOdd = ((maxDepth)%2);
+#if DEBUG_DO_ITERATIVE_DEEPENING
+        int useOdd = maxDepth%2;
         CheckersNEATDatatype retval;
         timer t;
         for (int a=2-useOdd;;a+=2)
         {
-            retval = evaluatemin(b,CheckersNEATDatatype(INT_MIN/2.0),0,a);
+            retval = evaluatemin(b,CheckersNEATDatatype(INT_MIN/2),0,a).first;
 
             if (a+2>maxDepth || t.elapsed()>timeLimit)
             {
                 //cout << "Ran to depth " << a << " (" << t.elapsed() << " sec.)" << endl;
-                return retval;
+                break;
             }
         }
 #else
-		if(dumpEvaluationImages)
-		{
-			numHandCodedEvaluations=0;
-			string filename = string("HandCodedEvalStream") + toString(numHandCodedStreams) + string(".txt");
-			handCodedEvalStream.open(filename.c_str());
-			string filename2 = string("HandCodedTreeStream") + toString(numHandCodedStreams) + string(".txt");
-			handCodedTreeStream.open(filename2.c_str());
-		}
-
         CheckersNEATDatatype retval = evaluatemin(b,INT_MIN/2,0,maxDepth).first;
+#endif
 
 		if(dumpEvaluationImages)
 		{
@@ -2259,7 +2189,6 @@ namespace HCUBE
 		}
 
 		return retval;
-#endif
     }
 
     void CheckersExperiment::makeMoveCliche(uchar b[8][8],int colorToMove,int* retval)
@@ -2272,7 +2201,7 @@ namespace HCUBE
         DEBUG_USE_HYPERNEAT_EVALUATION = 0;
         currentSubstrateIndex=handCodedAISubstrateIndex;
 
-	    boost::mutex::scoped_lock lock(cakeMutex);
+	    boost::mutex::scoped_lock lock(clicheMutex);
 
         cout << "CLICHE BEFORE\n";
 	    printBoard(b);
@@ -2357,9 +2286,8 @@ namespace HCUBE
 		DEBUG_USE_HYPERNEAT_EVALUATION = 0;
 		currentSubstrateIndex=handCodedAISubstrateIndex;
 
-
-		boost::mutex::scoped_lock lock(cakeMutex);
-		srand(cakeRandomSeed);
+		searchInfo.context = cakeSearchContext.get();
+		searchInfo.context->randomseed = cakeRandomSeed;
 
         //cout << "CAKE BEFORE\n";
 		//printBoard(b);
@@ -2406,101 +2334,297 @@ namespace HCUBE
         }
 	}
 
-    void CheckersExperiment::processGroup(shared_ptr<NEAT::GeneticGeneration> generation)
+    /**
+     * CheckersGameQueue: Hands the games of an evaluation out to the game threads one at
+     * a time
+     */
+    class CheckersGameQueue
     {
-        //cout << "Processing evaluation...\n";
-        shared_ptr<NEAT::GeneticIndividual> individual = group.front();
-        //You get 10 points just for entering the game, wahooo!
-        individual->setFitness(10);
-		numHandCodedStreams=0;
-        numHyperNEATStreams = 0;
+        vector<CheckersGameResult> &results;
 
-        populateSubstrate(individual);
+        boost::mutex queueMutex;
 
-        /*
-        gameinfo gi;
+        int nextGame;
 
-        // init gameinfo
-        memset (&gi, 0, sizeof (gi));
+        string error;
 
-        gi.experiment = this;
-        gi.result = UNKNOWN;
+    public:
+        CheckersGameQueue(vector<CheckersGameResult> &_results)
+                :
+                results(_results),
+                nextGame(0)
+        {
+        }
 
-        gi.player = "HyperNEAT";
+        void run(CheckersExperiment *experiment)
+        {
+            while (true)
+            {
+                int gameIndex;
+                {
+                    boost::mutex::scoped_lock lock(queueMutex);
+                    if (nextGame>=(int)results.size() || error.length())
+                    {
+                        return;
+                    }
+                    gameIndex = nextGame++;
+                }
 
-        // check opponent
-        gi.opponent = "simplech";
-        */
+                try
+                {
+                    experiment->playGameAsBlack(gameIndex,results[gameIndex],true);
+                }
+                catch (const std::exception &ex)
+                {
+                    boost::mutex::scoped_lock lock(queueMutex);
+                    if (!error.length())
+                    {
+                        error = ex.what();
+                    }
+                    return;
+                }
+            }
+        }
+
+        inline const string &getError()
+        {
+            return error;
+        }
+    };
+
+    void CheckersExperiment::playGames(vector<CheckersGameResult> &results)
+    {
+        //A game searched with the table an earlier game left can choose other moves, so
+        //once games may run at the same time each one starts from an empty table.  The
+        //fitness is then the same for any number of threads.  Without GameThreads the games
+        //keep sharing the table, which saves the most work when they follow the same lines.
+        bool independentGames = NEAT::Globals::getSingleton()->hasParameterValue("GameThreads");
+
+        int numThreads = 1;
+        if (independentGames)
+        {
+            numThreads = NEAT::Globals::getSingleton()->getThreadCount("GameThreads");
+        }
+        numThreads = min(numThreads,int(results.size()));
+
+        if (numThreads<=1)
+        {
+            for (int a=0;a<int(results.size());a++)
+            {
+                playGameAsBlack(a,results[a],independentGames);
+            }
+            return;
+        }
+
+        //The other threads play on clones, which have boards, search state and substrates
+        //of their own, including the cake opponent's.
+        vector<shared_ptr<CheckersExperiment> > players(numThreads-1);
+        for (int a=0;a<int(players.size());a++)
+        {
+            CheckersExperiment *player = (CheckersExperiment*)clone();
+            player->searchInfo.repcheck = NULL;
+            players[a].reset(player);
+        }
+
+        CheckersGameQueue queue(results);
+
+        boost::thread_group threads;
+        for (int a=0;a<int(players.size());a++)
+        {
+            threads.create_thread(boost::bind(&CheckersGameQueue::run,&queue,players[a].get()));
+        }
+        queue.run(this);
+        threads.join_all();
+
+        if (queue.getError().length())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(queue.getError());
+        }
+    }
+
+    void CheckersExperiment::playGameAsBlack(int gameIndex,CheckersGameResult &result,bool fromEmptyTable)
+    {
+        handCodedType = gameIndex;
+        result.rewards.clear();
+
+        if (fromEmptyTable && transpositionTable && transpositionTableOwner==this)
+        {
+            transpositionTable->clear();
+        }
 
         uchar b[8][8];
 
-        //cout << "Playing games with HyperNEAT as black\n";
-        for (handCodedType=0;handCodedType<HANDCODED_PLAYER_TESTS;handCodedType++)
+		cakeRandomSeed = 1000 + handCodedType;
+        if(searchInfo.repcheck)
+	        free(searchInfo.repcheck);
+	    resetsearchinfo(&searchInfo);
+	    // allocate memory for repcheck array
+	    searchInfo.repcheck = (REPETITION*)malloc((MAXDEPTH+HISTORYOFFSET) * sizeof(REPETITION));
+
+        resetBoard(b);
+
+        int retval=-1;
+		moves=0;
+
+        double inGameFitness=0.0;
+
+        for (currentRound=0;currentRound<CHECKERS_MAX_ROUNDS&&retval==-1;currentRound++)
         {
-			cakeRandomSeed = 1000 + handCodedType;
-            if(searchInfo.repcheck)
-		        free(searchInfo.repcheck);
-		    resetsearchinfo(&searchInfo);
-		    // allocate memory for repcheck array
-		    searchInfo.repcheck = (REPETITION*)malloc((MAXDEPTH+HISTORYOFFSET) * sizeof(REPETITION));
+#if 1
+			//Clear the evaluation cache
+			for (int a=0;a<65536;a++)
+			{
+				boardEvaluationCaches[0][a].clear();
+				boardEvaluationCaches[0][a].reserve(0);
+			}
 
-            resetBoard(b);
+			//Clear the evaluation cache
+			for (int a=0;a<65536;a++)
+			{
+				boardEvaluationCaches[1][a].clear();
+				boardEvaluationCaches[1][a].reserve(0);
+			}
 
-            int retval=-1;
-			moves=0;
+            //cout << "Round: " << currentRound << endl;
+            moveToMake = CheckersMove();
+            secondBestMoveToMake = CheckersMove();
+            DEBUG_USE_HANDCODED_EVALUATION = 0;
+            DEBUG_USE_HYPERNEAT_EVALUATION = 1;
+            currentSubstrateIndex=0;
+            firstevaluatemax(b,/*BASE_EVOLUTION_SEARCH_DEPTH+NEAT_SEARCH_HANDICAP+handCodedType*2*/8);
+
+#if CHECKERS_PRINT_ALTERNATE_MOVES
+            printBoard(b);
+            cout << "EVAL MAX:\n";
+            cout << "MOVE TO MAKE: "
+                << (int)moveToMake.from.x << ','
+                << (int)moveToMake.from.y
+                << " -> " << (int)moveToMake.getFinalDestination().x << ','
+                << (int)moveToMake.getFinalDestination().y << endl;
+            cout << "ALTERNATE MOVE TO MAKE: "
+                << (int)secondBestMoveToMake.from.x << ','
+                << (int)secondBestMoveToMake.from.y
+                << " -> " << (int)secondBestMoveToMake.getFinalDestination().x << ','
+                << (int)secondBestMoveToMake.getFinalDestination().y << endl;
+            CREATE_PAUSE("");
+#endif
 
-            double inGameFitness=0.0;
+#if CHECKERS_EXPERIMENT_DEBUG
+            cout << "BLACK MAKING MOVE\n";
 
-            for (currentRound=0;currentRound<CHECKERS_MAX_ROUNDS&&retval==-1;currentRound++)
+            printBoard(b);
+#endif
+
+            if (moveToMake.from.x==255)
             {
-#if 1
-				//Clear the evaluation cache
-				for (int a=0;a<65536;a++)
-				{
-					boardEvaluationCaches[0][a].clear();
-					boardEvaluationCaches[0][a].reserve(0);
-				}
-				//Clear the state list caches
-				for (int a=0;a<65536;a++)
-				{
-					boardStateLists[0][BLACK][a].clear();
-					boardStateLists[0][BLACK][a].reserve(0);
-				}
-				for (int a=0;a<65536;a++)
-				{
-					boardStateLists[0][WHITE][a].clear();
-					boardStateLists[0][WHITE][a].reserve(0);
-				}
+                //black loses
+                retval = WHITE;
+            }
+            else
+            {
+                makeMove(moveToMake,b);
+                retval = getWinner(b,WHITE);
 
-				//Clear the evaluation cache
-				for (int a=0;a<65536;a++)
-				{
-					boardEvaluationCaches[1][a].clear();
-					boardEvaluationCaches[1][a].reserve(0);
-				}
-				//Clear the state list caches
-				for (int a=0;a<65536;a++)
+#if CHECKERS_EXPERIMENT_LOG_EVALUATIONS
+				memcpy(gameLog[moves],b,sizeof(uchar)*8*8);
+				if(moveToMake.pieceCaptured)
 				{
-					boardStateLists[1][BLACK][a].clear();
-					boardStateLists[1][BLACK][a].reserve(0);
+					sprintf((char*)moveLog[moves],"%dx%d",gridToIndex(moveToMake.from),gridToIndex(moveToMake.getFinalDestination()));
 				}
-				for (int a=0;a<65536;a++)
+				else
 				{
-					boardStateLists[1][WHITE][a].clear();
-					boardStateLists[1][WHITE][a].reserve(0);
+					sprintf((char*)moveLog[moves],"%d-%d",gridToIndex(moveToMake.from),gridToIndex(moveToMake.getFinalDestination()));
 				}
+				moves++;
+#endif
+            }
+
+#if CHECKERS_EXPERIMENT_DEBUG
+            printBoard(b);
+            CREATE_PAUSE("");
+#endif
+#endif
+            if(retval==-1)
+            {
+                //makeMoveCliche(b,BLACK,&retval);
+            }
+
+            if (retval==-1)
+            {
+                //printBoard(b);
 
-                //cout << "Round: " << currentRound << endl;
                 moveToMake = CheckersMove();
                 secondBestMoveToMake = CheckersMove();
-                DEBUG_USE_HANDCODED_EVALUATION = 0;
-                DEBUG_USE_HYPERNEAT_EVALUATION = 1;
-                currentSubstrateIndex=0;
-                firstevaluatemax(b,/*BASE_EVOLUTION_SEARCH_DEPTH+NEAT_SEARCH_HANDICAP+handCodedType*2*/8);
+
+#if 0
+for(int r=0;r<8;r++) for(int c=0;c<8;c++) if((r+c)%2==0) b[r][c] = 0;
+b[0][6] = b[2][2] = b[3][1] = b[5][7] = WHITE | MAN;
+b[3][3] = WHITE|KING;
+b[4][6] = b[3][5] = b[6][2] = BLACK|MAN;
+#endif
+
+#if DEBUG_PLAY_CAKE_INSTEAD_OF_CLICHE == 0
+                makeMoveCliche(b,WHITE,&retval);
+                /*
+                //CLICHE ENGINE
+                {
+                    //progress_timer t;
+                    DEBUG_USE_HANDCODED_EVALUATION = 1;
+                    DEBUG_USE_HYPERNEAT_EVALUATION = 0;
+                    currentSubstrateIndex=handCodedAISubstrateIndex;
+
+					boost::mutex::scoped_lock lock(cakeMutex);
+					//printBoard(b);
+					//Play with cake
+					char output[255];
+                    memset(output,0,sizeof(char)*255);
+					int playnow=0;
+                    int bint[8][8];
+                    for(int r=0;r<8;r++) for(int c=0;c<8;c++) bint[r][c] = b[r][c];
+                    CBmove cbmove;
+                    MAXDEPTH = BASE_EVOLUTION_SEARCH_DEPTH;
+                    int cakeReturn = getmove(bint,WHITE,1000000.0,output,&playnow,0,0,&cbmove);
+                    for(int r=0;r<8;r++) for(int c=0;c<8;c++) b[r][c] = bint[r][c];
+
+					//cout << "cliche Value: " << cakeReturn << " Output: " << output << endl;
+					//printBoard(b);
+                    //CREATE_PAUSE("");
+
+					//firstevaluatemin(b,BASE_EVOLUTION_SEARCH_DEPTH);
+                    //cout << "SimpleCheckers time: ";
+
+                    if(cakeReturn == LOSS)
+                    {
+                        //No moves to make
+                        retval = BLACK;
+                    }
+					else
+					{
+#if CHECKERS_EXPERIMENT_LOG_EVALUATIONS
+						memcpy(gameLog[moves],b,sizeof(uchar)*8*8);
+						if(cbmove.ismove)
+						{
+							sprintf((char*)moveLog[moves],"%dx%d",gridToIndex(cbmove.from.x,cbmove.from.y),gridToIndex(cbmove.to.x,cbmove.to.y));
+						}
+						else
+						{
+							sprintf((char*)moveLog[moves],"%d-%d",gridToIndex(cbmove.from.x,cbmove.from.y),gridToIndex(cbmove.to.x,cbmove.to.y));
+						}
+						moves++;
+#endif
+					}
+				}
+                */
+
+#else
+                //CAKE ENGINE
+				makeMoveCake(b,WHITE,&retval);
+				//makeMoveCliche(b,WHITE,&retval);
+#endif
 
 #if CHECKERS_PRINT_ALTERNATE_MOVES
                 printBoard(b);
-                cout << "EVAL MAX:\n";
+                cout << "EVAL MIN:\n";
                 cout << "MOVE TO MAKE: "
                     << (int)moveToMake.from.x << ','
                     << (int)moveToMake.from.y
@@ -2515,284 +2639,189 @@ namespace HCUBE
 #endif
 
 #if CHECKERS_EXPERIMENT_DEBUG
-                cout << "BLACK MAKING MOVE\n";
+                cout << "WHITE MAKING MOVE\n";
 
                 printBoard(b);
 #endif
 
+#if 0 //Doesn't apply to cake
                 if (moveToMake.from.x==255)
                 {
-                    //black loses
-                    retval = WHITE;
+                    //white loses
+                    cout << "WHITE LOSES BECAUSE THERE'S NO MOVES LEFT!\n";
+                    retval = BLACK;
+                    //printBoard(b);
+                    CREATE_PAUSE("");
                 }
                 else
                 {
-                    makeMove(moveToMake,b);
-                    retval = getWinner(b,WHITE);
+                    if (
+                        chanceToMakeSecondBestMove > 0.01 &&
+                        (
+                        NEAT::Globals::getSingleton()->getRandom().getRandomDouble() <
+                        chanceToMakeSecondBestMove
+                        )
+                        )
+                    {
+                        if (secondBestMoveToMake.from.x==255)
+                        {
+                            throw CREATE_LOCATEDEXCEPTION_INFO("THIS SHOULDN'T HAPPEN!");
+                        }
 
-#if CHECKERS_EXPERIMENT_LOG_EVALUATIONS
-					memcpy(gameLog[moves],b,sizeof(uchar)*8*8);
-					if(moveToMake.pieceCaptured)
-					{
-						sprintf((char*)moveLog[moves],"%dx%d",gridToIndex(moveToMake.from),gridToIndex(moveToMake.getFinalDestination()));
-					}
-					else
-					{
-						sprintf((char*)moveLog[moves],"%d-%d",gridToIndex(moveToMake.from),gridToIndex(moveToMake.getFinalDestination()));
-					}
-					moves++;
+#if CHECKERS_PRINT_ALTERNATE_MOVES
+                        cout << "MADE SECOND BEST MOVE!!!!\n";
 #endif
+
+                        makeMove(secondBestMoveToMake,b);
+                    }
+                    else
+                    {
+                        makeMove(moveToMake,b);
+                    }
+
+                    retval = getWinner(b,BLACK);
                 }
+#endif
 
 #if CHECKERS_EXPERIMENT_DEBUG
                 printBoard(b);
                 CREATE_PAUSE("");
 #endif
-#endif
-                if(retval==-1)
-                {
-                    //makeMoveCliche(b,BLACK,&retval);
-                }
+            }
 
-                if (retval==-1)
-                {
-                    //printBoard(b);
+            int whiteMen,blackMen,whiteKings,blackKings;
 
-                    moveToMake = CheckersMove();
-                    secondBestMoveToMake = CheckersMove();
+            //countPieces(gi.board,whiteMen,blackMen,whiteKings,blackKings);
+            countPieces(b,whiteMen,blackMen,whiteKings,blackKings);
 
-#if 0
-	for(int r=0;r<8;r++) for(int c=0;c<8;c++) if((r+c)%2==0) b[r][c] = 0;
-	b[0][6] = b[2][2] = b[3][1] = b[5][7] = WHITE | MAN;
-	b[3][3] = WHITE|KING;
-	b[4][6] = b[3][5] = b[6][2] = BLACK|MAN;
-#endif
+            //Reward for # of pieces at every turn.
+            result.rewards.push_back(2 * (12-whiteMen) );
+            result.rewards.push_back(2 * (blackMen) );
 
-#if DEBUG_PLAY_CAKE_INSTEAD_OF_CLICHE == 0
-                    makeMoveCliche(b,WHITE,&retval);
-                    /*
-                    //CLICHE ENGINE
-                    {
-                        //progress_timer t;
-                        DEBUG_USE_HANDCODED_EVALUATION = 1;
-                        DEBUG_USE_HYPERNEAT_EVALUATION = 0;
-                        currentSubstrateIndex=handCodedAISubstrateIndex;
-
-						boost::mutex::scoped_lock lock(cakeMutex);
-						//printBoard(b);
-						//Play with cake
-						char output[255];
-                        memset(output,0,sizeof(char)*255);
-						int playnow=0;
-                        int bint[8][8];
-                        for(int r=0;r<8;r++) for(int c=0;c<8;c++) bint[r][c] = b[r][c];
-                        CBmove cbmove;
-                        MAXDEPTH = BASE_EVOLUTION_SEARCH_DEPTH;
-                        int cakeReturn = getmove(bint,WHITE,1000000.0,output,&playnow,0,0,&cbmove);
-                        for(int r=0;r<8;r++) for(int c=0;c<8;c++) b[r][c] = bint[r][c];
-
-						//cout << "cliche Value: " << cakeReturn << " Output: " << output << endl;
-						//printBoard(b);
-                        //CREATE_PAUSE("");
-
-						//firstevaluatemin(b,BASE_EVOLUTION_SEARCH_DEPTH);
-                        //cout << "SimpleCheckers time: ";
-
-                        if(cakeReturn == LOSS)
-                        {
-                            //No moves to make
-                            retval = BLACK;
-                        }
-						else
-						{
-#if CHECKERS_EXPERIMENT_LOG_EVALUATIONS
-							memcpy(gameLog[moves],b,sizeof(uchar)*8*8);
-							if(cbmove.ismove)
-							{
-								sprintf((char*)moveLog[moves],"%dx%d",gridToIndex(cbmove.from.x,cbmove.from.y),gridToIndex(cbmove.to.x,cbmove.to.y));
-							}
-							else
-							{
-								sprintf((char*)moveLog[moves],"%d-%d",gridToIndex(cbmove.from.x,cbmove.from.y),gridToIndex(cbmove.to.x,cbmove.to.y));
-							}
-							moves++;
-#endif
-						}
-					}
-                    */
+            result.rewards.push_back(3 * (12-whiteKings) );
+            result.rewards.push_back(3 * (blackKings) );
 
-#else
-                    //CAKE ENGINE
-					makeMoveCake(b,WHITE,&retval);
-					//makeMoveCliche(b,WHITE,&retval);
-#endif
+        }
 
-#if CHECKERS_PRINT_ALTERNATE_MOVES
-                    printBoard(b);
-                    cout << "EVAL MIN:\n";
-                    cout << "MOVE TO MAKE: "
-                        << (int)moveToMake.from.x << ','
-                        << (int)moveToMake.from.y
-                        << " -> " << (int)moveToMake.getFinalDestination().x << ','
-                        << (int)moveToMake.getFinalDestination().y << endl;
-                    cout << "ALTERNATE MOVE TO MAKE: "
-                        << (int)secondBestMoveToMake.from.x << ','
-                        << (int)secondBestMoveToMake.from.y
-                        << " -> " << (int)secondBestMoveToMake.getFinalDestination().x << ','
-                        << (int)secondBestMoveToMake.getFinalDestination().y << endl;
-                    CREATE_PAUSE("");
-#endif
 
-#if CHECKERS_EXPERIMENT_DEBUG
-                    cout << "WHITE MAKING MOVE\n";
+        //cout << "RETVAL: " << (retval==1?"WHITE":(retval==2?"BLACK":"")) << endl;
 
-                    printBoard(b);
+        if (retval==BLACK)
+        {
+            //#if CHECKERS_EXPERIMENT_DEBUG
+            cout << "WE WON!\n";
+#if CHECKERS_EXPERIMENT_LOG_EVALUATIONS
+            for (int a=0;a<moves;a++)
+            {
+                printBoard(gameLog[a]);
+            }
+            cout << gameLogToPDN() << endl;
+            CREATE_PAUSE("");
 #endif
+            //CREATE_PAUSE("");
+            //#endif
 
-#if 0 //Doesn't apply to cake
-                    if (moveToMake.from.x==255)
-                    {
-                        //white loses
-                        cout << "WHITE LOSES BECAUSE THERE'S NO MOVES LEFT!\n";
-                        retval = BLACK;
-                        //printBoard(b);
-                        CREATE_PAUSE("");
-                    }
-                    else
-                    {
-                        if (
-                            chanceToMakeSecondBestMove > 0.01 &&
-                            (
-                            NEAT::Globals::getSingleton()->getRandom().getRandomDouble() <
-                            chanceToMakeSecondBestMove
-                            )
-                            )
-                        {
-                            if (secondBestMoveToMake.from.x==255)
-                            {
-                                throw CREATE_LOCATEDEXCEPTION_INFO("THIS SHOULDN'T HAPPEN!");
-                            }
+            result.rewards.push_back(40000);
 
-#if CHECKERS_PRINT_ALTERNATE_MOVES
-                            cout << "MADE SECOND BEST MOVE!!!!\n";
-#endif
+            //You get bonus fitness for every round you don't have to play
+            //if you win
+            int roundsLeftOver = CHECKERS_MAX_ROUNDS-currentRound;
+            result.rewards.push_back(roundsLeftOver*72.0);
 
-                            makeMove(secondBestMoveToMake,b);
-                        }
-                        else
-                        {
-                            makeMove(moveToMake,b);
-                        }
-
-                        retval = getWinner(b,BLACK);
-                    }
+        }
+        /*NOTE: Tying counts as a loss
+        else if (retval==-1) //draw
+        {
+        cout << "WE TIED!\n";
+        result.rewards.push_back(200);
+        }
+        */
+        else //loss
+        {
+#if CHECKERS_EXPERIMENT_DEBUG
+            //Final board:
+            printBoard(b);
+            //CREATE_PAUSE("LOSS!");
 #endif
+            //if(gi.nummoves<90)
+            //{
+            //individual->reward(rounds/(((CheckersNEATDatatype)CHECKERS_MAX_ROUNDS)/10));
+            //}
 
-#if CHECKERS_EXPERIMENT_DEBUG
-                    printBoard(b);
-                    CREATE_PAUSE("");
+
+#if CHECKERS_EXPERIMENT_PRINT_EVALUATIONS_ON_LOSS
+            for (int a=0;a<moves;a++)
+            {
+                printBoard(gameLog[a]);
+            }
+			cout << "PDN: " << gameLogToPDN() << endl;
+            CREATE_PAUSE("");
 #endif
-                }
 
-                int whiteMen,blackMen,whiteKings,blackKings;
+            //Reward losing.  This discourages ties
+            result.rewards.push_back(10000);
+        }
 
-                //countPieces(gi.board,whiteMen,blackMen,whiteKings,blackKings);
-                countPieces(b,whiteMen,blackMen,whiteKings,blackKings);
+        result.winner = retval;
+    }
 
-                //Reward for # of pieces at every turn.
-                individual->reward(2 * (12-whiteMen) );
-                individual->reward(2 * (blackMen) );
+    void CheckersExperiment::processGroup(shared_ptr<NEAT::GeneticGeneration> generation)
+    {
+        //cout << "Processing evaluation...\n";
+        shared_ptr<NEAT::GeneticIndividual> individual = group.front();
+        //You get 10 points just for entering the game, wahooo!
+        individual->setFitness(10);
+		numHandCodedStreams=0;
+        numHyperNEATStreams = 0;
 
-                individual->reward(3 * (12-whiteKings) );
-                individual->reward(3 * (blackKings) );
+        populateSubstrate(individual);
 
-            }
+        /*
+        gameinfo gi;
 
+        // init gameinfo
+        memset (&gi, 0, sizeof (gi));
 
-            //cout << "RETVAL: " << (retval==1?"WHITE":(retval==2?"BLACK":"")) << endl;
+        gi.experiment = this;
+        gi.result = UNKNOWN;
 
-            if (retval==BLACK)
-            {
-                //#if CHECKERS_EXPERIMENT_DEBUG
-                cout << "WE WON!\n";
-#if CHECKERS_EXPERIMENT_LOG_EVALUATIONS
-                for (int a=0;a<moves;a++)
-                {
-                    printBoard(gameLog[a]);
-                }
-                cout << gameLogToPDN() << endl;
-                CREATE_PAUSE("");
-#endif
-                //CREATE_PAUSE("");
-                //#endif
+        gi.player = "HyperNEAT";
 
-                if (individual->getUserData().length())
-                {
-					CheckersStats stats(individual->getUserData());
-					stats.wins++;
-					individual->setUserData(stats.toString());
-                }
+        // check opponent
+        gi.opponent = "simplech";
+        */
 
-                individual->reward(40000);
+        uchar b[8][8];
 
-                //You get bonus fitness for every round you don't have to play
-                //if you win
-                int roundsLeftOver = CHECKERS_MAX_ROUNDS-currentRound;
-                individual->reward(roundsLeftOver*72.0);
+        //Games are rewarded in order after they are all played, so playing them on several
+        //threads gives exactly the fitness of a serial evaluation
+        vector<CheckersGameResult> gameResults(HANDCODED_PLAYER_TESTS);
+        playGames(gameResults);
 
-            }
-            /*NOTE: Tying counts as a loss
-            else if (retval==-1) //draw
+        for (int a=0;a<(int)gameResults.size();a++)
+        {
+            const CheckersGameResult &result = gameResults[a];
+            for (int c=0;c<(int)result.rewards.size();c++)
             {
-            cout << "WE TIED!\n";
-            individual->reward(200);
+                individual->reward(result.rewards[c]);
             }
-            */
-            else //loss
-            {
-#if CHECKERS_EXPERIMENT_DEBUG
-                //Final board:
-                printBoard(b);
-                //CREATE_PAUSE("LOSS!");
-#endif
-                //if(gi.nummoves<90)
-                //{
-                //individual->reward(rounds/(((CheckersNEATDatatype)CHECKERS_MAX_ROUNDS)/10));
-                //}
 
-
-#if CHECKERS_EXPERIMENT_PRINT_EVALUATIONS_ON_LOSS
-                for (int a=0;a<moves;a++)
+            if (individual->getUserData().length())
+            {
+                CheckersStats stats(individual->getUserData());
+                if (result.winner==BLACK)
                 {
-                    printBoard(gameLog[a]);
+                    stats.wins++;
                 }
-				cout << "PDN: " << gameLogToPDN() << endl;
-                CREATE_PAUSE("");
-#endif
-
-                if (retval==-1)
+                else if (result.winner==-1)
                 {
-                    //tie
-                    if (individual->getUserData().length())
-                    {
-						CheckersStats stats(individual->getUserData());
-						stats.ties++;
-						individual->setUserData(stats.toString());
-                    }
+                    stats.ties++;
                 }
                 else
                 {
-                    //loss
-                    if (individual->getUserData().length())
-                    {
-						CheckersStats stats(individual->getUserData());
-						stats.losses++;
-						individual->setUserData(stats.toString());
-                    }
+                    stats.losses++;
                 }
-
-                //Reward losing.  This discourages ties
-                individual->reward(10000);
+                individual->setUserData(stats.toString());
             }
         }
 
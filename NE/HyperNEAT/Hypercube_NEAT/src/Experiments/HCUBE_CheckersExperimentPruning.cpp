@@ -53,8 +53,6 @@ extern ofstream hyperNEATTreeStream;
 
 #define DEBUG_SHOW_HYPERNEAT_ALTERNATIVES (0)
 
-extern CheckersAdvisor *checkersAdvisor;
-
 namespace HCUBE
 {
     class BoardEvaluation
@@ -95,8 +93,6 @@ namespace HCUBE
 
     using namespace NEAT;
 
-    extern mutex cakeMutex;
-
     CheckersExperimentPruning::CheckersExperimentPruning(string _experimentName,int _threadID)
         :
     Experiment(_experimentName,_threadID),
@@ -109,6 +105,7 @@ namespace HCUBE
 		maxCakeNodes(10000)
     {
         searchInfo.repcheck = (REPETITION*)malloc((MAXDEPTH+HISTORYOFFSET)*sizeof(REPETITION));
+        searchInfo.context = NULL;
         //boardEvaluationCaches[0].resize(10000);
         //boardEvaluationCaches[1].resize(10000);
 
@@ -284,16 +281,16 @@ namespace HCUBE
         if(colorToMove==BLACK)
             otherColor=WHITE;
 
-        boost::mutex::scoped_lock lock(cakeMutex);
-        srand(cakeRandomSeed);
+        searchInfo.context = cakeSearchContext.get();
+        searchInfo.context->randomseed = cakeRandomSeed;
 
 		if(useAdvisor)
 		{
-			checkersAdvisor = this;
+			searchInfo.context->advisor = this;
 		}
 		else
 		{
-			checkersAdvisor = NULL;
+			searchInfo.context->advisor = NULL;
 		}
 
         //cout << "CAKE BEFORE\n";
@@ -319,7 +316,7 @@ namespace HCUBE
         //firstevaluatemin(b,BASE_EVOLUTION_SEARCH_DEPTH);
         //cout << "SimpleCheckers time: ";
 
-		checkersAdvisor = NULL;
+		searchInfo.context->advisor = NULL;
 
 		if(cakeReturn==WIN)
 		{
@@ -0,0 +1,228 @@
+#include "HCUBE_Defines.h"
+
+#include "Experiments/HCUBE_CheckersTranspositionTable.h"
+
+namespace HCUBE
+{
+    //splitmix64, to fill the key tables the same way on every run
+    static ulong nextZobristKey(ulong &state)
+    {
+        ulong z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    class CheckersZobristKeys
+    {
+    public:
+        //[x][y][black man, black king, white man, white king]
+        ulong pieceKeys[8][8][4];
+        ulong whiteToMoveKey;
+
+        //pieceKeys by bitboard square
+        ulong squareKeys[4][32];
+
+        CheckersZobristKeys()
+        {
+            ulong state = 0x436865636B657273ULL;
+            for (int x=0;x<8;x++)
+            {
+                for (int y=0;y<8;y++)
+                {
+                    for (int piece=0;piece<4;piece++)
+                    {
+                        pieceKeys[x][y][piece] = nextZobristKey(state);
+                    }
+                }
+            }
+            whiteToMoveKey = nextZobristKey(state);
+
+            for (int square=0;square<32;square++)
+            {
+                for (int piece=0;piece<4;piece++)
+                {
+                    squareKeys[piece][square] = pieceKeys
+                                                [CheckersBitboard::getSquareX(square)]
+                                                [CheckersBitboard::getSquareY(square)]
+                                                [piece];
+                }
+            }
+        }
+    };
+
+    static const CheckersZobristKeys zobristKeys;
+
+    //Layout of Slot::data
+    static const int VALUE_SHIFT = 0;
+    static const int DEPTH_SHIFT = 32;
+    static const int BOUND_SHIFT = 40;
+    static const int MOVE_SHIFT = 48;
+    static const int GENERATION_SHIFT = 56;
+
+    CheckersTranspositionTable::CheckersTranspositionTable(int megabytes)
+        :
+    bucketMask(0),
+        generation(0),
+        probes(0),
+        hits(0),
+        stores(0)
+    {
+        resize(megabytes);
+    }
+
+    void CheckersTranspositionTable::resize(int megabytes)
+    {
+        size_t budget = size_t(max(megabytes,1))*1024*1024;
+        size_t numBuckets = 1;
+        while (numBuckets*2*BUCKET_SIZE*sizeof(Slot) <= budget)
+        {
+            numBuckets *= 2;
+        }
+
+        slots.assign(numBuckets*BUCKET_SIZE,Slot());
+        bucketMask = numBuckets-1;
+        clear();
+    }
+
+    void CheckersTranspositionTable::clear()
+    {
+        if (!slots.empty())
+        {
+            memset(&slots[0],0,slots.size()*sizeof(Slot));
+        }
+        generation = 0;
+        resetCounters();
+    }
+
+    ulong CheckersTranspositionTable::getBoardKey(uchar b[8][8],int colorToMove)
+    {
+        ulong key = (colorToMove==WHITE) ? zobristKeys.whiteToMoveKey : 0;
+        for (int y=0;y<8;y++)
+        {
+            for (int x=(y%2);x<8;x+=2)
+            {
+                uchar square = b[x][y];
+                if (square&(BLACK|WHITE))
+                {
+                    int piece = ((square&WHITE) ? 2 : 0) + ((square&KING) ? 1 : 0);
+                    key ^= zobristKeys.pieceKeys[x][y][piece];
+                }
+            }
+        }
+        return key;
+    }
+
+    ulong CheckersTranspositionTable::getBoardKey(const CheckersBitboard &board,int colorToMove)
+    {
+        ulong key = (colorToMove==WHITE) ? zobristKeys.whiteToMoveKey : 0;
+
+        //Same keys as the uchar version, so both give the same hash for a position
+        const uint pieces[4] =
+        {
+            board.black&~board.kings,
+            board.black&board.kings,
+            board.white&~board.kings,
+            board.white&board.kings
+        };
+
+        for (int piece=0;piece<4;piece++)
+        {
+            for (uint mask=pieces[piece];mask;mask&=(mask-1))
+            {
+                key ^= zobristKeys.squareKeys[piece][CheckersBitboard::getLowestSquare(mask)];
+            }
+        }
+
+        return key;
+    }
+
+    ulong CheckersTranspositionTable::getSearchKey(ulong evaluator)
+    {
+        ulong state = evaluator;
+        return nextZobristKey(state);
+    }
+
+    bool CheckersTranspositionTable::probe(ulong key,Entry &entry)
+    {
+        probes++;
+
+        const Slot *bucket = &slots[(size_t(key)&bucketMask)*BUCKET_SIZE];
+        for (int a=0;a<BUCKET_SIZE;a++)
+        {
+            ulong data = bucket[a].data;
+            if ((bucket[a].check^data)!=key || data==0)
+            {
+                continue;
+            }
+
+            unsigned int valueBits = (unsigned int)(data>>VALUE_SHIFT);
+            memcpy(&entry.value,&valueBits,sizeof(float));
+            entry.depth = (signed char)(data>>DEPTH_SHIFT);
+            entry.bound = BoundType((data>>BOUND_SHIFT)&3);
+            entry.bestMove = int((data>>MOVE_SHIFT)&0xFF);
+            hits++;
+            return true;
+        }
+
+        return false;
+    }
+
+    void CheckersTranspositionTable::store(
+        ulong key,
+        CheckersNEATDatatype value,
+        int depth,
+        BoundType bound,
+        int bestMove
+    )
+    {
+        stores++;
+
+        depth = max(-128,min(127,depth));
+
+        float floatValue = float(value);
+        unsigned int valueBits;
+        memcpy(&valueBits,&floatValue,sizeof(float));
+
+        ulong data =
+            (ulong(valueBits)<<VALUE_SHIFT) |
+            (ulong((uchar)(signed char)depth)<<DEPTH_SHIFT) |
+            (ulong(bound)<<BOUND_SHIFT) |
+            (ulong(bestMove&0xFF)<<MOVE_SHIFT) |
+            (ulong(generation)<<GENERATION_SHIFT);
+
+        //Replace the same position if there is one, otherwise the slot that is worth the
+        //least: entries from earlier searches first, then the shallowest
+        Slot *bucket = &slots[(size_t(key)&bucketMask)*BUCKET_SIZE];
+        Slot *victim = bucket;
+        int victimWorth = INT_MAX;
+        for (int a=0;a<BUCKET_SIZE;a++)
+        {
+            ulong oldData = bucket[a].data;
+            if ((bucket[a].check^oldData)==key)
+            {
+                victim = bucket+a;
+                break;
+            }
+
+            int worth = (signed char)(oldData>>DEPTH_SHIFT);
+            if (uchar(oldData>>GENERATION_SHIFT)==generation && oldData)
+            {
+                worth += 256;
+            }
+            if (!oldData)
+            {
+                worth = INT_MIN;
+            }
+
+            if (worth<victimWorth)
+            {
+                victim = bucket+a;
+                victimWorth = worth;
+            }
+        }
+
+        victim->data = data;
+        victim->check = key^data;
+    }
+}
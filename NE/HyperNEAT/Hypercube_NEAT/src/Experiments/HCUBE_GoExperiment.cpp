@@ -23,6 +23,9 @@
 
 #include "SgSystem.h"
 
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
+
 #define GO_EXPERIMENT_DEBUG (0)
 
 #define DEBUG_CHECK_HAND_CODED_HEURISTIC (0)
@@ -73,6 +76,12 @@
 
 #define USE_SINGLE_LAYER_FOR_PIECES (1)
 
+#if USE_SINGLE_LAYER_FOR_PIECES
+#define GO_NUM_PIECE_LAYERS (1)
+#else
+#define GO_NUM_PIECE_LAYERS (2)
+#endif
+
 #ifdef _DEBUG
 #define UCT_MAX_GAMES (100)
 #else
@@ -83,10 +92,37 @@ namespace HCUBE
 {
     using namespace NEAT;
 
-    boost::mutex fuegoMutex;
+    /*
+     * fuegoMutex: Guards the state Fuego keeps for the whole process.  Every experiment plays
+     * on its own board and players, but creating players and reseeding go through Fuego's
+     * list of random generators, the book draws from its global generator, and the value
+     * heuristic hook is a single global read by the search threads.  Those take the lock
+     * exclusively; other searches share it, so they run alongside each other.
+     */
+    boost::shared_mutex fuegoMutex;
+
+    boost::mutex goStatsMutex;
+
+    GoBook *sharedGoBook = NULL;
 
     GoExperiment* currentExperiment = NULL;
 
+    //Loads the state every experiment shares.  Requires the exclusive lock on fuegoMutex.
+    void initializeFuego()
+    {
+        if(sharedGoBook)
+        {
+            return;
+        }
+
+        sharedGoBook = new GoBook();
+        sharedGoBook->Read("FuegoBook/book.dat");
+
+#ifndef _DEBUG
+        SgDebugToNull();
+#endif
+    }
+
     int HyperNEATMoveGenerator::Score(SgPoint p)
     {
         SG_UNUSED(p);
@@ -125,15 +161,19 @@ namespace HCUBE
         uctEnabled(false),
         board(NULL),
         self(NULL),
-        numGamesPerOpponent(20)
+        numGamesPerOpponent(20),
+        boardInputsValid(false)
     {
-        boost::mutex::scoped_lock lock(fuegoMutex);
-        goBook.Read("FuegoBook/book.dat");
+        {
+            boost::unique_lock<boost::shared_mutex> lock(fuegoMutex);
+            initializeFuego();
+        }
         setGoBoardSize(9,true);
     }
 
     GoExperiment::~GoExperiment()
     {
+        boost::unique_lock<boost::shared_mutex> lock(fuegoMutex);
         delete self;
         for(int a=0;a<(int)opponents.size();a++)
         {
@@ -212,6 +252,7 @@ namespace HCUBE
         substrateIndividuals[substrateNum]=individual;
 
         substrates[substrateNum].populateSubstrate(individual);
+        boardInputsValid=false;
     }
 
     void GoExperiment::printBoard(const GoBoard *boardToPrint)
@@ -294,7 +335,6 @@ namespace HCUBE
         shared_ptr<NEAT::GeneticIndividual> individual = group.front();
 		int scalingType = int(NEAT::Globals::getSingleton()->getParameterValue("GoScalingType")+0.1);
 
-        boost::mutex::scoped_lock lock(fuegoMutex);
 		if( (generation && generation->getGenerationNumber()>=499) || scalingType==GO_SCALING_NONE)
 		{
 			setGoBoardSize(9,true);
@@ -305,9 +345,6 @@ namespace HCUBE
 		}
 
 		//cout << "Processing individual...";
-#ifndef _DEBUG
-		SgDebugToNull();
-#endif
 
         //cout << "Processing evaluation...\n";
         individual->setFitness(10);
@@ -351,6 +388,7 @@ namespace HCUBE
 
                 //Initialize random
                 {
+                    boost::unique_lock<boost::shared_mutex> lock(fuegoMutex);
                     //Initialize the random seed (Must be positive, 0 means something special)
                     SgRandom::SetSeed(1000 + 1000*currentGame);
                 }
@@ -364,6 +402,7 @@ namespace HCUBE
 
                 bool hyperNEATPassed=false;
                 bool opponentPassed=false;
+                bool opponentSearched=false;
 
                 //Play alternating moves as HyperNEAT and the opponent until the game is decided
                 for(int round=0;;round++)
@@ -375,10 +414,13 @@ namespace HCUBE
                     //Alright, let HyperNEAT move
                     SgPoint selfMove;
                     {
-                        selfMove = goBook.LookupMove(*board);
+                        boost::unique_lock<boost::shared_mutex> lock(fuegoMutex);
+                        selfMove = sharedGoBook->LookupMove(*board);
 
                         if(selfMove == SG_NULLMOVE)
                         {
+                            //While the hook is set, every search would use this substrate,
+                            //so this search keeps the exclusive lock
                             currentExperiment = this;
                             defaultValueHeuristic = globalGetMoveHeuristic;
                             SgTimeRecord dummy(true,1e50);
@@ -434,12 +476,27 @@ namespace HCUBE
                     //Alright, hyperneat has moved, now let opponent move
                     SgPoint opponentMove;
                     {
-                        opponentMove = goBook.LookupMove(*board);
+                        {
+                            boost::unique_lock<boost::shared_mutex> lock(fuegoMutex);
+                            opponentMove = sharedGoBook->LookupMove(*board);
+                        }
 
                         if(opponentMove == SG_NULLMOVE)
                         {
                             SgTimeRecord dummy(true,1e50);
-                            opponentMove = opponent->GenMove(dummy,opponent->Board().ToPlay());
+                            if(opponentSearched)
+                            {
+                                boost::shared_lock<boost::shared_mutex> lock(fuegoMutex);
+                                opponentMove = opponent->GenMove(dummy,opponent->Board().ToPlay());
+                            }
+                            else
+                            {
+                                //The first search creates the player's thread states, whose
+                                //random generators add themselves to Fuego's list
+                                boost::unique_lock<boost::shared_mutex> lock(fuegoMutex);
+                                opponentMove = opponent->GenMove(dummy,opponent->Board().ToPlay());
+                                opponentSearched=true;
+                            }
                         }
                         else
                         {
@@ -580,26 +637,24 @@ namespace HCUBE
             totalWins += wins[opponentIndex];
         }
         float winPercent = ((totalWins*100.0f)/totalGames);
-        if(winPercent >= BEST_WIN_PERCENT)
-        {
-            BEST_WIN_PERCENT = winPercent;
-            cout << "BEST WIN PERCENT: " << ((totalWins*100.0f)/totalGames) << "%. Fitness: " << individual->getFitness() << ".\n";
-        }
-        if(totalWins>=int(opponents.size()*numGamesPerOpponent))
-        {
-            cout << "WON EVERY GAME!!!!!\n";
-        }
-        if(totalWins>=int(opponents.size()*numGamesPerOpponent)/2)
         {
-            cout << "WON HALF OF GAMES!!!!!\n";
+            boost::mutex::scoped_lock lock(goStatsMutex);
+            if(winPercent >= BEST_WIN_PERCENT)
+            {
+                BEST_WIN_PERCENT = winPercent;
+                cout << "BEST WIN PERCENT: " << ((totalWins*100.0f)/totalGames) << "%. Fitness: " << individual->getFitness() << ".\n";
+            }
+            if(totalWins>=int(opponents.size()*numGamesPerOpponent))
+            {
+                cout << "WON EVERY GAME!!!!!\n";
+            }
+            if(totalWins>=int(opponents.size()*numGamesPerOpponent)/2)
+            {
+                cout << "WON HALF OF GAMES!!!!!\n";
+            }
         }
 
         individual->setUserData(stats.toString());
-
-#ifndef _DEBUG
-		//In case post-hoc tests are done later on
-		SgDebugToWindow();
-#endif
 		//cout << "...done!\n";
                 //cout << "EVALUATION FINISHED\n";
 	}
@@ -658,45 +713,9 @@ namespace HCUBE
 
         //First, have HyperNEAT generate a move
 		substrates[0].getNetwork()->reinitialize();
-        for(int r=0;r<goBoardSize;r++)
-        {
-            for(int c=0;c<goBoardSize;c++)
-            {
-                SgBoardColor boardColor = self->Board().GetColor(SgPointUtil::Pt(c+1,r+1));
-#if USE_SINGLE_LAYER_FOR_PIECES
-                if(boardColor==SG_BLACK)
-                {
-                    substrates[0].setValue( Node(r,c,0) , 1 );
-                }
-                else if(boardColor==SG_WHITE)
-                {
-                    substrates[0].setValue( Node(r,c,0) , -1 );
-                }
-                else //c==SG_EMPTY
-                {
-                    substrates[0].setValue( Node(r,c,0) , 0 );
-                }
-#else
-                if(boardColor==SG_BLACK)
-                {
-                    substrates[0].setValue( Node(r,c,0) , 1 );
-                }
-                else
-                {
-                    substrates[0].setValue( Node(r,c,0) , -1 );
-                }
-
-                if(boardColor==SG_WHITE)
-                {
-                    substrates[0].setValue( Node(r,c,1) , 1 );
-                }
-                else
-                {
-                    substrates[0].setValue( Node(r,c,1) , -1 );
-                }
-#endif
-            }
-        }
+        boardInputsValid=false;
+        bool boardEmpty;
+        writeBoardInputs(self->Board(),boardEmpty);
         substrates[0].getNetwork()->dummyActivation();
         substrates[0].getNetwork()->update();
 
@@ -711,8 +730,7 @@ namespace HCUBE
                     self->Board().IsLegal(p)
                     )
                 {
-                    int index = substrates[0].getLayerIndex("Output");
-                    float moveMotivation = substrates[0].getValue(Node(r,c,index));
+                    float moveMotivation = substrates[0].getValue(boardOutputHandles[r*goBoardSize+c]);
 
                     if(moveMotivation>0)
                     {
@@ -746,80 +764,69 @@ namespace HCUBE
             throw CREATE_LOCATEDEXCEPTION_INFO("DIFFERENT SIZE BOARD IS NOT SUPPORTED YET!");
         }
 
-        bool boardChanged=false;
-        bool boardEmpty=true;
-        //First, have HyperNEAT generate a move
+        bool boardEmpty;
+        bool boardChanged = writeBoardInputs(*board,boardEmpty);
+
+        if(boardChanged || boardEmpty)
+        {
+            //cout << "Board Changed or empty, evaluating\n";
+            substrates[0].getNetwork()->dummyActivation();
+            substrates[0].getNetwork()->update();
+        }
+
+        float rawValue = substrates[0].getValue(boardOutputHandles[(SgPointUtil::Row(p)-1)*goBoardSize + SgPointUtil::Col(p)-1]);
+
+        //negative values don't make sense, so scale to be [0-1]
+        return (rawValue+1.0) / 2.0;
+    }
+
+    bool GoExperiment::writeBoardInputs(const GoBoard &boardToWrite,bool &boardEmpty)
+    {
+        //Encode the board in the order of the layer's nodes, then copy the layers over whole
+        boardEmpty = true;
         for(int r=0;r<goBoardSize;r++)
         {
             for(int c=0;c<goBoardSize;c++)
             {
-                SgBoardColor boardColor = board->GetColor(SgPointUtil::Pt(c+1,r+1));
+                SgBoardColor boardColor = boardToWrite.GetColor(SgPointUtil::Pt(c+1,r+1));
+                int index = boardInputIndices[r*goBoardSize+c];
+                if(boardColor!=SG_EMPTY)
+                {
+                    boardEmpty = false;
+                }
 #if USE_SINGLE_LAYER_FOR_PIECES
                 if(boardColor==SG_BLACK)
                 {
-                    if( substrates[0].getValue( Node(r,c,0) ) != 1.0f)
-                    {
-                        boardChanged = true;
-                    }
-                    boardEmpty = false;
-                    substrates[0].setValue( Node(r,c,0) , 1.0f );
+                    newBoardInputValues[0][index] = 1.0f;
                 }
                 else if(boardColor==SG_WHITE)
                 {
-                    if( substrates[0].getValue( Node(r,c,0) ) != -1.0f)
-                    {
-                        boardChanged = true;
-                    }
-                    boardEmpty = false;
-                    substrates[0].setValue( Node(r,c,0) , -1.0f );
+                    newBoardInputValues[0][index] = -1.0f;
                 }
                 else //c==SG_EMPTY
                 {
-                    if( substrates[0].getValue( Node(r,c,0) ) != 0.0f)
-                    {
-                        boardChanged = true;
-                    }
-                    substrates[0].setValue( Node(r,c,0) , 0.0f );
+                    newBoardInputValues[0][index] = 0.0f;
                 }
 #else
-                if(boardColor==SG_BLACK)
-                {
-                    substrates[0].setValue( Node(r,c,0) , 1 );
-                }
-                else
-                {
-                    substrates[0].setValue( Node(r,c,0) , -1 );
-                }
-
-                if(boardColor==SG_WHITE)
-                {
-                    substrates[0].setValue( Node(r,c,1) , 1 );
-                }
-                else
-                {
-                    substrates[0].setValue( Node(r,c,1) , -1 );
-                }
+                newBoardInputValues[0][index] = (boardColor==SG_BLACK) ? 1.0f : -1.0f;
+                newBoardInputValues[1][index] = (boardColor==SG_WHITE) ? 1.0f : -1.0f;
 #endif
             }
         }
 
-        if(boardChanged)
-        {
-            int breakme=0;
-        }
-
-        if(boardChanged || boardEmpty)
+        bool boardChanged=false;
+        for(int layer=0;layer<GO_NUM_PIECE_LAYERS;layer++)
         {
-            //cout << "Board Changed or empty, evaluating\n";
-            substrates[0].getNetwork()->dummyActivation();
-            substrates[0].getNetwork()->update();
+            if(!boardInputsValid || newBoardInputValues[layer]!=boardInputValues[layer])
+            {
+                boardInputValues[layer].swap(newBoardInputValues[layer]);
+                substrates[0].setLayerValues(layer,&boardInputValues[layer][0]);
+                boardChanged = true;
+            }
         }
+        boardInputsValid = true;
 
-        int index = substrates[0].getLayerIndex("Output");
-        float rawValue = substrates[0].getValue(Node( SgPointUtil::Row(p)-1 , SgPointUtil::Col(p)-1 ,index));
-
-        //negative values don't make sense, so scale to be [0-1]
-        return (rawValue+1.0) / 2.0;
+        return boardChanged;
     }
 
     void GoExperiment::setGoBoardSize(int newSize,bool enableUCT)
@@ -894,12 +901,33 @@ namespace HCUBE
 		cout << "SCALING TYPE: " << scalingType << "\n";
         substrates[0] = NEAT::LayeredSubstrate<GoNEATDatatype>();
         substrates[0].setLayerInfo(layerInfo);
+        substrateIndividuals[0].reset();
+
+        int outputLayer = substrates[0].getLayerIndex("Output");
+        boardInputIndices.resize(goBoardSize*goBoardSize);
+        boardOutputHandles.resize(goBoardSize*goBoardSize);
+        for(int r=0;r<goBoardSize;r++)
+        {
+            for(int c=0;c<goBoardSize;c++)
+            {
+                boardInputIndices[r*goBoardSize+c] = substrates[0].resolve(Node(r,c,0)).index;
+                boardOutputHandles[r*goBoardSize+c] = substrates[0].resolve(Node(r,c,outputLayer));
+            }
+        }
+        for(int layer=0;layer<GO_NUM_PIECE_LAYERS;layer++)
+        {
+            boardInputValues[layer].assign(goBoardSize*goBoardSize,0.0f);
+            newBoardInputValues[layer].assign(goBoardSize*goBoardSize,0.0f);
+        }
+        boardInputsValid=false;
 
         createGoPlayers(enableUCT);
     }
 
     void GoExperiment::createGoPlayers(bool enableUCT)
     {
+        boost::unique_lock<boost::shared_mutex> lock(fuegoMutex);
+
         if(board)
         {
             delete board;
@@ -416,22 +416,7 @@ namespace HCUBE
         ushort b[8][8]
     )
     {
-        for (int x=0;x<8;x++)
-        {
-            for (int y=0;y<8;y++)
-            {
-                if (hasMove(b,OTHELLO_BLACK,x,y))
-                {
-                    return true;
-                }
-                if (hasMove(b,OTHELLO_WHITE,x,y))
-                {
-                    return true;
-                }
-            }
-        }
-
-        return false;
+        return hasAnyMove(OthelloBitboard(b));
     }
 
     int OthelloCommon::generateMoveList(ushort b[8][8],OthelloMove *moveList,int color)
@@ -441,18 +426,17 @@ namespace HCUBE
 #endif
         int numMoves=0;
 
-        for (int x=0;x<8;x++)
+        //The bits come out in the order of the x then y loops of hasMove(...)
+        for (ulong moves=getMoves(OthelloBitboard(b),color);moves;moves&=(moves-1))
         {
-            for (int y=0;y<8;y++)
+            int square = OthelloBitboard::getLowestSquare(moves);
+            moveList[numMoves++].reset(
+                Vector2<uchar>(OthelloBitboard::getSquareX(square),OthelloBitboard::getSquareY(square)),
+                color
+            );
+            if ( (moveList+numMoves) >= (totalMoveList+MAX_TOTAL_MOVES) )
             {
-                if (hasMove(b,color,x,y))
-                {
-                    moveList[numMoves++].reset( Vector2<uchar>(x,y), color );
-                    if ( (moveList+numMoves) >= (totalMoveList+MAX_TOTAL_MOVES) )
-                    {
-                        throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: MAXED OUT MOVE LIST!");
-                    }
-                }
+                throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: MAXED OUT MOVE LIST!");
             }
         }
 
@@ -493,4 +477,233 @@ namespace HCUBE
             return OTHELLO_END_TIE;
         }
     }
+
+    //Opponent pieces off the y=0 and y=7 edges.  A line along y or a diagonal can only
+    //run over these, so a shift never wraps from one column into the next.
+    static const ulong OTHELLO_INNER_Y = 0x7E7E7E7E7E7E7E7EULL;
+
+    //The runs of opponent pieces that start next to one of start's squares and lead
+    //towards square+shift.  A run is at most six pieces long, so six steps fill it
+    //without a branch.
+    static inline ulong fillUp(ulong start,ulong opponent,int shift)
+    {
+        ulong fill = (start<<shift)&opponent;
+        fill |= (fill<<shift)&opponent;
+        fill |= (fill<<shift)&opponent;
+        fill |= (fill<<shift)&opponent;
+        fill |= (fill<<shift)&opponent;
+        fill |= (fill<<shift)&opponent;
+        return fill;
+    }
+
+    static inline ulong fillDown(ulong start,ulong opponent,int shift)
+    {
+        ulong fill = (start>>shift)&opponent;
+        fill |= (fill>>shift)&opponent;
+        fill |= (fill>>shift)&opponent;
+        fill |= (fill>>shift)&opponent;
+        fill |= (fill>>shift)&opponent;
+        fill |= (fill>>shift)&opponent;
+        return fill;
+    }
+
+    static inline ulong getLineFlipsUp(ulong move,ulong own,ulong opponent,int shift)
+    {
+        ulong line = fillUp(move,opponent,shift);
+        return ((line<<shift)&own) ? line : 0;
+    }
+
+    static inline ulong getLineFlipsDown(ulong move,ulong own,ulong opponent,int shift)
+    {
+        ulong line = fillDown(move,opponent,shift);
+        return ((line>>shift)&own) ? line : 0;
+    }
+
+    OthelloBitboard::OthelloBitboard(ushort b[8][8])
+            :
+            black(0),
+            white(0)
+    {
+        for (int x=0;x<8;x++)
+        {
+            for (int y=0;y<8;y++)
+            {
+                int piece = OTHELLO_GET_PIECE(b[x][y]);
+                if (piece==OTHELLO_BLACK)
+                {
+                    black |= (1ULL<<getSquare(x,y));
+                }
+                else if (piece==OTHELLO_WHITE)
+                {
+                    white |= (1ULL<<getSquare(x,y));
+                }
+            }
+        }
+    }
+
+    void OthelloBitboard::toBoard(ushort b[8][8]) const
+    {
+        memset(b,0,sizeof(ushort)*8*8);
+
+        for (ulong mask=black;mask;mask&=(mask-1))
+        {
+            int square = getLowestSquare(mask);
+            b[getSquareX(square)][getSquareY(square)] = OTHELLO_BLACK;
+        }
+        for (ulong mask=white;mask;mask&=(mask-1))
+        {
+            int square = getLowestSquare(mask);
+            b[getSquareX(square)][getSquareY(square)] = OTHELLO_WHITE;
+        }
+
+        OTHELLO_SET_NUM_BLACK_PIECES(b,countSquares(black));
+        OTHELLO_SET_NUM_WHITE_PIECES(b,countSquares(white));
+    }
+
+    ulong OthelloBitboard::makeMove(int square,int color)
+    {
+        ulong flips = OthelloCommon::getFlips(*this,color,square);
+        ulong placed = flips|(1ULL<<square);
+
+        if (color==OTHELLO_BLACK)
+        {
+            black |= placed;
+            white &= ~flips;
+        }
+        else
+        {
+            white |= placed;
+            black &= ~flips;
+        }
+
+        return flips;
+    }
+
+    ulong OthelloCommon::getMoves(const OthelloBitboard &board,int color)
+    {
+        ulong own = board.getPieces(color);
+        ulong opponent = board.getPieces(OTHELLO_BLACK+OTHELLO_WHITE-color);
+        ulong empty = board.getEmpty();
+
+        //Shifting by 8 moves along x, 1 along y and 7 or 9 along the diagonals
+        ulong inner = opponent&OTHELLO_INNER_Y;
+        ulong moves =
+            (fillUp(own,opponent,8)<<8) | (fillDown(own,opponent,8)>>8) |
+            (fillUp(own,inner,1)<<1) | (fillDown(own,inner,1)>>1) |
+            (fillUp(own,inner,7)<<7) | (fillDown(own,inner,7)>>7) |
+            (fillUp(own,inner,9)<<9) | (fillDown(own,inner,9)>>9);
+
+        return moves&empty;
+    }
+
+    ulong OthelloCommon::getFlips(const OthelloBitboard &board,int color,int square)
+    {
+        ulong move = 1ULL<<square;
+        if (!(move&board.getEmpty()))
+        {
+            return 0;
+        }
+
+        ulong own = board.getPieces(color);
+        ulong opponent = board.getPieces(OTHELLO_BLACK+OTHELLO_WHITE-color);
+
+        ulong inner = opponent&OTHELLO_INNER_Y;
+        ulong flips =
+            getLineFlipsUp(move,own,opponent,8) | getLineFlipsDown(move,own,opponent,8) |
+            getLineFlipsUp(move,own,inner,1) | getLineFlipsDown(move,own,inner,1) |
+            getLineFlipsUp(move,own,inner,7) | getLineFlipsDown(move,own,inner,7) |
+            getLineFlipsUp(move,own,inner,9) | getLineFlipsDown(move,own,inner,9);
+
+        return flips;
+    }
+
+    bool OthelloCommon::hasAnyMove(const OthelloBitboard &board)
+    {
+        return (getMoves(board,OTHELLO_BLACK)|getMoves(board,OTHELLO_WHITE))!=0;
+    }
+
+    int OthelloCommon::getWinner(const OthelloBitboard &board)
+    {
+        int blackPieces = OthelloBitboard::countSquares(board.black);
+        int whitePieces = OthelloBitboard::countSquares(board.white);
+
+        if (!blackPieces)
+        {
+            return OTHELLO_WHITE;
+        }
+        else if (!whitePieces)
+        {
+            return OTHELLO_BLACK;
+        }
+        else if (hasAnyMove(board))
+        {
+            //Game is still ongoing
+            return OTHELLO_END_UNKNOWN;
+        }
+        else if (blackPieces<whitePieces)
+        {
+            return OTHELLO_WHITE;
+        }
+        else if (blackPieces>whitePieces)
+        {
+            return OTHELLO_BLACK;
+        }
+        else
+        {
+            return OTHELLO_END_TIE;
+        }
+    }
+
+    OthelloMove OthelloCommon::getOthelloMove(const OthelloBitboard &board,int color,int square)
+    {
+        OthelloMove move(
+            Vector2<uchar>(OthelloBitboard::getSquareX(square),OthelloBitboard::getSquareY(square)),
+            color
+        );
+
+        int pieceFlipIndex=0;
+        for (ulong flips=getFlips(board,color,square);flips;flips&=(flips-1))
+        {
+            int flipSquare = OthelloBitboard::getLowestSquare(flips);
+            move.piecesFlipped[pieceFlipIndex++] = Vector2<uchar>(
+                OthelloBitboard::getSquareX(flipSquare),
+                OthelloBitboard::getSquareY(flipSquare)
+            );
+        }
+
+        return move;
+    }
+
+    ulong OthelloCommon::perft(const OthelloBitboard &board,int color,int depth)
+    {
+        if (depth==0)
+        {
+            return 1;
+        }
+
+        int otherColor = OTHELLO_BLACK+OTHELLO_WHITE-color;
+
+        ulong moves = getMoves(board,color);
+        if (!moves)
+        {
+            if (!getMoves(board,otherColor))
+            {
+                //Game over
+                return 1;
+            }
+
+            //Pass
+            return perft(board,otherColor,depth-1);
+        }
+
+        ulong nodes=0;
+        for (;moves;moves&=(moves-1))
+        {
+            OthelloBitboard child = board;
+            child.makeMove(OthelloBitboard::getLowestSquare(moves),color);
+            nodes += perft(child,otherColor,depth-1);
+        }
+
+        return nodes;
+    }
 }
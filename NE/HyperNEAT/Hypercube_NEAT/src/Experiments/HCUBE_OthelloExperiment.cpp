@@ -30,6 +30,9 @@
 
 #define DEBUG_USE_DELTAS (0)
 
+//Searches shallower than this stay on one thread, starting the threads would cost more
+#define PARALLEL_SEARCH_MIN_DEPTH (4)
+
 namespace HCUBE
 {
 	extern ofstream *outfile;
@@ -40,7 +43,9 @@ namespace HCUBE
 	Experiment(_experimentName,_threadID),
 		currentSubstrateIndex(0),
 		DEBUG_USE_HANDCODED_EVALUATION(0),
-		DEBUG_USE_HYPERNEAT_EVALUATION(0)
+		DEBUG_USE_HYPERNEAT_EVALUATION(0),
+		searchHelpersOwner(NULL),
+		numSearchThreads(0)
 	{
 		numNodesX[0] = numNodesY[0] = 8;
 		numNodesX[1] = numNodesY[1] = 8;
@@ -249,6 +254,16 @@ namespace HCUBE
 #if OTHELLO_EXPERIMENT_ENABLE_BIASES
 		delete[] nodeBiases;
 #endif
+
+		//Both substrates are generated with the same layout
+		for (int y=0;y<numNodesY[0];y++)
+		{
+			for (int x=0;x<numNodesX[0];x++)
+			{
+				boardInputHandles[y][x] = substrate->resolve(nameLookup[Node(x,y,0)]);
+			}
+		}
+		boardOutputHandle = substrate->resolve(nameLookup[Node(0,0,2)]);
 	}
 
 	inline OthelloNEATDatatype convertOutputToWeight(OthelloNEATDatatype output)
@@ -293,6 +308,36 @@ namespace HCUBE
 
 		NEAT::FastNetwork<OthelloNEATDatatype> network = individual->spawnFastPhenotypeStack<OthelloNEATDatatype>();
 
+		NEAT::NodeHandle x1Handle = network.resolve("X1");
+		NEAT::NodeHandle y1Handle = network.resolve("Y1");
+		NEAT::NodeHandle x2Handle = network.resolve("X2");
+		NEAT::NodeHandle y2Handle = network.resolve("Y2");
+		NEAT::NodeHandle deltaXHandle = network.resolve("DeltaX");
+		NEAT::NodeHandle deltaYHandle = network.resolve("DeltaY");
+		NEAT::NodeHandle biasHandle = network.resolve("Bias");
+		NEAT::NodeHandle outputABHandle = network.resolve("Output_ab");
+		NEAT::NodeHandle outputBCHandle = network.resolve("Output_bc");
+#if DEBUG_DIRECT_LINKS
+		NEAT::NodeHandle outputACHandle = network.resolve("Output_ac");
+		if (!outputACHandle.isValid())
+		{
+			throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Could not find node named Output_ac\n");
+		}
+#endif
+
+		if (
+			!x1Handle.isValid() || !y1Handle.isValid() || !biasHandle.isValid() ||
+			!outputABHandle.isValid() || !outputBCHandle.isValid()
+			)
+		{
+			throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: The CPPN is missing an input or output node!\n");
+		}
+
+		if (!deltaXHandle.isValid())
+		{
+			throw CREATE_LOCATEDEXCEPTION_INFO("THIS NETWORK HAS NO DELTAS BY ACCIDENT!\n");
+		}
+
 		int linkCounter=0;
 
 #if OTHELLO_EXPERIMENT_DEBUG
@@ -351,39 +396,32 @@ namespace HCUBE
 								}
 
 								network.reinitialize();
-								network.setValue("X1",x1normal);
-								network.setValue("Y1",y1normal);
-								if (network.hasNode("X2"))
+								network.setValue(x1Handle,x1normal);
+								network.setValue(y1Handle,y1normal);
+								if (x2Handle.isValid())
 								{
-									network.setValue("X2",x2normal);
-									network.setValue("Y2",y2normal);
+									network.setValue(x2Handle,x2normal);
+									network.setValue(y2Handle,y2normal);
 								}
-								if (network.hasNode("DeltaX"))
-								{
-									network.setValue("DeltaX",x2normal-x1normal);
-									network.setValue("DeltaY",y2normal-y1normal);
-								}
-								else
-								{
-									throw CREATE_LOCATEDEXCEPTION_INFO("THIS NETWORK HAS NO DELTAS BY ACCIDENT!\n");
-								}
-								network.setValue("Bias",(OthelloNEATDatatype)0.3);
+								network.setValue(deltaXHandle,x2normal-x1normal);
+								network.setValue(deltaYHandle,y2normal-y1normal);
+								network.setValue(biasHandle,(OthelloNEATDatatype)0.3);
 								network.update();
 
 								OthelloNEATDatatype output;
 
 								if (z1==0 && z2==1)
 								{
-									output = network.getValue("Output_ab");
+									output = network.getValue(outputABHandle);
 								}
 								else if (z1==1 && z2==2)
 								{
-									output = network.getValue("Output_bc");
+									output = network.getValue(outputBCHandle);
 								}
 								else if (z1==0 && z2==2)
 								{
 #if DEBUG_DIRECT_LINKS
-									output = network.getValue("Output_ac");
+									output = network.getValue(outputACHandle);
 #else
 									output = 0;
 #endif
@@ -749,11 +787,11 @@ namespace HCUBE
 
 					if ( OTHELLO_GET_PIECE(b[boardx][boardy]) == OTHELLO_WHITE )
 					{
-						substrate->setValue( getNameFromNode(Node(x,y,0)) , -1.0 );
+						substrate->setValue( boardInputHandles[y][x] , -1.0 );
 					}
 					else if ( OTHELLO_GET_PIECE(b[boardx][boardy]) == OTHELLO_BLACK )
 					{
-						substrate->setValue( getNameFromNode(Node(x,y,0)) , 1.0 );
+						substrate->setValue( boardInputHandles[y][x] , 1.0 );
 					}
 					else
 					{
@@ -766,7 +804,7 @@ namespace HCUBE
 
 			substrate->update();
 			substrate->update();
-			output = substrate->getValue(getNameFromNode(Node(0,0,2)));
+			output = substrate->getValue(boardOutputHandle);
 
 #if OTHELLO_EXPERIMENT_PRINT_BOARD_RATINGS
 			printBoard(b);
@@ -912,55 +950,205 @@ namespace HCUBE
 		{}
 	};
 
-	OthelloNEATDatatype OthelloExperiment::evaluatemax(ushort b[8][8],  OthelloNEATDatatype parentBeta, int depth,int maxDepth)
+	/**
+	 * OthelloRootSearch: Hands the root moves of a parallel search out to the search
+	 * threads one at a time
+	 */
+	class OthelloRootSearch
 	{
-		if (depth==0)
+		const vector<OthelloBitboard> &children;
+
+		OthelloNEATDatatype *results;
+
+		int childColor;
+
+		OthelloNEATDatatype bound;
+
+		int maxDepth;
+
+		boost::mutex queueMutex;
+
+		int nextChild;
+
+		string error;
+
+	public:
+		OthelloRootSearch(
+			const vector<OthelloBitboard> &_children,
+			OthelloNEATDatatype *_results,
+			int _childColor,
+			OthelloNEATDatatype _bound,
+			int _maxDepth
+			)
+			:
+		children(_children),
+			results(_results),
+			childColor(_childColor),
+			bound(_bound),
+			maxDepth(_maxDepth),
+			nextChild(0)
+		{}
+
+		void run(OthelloExperiment *experiment)
 		{
-			totalNumMoves=0;
-#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
-			cout << "Creating new outfile\n";
-			if (outfile) delete outfile;
-			outfile = new ofstream("BoardEvaluations.txt");
-#endif
+			while (true)
+			{
+				int childIndex;
+				{
+					boost::mutex::scoped_lock lock(queueMutex);
+					if (nextChild>=(int)children.size() || error.length())
+					{
+						return;
+					}
+					childIndex = nextChild++;
+				}
+
+				try
+				{
+					if (childColor==OTHELLO_WHITE)
+					{
+						results[childIndex] = experiment->evaluatemin(children[childIndex],bound,1,maxDepth);
+					}
+					else
+					{
+						results[childIndex] = experiment->evaluatemax(children[childIndex],bound,1,maxDepth);
+					}
+				}
+				catch (const std::exception &ex)
+				{
+					boost::mutex::scoped_lock lock(queueMutex);
+					if (!error.length())
+					{
+						error = ex.what();
+					}
+					return;
+				}
+			}
 		}
-#if DEBUG_BOARD_CACHE
-		OthelloBoardState boardState(b,OTHELLO_BLACK,depth);
-		if (depth==0)
+
+		inline const string &getError()
 		{
-			boardStateCache.clear();
+			return error;
 		}
-		else
+	};
+
+	int OthelloExperiment::getSearchThreadCount()
+	{
+		if (!numSearchThreads)
 		{
-			OthelloBoardStateMap::iterator bsIterator = boardStateCache.find(boardState);
+			NEAT::Globals *globals = NEAT::Globals::getSingleton();
+			if (globals->hasParameterValue("SearchThreads"))
+			{
+				numSearchThreads = globals->getThreadCount("SearchThreads");
+			}
+			else
+			{
+				numSearchThreads = 1;
+			}
+		}
+		return numSearchThreads;
+	}
 
-			if (bsIterator!=boardStateCache.end())
+	void OthelloExperiment::searchRootMoves(
+		const OthelloBitboard &board,
+		ulong moves,
+		int color,
+		OthelloNEATDatatype bound,
+		int maxDepth,
+		OthelloNEATDatatype *results
+		)
+	{
+		if (searchHelpersOwner!=this)
+		{
+			searchHelpers.clear();
+			searchHelpersOwner = this;
+		}
+		searchHelpers.resize(getSearchThreadCount()-1);
+
+		for (int a=0;a<(int)searchHelpers.size();a++)
+		{
+			if (!searchHelpers[a])
 			{
-				//cout << "CACHE HIT, BAILING\n";
-				//This board has already been explored before, treat this as a loss
-				if (bsIterator->second>parentBeta)
-				{
-					//This will be worse than the last time this state was seen.  Don't bother.
-					return INT_MIN/2;
-				}
+				OthelloExperiment *helper = (OthelloExperiment*)clone();
+				helper->searchHelpers.clear();
+				helper->searchHelpersOwner = helper;
+				searchHelpers[a].reset(helper);
 			}
 
-			if (boardStateCache.size()<10000)
+			//Copying the networks is much cheaper than cloning the move list again
+			OthelloExperiment *helper = searchHelpers[a].get();
+			for (int b=0;b<2;b++)
 			{
-				boardStateCache.insert(boardState,parentBeta);
+				if (helper->substrateIndividuals[b]!=substrateIndividuals[b])
+				{
+					helper->substrates[b] = substrates[b];
+					helper->substrateIndividuals[b] = substrateIndividuals[b];
+					helper->boardEvaluationCache.clear();
+				}
 			}
+			helper->currentSubstrateIndex = currentSubstrateIndex;
+			helper->handCodedType = handCodedType;
+			helper->handCodedDepth = handCodedDepth;
+			helper->DEBUG_USE_HANDCODED_EVALUATION = DEBUG_USE_HANDCODED_EVALUATION;
+			helper->DEBUG_USE_HYPERNEAT_EVALUATION = DEBUG_USE_HYPERNEAT_EVALUATION;
+			helper->randomMoveChance = 0;
 		}
-#endif
 
-		int newMoveStart = totalNumMoves;
+		vector<OthelloBitboard> children;
+		for (;moves;moves&=(moves-1))
+		{
+			children.push_back(board);
+			children.back().makeMove(OthelloBitboard::getLowestSquare(moves),color);
+		}
 
-		OthelloMove *moveList = &totalMoveList[newMoveStart];
-		int moveListCount;
+		OthelloRootSearch search(
+			children,
+			results,
+			(color==OTHELLO_BLACK) ? OTHELLO_WHITE : OTHELLO_BLACK,
+			bound,
+			maxDepth
+			);
 
-		OthelloNEATDatatype alpha=OthelloNEATDatatype(INT_MIN);
+		boost::thread_group threads;
+		for (int a=0;a<(int)searchHelpers.size();a++)
+		{
+			threads.create_thread(boost::bind(&OthelloRootSearch::run,&search,searchHelpers[a].get()));
+		}
+		search.run(this);
+		threads.join_all();
+
+		if (search.getError().length())
+		{
+			throw CREATE_LOCATEDEXCEPTION_INFO(search.getError());
+		}
+	}
+
+	OthelloNEATDatatype OthelloExperiment::evaluatemax(ushort b[8][8],  OthelloNEATDatatype parentBeta, int depth,int maxDepth)
+	{
+		return evaluatemax(OthelloBitboard(b),parentBeta,depth,maxDepth);
+	}
+
+	OthelloNEATDatatype OthelloExperiment::evaluatemin(ushort b[8][8],  OthelloNEATDatatype parentAlpha, int depth,int maxDepth)
+	{
+		return evaluatemin(OthelloBitboard(b),parentAlpha,depth,maxDepth);
+	}
+
+	OthelloNEATDatatype OthelloExperiment::evaluatemax(const OthelloBitboard &board,  OthelloNEATDatatype parentBeta, int depth,int maxDepth)
+	{
+#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
+		if (depth==0)
+		{
+			cout << "Creating new outfile\n";
+			if (outfile) delete outfile;
+			outfile = new ofstream("BoardEvaluations.txt");
+		}
+#endif
 
-		int bestMoveSoFarIndex=-1;
+		//The moves come out of the mask in the order generateMoveList(...) lists them
+		ulong moves = getMoves(board,OTHELLO_BLACK);
+		int moveListCount = OthelloBitboard::countSquares(moves);
 
-		moveListCount = generateMoveList(b,moveList,OTHELLO_BLACK);
+		OthelloNEATDatatype alpha=OthelloNEATDatatype(INT_MIN);
 
 		if (!moveListCount)
 		{
@@ -971,7 +1159,7 @@ namespace HCUBE
 		if (depth==0 && moveListCount==1)
 		{
 			//Forced move, don't bother doing any evaluations
-			moveToMake = moveList[0];
+			moveToMake = getOthelloMove(board,OTHELLO_BLACK,OthelloBitboard::getLowestSquare(moves));
 			return 0;
 		}
 
@@ -985,17 +1173,28 @@ namespace HCUBE
 				int randomMove =
 					NEAT::Globals::getSingleton()->getRandom().getRandomWithinRange(0,moveListCount-1);
 
-				moveToMake = moveList[randomMove];
+				ulong randomMoves = moves;
+				for (int a=0;a<randomMove;a++)
+				{
+					randomMoves &= (randomMoves-1);
+				}
+
+				moveToMake = getOthelloMove(board,OTHELLO_BLACK,OthelloBitboard::getLowestSquare(randomMoves));
 				return 0;
 			}
 		}
 
 #if OTHELLO_EXPERIMENT_DEBUG
-		printBoard(b);
+		{
+			ushort b[8][8];
+			board.toBoard(b);
+			printBoard(b);
+		}
 		cout << "Moves for black: " << endl;
-		for (int a=0;a<moveListCount;a++)
+		for (ulong debugMoves=moves;debugMoves;debugMoves&=(debugMoves-1))
 		{
-			cout << "MOVE: (" << (int)moveList[a].position.x << ',' << (int)moveList[a].position.y << ")" << endl;
+			int square = OthelloBitboard::getLowestSquare(debugMoves);
+			cout << "MOVE: (" << OthelloBitboard::getSquareX(square) << ',' << OthelloBitboard::getSquareY(square) << ")" << endl;
 		}
 		CREATE_PAUSE("Done listing moves");
 #endif
@@ -1003,37 +1202,54 @@ namespace HCUBE
 		if (depth==maxDepth)
 		{
 			//This is a leaf node, return the neural network's evaluation
+			ushort b[8][8];
+			board.toBoard(b);
 			return evaluateLeafBlack(b);
 		}
 
 		OthelloNEATDatatype childBeta;
 
-		totalNumMoves+=moveListCount;
+		//At the root, the moves after the first can be searched on other threads against
+		//the bound the first move leaves.  The loop below goes over their results in order,
+		//so it picks the same move a serial search would.
+		bool searchRootInParallel =
+			depth==0 &&
+			moveListCount>2 &&
+			maxDepth>=PARALLEL_SEARCH_MIN_DEPTH &&
+			getSearchThreadCount()>1;
+		vector<OthelloNEATDatatype> rootResults;
 
-		if (totalNumMoves >= MAX_TOTAL_MOVES)
+		for (int a=0;moves;moves&=(moves-1),a++)
 		{
-			CREATE_PAUSE("Shit! I blew my move stack!");
-		}
+			int square = OthelloBitboard::getLowestSquare(moves);
 
-		for (int a=0;a<moveListCount;a++)
-		{
-			makeMove(moveList[a],b);
+			OthelloBitboard childBoard = board;
+			childBoard.makeMove(square,OTHELLO_BLACK);
 
-			int winner = getWinner(b);
+			int winner = getWinner(childBoard);
 
 			if (winner==OTHELLO_BLACK)
 			{
 				//CREATE_PAUSE("FOUND WIN FOR BLACK!");
-				reverseMove(moveList[a],b);
-
 				if (depth==0)
-					moveToMake = moveList[a];
+					moveToMake = getOthelloMove(board,OTHELLO_BLACK,square);
 
 				return OthelloNEATDatatype(INT_MAX/2);
 			}
 
-			childBeta = evaluatemin(b,alpha,depth+1,maxDepth);
-			reverseMove(moveList[a],b);
+			if (searchRootInParallel && a>0)
+			{
+				if (a==1)
+				{
+					rootResults.resize(moveListCount-1);
+					searchRootMoves(board,moves,OTHELLO_BLACK,alpha,maxDepth,&rootResults[0]);
+				}
+				childBeta = rootResults[a-1];
+			}
+			else
+			{
+				childBeta = evaluatemin(childBoard,alpha,depth+1,maxDepth);
+			}
 
 #if OTHELLO_EXPERIMENT_DEBUG
 			for (int dd=0;dd<depth;dd++)
@@ -1049,16 +1265,15 @@ namespace HCUBE
 				cout << "Found new alpha\n";
 #endif
 				alpha = childBeta;
-				bestMoveSoFarIndex = a;
 				if (depth==0)
 				{
 					//This means that this is the root max, so store the best move.
+					moveToMake = getOthelloMove(board,OTHELLO_BLACK,square);
+
 #if OTHELLO_EXPERIMENT_DEBUG
-					cout << "BLACK: MOVE_TO_MAKE: (" << moveList[a].position.x << ',' << moveList[a].position.y << ")" << endl;
+					cout << "BLACK: MOVE_TO_MAKE: (" << (int)moveToMake.position.x << ',' << (int)moveToMake.position.y << ")" << endl;
 					CREATE_PAUSE("SETTING MOVE_TO_MAKE");
 #endif
-
-					moveToMake = moveList[a];
 				}
 				else
 				{
@@ -1069,128 +1284,12 @@ namespace HCUBE
 						CREATE_PAUSE("");
 #endif
 						//parent will never choose this alpha
-						totalNumMoves-=moveListCount;
-
-#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
-						//cout << "Printing board leaf evaluations\n";
-						if (depth<=2)
-						{
-							*outfile << "Depth: " << depth << endl;
-							for (int y=0;y<8;y++)
-							{
-								for (int x=7;x>=0;x--)
-								{
-									if (b[x][y]&FREE)
-									{
-										*outfile << " ";
-									}
-									else if (b[x][y]&BLACK)
-									{
-										if (b[x][y]&MAN)
-										{
-											*outfile << "b";
-										}
-										else
-										{
-											*outfile << "B";
-										}
-									}
-									else if (b[x][y]&WHITE)
-									{
-										if (b[x][y]&MAN)
-										{
-											*outfile << "w";
-										}
-										else
-										{
-											*outfile << "W";
-										}
-									}
-									else
-									{
-										*outfile << "_";
-									}
-								}
-								*outfile << endl;
-							}
-							*outfile << "BEST MOVE FOR BLACK: " << (int)moveList[a].from.x << ',' << (int)moveList[a].from.y << " to "
-								<< (int)moveList[a].getFinalDestination().x << ',' << (int)moveList[a].getFinalDestination().y << endl;
-							*outfile << endl;
-						}
-#endif
-#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
-						if (depth==0)
-						{
-							cout << __LINE__ << " Closing outfile handle\n";
-							if (outfile)
-							{
-								outfile->close();
-								delete outfile;
-							}
-							outfile = NULL;
-						}
-#endif
 						return alpha;
 					}
 				}
 			}
 		}
 
-		totalNumMoves-=moveListCount;
-#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
-		//cout << "Printing board leaf evaluations\n";
-		if (depth<=2)
-		{
-			*outfile << "Depth: " << depth << endl;
-			for (int y=0;y<8;y++)
-			{
-				for (int x=7;x>=0;x--)
-				{
-					if (b[x][y]&FREE)
-					{
-						*outfile << " ";
-					}
-					else if (b[x][y]&BLACK)
-					{
-						if (b[x][y]&MAN)
-						{
-							*outfile << "b";
-						}
-						else
-						{
-							*outfile << "B";
-						}
-					}
-					else if (b[x][y]&WHITE)
-					{
-						if (b[x][y]&MAN)
-						{
-							*outfile << "w";
-						}
-						else
-						{
-							*outfile << "W";
-						}
-					}
-					else
-					{
-						*outfile << "_";
-					}
-				}
-				*outfile << endl;
-			}
-			if (bestMoveSoFarIndex!=-1)
-			{
-				*outfile << "BEST MOVE FOR BLACK: " << (int)moveList[bestMoveSoFarIndex].from.x << ',' << (int)moveList[bestMoveSoFarIndex].from.y << " to "
-					<< (int)moveList[bestMoveSoFarIndex].getFinalDestination().x << ',' << (int)moveList[bestMoveSoFarIndex].getFinalDestination().y << endl;
-				*outfile << endl;
-			}
-			else
-			{
-				*outfile << "NO MOVES FOUND (OR WILL NEVER GET TO THIS PART OF THE GAME TREE)\n";
-			}
-		}
-#endif
 #if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
 		if (depth==0)
 		{
@@ -1206,49 +1305,13 @@ namespace HCUBE
 		return alpha;
 	}
 
-	OthelloNEATDatatype OthelloExperiment::evaluatemin(ushort b[8][8],  OthelloNEATDatatype parentAlpha, int depth,int maxDepth)
+	OthelloNEATDatatype OthelloExperiment::evaluatemin(const OthelloBitboard &board,  OthelloNEATDatatype parentAlpha, int depth,int maxDepth)
 	{
-		if (depth==0)
-		{
-			totalNumMoves=0;
-		}
-#if DEBUG_BOARD_CACHE
-		OthelloBoardState boardState(b,OTHELLO_WHITE,depth);
-		if (depth==0)
-		{
-			boardStateCache.clear();
-		}
-		else
-		{
-			OthelloBoardStateMap::iterator bsIterator = boardStateCache.find(boardState);
-
-			if (bsIterator!=boardStateCache.end())
-			{
-				//cout << "CACHE HIT, BAILING\n";
-				//This board has already been explored before, treat this as a loss
-				if (bsIterator->second<parentAlpha)
-				{
-					//This will be a subset of the moves seen previously.  Ignore
-					return (OthelloNEATDatatype)INT_MAX/2;
-				}
-			}
-
-			boardStateCache.insert(boardState,parentAlpha);
-		}
-#endif
-
-
-		int newMoveStart = totalNumMoves;
-
-		OthelloMove *moveList = &totalMoveList[newMoveStart];
-		int moveListCount;
+		ulong moves = getMoves(board,OTHELLO_WHITE);
+		int moveListCount = OthelloBitboard::countSquares(moves);
 
 		OthelloNEATDatatype beta=OthelloNEATDatatype(INT_MAX);
 
-		int bestMoveSoFarIndex=-1;
-
-		moveListCount = generateMoveList(b,moveList,OTHELLO_WHITE);
-
 		if (!moveListCount)
 		{
 			/*NOTE:
@@ -1264,7 +1327,7 @@ namespace HCUBE
 		if (depth==0 && moveListCount==1)
 		{
 			//Forced move, don't bother doing any evaluations
-			moveToMake = moveList[0];
+			moveToMake = getOthelloMove(board,OTHELLO_WHITE,OthelloBitboard::getLowestSquare(moves));
 			return 0;
 		}
 
@@ -1278,17 +1341,28 @@ namespace HCUBE
 				int randomMove =
 					NEAT::Globals::getSingleton()->getRandom().getRandomWithinRange(0,moveListCount-1);
 
-				moveToMake = moveList[randomMove];
+				ulong randomMoves = moves;
+				for (int a=0;a<randomMove;a++)
+				{
+					randomMoves &= (randomMoves-1);
+				}
+
+				moveToMake = getOthelloMove(board,OTHELLO_WHITE,OthelloBitboard::getLowestSquare(randomMoves));
 				return 0;
 			}
 		}
 
 #if OTHELLO_EXPERIMENT_DEBUG
-		printBoard(b);
+		{
+			ushort b[8][8];
+			board.toBoard(b);
+			printBoard(b);
+		}
 		cout << "Moves for white: " << endl;
-		for (int a=0;a<moveListCount;a++)
+		for (ulong debugMoves=moves;debugMoves;debugMoves&=(debugMoves-1))
 		{
-			cout << "MOVE: (" << (int)moveList[a].position.x << ',' << (int)moveList[a].position.y << ")\n";
+			int square = OthelloBitboard::getLowestSquare(debugMoves);
+			cout << "MOVE: (" << OthelloBitboard::getSquareX(square) << ',' << OthelloBitboard::getSquareY(square) << ")\n";
 		}
 		CREATE_PAUSE("Done listing moves");
 #endif
@@ -1296,37 +1370,51 @@ namespace HCUBE
 		if (depth==maxDepth)
 		{
 			//This is a leaf node, return the hand coded evaluation
+			ushort b[8][8];
+			board.toBoard(b);
 			return evaluateLeafWhite(b);
 		}
 
 		OthelloNEATDatatype childAlpha;
 
-		totalNumMoves+=moveListCount;
+		bool searchRootInParallel =
+			depth==0 &&
+			moveListCount>2 &&
+			maxDepth>=PARALLEL_SEARCH_MIN_DEPTH &&
+			getSearchThreadCount()>1;
+		vector<OthelloNEATDatatype> rootResults;
 
-		if (totalNumMoves >= MAX_TOTAL_MOVES)
+		for (int a=0;moves;moves&=(moves-1),a++)
 		{
-			CREATE_PAUSE("Shit! I blew my move stack!");
-		}
+			int square = OthelloBitboard::getLowestSquare(moves);
 
-		for (int a=0;a<moveListCount;a++)
-		{
-			makeMove(moveList[a],b);
+			OthelloBitboard childBoard = board;
+			childBoard.makeMove(square,OTHELLO_WHITE);
 
-			int winner = getWinner(b);
+			int winner = getWinner(childBoard);
 
 			if (winner==OTHELLO_WHITE)
 			{
 				//CREATE_PAUSE("FOUND WIN FOR WHITE!");
-				reverseMove(moveList[a],b);
-
 				if (depth==0)
-					moveToMake = moveList[a];
+					moveToMake = getOthelloMove(board,OTHELLO_WHITE,square);
 
 				return (OthelloNEATDatatype)INT_MIN/2;
 			}
 
-			childAlpha = evaluatemax(b,beta,depth+1,maxDepth);
-			reverseMove(moveList[a],b);
+			if (searchRootInParallel && a>0)
+			{
+				if (a==1)
+				{
+					rootResults.resize(moveListCount-1);
+					searchRootMoves(board,moves,OTHELLO_WHITE,beta,maxDepth,&rootResults[0]);
+				}
+				childAlpha = rootResults[a-1];
+			}
+			else
+			{
+				childAlpha = evaluatemax(childBoard,beta,depth+1,maxDepth);
+			}
 
 			if (childAlpha < beta)
 			{
@@ -1334,144 +1422,28 @@ namespace HCUBE
 				cout << "Found new beta\n";
 #endif
 				beta = childAlpha;
-				bestMoveSoFarIndex = a;
 
 				if (depth==0)
 				{
 					//This means that this is the root max, so store the best move.
+					moveToMake = getOthelloMove(board,OTHELLO_WHITE,square);
+
 #if OTHELLO_EXPERIMENT_DEBUG
-					cout << "WHITE: MOVE_TO_MAKE: (" << moveList[a].position.x << ',' << moveList[a].position.y << ")\n";
+					cout << "WHITE: MOVE_TO_MAKE: (" << (int)moveToMake.position.x << ',' << (int)moveToMake.position.y << ")\n";
 					CREATE_PAUSE("SETTING MOVE_TO_MAKE");
 #endif
-
-					moveToMake = moveList[a];
 				}
 				else
 				{
 					if (parentAlpha >= beta)
 					{
 						//parent will never choose this beta
-						totalNumMoves-=moveListCount;
-#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
-						if (depth<=2)
-						{
-							*outfile << "Depth: " << depth << endl;
-							//cout << "Printing board leaf evaluations\n";
-							for (int y=0;y<8;y++)
-							{
-								for (int x=7;x>=0;x--)
-								{
-									if (b[x][y]&FREE)
-									{
-										*outfile << " ";
-									}
-									else if (b[x][y]&BLACK)
-									{
-										if (b[x][y]&MAN)
-										{
-											*outfile << "b";
-										}
-										else
-										{
-											*outfile << "B";
-										}
-									}
-									else if (b[x][y]&WHITE)
-									{
-										if (b[x][y]&MAN)
-										{
-											*outfile << "w";
-										}
-										else
-										{
-											*outfile << "W";
-										}
-									}
-									else
-									{
-										*outfile << "_";
-									}
-								}
-								*outfile << endl;
-							}
-							if (bestMoveSoFarIndex!=-1)
-							{
-								*outfile << "BEST MOVE FOR WHITE: " << (int)moveList[bestMoveSoFarIndex].from.x << ',' << (int)moveList[bestMoveSoFarIndex].from.y << " to "
-									<< (int)moveList[bestMoveSoFarIndex].getFinalDestination().x << ',' << (int)moveList[bestMoveSoFarIndex].getFinalDestination().y << endl;
-								*outfile << endl;
-							}
-							else
-							{
-								*outfile << "NO MOVES FOUND (OR WILL NEVER GET TO THIS PART OF THE GAME TREE)\n";
-							}
-						}
-#endif
 						return beta;
 					}
 				}
 			}
 		}
 
-		if (depth==0 && moveListCount==0)
-		{
-			cout << "NO MOVES TO MAKE!!!\n";
-		}
-
-		totalNumMoves-=moveListCount;
-#if DEBUG_DUMP_BOARD_LEAF_EVALUATIONS
-		//cout << "Printing board leaf evaluations\n";
-		if (depth<=2)
-		{
-			*outfile << "Depth: " << depth << endl;
-			for (int y=0;y<8;y++)
-			{
-				for (int x=7;x>=0;x--)
-				{
-					if (b[x][y]&FREE)
-					{
-						*outfile << " ";
-					}
-					else if (b[x][y]&BLACK)
-					{
-						if (b[x][y]&MAN)
-						{
-							*outfile << "b";
-						}
-						else
-						{
-							*outfile << "B";
-						}
-					}
-					else if (b[x][y]&WHITE)
-					{
-						if (b[x][y]&MAN)
-						{
-							*outfile << "w";
-						}
-						else
-						{
-							*outfile << "W";
-						}
-					}
-					else
-					{
-						*outfile << "_";
-					}
-				}
-				*outfile << endl;
-			}
-			if (bestMoveSoFarIndex!=-1)
-			{
-				*outfile << "BEST MOVE FOR WHITE: " << (int)moveList[bestMoveSoFarIndex].from.x << ',' << (int)moveList[bestMoveSoFarIndex].from.y << " to "
-					<< (int)moveList[bestMoveSoFarIndex].getFinalDestination().x << ',' << (int)moveList[bestMoveSoFarIndex].getFinalDestination().y << endl;
-				*outfile << endl;
-			}
-			else
-			{
-				*outfile << "NO MOVES FOUND (OR WILL NEVER GET TO THIS PART OF THE GAME TREE)\n";
-			}
-		}
-#endif
 		return beta;
 	}
 
@@ -5,9 +5,8 @@ namespace HCUBE
 #if defined(_DEBUG) || defined(USE_GPU)
 	int NUM_THREADS = 1;
 #else
-    //Automatically sets to the # of threads.
-	int NUM_THREADS = 1;
-	//int NUM_THREADS = boost::thread::hardware_concurrency();
+    //0 reads the EvaluationThreads parameter when the experiment is set up
+	int NUM_THREADS = 0;
 #endif
 
 	const int EXPERIMENT_BLOCKS_GUI  = 0;
@@ -0,0 +1,188 @@
+#include "HCUBE_Defines.h"
+
+#include "HCUBE_EvaluationPool.h"
+
+namespace HCUBE
+{
+    EvaluationPool::EvaluationPool(int _numThreads)
+        :
+        numThreads(_numThreads),
+        shuttingDown(false),
+        jobNumber(0),
+        jobIndividualCount(0),
+        jobGroupCapacity(1),
+        nextIndividual(0),
+        busyWorkers(0)
+    {
+        for (int a=0;a<numThreads;a++)
+        {
+            threads.create_thread(boost::bind(&EvaluationPool::runWorker,this,a));
+        }
+    }
+
+    EvaluationPool::~EvaluationPool()
+    {
+        {
+            boost::mutex::scoped_lock lock(poolMutex);
+            shuttingDown=true;
+        }
+        workCondition.notify_all();
+        threads.join_all();
+    }
+
+    void EvaluationPool::evaluate(
+        const vector<shared_ptr<Experiment> > &experiments,
+        shared_ptr<NEAT::GeneticGeneration> generation,
+        vector<shared_ptr<NEAT::GeneticIndividual> >::iterator individualIterator,
+        int individualCount
+        )
+    {
+        if ((int)experiments.size()<numThreads)
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Need one experiment per evaluation thread!");
+        }
+
+        boost::mutex::scoped_lock lock(poolMutex);
+
+        jobExperiments.assign(experiments.begin(),experiments.begin()+numThreads);
+        jobGeneration = generation;
+        jobIndividuals = individualIterator;
+        jobIndividualCount = individualCount;
+        jobGroupCapacity = max(1,experiments[0]->getGroupCapacity());
+        nextIndividual = 0;
+        busyWorkers = numThreads;
+        error = string();
+        jobNumber++;
+
+        workCondition.notify_all();
+
+        while (busyWorkers>0)
+        {
+            doneCondition.wait(lock);
+        }
+
+        //Don't hold on to the generation or the experiments between jobs
+        jobExperiments.clear();
+        jobGeneration.reset();
+
+        if (error.length())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(error);
+        }
+    }
+
+    void EvaluationPool::runWorker(int workerIndex)
+    {
+        int lastJobNumber=0;
+
+        while (true)
+        {
+            shared_ptr<Experiment> experiment;
+            shared_ptr<NEAT::GeneticGeneration> generation;
+            vector<shared_ptr<NEAT::GeneticIndividual> >::iterator individualIterator;
+            int individualCount,groupCapacity;
+
+            {
+                boost::mutex::scoped_lock lock(poolMutex);
+                while (!shuttingDown && jobNumber==lastJobNumber)
+                {
+                    workCondition.wait(lock);
+                }
+
+                if (shuttingDown)
+                {
+                    return;
+                }
+
+                lastJobNumber = jobNumber;
+                experiment = jobExperiments[workerIndex];
+                generation = jobGeneration;
+                individualIterator = jobIndividuals;
+                individualCount = jobIndividualCount;
+                groupCapacity = jobGroupCapacity;
+            }
+
+            while (true)
+            {
+                int begin;
+                {
+                    boost::mutex::scoped_lock lock(poolMutex);
+                    if (nextIndividual>=individualCount || error.length())
+                    {
+                        break;
+                    }
+                    begin = nextIndividual;
+                    nextIndividual += groupCapacity;
+                }
+
+                string groupError;
+                try
+                {
+                    processGroup(
+                        experiment,
+                        generation,
+                        individualIterator+begin,
+                        min(groupCapacity,individualCount-begin)
+                        );
+                }
+                catch (string s)
+                {
+                    groupError = s;
+                }
+                catch (const char *s)
+                {
+                    groupError = s;
+                }
+                catch (const std::exception &ex)
+                {
+                    groupError = ex.what();
+                }
+                catch (...)
+                {
+                    groupError = "An unknown exception has occured!";
+                }
+
+                if (groupError.length())
+                {
+                    cout << "CAUGHT ERROR AT " << __FILE__ << " : " << __LINE__ << endl;
+                    boost::mutex::scoped_lock lock(poolMutex);
+                    if (!error.length())
+                    {
+                        error = groupError;
+                    }
+                }
+            }
+
+            {
+                boost::mutex::scoped_lock lock(poolMutex);
+                busyWorkers--;
+                if (busyWorkers==0)
+                {
+                    doneCondition.notify_all();
+                }
+            }
+        }
+    }
+
+    void EvaluationPool::processGroup(
+        shared_ptr<Experiment> experiment,
+        shared_ptr<NEAT::GeneticGeneration> generation,
+        vector<shared_ptr<NEAT::GeneticIndividual> >::iterator individualIterator,
+        int individualCount
+        )
+    {
+        for (int a=0;a<individualCount;a++,individualIterator++)
+        {
+            experiment->addIndividualToGroup(*individualIterator);
+        }
+
+        if (experiment->getGroupSize()!=experiment->getGroupCapacity())
+        {
+            experiment->clearGroup();
+            throw CREATE_LOCATEDEXCEPTION_INFO("Error, individuals were left over after run finished!");
+        }
+
+        experiment->processGroup(generation);
+        experiment->clearGroup();
+    }
+}
@@ -57,6 +57,9 @@
 #endif
 
 #include "HCUBE_EvaluationSet.h"
+#include "HCUBE_EvaluationPool.h"
+
+#include "NEAT_IndexedPopulationFile.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/archive/binary_oarchive.hpp>
@@ -66,6 +69,8 @@
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/copy.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 
 namespace HCUBE
 {
@@ -74,6 +79,7 @@ namespace HCUBE
         running(false),
         started(false),
         cleanup(false),
+        numEvaluationThreads(1),
         populationMutex(new mutex()),
         frame(NULL)
     {
@@ -95,7 +101,32 @@ namespace HCUBE
 
         cout << "SETTING UP EXPERIMENT TYPE: " << experimentType << endl;
 
-        for(int a=0;a<NUM_THREADS;a++)
+        numEvaluationThreads = NUM_THREADS;
+        if (numEvaluationThreads<=0)
+        {
+            //Without an EvaluationThreads parameter, stay on one thread like before
+            NEAT::Globals *globals = NEAT::Globals::getSingleton();
+            if (globals->hasParameterValue("EvaluationThreads"))
+            {
+                numEvaluationThreads = globals->getThreadCount("EvaluationThreads");
+            }
+            else
+            {
+                numEvaluationThreads = 1;
+            }
+        }
+        if (experimentType==EXPERIMENT_ATARI_HYBRID && numEvaluationThreads!=1)
+        {
+            //The hybrid list holds a HyperNEAT and an FT-NEAT experiment, and
+            //setActiveExperiment(...) swaps only the first two
+            cout << "Hybrid experiments evaluate on one thread, ignoring " << numEvaluationThreads << endl;
+            numEvaluationThreads = 1;
+        }
+        evaluationPool.reset();
+
+        cout << "EVALUATION THREADS: " << numEvaluationThreads << endl;
+
+        for(int a=0;a<numEvaluationThreads;a++)
         {
             switch (experimentType)
             {
@@ -365,23 +396,63 @@ namespace HCUBE
     }
 
     void ExperimentRun::loadPopulationBoost(string filename) {
-        population = shared_ptr<NEAT::GeneticPopulation>(new NEAT::GeneticPopulation());
+        if (NEAT::IndexedPopulationFile::isIndexedPopulationFile(filename)) {
+            NEAT::IndexedPopulationFile indexedFile(filename);
+            deserializePopulationBoost(indexedFile.getArchiveData(),indexedFile.getArchiveSize());
+            return;
+        }
+
         std::ifstream ifs(filename.c_str(), std::ios::in|std::ios::binary);
         assert(ifs.good());
-        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-        in.push(boost::iostreams::gzip_decompressor());
-        in.push(ifs);
-        boost::archive::binary_iarchive ia(in);
-        ia >> (*population);
+        string archive((std::istreambuf_iterator<char>(ifs)),std::istreambuf_iterator<char>());
+        deserializePopulationBoost(archive.data(),archive.size());
     }
 
     void ExperimentRun::savePopulationBoost(string filename) {
+        string archive = serializePopulationBoost();
         std::ofstream ofs(filename.c_str(),std::ios::out|std::ios::binary|std::ios::trunc);
-        boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
-        out.push(boost::iostreams::gzip_compressor());
-        out.push(ofs);
-        boost::archive::binary_oarchive oa(out);
-        oa << *population;
+        ofs.write(archive.data(),archive.size());
+    }
+
+    void ExperimentRun::savePopulationIndexed(string filename) {
+        shared_ptr<NEAT::GeneticGeneration> generation = population->getGeneration();
+        vector<shared_ptr<NEAT::GeneticIndividual> > individuals;
+        for (int a=0;a<generation->getIndividualCount();a++) {
+            individuals.push_back(generation->getIndividual(a));
+        }
+        NEAT::IndexedPopulationFile::write(
+            filename,
+            individuals,
+            population->getGenerationCount()-1,
+            serializePopulationBoost()
+            );
+    }
+
+    shared_ptr<NEAT::GeneticIndividual> ExperimentRun::loadIndividualIndexed(string filename,int individualId) {
+        NEAT::IndexedPopulationFile indexedFile(filename);
+        indexedFile.loadParameters();
+        return indexedFile.getIndividual(individualId);
+    }
+
+    string ExperimentRun::serializePopulationBoost() {
+        string archive;
+        {
+            boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
+            out.push(boost::iostreams::gzip_compressor());
+            out.push(boost::iostreams::back_inserter(archive));
+            boost::archive::binary_oarchive oa(out);
+            oa << *population;
+        }
+        return archive;
+    }
+
+    void ExperimentRun::deserializePopulationBoost(const char *data,size_t size) {
+        population = shared_ptr<NEAT::GeneticPopulation>(new NEAT::GeneticPopulation());
+        boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+        in.push(boost::iostreams::gzip_decompressor());
+        in.push(boost::iostreams::array_source(data,size));
+        boost::archive::binary_iarchive ia(in);
+        ia >> (*population);
     }
 
     void ExperimentRun::setupExperimentInProgress(
@@ -439,9 +510,14 @@ namespace HCUBE
             population->cleanupOld();
         }
 
-        // Save the population
+        // Save the population.  Anything but a .ser.gz gets the indexed format so
+        // that evaluators can read a single individual out of it.
         //population->dumpBest(outputFileName, true, true);
-        savePopulationBoost(outputFileName);
+        if (iends_with(outputFileName,".ser.gz")) {
+            savePopulationBoost(outputFileName);
+        } else {
+            savePopulationIndexed(outputFileName);
+        }
 
         // Try to load the population to make sure it saved correctly
         try {
@@ -560,6 +636,20 @@ namespace HCUBE
         experiments[0]->processGroup(generation);
         return generation->getIndividual(individualId)->getFitness();
     }
+
+    float ExperimentRun::evaluateIndividual(shared_ptr<NEAT::GeneticIndividual> individual) {
+        shared_ptr<NEAT::GeneticGeneration> generation;
+        if (population) {
+            generation = population->getGeneration();
+        } else {
+            generation = shared_ptr<NEAT::GeneticGeneration>(new NEAT::GeneticGeneration());
+        }
+        experiments[0]->preprocessIndividual(generation, individual);
+        experiments[0]->clearGroup();
+        experiments[0]->addIndividualToGroup(individual);
+        experiments[0]->processGroup(generation);
+        return individual->getFitness();
+    }
  
     void ExperimentRun::evaluatePopulation()
     {
@@ -569,7 +659,7 @@ namespace HCUBE
 
         int populationSize = population->getIndividualCount();
 
-        if(NUM_THREADS==1)
+        if(numEvaluationThreads==1)
         {
             //Bypass the threading logic for a single thread
 
@@ -583,70 +673,18 @@ namespace HCUBE
         }
         else
         {
-            int populationPerProcess = populationSize/NUM_THREADS;
-
-            boost::thread** threads = new boost::thread*[NUM_THREADS];
-            EvaluationSet** evaluationSets = new EvaluationSet*[NUM_THREADS];
-
-            for (int i = 0; i < NUM_THREADS; ++i)
+            //The workers stay alive between generations
+            if (!evaluationPool)
             {
-                if (i+1==NUM_THREADS)
-                {
-                    //Fix for uneven distribution
-                    int populationIteratorSize =
-                        populationSize
-                        - populationPerProcess*(NUM_THREADS-1);
-                    evaluationSets[i] =
-                        new EvaluationSet(
-                            experiments[i],
-                            generation,
-                            population->getIndividualIterator(populationPerProcess*i),
-                            populationIteratorSize
-                            );
-                }
-                else
-                {
-
-                    evaluationSets[i] =
-                        new EvaluationSet(
-                            experiments[i],
-                            generation,
-                            population->getIndividualIterator(populationPerProcess*i),
-                            populationPerProcess
-                            );
-                }
-
-                threads[i] =
-                    new boost::thread(
-                        boost::bind(
-                            &EvaluationSet::run,
-                            evaluationSets[i]
-                            )
-                        );
-            }
-
-            //loop through each thread, making sure it is finished before we move on
-            for (int i=0;i<NUM_THREADS;++i)
-            {
-                /*if (!evaluationSets[i]->isFinished())
-                  {
-                  --i;
-                  boost::xtime xt;
-                  boost::xtime_get(&xt, boost::TIME_UTC);
-                  xt.sec += 1;
-                  boost::thread::sleep(xt); // Sleep for 1/2 second
-                  }*/
-                threads[i]->join();
+                evaluationPool.reset(new EvaluationPool(numEvaluationThreads));
             }
 
-            for (int i = 0; i < NUM_THREADS; ++i)
-            {
-                delete threads[i];
-                delete evaluationSets[i];
-            }
-
-            delete[] threads;
-            delete[] evaluationSets;
+            evaluationPool->evaluate(
+                experiments,
+                generation,
+                population->getIndividualIterator(0),
+                populationSize
+                );
         }
     }
 
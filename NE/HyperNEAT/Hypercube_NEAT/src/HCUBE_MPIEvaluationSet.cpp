@@ -21,7 +21,8 @@ namespace HCUBE
 
             vector<shared_ptr<NEAT::GeneticIndividual> >::iterator tmpIterator;
 
-            ostringstream ostr;
+            vector<char> message;
+            NEAT::GenomeWriter writer(message);
 
             if (targetProcessor!=0)
             {
@@ -37,7 +38,7 @@ namespace HCUBE
                 }
 #endif
 
-                ostr << testCount << " ";
+                writer.write(testCount);
 
 #ifdef EPLEX_INTERNAL
                 if (dynamic_cast<NEAT::CoEvoExperiment*>(experiment.get()))
@@ -55,13 +56,13 @@ namespace HCUBE
                         shared_ptr<NEAT::GeneticIndividual> testInd =
                             gen->getTest(a);
 
-                        testInd->dump(ostr);
+                        testInd->dump(writer);
                     }
                 }
 #endif
             }
 
-            ostr << individualCount << " ";
+            writer.write(individualCount);
 
 #if MPI_EVALUATION_SET_DEBUG
             cout << targetProcessor << " MAIN) Collecting individuals...\n";
@@ -85,7 +86,7 @@ namespace HCUBE
                 else
                 {
                     //other processor, package the individuals for transfer
-                    (*tmpIterator)->dump(ostr);
+                    (*tmpIterator)->dump(writer);
                 }
             }
 
@@ -99,23 +100,13 @@ namespace HCUBE
                 cout << targetProcessor << " MAIN) Sending individuals...\n";
 #endif
 
-                string str = ostr.str();
-
-                char *buffer = new char[str.length()+1];
-
-                memcpy(buffer,str.c_str(),str.length());
-
-                buffer[str.length()] = '\0'; //null terminate
-
-                int lengthInt = (int)str.length() + 1;
+                int lengthInt = (int)message.size();
 
                 {
                     boost::mutex::scoped_lock lock(mpiMutex);
                     MPI_Send (&lengthInt,1,MPI_INT,targetProcessor,INDIVIDUAL_GENOMES_TAG,MPI_COMM_WORLD);
-                    MPI_Send (buffer,lengthInt,MPI_CHAR,targetProcessor,INDIVIDUAL_GENOMES_TAG,MPI_COMM_WORLD);
+                    MPI_Send (&message[0],lengthInt,MPI_CHAR,targetProcessor,INDIVIDUAL_GENOMES_TAG,MPI_COMM_WORLD);
                 }
-
-                delete[] buffer;
             }
         }
         catch (string s)
@@ -200,54 +191,40 @@ namespace HCUBE
                 cout << targetProcessor << " MAIN) Waiting for results...\n";
 #endif
 
-				int msgSize = 0;
-				char *buffer = NULL;
+                int msgSize = 0;
+                vector<char> buffer;
 
                 {
                     boost::mutex::scoped_lock lock(mpiMutex);
                     MPI_Status Stat;
-                    //MPI_Recv (newFitness,individualCount,MPI_DOUBLE,targetProcessor,NEW_FITNESSES_TAG,MPI_COMM_WORLD,&Stat);
-					MPI_Recv (&msgSize,1,MPI_INT,targetProcessor,NEW_INDIVIDUALS_TAG,MPI_COMM_WORLD,&Stat);
+                    MPI_Recv (&msgSize,1,MPI_INT,targetProcessor,NEW_FITNESSES_TAG,MPI_COMM_WORLD,&Stat);
 
 #if MPI_EVALUATION_SET_DEBUG
-					cout << targetProcessor << " MAIN) Got Message of size " << msgSize << "...\n";
+                    cout << targetProcessor << " MAIN) Got Message of size " << msgSize << "...\n";
 #endif
 
-					buffer = new char[msgSize];
-					MPI_Recv (buffer,msgSize,MPI_CHAR,targetProcessor,NEW_INDIVIDUALS_TAG,MPI_COMM_WORLD,&Stat);
+                    buffer.resize(max(msgSize,1));
+                    MPI_Recv (&buffer[0],msgSize,MPI_CHAR,targetProcessor,NEW_FITNESSES_TAG,MPI_COMM_WORLD,&Stat);
                 }
-				istringstream istr(buffer);
+
+                //The individuals stay where they are, only their results are copied in
+                NEAT::GenomeReader reader(&buffer[0],msgSize);
 
                 tmpIterator = individualIterator;
                 for (int a=0;a<individualCount;a++,tmpIterator++)
                 {
-					(*tmpIterator) = shared_ptr<NEAT::GeneticIndividual>(
-										new NEAT::GeneticIndividual(istr)
-										);
-				}
-
-#if MPI_EVALUATION_SET_DEBUG
-                cout << targetProcessor << " MAIN) Received new fitness values\n";
-#endif
+                    (*tmpIterator)->setFitness(reader.read<double>());
+                }
 
-				/*
                 tmpIterator = individualIterator;
                 for (int a=0;a<individualCount;a++,tmpIterator++)
                 {
-                    if (fabs(newFitness[a])<1e-6)
-                    {
-                        throw CREATE_LOCATEDEXCEPTION_INFO("Error, 0 fitness!");
-                    }
-#if MPI_EVALUATION_SET_DEBUG
-                    cout << targetProcessor << " MAIN) fitness: " << newFitness[a] << "\n";
-#endif
-                    (*tmpIterator)->setFitness(newFitness[a]);
+                    (*tmpIterator)->setUserData(reader.readString());
                 }
-				*/
-
 
-                delete[] buffer;
-                //delete[] newFitness;
+#if MPI_EVALUATION_SET_DEBUG
+                cout << targetProcessor << " MAIN) Received new fitness values\n";
+#endif
             }
 
 #if MPI_EVALUATION_SET_DEBUG
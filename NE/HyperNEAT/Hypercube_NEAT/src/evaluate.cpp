@@ -6,6 +6,7 @@
 #endif
 
 #include "HCUBE_ExperimentRun.h"
+#include "NEAT_IndexedPopulationFile.h"
 #include "Experiments/HCUBE_AtariExperiment.h"
 #include "Experiments/HCUBE_AtariNoGeomExperiment.h"
 #include "Experiments/HCUBE_AtariFTNeatExperiment.h"
@@ -23,15 +24,186 @@ using namespace boost;
 using namespace HCUBE;
 using namespace NEAT;
 
+// The experiments of a run, initialized for one rom. For Hybrid runs that haven't
+// switched to FT-NEAT yet, hybridHyperNEAT and hybridFTNEAT are set and every
+// HyperNEAT individual is converted and played as an FT-NEAT individual.
+struct RomExperiments {
+    shared_ptr<AtariExperiment> hybridHyperNEAT;
+    shared_ptr<AtariFTNeatExperiment> hybridFTNEAT;
+    // The HybridConversionFinished flag the experiments were set up for
+    bool hybridConversionFinished;
+};
+
+// True when a Hybrid run has already swapped its population to FT-NEAT. The flag comes
+// from the loaded population or parameters, so ask after they are loaded.
+bool isHybridConversionFinished(int experimentType) {
+    Globals* globals = Globals::getSingleton();
+    return experimentType == 33 &&
+        globals->hasParameterValue("HybridConversionFinished") &&
+        globals->getParameterValue("HybridConversionFinished") == 1.0;
+}
+
+RomExperiments initializeExperiments(HCUBE::ExperimentRun &experimentRun, int experimentType,
+                                     const string &rom_file) {
+    RomExperiments romExperiments;
+    romExperiments.hybridConversionFinished = isHybridConversionFinished(experimentType);
+
+    // Cast the experiment into the correct subclass and initialize with rom file
+    shared_ptr<Experiment> e = experimentRun.getExperiment();
+    if (experimentType == 30 || experimentType == 35 || experimentType == 36) {
+        shared_ptr<AtariExperiment> exp = static_pointer_cast<AtariExperiment>(e);
+        exp->initializeExperiment(rom_file.c_str());
+    } else if (experimentType == 31 || experimentType == 39 || experimentType == 40) {
+        shared_ptr<AtariNoGeomExperiment> exp = static_pointer_cast<AtariNoGeomExperiment>(e);
+        exp->initializeExperiment(rom_file.c_str());
+    } else if (experimentType == 32 || experimentType == 37 || experimentType == 38) {
+        shared_ptr<AtariFTNeatExperiment> exp = static_pointer_cast<AtariFTNeatExperiment>(e);
+        exp->initializeExperiment(rom_file.c_str());
+    } else if (experimentType == 33) {
+        // This is the Hybrid experiment and can thus be either HyperNEAT or FT-NEAT
+        if (romExperiments.hybridConversionFinished) {
+            // Make the FT-NEAT experiment active
+            experimentRun.setActiveExperiment(1);
+            e = experimentRun.getExperiment();
+            shared_ptr<AtariFTNeatExperiment> exp = static_pointer_cast<AtariFTNeatExperiment>(e);
+            exp->initializeExperiment(rom_file.c_str());
+        } else {
+            // This is the early generational case before the swap has happened.
+            // Initialize both experiments; see evaluateIndividual for the rest.
+            romExperiments.hybridHyperNEAT = static_pointer_cast<AtariExperiment>(e);
+            romExperiments.hybridHyperNEAT->initializeExperiment(rom_file.c_str());
+            experimentRun.setActiveExperiment(1);
+            e = experimentRun.getExperiment();
+            romExperiments.hybridFTNEAT = static_pointer_cast<AtariFTNeatExperiment>(e);
+            romExperiments.hybridFTNEAT->initializeExperiment(rom_file.c_str());
+        }
+    }  else if (experimentType == 34) {
+        shared_ptr<AtariIntrinsicExperiment> exp = static_pointer_cast<AtariIntrinsicExperiment>(e);
+        exp->initializeExperiment(rom_file.c_str());
+    }
+
+    return romExperiments;
+}
+
+float evaluateIndividual(HCUBE::ExperimentRun &experimentRun, const RomExperiments &romExperiments,
+                         shared_ptr<NEAT::GeneticIndividual> individual) {
+    if (!romExperiments.hybridHyperNEAT) {
+        return experimentRun.evaluateIndividual(individual);
+    }
+
+    // This is a nasty-hack like short circuit of the
+    // normal evaluation procedure. It is used for
+    // HyperNEAT evaluation in Hybrid experiments. The
+    // crux of this method is to convert the hyperneat
+    // indvidual to be evaluated into a FT-individual and
+    // then perform the eval using FT methods. This should
+    // ensure that when the swap is done, fitness does not
+    // drop off as a result of using different types of
+    // networks to evaluate individuals.
+    shared_ptr<AtariExperiment> atariExp = romExperiments.hybridHyperNEAT;
+    shared_ptr<AtariFTNeatExperiment> ftExp = romExperiments.hybridFTNEAT;
+    atariExp->substrate.populateSubstrate(individual);
+    NEAT::LayeredSubstrate<float>* HyperNEAT_substrate = &atariExp->substrate;
+    shared_ptr<GeneticPopulation> FTNEAT_population(ftExp->createInitialPopulation(1));
+    shared_ptr<GeneticIndividual> FTNEAT_individual = FTNEAT_population->getGeneration()->getIndividual(0);
+    ftExp->convertIndividual(FTNEAT_individual, HyperNEAT_substrate);
+    ftExp->evaluateIndividual(FTNEAT_individual);
+    return FTNEAT_individual->getFitness();
+}
+
+void writeFitness(const string &individualFitnessFile, float fitness) {
+    cout << "[HyperNEAT core] Fitness found to be " << fitness << ". Writing to: " <<
+        individualFitnessFile << endl;
+    ofstream fout(individualFitnessFile.c_str());
+    fout << fitness << endl;
+    fout.close();
+}
+
+// Reads jobs from stdin, one per line: "(populationfile) (individualId) (fitnessFile)".
+// Each result is written to the fitness file and echoed on stdout as
+// "FITNESS (individualId) (fitness)", so a driver can tell it apart from the log output.
+// The rom and the experiment are set up after the first population is loaded, and again
+// only if a later population flips HybridConversionFinished. A population file is only
+// opened again when a job names a different file or the file has changed since it was
+// loaded. Indexed population files stay mapped and only the genome each job asks for is
+// decoded.
+void runEvaluationDaemon(HCUBE::ExperimentRun &experimentRun, int experimentType,
+                         const string &rom_file) {
+    Globals* globals = Globals::getSingleton();
+    RomExperiments romExperiments;
+    bool experimentsInitialized = false;
+    string loadedPopulationFile;
+    std::time_t loadedPopulationTime = 0;
+    shared_ptr<IndexedPopulationFile> indexedFile;
+
+    string line;
+    while (getline(cin, line)) {
+        istringstream job(line);
+        string populationFile, individualFitnessFile;
+        unsigned int individualId;
+        if (!(job >> populationFile)) {
+            continue;
+        }
+        if (populationFile == "QUIT") {
+            break;
+        }
+        if (!(job >> individualId >> individualFitnessFile)) {
+            cerr << "[HyperNEAT core] Bad job line: \"" << line << "\"" << endl;
+            cout << "ERROR " << line << endl;
+            continue;
+        }
+
+        std::time_t populationTime = boost::filesystem::last_write_time(populationFile);
+        if (populationFile != loadedPopulationFile || populationTime != loadedPopulationTime) {
+            indexedFile.reset();
+            if (IndexedPopulationFile::isIndexedPopulationFile(populationFile)) {
+                indexedFile = shared_ptr<IndexedPopulationFile>(new IndexedPopulationFile(populationFile));
+                indexedFile->loadParameters();
+            } else {
+                experimentRun.createPopulation(populationFile);
+            }
+            loadedPopulationFile = populationFile;
+            loadedPopulationTime = populationTime;
+            cout << "[HyperNEAT core] Population Loaded: " << populationFile << endl;
+        }
+
+        // Like the single-shot path, which initializes the experiments after loading
+        if (!experimentsInitialized ||
+            romExperiments.hybridConversionFinished != isHybridConversionFinished(experimentType)) {
+            if (experimentsInitialized && experimentType == 33) {
+                // initializeExperiments left the FT-NEAT experiment active, swap it back
+                experimentRun.setActiveExperiment(1);
+            }
+            romExperiments = initializeExperiments(experimentRun, experimentType, rom_file);
+            experimentsInitialized = true;
+        }
+
+        // Every job sees the random state a fresh process has after loading the
+        // population, which reseeds from the saved RandomSeed (overriding -R)
+        globals->initRandom();
+
+        shared_ptr<NEAT::GeneticIndividual> individual = indexedFile ?
+            indexedFile->getIndividual(individualId) : experimentRun.getIndividual(individualId);
+
+        cout << "[HyperNEAT core] Evaluating individual: " << individualId << endl;
+        float fitness = evaluateIndividual(experimentRun, romExperiments, individual);
+        writeFitness(individualFitnessFile, fitness);
+        cout << "FITNESS " << individualId << " " << fitness << endl;
+    }
+}
+
 int HyperNEAT_main(int argc,char **argv) {
     CommandLineParser commandLineParser(argc,argv);
     Globals* globals = Globals::init();
 
+    bool daemonMode = commandLineParser.HasSwitch("-D");
+
     if (commandLineParser.HasSwitch("-I") && // Experiment params
-        commandLineParser.HasSwitch("-F") && // Fitness file to write to
-        commandLineParser.HasSwitch("-P") && // Population file to read from
-        commandLineParser.HasSwitch("-N") && // Individual number within pop file
-        commandLineParser.HasSwitch("-G"))   // Rom file to run
+        commandLineParser.HasSwitch("-G") && // Rom file to run
+        (daemonMode ||                       // Jobs come in on stdin
+         (commandLineParser.HasSwitch("-F") && // Fitness file to write to
+          commandLineParser.HasSwitch("-P") && // Population file to read from
+          commandLineParser.HasSwitch("-N"))))  // Individual number within pop file
     {
 
         globals = Globals::init(commandLineParser.GetArgument("-I",0));
@@ -47,107 +219,56 @@ int HyperNEAT_main(int argc,char **argv) {
         HCUBE::ExperimentRun experimentRun;
         experimentRun.setupExperiment(experimentType, "output.xml");
 
-        string populationFile = commandLineParser.GetArgument("-P",0);
-        experimentRun.createPopulation(populationFile);
-        cout << "[HyperNEAT core] Population Created\n";
+        string rom_file = commandLineParser.GetArgument("-G",0);
 
-        unsigned int individualId = stringTo<unsigned int>(commandLineParser.GetArgument("-N",0));
-        cout << "[HyperNEAT core] Evaluating individual: " << individualId << endl;
+        if (daemonMode) {
+            cout << "[HyperNEAT core] Waiting for jobs on stdin\n";
+            runEvaluationDaemon(experimentRun, experimentType, rom_file);
+        } else {
+            string populationFile = commandLineParser.GetArgument("-P",0);
+            unsigned int individualId = stringTo<unsigned int>(commandLineParser.GetArgument("-N",0));
 
-        // Cast the experiment into the correct subclass and initialize with rom file
-        string rom_file = commandLineParser.GetArgument("-G",0);
-        shared_ptr<Experiment> e = experimentRun.getExperiment();
-        if (experimentType == 30 || experimentType == 35 || experimentType == 36) {
-            shared_ptr<AtariExperiment> exp = static_pointer_cast<AtariExperiment>(e);
-            exp->initializeExperiment(rom_file.c_str());
-        } else if (experimentType == 31 || experimentType == 39 || experimentType == 40) {
-            shared_ptr<AtariNoGeomExperiment> exp = static_pointer_cast<AtariNoGeomExperiment>(e);
-            exp->initializeExperiment(rom_file.c_str());
-        } else if (experimentType == 32 || experimentType == 37 || experimentType == 38) {
-            shared_ptr<AtariFTNeatExperiment> exp = static_pointer_cast<AtariFTNeatExperiment>(e);
-            exp->initializeExperiment(rom_file.c_str());
-        } else if (experimentType == 33) {
-            // This is the Hybrid experiment and can thus be either HyperNEAT or FT-NEAT
-            if (globals->hasParameterValue("HybridConversionFinished") &&
-                globals->getParameterValue("HybridConversionFinished") == 1.0) {
-                // Make the FT-NEAT experiment active
-                experimentRun.setActiveExperiment(1);
-                e = experimentRun.getExperiment();
-                shared_ptr<AtariFTNeatExperiment> exp = static_pointer_cast<AtariFTNeatExperiment>(e);
-                exp->initializeExperiment(rom_file.c_str());
+            // Only the requested genome is read out of an indexed population file
+            shared_ptr<NEAT::GeneticIndividual> individual;
+            if (IndexedPopulationFile::isIndexedPopulationFile(populationFile)) {
+                individual = experimentRun.loadIndividualIndexed(populationFile, individualId);
+                cout << "[HyperNEAT core] Individual Loaded\n";
             } else {
-                // shared_ptr<AtariExperiment> exp = static_pointer_cast<AtariExperiment>(e);
-                // exp->initializeExperiment(rom_file.c_str());
-
-                // This is a nasty-hack like short circuit of the
-                // normal evaluation procedure. It is used for
-                // HyperNEAT evaluation in Hybrid experiments. The
-                // crux of this method is to convert the hyperneat
-                // indvidual to be evaluated into a FT-individual and
-                // then perform the eval using FT methods. This should
-                // ensure that when the swap is done, fitness does not
-                // drop off as a result of using different types of
-                // networks to evaluate individuals.
-                // This is the early generational case before the swap has happened
-                shared_ptr<AtariExperiment> atariExp = static_pointer_cast<AtariExperiment>(e);
-                // Initialize both experiments
-                atariExp->initializeExperiment(rom_file.c_str());
-                experimentRun.setActiveExperiment(1);
-                e = experimentRun.getExperiment();
-                shared_ptr<AtariFTNeatExperiment> ftExp = static_pointer_cast<AtariFTNeatExperiment>(e);
-                ftExp->initializeExperiment(rom_file.c_str());
-                // Get the individual to evaluate
-                shared_ptr<NEAT::GeneticPopulation> population = experimentRun.getPopulation();
-                shared_ptr<NEAT::GeneticGeneration> generation = population->getGeneration();
-                shared_ptr<NEAT::GeneticIndividual> HyperNEAT_individual = generation->getIndividual(individualId);
-                atariExp->substrate.populateSubstrate(HyperNEAT_individual);
-                NEAT::LayeredSubstrate<float>* HyperNEAT_substrate = &atariExp->substrate;
-                GeneticPopulation* FTNEAT_population = ftExp->createInitialPopulation(1);
-                shared_ptr<GeneticIndividual> FTNEAT_individual = FTNEAT_population->getGeneration()->getIndividual(0);
-                ftExp->convertIndividual(FTNEAT_individual, HyperNEAT_substrate);
-                ftExp->evaluateIndividual(FTNEAT_individual);
-                float fitness = FTNEAT_individual->getFitness();
-                string individualFitnessFile = commandLineParser.GetArgument("-F",0);
-                cout << "[HyperNEAT core] Fitness found to be " << fitness << ". Writing to: " <<
-                    individualFitnessFile << endl;
-                ofstream fout(individualFitnessFile.c_str());
-                fout << fitness << endl;
-                fout.close();
-                cout << "[HyperNEAT core] Individual evaluation fin." << endl;
-                exit(0);
+                experimentRun.createPopulation(populationFile);
+                cout << "[HyperNEAT core] Population Created\n";
+                individual = experimentRun.getIndividual(individualId);
             }
-        }  else if (experimentType == 34) {
-            shared_ptr<AtariIntrinsicExperiment> exp = static_pointer_cast<AtariIntrinsicExperiment>(e);
-            exp->initializeExperiment(rom_file.c_str());
-        }
 
-        float fitness = experimentRun.evaluateIndividual(individualId);
+            cout << "[HyperNEAT core] Evaluating individual: " << individualId << endl;
+
+            RomExperiments romExperiments = initializeExperiments(experimentRun, experimentType, rom_file);
+            float fitness = evaluateIndividual(experimentRun, romExperiments, individual);
 
-        string individualFitnessFile = 
-            commandLineParser.GetArgument("-F",0);
-        cout << "[HyperNEAT core] Fitness found to be " << fitness << ". Writing to: " <<
-            individualFitnessFile << endl;
-        ofstream fout(individualFitnessFile.c_str());
-        fout << fitness << endl;
-        fout.close();
+            writeFitness(commandLineParser.GetArgument("-F",0), fitness);
+        }
         cout << "[HyperNEAT core] Individual evaluation fin." << endl;
 
     } else {
         cout << "./atari_evaluate [-R (seed)] -I (datafile) -P (populationfile) -N (individualId) "
             "-F (fitnessFile) -G (romFile)\n";
+        cout << "./atari_evaluate [-R (seed)] -I (datafile) -G (romFile) -D\n";
         cout << "\t\t(datafile) HyperNEAT experiment data file - typically data/AtariExperiment.dat\n";
         cout << "\t\t(populationfile) current population file containing all the individuals - "
-            "typically generationXX.xml.gz\n";
+            "typically generationXX.idx (indexed) or generationXX.ser.gz\n";
         cout << "\t\t(individualId) unsigned int specifying which particular individual from the above"
             "population file we are evaluating\n";
         cout << "\t\t(fitnessFile) fitness value once estimated written to file - "
             "typically fitness.XX.individualId\n";
         cout << "\t\t(romFile) the Atari rom file to evaluate the agent against.\n";
+        cout << "\t\t-D keeps the rom and experiment loaded and reads jobs from stdin, one per line:\n"
+            "\t\t\t(populationfile) (individualId) (fitnessFile)\n"
+            "\t\tand answers each with a line \"FITNESS (individualId) (fitness)\". QUIT or EOF stops.\n";
     }
 
     globals->deinit();
+    return 0;
 }
 
 int main(int argc,char **argv) {
-    HyperNEAT_main(argc,argv);
+    return HyperNEAT_main(argc,argv);
 }
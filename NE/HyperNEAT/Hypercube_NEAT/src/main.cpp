@@ -419,5 +419,5 @@ int HyperNEAT_main(int argc,char **argv)
 
 int main(int argc,char **argv)
 {
-    HyperNEAT_main(argc,argv);
+    return HyperNEAT_main(argc,argv);
 }
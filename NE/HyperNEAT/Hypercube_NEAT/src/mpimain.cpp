@@ -54,8 +54,9 @@ void runOrContinueExperiment(HCUBE::MPIExperimentRun &experimentRun)
 
     //cout << "Experiment pointer: " << experiment << endl;
 
-    char *buffer=NULL;
-    int bufferSize=0;
+    //Reused for every message, so it only grows to the largest chunk seen
+    vector<char> buffer;
+    vector<char> results;
 
     int curGenNumber=0;
     if(experimentRun.getPopulation())
@@ -95,21 +96,18 @@ void runOrContinueExperiment(HCUBE::MPIExperimentRun &experimentRun)
         continue; // ????  This shouldn't happen, but handle anyways
       }
 
-      if (bufferSize<msgSize)
+      if ((int)buffer.size()<msgSize)
       {
-        bufferSize = msgSize;
-        buffer = (char*)realloc(buffer,bufferSize);
+        buffer.resize(msgSize);
       }
 
-      memset(buffer,0,bufferSize);
-
 #if DEBUG_MPI_MAIN
       cout << rank << ") Getting buffer...\n";
 #endif
 
       {
         MPI_Status Stat;
-        MPI_Recv (buffer,msgSize,MPI_CHAR,0,INDIVIDUAL_GENOMES_TAG,MPI_COMM_WORLD,&Stat);
+        MPI_Recv (&buffer[0],msgSize,MPI_CHAR,0,INDIVIDUAL_GENOMES_TAG,MPI_COMM_WORLD,&Stat);
       }
 
 #if DEBUG_MPI_MAIN
@@ -118,15 +116,10 @@ void runOrContinueExperiment(HCUBE::MPIExperimentRun &experimentRun)
       //cout << buffer << endl;
 #endif
 
-      istringstream istr(buffer);
-
-#if DEBUG_MPI_MAIN
-      cout << rank << ") Loaded stringstream\n";
-#endif
-
+      //Decode straight out of the receive buffer
+      NEAT::GenomeReader reader(&buffer[0],msgSize);
 
-      int testCount;
-      istr >> testCount;
+      int testCount = reader.read<int>();
 
 
       shared_ptr<NEAT::GeneticGeneration> generation;
@@ -156,7 +149,7 @@ void runOrContinueExperiment(HCUBE::MPIExperimentRun &experimentRun)
 #ifdef EPLEX_INTERNAL
       for(int a=0;a<testCount;a++)
       {
-        shared_ptr<NEAT::GeneticIndividual> testInd(new NEAT::GeneticIndividual(istr));
+        shared_ptr<NEAT::GeneticIndividual> testInd(new NEAT::GeneticIndividual(reader));
 
         shared_ptr<NEAT::CoEvoGeneticGeneration> coEvoGen =
           static_pointer_cast<NEAT::CoEvoGeneticGeneration>(generation);
@@ -165,16 +158,14 @@ void runOrContinueExperiment(HCUBE::MPIExperimentRun &experimentRun)
       }
 #endif
 
-      int individualCount;
-
-      istr >> individualCount;
+      int individualCount = reader.read<int>();
 
 #if DEBUG_MPI_MAIN
       cout << rank << ") Individualcount: " << individualCount << endl;
 #endif
 
-      //double *newFitness = (double*)malloc(sizeof(double)*individualCount);
-      ostringstream ostr;
+      vector<double> newFitness(individualCount);
+      vector<string> newUserData(individualCount);
 
 #if DEBUG_MPI_MAIN
       cout << rank << ") Fitness buffer created\n";
@@ -189,7 +180,7 @@ void runOrContinueExperiment(HCUBE::MPIExperimentRun &experimentRun)
         for (int b=0;b<experiment->getGroupCapacity();b++)
         {
           shared_ptr<NEAT::GeneticIndividual> ind(
-            new NEAT::GeneticIndividual(istr)
+            new NEAT::GeneticIndividual(reader)
             );
 
           experiment->addIndividualToGroup(ind);
@@ -207,8 +198,8 @@ void runOrContinueExperiment(HCUBE::MPIExperimentRun &experimentRun)
 
         for (int b=0;b<experiment->getGroupCapacity();b++)
         {
-			experiment->getGroupMember(b)->dump(ostr);
-          //newFitness[a+b] = experiment->getGroupMember(b)->getFitness();
+          newFitness[a+b] = experiment->getGroupMember(b)->getFitness();
+          newUserData[a+b] = experiment->getGroupMember(b)->getUserData();
         }
 
 #if DEBUG_MPI_MAIN
@@ -227,29 +218,25 @@ void runOrContinueExperiment(HCUBE::MPIExperimentRun &experimentRun)
       cout << rank << ") Sending new fitness values\n";
 #endif
 
-        string str = ostr.str();
-
-        char *buffer = new char[str.length()+1];
-
-        memcpy(buffer,str.c_str(),str.length());
-
-        buffer[str.length()] = '\0'; //null terminate
+      results.clear();
+      NEAT::GenomeWriter writer(results);
+      for (int a=0;a<individualCount;a++)
+      {
+        writer.write(newFitness[a]);
+      }
+      for (int a=0;a<individualCount;a++)
+      {
+        writer.write(newUserData[a]);
+      }
 
-        int lengthInt = (int)str.length() + 1;
+      int lengthInt = (int)results.size();
 
 #if DEBUG_MPI_MAIN
       cout << rank << ") Sending message of size " << lengthInt << "\n";
 #endif
 
-      //MPI_Send (newFitness,individualCount,MPI_DOUBLE,0,NEW_FITNESSES_TAG,MPI_COMM_WORLD);
-		MPI_Send (&lengthInt,1,MPI_INT,0,NEW_INDIVIDUALS_TAG,MPI_COMM_WORLD);
-		MPI_Send (buffer,lengthInt,MPI_CHAR,0,NEW_INDIVIDUALS_TAG,MPI_COMM_WORLD);
-
-#if DEBUG_MPI_MAIN
-      cout << rank << ") Cleaning up new fitness values\n";
-#endif
-
-      //free(newFitness);
+      MPI_Send (&lengthInt,1,MPI_INT,0,NEW_FITNESSES_TAG,MPI_COMM_WORLD);
+      MPI_Send (results.empty()?NULL:&results[0],lengthInt,MPI_CHAR,0,NEW_FITNESSES_TAG,MPI_COMM_WORLD);
     }
   }
 }
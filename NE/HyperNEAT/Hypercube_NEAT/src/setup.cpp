@@ -87,8 +87,9 @@ int HyperNEAT_main(int argc,char **argv) {
     experimentRun.startCondor();
 
     NEAT::Globals::deinit();
+    return 0;
 }
 
 int main(int argc,char **argv) {
-    HyperNEAT_main(argc,argv);
+    return HyperNEAT_main(argc,argv);
 }
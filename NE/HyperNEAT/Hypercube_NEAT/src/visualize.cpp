@@ -97,8 +97,9 @@ int HyperNEAT_main(int argc,char **argv) {
     }
 
     NEAT::Globals::deinit();
+    return 0;
 }
 
 int main(int argc,char **argv) {
-    HyperNEAT_main(argc,argv);
+    return HyperNEAT_main(argc,argv);
 }
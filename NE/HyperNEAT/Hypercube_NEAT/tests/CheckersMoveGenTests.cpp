@@ -0,0 +1,170 @@
+#include "HCUBE_Defines.h"
+
+#include "Experiments/HCUBE_CheckersCommon.h"
+
+// Cross-checks the bitboard checkers move generator against the uchar[8][8] generator it
+// replaced in the search.  Random games compare the move lists (same moves, same order)
+// and the boards after every move; perft from the opening is compared between both
+// generators and with the known counts, and both are timed.
+
+#define NUM_GAMES (2000)
+
+#define MAX_GAME_PLIES (200)
+
+#define MAX_PERFT_DEPTH (8)
+
+namespace HCUBE
+{
+    //Positions at each depth below the opening, black to move
+    static const ulong openingPerft[MAX_PERFT_DEPTH+1] =
+    {
+        1, 7, 49, 302, 1469, 7361, 36768, 179740, 845931
+    };
+
+    /**
+     * legacyPerft: perft with the uchar generator, the way the search used to walk the tree
+     */
+    ulong legacyPerft(CheckersCommon &common,uchar b[8][8],int color,int depth)
+    {
+        if (depth<=0)
+        {
+            return 1;
+        }
+
+        vector<CheckersMove> moveList;
+        bool foundJump;
+        int numMoves = common.generateMoveList(moveList,0,b,color,foundJump);
+
+        if (depth==1)
+        {
+            return ulong(numMoves);
+        }
+
+        int otherColor = (color==BLACK) ? WHITE : BLACK;
+        ulong nodes=0;
+        for (int a=0;a<numMoves;a++)
+        {
+            common.makeMove(moveList[a],b);
+            nodes += legacyPerft(common,b,otherColor,depth-1);
+            common.reverseMove(moveList[a],b);
+        }
+
+        return nodes;
+    }
+
+    int checkRandomGames(CheckersCommon &common)
+    {
+        NEAT::Random &random = NEAT::Globals::getSingleton()->getRandom();
+
+        int mismatches=0;
+        ulong positions=0,moves=0,multiJumps=0;
+
+        vector<CheckersMove> moveList;
+        CheckersBitMoveList bitMoveList;
+
+        for (int game=0;game<NUM_GAMES;game++)
+        {
+            uchar b[8][8];
+            common.resetBoard(b);
+            CheckersBitboard board(b);
+            int color = BLACK;
+
+            for (int ply=0;ply<MAX_GAME_PLIES;ply++)
+            {
+                if (!(CheckersBitboard(b)==board))
+                {
+                    cout << "Game " << game << ", ply " << ply << ": the boards differ\n";
+                    mismatches++;
+                    break;
+                }
+
+                moveList.clear();
+                bool foundJump;
+                int numMoves = common.generateMoveList(moveList,0,b,color,foundJump);
+                common.generateMoveList(board,color,bitMoveList);
+
+                positions++;
+                moves += numMoves;
+
+                bool sameMoves = (numMoves==bitMoveList.numMoves && foundJump==bitMoveList.foundJump);
+                for (int a=0;sameMoves && a<numMoves;a++)
+                {
+                    sameMoves = (moveList[a]==common.getCheckersMove(bitMoveList.moves[a]));
+                    if (bitMoveList.moves[a].numJumps>1)
+                    {
+                        multiJumps++;
+                    }
+                }
+
+                if (!sameMoves)
+                {
+                    cout << "Game " << game << ", ply " << ply << ": the move lists differ\n";
+                    common.printBoard(b);
+                    mismatches++;
+                    break;
+                }
+
+                if (numMoves==0)
+                {
+                    break;
+                }
+
+                int move = random.getRandomInt(numMoves);
+                common.makeMove(moveList[move],b);
+                board.makeMove(bitMoveList.moves[move],color);
+                color = (color==BLACK) ? WHITE : BLACK;
+            }
+        }
+
+        cout << NUM_GAMES << " random games: " << positions << " positions, " << moves << " moves, "
+             << multiJumps << " multi-jumps, " << mismatches << " mismatches\n";
+
+        return mismatches;
+    }
+
+    int checkPerft(CheckersCommon &common)
+    {
+        uchar b[8][8];
+        common.resetBoard(b);
+        CheckersBitboard board(b);
+
+        int mismatches=0;
+        for (int depth=1;depth<=MAX_PERFT_DEPTH;depth++)
+        {
+            boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+            ulong bitNodes = common.perft(board,BLACK,depth);
+            boost::posix_time::ptime middle = boost::posix_time::microsec_clock::universal_time();
+            ulong legacyNodes = legacyPerft(common,b,BLACK,depth);
+            boost::posix_time::ptime end = boost::posix_time::microsec_clock::universal_time();
+
+            cout << "perft(" << depth << "): bitboard " << bitNodes << " in " << (middle-start).total_milliseconds()
+                 << " ms, uchar generator " << legacyNodes << " in " << (end-middle).total_milliseconds() << " ms\n";
+
+            if (bitNodes!=openingPerft[depth] || legacyNodes!=openingPerft[depth])
+            {
+                cout << "perft(" << depth << ") should be " << openingPerft[depth] << endl;
+                mismatches++;
+            }
+        }
+
+        return mismatches;
+    }
+}
+
+int main()
+{
+    NEAT::Globals::init();
+    NEAT::Globals::getSingleton()->seedRandom(41);
+
+    HCUBE::CheckersCommon common;
+
+    int mismatches=0;
+    mismatches += HCUBE::checkRandomGames(common);
+    mismatches += HCUBE::checkPerft(common);
+
+    cout << mismatches << " mismatches\n";
+
+    NEAT::Globals::deinit();
+
+    return (mismatches==0)?0:1;
+}
@@ -0,0 +1,323 @@
+#include "HCUBE_Defines.h"
+
+#include "Experiments/HCUBE_OthelloCommon.h"
+
+// Cross-checks the bitboard Othello move generator against the ushort[8][8] generator it
+// replaced.  Random games compare the move lists (same moves, same order), the pieces each
+// move flips, the boards after every move, hasAnyMove and getWinner; perft from the
+// opening is compared between both generators and with the known counts, and both are timed.
+
+#define NUM_GAMES (2000)
+
+#define MAX_PERFT_DEPTH (9)
+
+namespace HCUBE
+{
+    //Positions at each depth below the opening, black to move
+    static const ulong openingPerft[MAX_PERFT_DEPTH+1] =
+    {
+        1, 4, 12, 56, 244, 1396, 8200, 55092, 390216, 3005288
+    };
+
+    /**
+     * OthelloTestCommon: Gives the tests the move buffer that generateMoveList checks against
+     */
+    class OthelloTestCommon : public OthelloCommon
+    {
+    public:
+        OthelloMove *getMoveBuffer()
+        {
+            return totalMoveList;
+        }
+    };
+
+    void resetBoard(ushort b[8][8])
+    {
+        memset(b,0,sizeof(ushort)*8*8);
+
+        b[3][3] = b[4][4] = OTHELLO_WHITE;
+        b[4][3] = b[3][4] = OTHELLO_BLACK;
+
+        OTHELLO_SET_NUM_BLACK_PIECES(b,2);
+        OTHELLO_SET_NUM_WHITE_PIECES(b,2);
+    }
+
+    /**
+     * legacyHasAnyMove, legacyGenerateMoveList and legacyGetWinner: The ushort board
+     * functions as they were before the bitboard, built on hasMove(...)
+     */
+    bool legacyHasAnyMove(OthelloCommon &common,ushort b[8][8])
+    {
+        for (int x=0;x<8;x++)
+        {
+            for (int y=0;y<8;y++)
+            {
+                if (common.hasMove(b,OTHELLO_BLACK,x,y))
+                {
+                    return true;
+                }
+                if (common.hasMove(b,OTHELLO_WHITE,x,y))
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    int legacyGenerateMoveList(OthelloCommon &common,ushort b[8][8],vector<OthelloMove> &moveList,int color)
+    {
+        moveList.clear();
+
+        for (int x=0;x<8;x++)
+        {
+            for (int y=0;y<8;y++)
+            {
+                if (common.hasMove(b,color,x,y))
+                {
+                    moveList.push_back(OthelloMove(Vector2<uchar>(x,y),color));
+                }
+            }
+        }
+
+        return int(moveList.size());
+    }
+
+    int legacyGetWinner(OthelloCommon &common,ushort b[8][8])
+    {
+        int blackPieces = OTHELLO_GET_NUM_BLACK_PIECES(b);
+        int whitePieces = OTHELLO_GET_NUM_WHITE_PIECES(b);
+
+        if (!blackPieces)
+        {
+            return OTHELLO_WHITE;
+        }
+        else if (!whitePieces)
+        {
+            return OTHELLO_BLACK;
+        }
+        else if (legacyHasAnyMove(common,b))
+        {
+            return OTHELLO_END_UNKNOWN;
+        }
+        else if (blackPieces<whitePieces)
+        {
+            return OTHELLO_WHITE;
+        }
+        else if (blackPieces>whitePieces)
+        {
+            return OTHELLO_BLACK;
+        }
+        else
+        {
+            return OTHELLO_END_TIE;
+        }
+    }
+
+    /**
+     * legacyPerft: perft with the ushort generator, passing the same way as OthelloCommon::perft
+     */
+    ulong legacyPerft(OthelloCommon &common,ushort b[8][8],int color,int depth)
+    {
+        if (depth<=0)
+        {
+            return 1;
+        }
+
+        int otherColor = OTHELLO_BLACK+OTHELLO_WHITE-color;
+
+        vector<OthelloMove> moveList;
+        int numMoves = legacyGenerateMoveList(common,b,moveList,color);
+
+        if (!numMoves)
+        {
+            vector<OthelloMove> otherMoveList;
+            if (!legacyGenerateMoveList(common,b,otherMoveList,otherColor))
+            {
+                //Game over
+                return 1;
+            }
+
+            //Pass
+            return legacyPerft(common,b,otherColor,depth-1);
+        }
+
+        ulong nodes=0;
+        for (int a=0;a<numMoves;a++)
+        {
+            common.makeMove(moveList[a],b);
+            nodes += legacyPerft(common,b,otherColor,depth-1);
+            common.reverseMove(moveList[a],b);
+        }
+
+        return nodes;
+    }
+
+    ulong getFlippedMask(OthelloMove &move)
+    {
+        ulong mask=0;
+        for (int a=0;a<move.getNumPiecesFlipped();a++)
+        {
+            mask |= (1ULL<<OthelloBitboard::getSquare(move.piecesFlipped[a].x,move.piecesFlipped[a].y));
+        }
+        return mask;
+    }
+
+    bool sameBoard(ushort b[8][8],const OthelloBitboard &board)
+    {
+        return OthelloBitboard(b)==board
+               && OTHELLO_GET_NUM_BLACK_PIECES(b)==OthelloBitboard::countSquares(board.black)
+               && OTHELLO_GET_NUM_WHITE_PIECES(b)==OthelloBitboard::countSquares(board.white);
+    }
+
+    int checkRandomGames(OthelloTestCommon &common)
+    {
+        NEAT::Random &random = NEAT::Globals::getSingleton()->getRandom();
+
+        int mismatches=0;
+        ulong positions=0,moves=0,passes=0;
+
+        vector<OthelloMove> moveList;
+
+        for (int game=0;game<NUM_GAMES;game++)
+        {
+            ushort b[8][8];
+            resetBoard(b);
+            OthelloBitboard board(b);
+            int color = OTHELLO_BLACK;
+
+            for (int ply=0;;ply++)
+            {
+                if (!sameBoard(b,board))
+                {
+                    cout << "Game " << game << ", ply " << ply << ": the boards differ\n";
+                    mismatches++;
+                    break;
+                }
+
+                if (legacyHasAnyMove(common,b)!=OthelloCommon::hasAnyMove(board)
+                    || legacyGetWinner(common,b)!=OthelloCommon::getWinner(board)
+                    || legacyGetWinner(common,b)!=common.getWinner(b))
+                {
+                    cout << "Game " << game << ", ply " << ply << ": hasAnyMove or getWinner differ\n";
+                    common.printBoard(b);
+                    mismatches++;
+                    break;
+                }
+
+                int numMoves = legacyGenerateMoveList(common,b,moveList,color);
+                int numBufferMoves = common.generateMoveList(b,common.getMoveBuffer(),color);
+                ulong bitMoves = OthelloCommon::getMoves(board,color);
+
+                positions++;
+                moves += numMoves;
+
+                bool sameMoves = (numMoves==numBufferMoves && numMoves==OthelloBitboard::countSquares(bitMoves));
+                ulong remainingMoves = bitMoves;
+                for (int a=0;sameMoves && a<numMoves;a++)
+                {
+                    int square = OthelloBitboard::getLowestSquare(remainingMoves);
+                    remainingMoves &= (remainingMoves-1);
+                    sameMoves =
+                        moveList[a].position==common.getMoveBuffer()[a].position
+                        && OthelloBitboard::getSquare(moveList[a].position.x,moveList[a].position.y)==square;
+                }
+
+                if (!sameMoves)
+                {
+                    cout << "Game " << game << ", ply " << ply << ": the move lists differ\n";
+                    common.printBoard(b);
+                    mismatches++;
+                    break;
+                }
+
+                if (numMoves==0)
+                {
+                    if (!legacyHasAnyMove(common,b))
+                    {
+                        break;
+                    }
+
+                    passes++;
+                    color = OTHELLO_BLACK+OTHELLO_WHITE-color;
+                    continue;
+                }
+
+                OthelloMove &move = moveList[random.getRandomInt(numMoves)];
+                int square = OthelloBitboard::getSquare(move.position.x,move.position.y);
+
+                OthelloMove bitMove = OthelloCommon::getOthelloMove(board,color,square);
+                ulong flips = OthelloCommon::getFlips(board,color,square);
+
+                common.makeMove(move,b);
+                ulong madeFlips = board.makeMove(square,color);
+
+                if (flips!=madeFlips || getFlippedMask(move)!=flips || getFlippedMask(bitMove)!=flips
+                    || move.getNumPiecesFlipped()!=bitMove.getNumPiecesFlipped())
+                {
+                    cout << "Game " << game << ", ply " << ply << ": the flipped pieces differ\n";
+                    common.printBoard(b);
+                    mismatches++;
+                    break;
+                }
+
+                color = OTHELLO_BLACK+OTHELLO_WHITE-color;
+            }
+        }
+
+        cout << NUM_GAMES << " random games: " << positions << " positions, " << moves << " moves, "
+             << passes << " passes, " << mismatches << " mismatches\n";
+
+        return mismatches;
+    }
+
+    int checkPerft(OthelloCommon &common)
+    {
+        ushort b[8][8];
+        resetBoard(b);
+        OthelloBitboard board(b);
+
+        int mismatches=0;
+        for (int depth=1;depth<=MAX_PERFT_DEPTH;depth++)
+        {
+            boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+            ulong bitNodes = OthelloCommon::perft(board,OTHELLO_BLACK,depth);
+            boost::posix_time::ptime middle = boost::posix_time::microsec_clock::universal_time();
+            ulong legacyNodes = legacyPerft(common,b,OTHELLO_BLACK,depth);
+            boost::posix_time::ptime end = boost::posix_time::microsec_clock::universal_time();
+
+            cout << "perft(" << depth << "): bitboard " << bitNodes << " in " << (middle-start).total_milliseconds()
+                 << " ms, ushort generator " << legacyNodes << " in " << (end-middle).total_milliseconds() << " ms\n";
+
+            if (bitNodes!=openingPerft[depth] || legacyNodes!=openingPerft[depth])
+            {
+                cout << "perft(" << depth << ") should be " << openingPerft[depth] << endl;
+                mismatches++;
+            }
+        }
+
+        return mismatches;
+    }
+}
+
+int main()
+{
+    NEAT::Globals::init();
+    NEAT::Globals::getSingleton()->seedRandom(43);
+
+    //Too big for the stack
+    HCUBE::OthelloTestCommon *common = new HCUBE::OthelloTestCommon();
+
+    int mismatches=0;
+    mismatches += HCUBE::checkRandomGames(*common);
+    mismatches += HCUBE::checkPerft(*common);
+
+    cout << mismatches << " mismatches\n";
+
+    delete common;
+
+    NEAT::Globals::deinit();
+
+    return (mismatches==0)?0:1;
+}
@@ -0,0 +1,259 @@
+#ifndef NEAT_ACTIVATIONFUNCTION_H_INCLUDED
+#define NEAT_ACTIVATIONFUNCTION_H_INCLUDED
+
+#include "NEAT_Globals.h"
+
+namespace NEAT
+{
+    extern double signedSigmoidTable[6001];
+    extern double unsignedSigmoidTable[6001];
+
+    /**
+     * fastTanh: Lambert's continued fraction for tanh truncated to a 7/6 rational function.
+     * The input is clamped to +/-4.97, where the fraction reaches 1.  Max abs error is 9.6e-5
+     * (at the clamp).
+     */
+    template<class Type>
+    inline Type fastTanh(Type x)
+    {
+        x = min(max(x,(Type)-4.97),(Type)4.97);
+        Type x2 = x*x;
+        return
+            x*((Type)135135+x2*((Type)17325+x2*((Type)378+x2)))
+            / ((Type)135135+x2*((Type)62370+x2*((Type)3150+x2*(Type)28)));
+    }
+
+    /**
+     * ActivationPolicy: The activation functions with the signed/unsigned choice and the
+     * sigmoid mode fixed at compile time, so a loop over nodes has no per-node branches on them.
+     * The formulas are the ones FastNetwork has always used.
+     */
+    template<class Type,bool SignedActivation,int Sigmoid>
+    class ActivationPolicy
+    {
+    public:
+        static inline Type sigmoid(Type tmpVal)
+        {
+            if (Sigmoid==SIGMOID_MODE_FAST)
+            {
+                Type retVal = fastTanh(tmpVal*(Type)0.5);
+                return SignedActivation ? retVal : (retVal+(Type)1.0)*(Type)0.5;
+            }
+            else if (Sigmoid==SIGMOID_MODE_TANH)
+            {
+                if (SignedActivation)
+                {
+                    return 2 / (1 + exp(-2 * tmpVal)) - 1;
+                }
+                else
+                {
+                    return (1 + exp(-2 * tmpVal));
+                }
+            }
+            else
+            {
+                //The comparison is written so NaN takes the exp() path
+                if (tmpVal>=-2.9 && tmpVal<=2.9)
+                {
+                    if (SignedActivation)
+                    {
+                        return (Type)signedSigmoidTable[int(tmpVal*1000.0)+3000];
+                    }
+                    else
+                    {
+                        return (Type)unsignedSigmoidTable[int(tmpVal*1000.0)+3000];
+                    }
+                }
+                else
+                {
+                    if (SignedActivation)
+                    {
+                        return (Type)( ((1.0 / (1+exp(-tmpVal))) - 0.5)*2.0 );
+                    }
+                    else
+                    {
+                        return 1 / (1+exp(-tmpVal));
+                    }
+                }
+            }
+        }
+
+        static inline Type activate(Type tmpVal,ActivationFunction function)
+        {
+            switch (function)
+            {
+            case ACTIVATION_FUNCTION_SIGMOID:
+                return sigmoid(tmpVal);
+            case ACTIVATION_FUNCTION_SIN:
+                if (SignedActivation)
+                {
+                    return sin(tmpVal);
+                }
+                return (sin(tmpVal)+1)/2;
+            case ACTIVATION_FUNCTION_COS:
+                if (SignedActivation)
+                {
+                    return cos(tmpVal);
+                }
+                return (cos(tmpVal)+1)/2;
+            case ACTIVATION_FUNCTION_GAUSSIAN:
+                return exp(-pow(tmpVal,2));
+            case ACTIVATION_FUNCTION_SQUARE:
+                return tmpVal*tmpVal;
+            case ACTIVATION_FUNCTION_ABS_ROOT:
+                if (SignedActivation && tmpVal<0.0)
+                {
+                    return -sqrt(fabs(tmpVal));
+                }
+                return sqrt(fabs(tmpVal));
+            case ACTIVATION_FUNCTION_LINEAR:
+                if (SignedActivation)
+                {
+                    return min(max(tmpVal,(Type)-3.0),(Type)3.0) / (Type)3.0;
+                }
+                return ((min(max(tmpVal,(Type)-3.0),(Type)3.0) / (Type)3.0) + 1) / (Type)2.0;
+            case ACTIVATION_FUNCTION_ONES_COMPLIMENT:
+                if (SignedActivation)
+                {
+                    Type tmpVal2 = (Type)min(1.0,max(-1.0,tmpVal/3.0));
+                    if (tmpVal>-0.1)
+                    {
+                        return (Type)1.0-tmpVal2;
+                    }
+                    return ((Type)-1.0) - tmpVal;
+                }
+                return ((Type)1.0)-(Type)min(1.0,max(0.0,tmpVal/3.0));
+            default:
+                throw CREATE_LOCATEDEXCEPTION_INFO("Unknown activation function!!!");
+            }
+        }
+
+        static void activateNodes(Type *values,const ActivationFunction *functions,int begin,int end)
+        {
+            for (int a=begin;a<end;a++)
+            {
+                values[a] = activate(values[a],functions[a]);
+            }
+        }
+
+        template<int Function>
+        static void activateGroup(Type *values,const int *nodes,int count)
+        {
+            for (int a=0;a<count;a++)
+            {
+                values[nodes[a]] = activate(values[nodes[a]],ActivationFunction(Function));
+            }
+        }
+
+        template<int Function>
+        static void activateRow(Type *values,int count)
+        {
+            for (int a=0;a<count;a++)
+            {
+                values[a] = activate(values[a],ActivationFunction(Function));
+            }
+        }
+    };
+
+    /**
+     * ActivationKernel: The ActivationPolicy instantiation picked once (normally from the
+     * Globals when a network is built), as function pointers.  activateGroup and activateRow
+     * have one entry per activation function so their loops are fully specialized.
+     */
+    template<class Type>
+    class ActivationKernel
+    {
+    public:
+        typedef Type (*ActivateFunction)(Type value,ActivationFunction function);
+        typedef void (*ActivateNodesFunction)(Type *values,const ActivationFunction *functions,int begin,int end);
+        typedef void (*ActivateGroupFunction)(Type *values,const int *nodes,int count);
+        typedef void (*ActivateRowFunction)(Type *values,int count);
+
+        ActivateFunction activate;
+        ActivateNodesFunction activateNodes;
+        ActivateGroupFunction activateGroup[ACTIVATION_FUNCTION_END];
+        ActivateRowFunction activateRow[ACTIVATION_FUNCTION_END];
+
+        /**
+         * (Constructor) Signed table sigmoid.  Does not touch the Globals, so it is safe
+         * for networks that are built before the Globals exist.
+         */
+        ActivationKernel()
+        {
+            assign<ActivationPolicy<Type,true,SIGMOID_MODE_TABLE> >();
+        }
+
+        ActivationKernel(bool signedActivation,SigmoidMode sigmoidMode)
+        {
+            select(signedActivation,sigmoidMode);
+        }
+
+        static ActivationKernel fromGlobals()
+        {
+            Globals *globals = Globals::getSingleton();
+            return ActivationKernel(globals->hasSignedActivation(),globals->getSigmoidMode());
+        }
+
+        void select(bool signedActivation,SigmoidMode sigmoidMode)
+        {
+            if (signedActivation)
+            {
+                switch (sigmoidMode)
+                {
+                case SIGMOID_MODE_TANH:
+                    assign<ActivationPolicy<Type,true,SIGMOID_MODE_TANH> >();
+                    break;
+                case SIGMOID_MODE_FAST:
+                    assign<ActivationPolicy<Type,true,SIGMOID_MODE_FAST> >();
+                    break;
+                default:
+                    assign<ActivationPolicy<Type,true,SIGMOID_MODE_TABLE> >();
+                    break;
+                }
+            }
+            else
+            {
+                switch (sigmoidMode)
+                {
+                case SIGMOID_MODE_TANH:
+                    assign<ActivationPolicy<Type,false,SIGMOID_MODE_TANH> >();
+                    break;
+                case SIGMOID_MODE_FAST:
+                    assign<ActivationPolicy<Type,false,SIGMOID_MODE_FAST> >();
+                    break;
+                default:
+                    assign<ActivationPolicy<Type,false,SIGMOID_MODE_TABLE> >();
+                    break;
+                }
+            }
+        }
+
+    protected:
+        template<class Policy>
+        void assign()
+        {
+            activate = &Policy::activate;
+            activateNodes = &Policy::activateNodes;
+
+            activateGroup[ACTIVATION_FUNCTION_SIGMOID] = &Policy::template activateGroup<ACTIVATION_FUNCTION_SIGMOID>;
+            activateGroup[ACTIVATION_FUNCTION_SIN] = &Policy::template activateGroup<ACTIVATION_FUNCTION_SIN>;
+            activateGroup[ACTIVATION_FUNCTION_COS] = &Policy::template activateGroup<ACTIVATION_FUNCTION_COS>;
+            activateGroup[ACTIVATION_FUNCTION_GAUSSIAN] = &Policy::template activateGroup<ACTIVATION_FUNCTION_GAUSSIAN>;
+            activateGroup[ACTIVATION_FUNCTION_SQUARE] = &Policy::template activateGroup<ACTIVATION_FUNCTION_SQUARE>;
+            activateGroup[ACTIVATION_FUNCTION_ABS_ROOT] = &Policy::template activateGroup<ACTIVATION_FUNCTION_ABS_ROOT>;
+            activateGroup[ACTIVATION_FUNCTION_LINEAR] = &Policy::template activateGroup<ACTIVATION_FUNCTION_LINEAR>;
+            activateGroup[ACTIVATION_FUNCTION_ONES_COMPLIMENT] = &Policy::template activateGroup<ACTIVATION_FUNCTION_ONES_COMPLIMENT>;
+
+            activateRow[ACTIVATION_FUNCTION_SIGMOID] = &Policy::template activateRow<ACTIVATION_FUNCTION_SIGMOID>;
+            activateRow[ACTIVATION_FUNCTION_SIN] = &Policy::template activateRow<ACTIVATION_FUNCTION_SIN>;
+            activateRow[ACTIVATION_FUNCTION_COS] = &Policy::template activateRow<ACTIVATION_FUNCTION_COS>;
+            activateRow[ACTIVATION_FUNCTION_GAUSSIAN] = &Policy::template activateRow<ACTIVATION_FUNCTION_GAUSSIAN>;
+            activateRow[ACTIVATION_FUNCTION_SQUARE] = &Policy::template activateRow<ACTIVATION_FUNCTION_SQUARE>;
+            activateRow[ACTIVATION_FUNCTION_ABS_ROOT] = &Policy::template activateRow<ACTIVATION_FUNCTION_ABS_ROOT>;
+            activateRow[ACTIVATION_FUNCTION_LINEAR] = &Policy::template activateRow<ACTIVATION_FUNCTION_LINEAR>;
+            activateRow[ACTIVATION_FUNCTION_ONES_COMPLIMENT] = &Policy::template activateRow<ACTIVATION_FUNCTION_ONES_COMPLIMENT>;
+        }
+    };
+}
+
+#endif // NEAT_ACTIVATIONFUNCTION_H_INCLUDED
@@ -6,6 +6,7 @@
 #include "NEAT_NetworkNode.h"
 #include "NEAT_NetworkLink.h"
 #include "NEAT_NetworkIndexedLink.h"
+#include "NEAT_ActivationFunction.h"
 
 namespace NEAT
 {
@@ -35,6 +36,12 @@ namespace NEAT
          */
         int numConstantNodes;
 
+        /**
+         * The activation functions, specialized for the Globals' activation settings
+         * when the network was built
+         */
+        ActivationKernel<Type> activationKernel;
+
     public:
         /**
          *  (Constructor) Create a Network with the inputed toplogy
@@ -101,6 +108,28 @@ namespace NEAT
          */
         NEAT_DLL_EXPORT void setValue(const string &nodeName,Type newValue);
 
+        /**
+         *  resolve: gets a handle to the specified node.  The handle is
+         *  invalid (see NodeHandle::isValid) if the node does not exist.
+         */
+        NEAT_DLL_EXPORT NodeHandle resolve(const string &nodeName) const;
+
+        /**
+         *  getValue: gets the value for a resolved node
+         */
+        inline Type getValue(const NodeHandle &node) const
+        {
+            return nodeValues[node.index];
+        }
+
+        /**
+         *  setValue: sets the value for a resolved node
+         */
+        inline void setValue(const NodeHandle &node,Type newValue)
+        {
+            nodeValues[node.index] = newValue;
+        }
+
         /**
          *  setValue: sets the value for a specified node
          */
@@ -154,8 +183,6 @@ namespace NEAT
 
     protected:
         void copyFrom(const FastBiasNetwork &other);
-
-        Type runActivationFunction(Type value,ActivationFunction function);
     };
 
 }
@@ -54,6 +54,30 @@ namespace NEAT
         }
     };
 
+    /**
+     * CompiledLayerLinks: The weights from one source layer in the layout update() reads.
+     * Sparse weights keep only their nonzero entries, grouped by source node (compressed
+     * sparse columns), so an update only visits the links of the active source nodes.
+     * Dense weights are repacked into blocks of 8 destination nodes, [block][source][node],
+     * so one pass over the sources fills a whole block of sums.
+     */
+    template<class Type>
+    class CompiledLayerLinks
+    {
+    public:
+        //The links from source node n are [columnStarts[n],columnStarts[n+1])
+        vector<int> columnStarts;
+        vector<int> toNodes;
+        vector<Type> weights;
+
+        vector<Type> blockWeights;
+
+        inline bool isCompiled() const
+        {
+            return !columnStarts.empty() || !blockWeights.empty();
+        }
+    };
+
     /**
      *  The FastLayeredNetwork class is designed to be faster at the cost
      *  of being less dynamic.  Adding/Removing links and nodes
@@ -65,6 +89,35 @@ namespace NEAT
     protected:
         vector<NetworkLayer<Type> > layers;
 
+        /**
+         * compiledLinks: compiledLinks[layer][a] holds the weights from layers[layer].fromLayers[a].
+         * It is rebuilt by the first update() after the weights change.
+         */
+        vector<vector<CompiledLayerLinks<Type> > > compiledLinks;
+
+        bool linksChanged;
+
+        //The row of the first node of each layer in the batch values
+        vector<size_t> layerNodeOffsets;
+
+        size_t totalNodeCount;
+
+        /**
+         * inputSums: inputSums[layer][a] holds what input layer layers[layer].fromLayers[a]
+         * adds to each node of the layer, for the input values in cachedInputs.  Only kept
+         * by updateIncremental().
+         */
+        vector<vector<vector<Type> > > inputSums;
+        vector<vector<Type> > cachedInputs;
+
+        int incrementalUpdates;
+
+        //Scratch space for update(), updateIncremental() and updateBatch()
+        vector<int> activeNodes;
+        vector<Type> linkSums;
+        vector<int> changedNodes;
+        vector<Type> inputDeltas;
+
     public:
         /**
          *  (Constructor) Create a Network with the inputed toplogy
@@ -110,6 +163,37 @@ namespace NEAT
          */
         NEAT_DLL_EXPORT void setValue(const Node &nodeIndex,Type newValue);
 
+        /**
+         *  resolve: gets a handle to the specified node
+         */
+        NEAT_DLL_EXPORT NodeHandle resolve(const Node &nodeIndex);
+
+        /**
+         *  getValue: gets the value for a resolved node
+         */
+        inline Type getValue(const NodeHandle &node) const
+        {
+            return layers[node.layer].nodeValues[node.index];
+        }
+
+        /**
+         *  setValue: sets the value for a resolved node
+         */
+        inline void setValue(const NodeHandle &node,Type newValue)
+        {
+            layers[node.layer].nodeValues[node.index] = newValue;
+        }
+
+        /**
+         *  setLayerValues: sets every node of a layer at once.  values holds one value
+         *  per node, at the indices of the resolved nodes.
+         */
+        inline void setLayerValues(int layer,const Type *values)
+        {
+            vector<Type> &nodeValues = layers[layer].nodeValues;
+            memcpy(&nodeValues[0],values,sizeof(Type)*nodeValues.size());
+        }
+
         /**
          *  getLink: gets the link weight between two specified nodes
          */
@@ -137,7 +221,79 @@ namespace NEAT
          */
         NEAT_DLL_EXPORT virtual void update();
 
+        /**
+         * updateIncremental: Works like update(), but keeps what every input layer adds to
+         * the layers it feeds.  Only the inputs that changed since the last call are applied,
+         * as rank-1 updates, so evaluating positions that differ by a few inputs (successive
+         * leaves of a game tree, successive frames) only pays for the difference.  Setting
+         * an input back to its old value undoes its change, so a search can make and unmake
+         * moves on the inputs directly.  The sums are rebuilt from scratch when that is no
+         * more work, and periodically, so the rounding in the deltas doesn't add up; between
+         * rebuilds the outputs can differ from update() in the last bits.
+         */
+        NEAT_DLL_EXPORT void updateIncremental();
+
+        /**
+         * updateBatch: Runs update() for batchSize samples at once.  batchValues holds
+         * batchSize values for every node of every layer, as [node][sample] rows (see
+         * getBatchValues()).  Fill in the rows of the input layers, call updateBatch() and
+         * read the rows of the other layers back.  Each sample gets exactly the values
+         * update() computes from the same inputs.  The network's own node values are not
+         * touched.
+         */
+        NEAT_DLL_EXPORT void updateBatch(vector<Type> &batchValues,int batchSize);
+
+        /**
+         * getBatchValueCount: The size of the batch values for batchSize samples
+         */
+        inline size_t getBatchValueCount(int batchSize) const
+        {
+            return totalNodeCount*batchSize;
+        }
+
+        /**
+         * getBatchValues: The batchSize values of a resolved node in the batch values
+         */
+        inline Type *getBatchValues(vector<Type> &batchValues,const NodeHandle &node,int batchSize) const
+        {
+            return &batchValues[(layerNodeOffsets[node.layer]+node.index)*size_t(batchSize)];
+        }
+
+        /**
+         * isSparse: Whether the weights from layers[layer].fromLayers[fromLayerIndex] are
+         * stored compressed.  Only valid after an update().
+         */
+        inline bool isSparse(int layer,int fromLayerIndex) const
+        {
+            return !compiledLinks[layer][fromLayerIndex].columnStarts.empty();
+        }
+
     protected:
+        /**
+         * compileLinks: Measures the density of every weight matrix and builds the
+         * compressed copy of the sparse ones and the blocked copy of the dense ones
+         */
+        void compileLinks();
+
+        /**
+         * addLinkSums: Adds the sums of the given source nodes through compiled links to
+         * toValues
+         */
+        void addLinkSums(
+            const CompiledLayerLinks<Type> &links,
+            int numToNodes,
+            int numFromNodes,
+            const Type *fromValues,
+            const int *fromNodes,
+            int numSumNodes,
+            Type *toValues
+        );
+
+        /**
+         * updateLayer: Recomputes the node values of one layer.  With useInputSums, the
+         * sums kept by updateIncremental() stand in for the input layers.
+         */
+        void updateLayer(size_t layerIndex,bool useInputSums);
     };
 
 }
@@ -6,6 +6,7 @@
 #include "NEAT_NetworkNode.h"
 #include "NEAT_NetworkLink.h"
 #include "NEAT_NetworkIndexedLink.h"
+#include "NEAT_ActivationFunction.h"
 
 namespace NEAT
 {
@@ -34,6 +35,28 @@ namespace NEAT
          */
         int numConstantNodes;
 
+        /**
+         * The compiled layout holds the links of every updated node in one contiguous
+         * row (sorted by target node, structure-of-arrays) and the updated nodes grouped
+         * by activation function.  compiledRowStart has one entry per updated node plus
+         * one.  compiledLinkOrder maps each compiled link back to links[] so the weights
+         * can be refreshed when they are changed through getLink().
+         */
+        bool compiledUpdate;
+        bool compiledWeightsDirty;
+        vector<int> compiledRowStart;
+        vector<int> compiledFromNodes;
+        vector<Type> compiledWeights;
+        vector<int> compiledLinkOrder;
+        vector<int> activationGroupNodes;
+        vector<int> activationGroupStart;
+
+        /**
+         * The activation functions, specialized for the Globals' activation settings
+         * when the network was built
+         */
+        ActivationKernel<Type> activationKernel;
+
     public:
         /**
          *  (Constructor) Create a Network with the inputed toplogy
@@ -93,11 +116,63 @@ namespace NEAT
          */
         NEAT_DLL_EXPORT void setValue(const string &nodeName,Type newValue);
 
+        /**
+         *  resolve: gets a handle to the specified node.  The handle is
+         *  invalid (see NodeHandle::isValid) if the node does not exist.
+         */
+        NEAT_DLL_EXPORT NodeHandle resolve(const string &nodeName) const;
+
+        /**
+         *  getValue: gets the value for a resolved node
+         */
+        inline Type getValue(const NodeHandle &node) const
+        {
+            return nodeValues[node.index];
+        }
+
+        /**
+         *  setValue: sets the value for a resolved node
+         */
+        inline void setValue(const NodeHandle &node,Type newValue)
+        {
+            nodeValues[node.index] = newValue;
+        }
+
+        /**
+         *  scatterValues: sets the values of several resolved nodes at once.
+         *  nodeIndices holds the index of each node's handle, and values its
+         *  new value.
+         */
+        template<class ValueType>
+        inline void scatterValues(const int *nodeIndices,const ValueType *values,int count)
+        {
+            for(int a=0;a<count;a++)
+            {
+                nodeValues[nodeIndices[a]] = Type(values[a]);
+            }
+        }
+
+        /**
+         *  getNodeIndex: gets the internal index of a node, or -1 if the
+         *  node does not exist.  Used to resolve names once before a batch.
+         */
+        NEAT_DLL_EXPORT int getNodeIndex(const string &nodeName) const;
+
+        /**
+         *  getNodeCount: gets the number of nodes
+         */
+        inline int getNodeCount() const
+        {
+            return numNodes;
+        }
+
         /**
          *  getLink: gets the link according to its index when created
          */
         NetworkIndexedLink<Type> *getLink(int index)
         {
+            //The caller may change the weight
+            compiledWeightsDirty=true;
             return &links[index];
         }
 
@@ -141,6 +216,43 @@ namespace NEAT
             updateFixedIterations(1);
         }
 
+        /**
+         * updateBatch: Activates the network from its reinitialized state
+         * for batchSize input tuples at once.  inputValues holds one row of
+         * batchSize values for each node in inputIndices (see getNodeIndex).
+         * Constant nodes that are not inputs are zero.  Node values are kept
+         * in batchValues as [node][batch] rows, so each link is applied to
+         * the whole batch in one pass.  The results are identical to calling
+         * reinitialize(), setValue() and update() on each tuple in turn.
+         * Use getBatchValues() to read a node's results afterwards.  The
+         * network's own node values are not touched.
+         */
+        NEAT_DLL_EXPORT void updateBatch(
+            const int *inputIndices,
+            int numInputs,
+            const Type *inputValues,
+            int batchSize,
+            vector<Type> &batchValues
+        );
+
+        /**
+         * getBatchValues: gets the batchSize results of a node after updateBatch()
+         */
+        inline const Type *getBatchValues(const vector<Type> &batchValues,int nodeIndex,int batchSize) const
+        {
+            return &batchValues[size_t(nodeIndex)*batchSize];
+        }
+
+        /**
+         * setCompiledUpdate: Chooses between the compiled (target-sorted) update kernel
+         * and the original kernel that walks the links in creation order.  Both give
+         * identical results.
+         */
+        inline void setCompiledUpdate(bool value)
+        {
+            compiledUpdate = value;
+        }
+
         NEAT_DLL_EXPORT void print();
 
         NEAT_DLL_EXPORT void clearAllLinkWeights();
@@ -150,7 +262,9 @@ namespace NEAT
     protected:
         void copyFrom(const FastNetwork &other);
 
-        Type runActivationFunction(Type value,ActivationFunction function,bool signedActivation,bool usingTanhSigmoid);
+        void buildCompiledLinks();
+
+        void updateCompiledIteration();
 
         Type activationFunctionDerivative(Type value,ActivationFunction function);
     };
@@ -39,6 +39,12 @@ namespace NEAT
          */
         int numForwardLinks;
 
+        /**
+         * The activation functions, specialized for the Globals' activation settings
+         * when the network was built
+         */
+        ActivationKernel<double> activationKernel;
+
     public:
         /* Create a Network with the inputed toplogy */
         NEAT_DLL_EXPORT FractalNetwork(const vector<NetworkNode *> &_nodes,const vector<NetworkLink *> &_links);
@@ -92,8 +98,6 @@ namespace NEAT
 
     protected:
         void copyFrom(const FractalNetwork &other);
-
-        double runActivationFunction(double value,ActivationFunction function);
     };
 
 }
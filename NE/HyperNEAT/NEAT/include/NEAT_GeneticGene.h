@@ -2,6 +2,7 @@
 #define __GENETICGENE_H__
 
 #include "NEAT_Globals.h"
+#include "NEAT_GenomeBuffer.h"
 
 namespace NEAT
 {
@@ -40,6 +41,11 @@ namespace NEAT
 
         GeneticGene(istream &istr);
 
+        /**
+         * Constructor: Creates a GeneticGene from the binary wire format
+         */
+        GeneticGene(GenomeReader &reader);
+
         virtual ~GeneticGene();
 
         virtual bool operator==(const GeneticGene &other) const;
@@ -95,6 +101,11 @@ namespace NEAT
 
         virtual void dump(ostream &ostr);
 
+        /**
+         * dump: appends this gene to a buffer in the binary wire format
+         */
+        virtual void dump(GenomeWriter &writer);
+
         inline void incrementAge()
         {
             age++;
@@ -82,6 +82,11 @@ namespace NEAT
          */
         NEAT_DLL_EXPORT GeneticIndividual(istream& stream);
 
+        /**
+         * Create an individual from the length-prefixed binary wire format.
+         */
+        NEAT_DLL_EXPORT GeneticIndividual(GenomeReader &reader);
+
         /**
          * Create a baby individual from two parents
         */
@@ -132,6 +137,11 @@ namespace NEAT
 
         NEAT_DLL_EXPORT void dump(ostream &ostr);
 
+        /**
+         * dump: Appends the individual to a buffer in the length-prefixed binary wire format
+         */
+        NEAT_DLL_EXPORT void dump(GenomeWriter &writer);
+
         NEAT_DLL_EXPORT void print() const;
 
         inline void setFitness(double _fitness)
@@ -217,6 +227,12 @@ namespace NEAT
 
         NEAT_DLL_EXPORT void addLink(GeneticLinkGene link);
 
+        /**
+         * commitProvisionalIDs: Replaces the IDs handed out from 'ids' with real ones, in
+         * creation order.  New nodes and links are matched against the innovation history here.
+         */
+        NEAT_DLL_EXPORT void commitProvisionalIDs(const ProvisionalIDs &ids);
+
         NEAT_DLL_EXPORT bool isValid();
 	protected:
     };
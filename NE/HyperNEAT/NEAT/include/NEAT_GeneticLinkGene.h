@@ -58,6 +58,8 @@ namespace NEAT
 
         GeneticLinkGene(istream &istr);
 
+        GeneticLinkGene(GenomeReader &reader);
+
         virtual ~GeneticLinkGene();
 
         virtual bool operator==(const GeneticLinkGene &other) const;
@@ -101,6 +103,8 @@ namespace NEAT
 
         virtual void dump(ostream &ostr);
 
+        virtual void dump(GenomeWriter &writer);
+
         void setFixed(bool _fixed)
         {
             fixed = _fixed;
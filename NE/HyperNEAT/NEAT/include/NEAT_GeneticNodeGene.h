@@ -62,6 +62,8 @@ namespace NEAT
 
         GeneticNodeGene(istream &istr);
 
+        GeneticNodeGene(GenomeReader &reader);
+
         virtual bool operator==(const GeneticNodeGene &other) const;
 
         inline const string &getName() const
@@ -90,6 +92,8 @@ namespace NEAT
 
         virtual void dump(ostream &ostr);
 
+        virtual void dump(GenomeWriter &writer);
+
         inline ActivationFunction getActivationFunction() const
         {
             return activationFunction;
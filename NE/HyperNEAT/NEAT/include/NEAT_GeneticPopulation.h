@@ -7,6 +7,7 @@
 #include "NEAT_Globals.h"
 #include "NEAT_GeneticSpecies.h"
 #include "NEAT_GeneticGeneration.h"
+#include "NEAT_SpeciationEngine.h"
 
 #ifdef EPLEX_INTERNAL
 #include "NEAT_CoEvoExperiment.h"
@@ -49,6 +50,8 @@ namespace NEAT
         vector<shared_ptr<GeneticSpecies> > extinctSpecies;
 
         int onGeneration;
+
+        SpeciationEngine speciationEngine;
     public:
         NEAT_DLL_EXPORT GeneticPopulation();
 
@@ -101,6 +104,17 @@ namespace NEAT
 
         NEAT_DLL_EXPORT void produceNextGeneration();
 
+        /**
+         * makeBabies: Makes one baby per plan on "ReproductionThreads" threads (0 or missing means
+         * one per core).  Baby 'a' draws from random stream streamBase+a and its IDs are committed
+         * in plan order, so the babies are the same for a given seed whatever the thread count.
+         */
+        NEAT_DLL_EXPORT void makeBabies(
+            const vector<OffspringPlan> &plans,
+            vector<shared_ptr<GeneticIndividual> > &babies,
+            ulong streamBase
+        );
+
         NEAT_DLL_EXPORT void dump(string filename,bool includeGenes,bool doGZ);
 
         NEAT_DLL_EXPORT void dumpBest(string filename,bool includeGenes,bool doGZ);
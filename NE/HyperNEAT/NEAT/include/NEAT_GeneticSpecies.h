@@ -6,6 +6,36 @@
 
 namespace NEAT
 {
+    /**
+     * OffspringPlan: The parents picked for one baby.  parent2 is empty when the baby is a
+     * mutated copy of parent1.
+     */
+    class OffspringPlan
+    {
+    public:
+        shared_ptr<GeneticIndividual> parent1,parent2;
+
+        double minGenerationalFitness;
+
+        OffspringPlan(
+            shared_ptr<GeneticIndividual> _parent1,
+            shared_ptr<GeneticIndividual> _parent2,
+            double _minGenerationalFitness
+        )
+                :
+                parent1(_parent1),
+                parent2(_parent2),
+                minGenerationalFitness(_minGenerationalFitness)
+        {
+        }
+
+        /**
+         * makeBaby: Crosses over and mutates the parents.  Safe to call from several threads
+         * at once as long as each has its own RandomStreamScope and ProvisionalIDScope.
+         */
+        NEAT_DLL_EXPORT shared_ptr<GeneticIndividual> makeBaby() const;
+    };
+
     /*
      * GeneticSpecies: This class is responsible for handling a species: a group of similar individuals
      */
@@ -126,7 +156,11 @@ namespace NEAT
 
         NEAT_DLL_EXPORT void incrementAge();
 
-        NEAT_DLL_EXPORT void makeBabies(vector<shared_ptr<GeneticIndividual> > &babies, double minGenerationalFitness);
+        /**
+         * planBabies: Picks the parents of every remaining offspring of the species.  The babies
+         * themselves are made later (see GeneticPopulation::makeBabies).
+         */
+        NEAT_DLL_EXPORT void planBabies(vector<OffspringPlan> &plans, double minGenerationalFitness);
 
         NEAT_DLL_EXPORT void dump(TiXmlElement *speciesElement);
     };
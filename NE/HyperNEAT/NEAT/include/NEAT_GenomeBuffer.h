@@ -0,0 +1,136 @@
+#ifndef __NEAT_GENOMEBUFFER_H__
+#define __NEAT_GENOMEBUFFER_H__
+
+#include "NEAT_Defines.h"
+#include "NEAT_STL.h"
+
+namespace NEAT
+{
+    /**
+     * GenomeWriter: Appends values to a byte buffer in their native binary form.  This is
+     * the wire format used between MPI ranks, so every rank has to share the same
+     * endianness and type sizes (which is the case on a homogeneous cluster).
+     */
+    class GenomeWriter
+    {
+    protected:
+        vector<char> &buffer;
+
+    public:
+        GenomeWriter(vector<char> &_buffer)
+                :
+                buffer(_buffer)
+        {
+        }
+
+        template<class T>
+        inline void write(const T &value)
+        {
+            const char *bytes = reinterpret_cast<const char *>(&value);
+            buffer.insert(buffer.end(),bytes,bytes+sizeof(T));
+        }
+
+        inline void write(const string &value)
+        {
+            write(int(value.length()));
+            buffer.insert(buffer.end(),value.begin(),value.end());
+        }
+
+        inline void write(bool value)
+        {
+            write((unsigned char)(value?1:0));
+        }
+
+        /**
+         * reserveLength: Leaves room for a length and returns its offset.  Pass the offset to
+         * writeLength() once everything the length covers has been written.
+         */
+        inline size_t reserveLength()
+        {
+            size_t offset = buffer.size();
+            write(int(0));
+            return offset;
+        }
+
+        inline void writeLength(size_t offset)
+        {
+            int length = int(buffer.size()-offset-sizeof(int));
+            memcpy(&buffer[offset],&length,sizeof(int));
+        }
+
+        inline size_t size() const
+        {
+            return buffer.size();
+        }
+    };
+
+    /**
+     * GenomeReader: Reads values written by a GenomeWriter straight out of a receive
+     * buffer, without copying the buffer into a stream first.
+     */
+    class GenomeReader
+    {
+    protected:
+        const char *position;
+
+        const char *end;
+
+    public:
+        GenomeReader(const char *data,size_t size)
+                :
+                position(data),
+                end(data+size)
+        {
+        }
+
+        template<class T>
+        inline T read()
+        {
+            T value;
+            memcpy(&value,take(sizeof(T)),sizeof(T));
+            return value;
+        }
+
+        inline string readString()
+        {
+            int length = read<int>();
+            if (length<0)
+            {
+                throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Negative string length in genome buffer!");
+            }
+            const char *data = take(length);
+            return string(data,data+length);
+        }
+
+        inline bool readBool()
+        {
+            return read<unsigned char>()!=0;
+        }
+
+        /**
+         * take: Returns a pointer to the next 'count' bytes and moves past them
+         */
+        inline const char *take(size_t count)
+        {
+            if (size_t(end-position)<count)
+            {
+                throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Read past the end of a genome buffer!");
+            }
+            const char *data = position;
+            position += count;
+            return data;
+        }
+
+        inline const char *getPosition() const
+        {
+            return position;
+        }
+
+        inline size_t getBytesLeft() const
+        {
+            return size_t(end-position);
+        }
+    };
+}
+
+#endif
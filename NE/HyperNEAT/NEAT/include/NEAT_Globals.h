@@ -4,14 +4,19 @@
 #include "NEAT_Defines.h"
 #include "NEAT_STL.h"
 #include "NEAT_Random.h"
+#include "NEAT_InnovationTable.h"
 #include "tinyxmlplus.h"
 
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/shared_ptr.hpp>
+#include <boost/thread/tss.hpp>
 
 /* #defines */
 #define LAST_GENERATION  (-1)
 
+/* Genes created under a ProvisionalIDScope get IDs from here up until they are committed */
+#define PROVISIONAL_GENE_ID (0x40000000)
+
 enum ActivationFunction
 {
     ACTIVATION_FUNCTION_SIGMOID = 0,
@@ -29,9 +34,28 @@ extern const char *activationFunctionNames[ACTIVATION_FUNCTION_END];
 
 namespace NEAT
 {
+    /**
+     * SigmoidMode: How ACTIVATION_FUNCTION_SIGMOID is computed.
+     * SIGMOID_MODE_TABLE: lookup in the 6001-entry sigmoid tables between -2.9 and 2.9,
+     *   exp() outside of it.  Max abs error of the signed sigmoid is 5e-4 (table truncation).
+     * SIGMOID_MODE_TANH: exp() based tanh (the "UseTanhSigmoid" parameter).
+     * SIGMOID_MODE_FAST: fastTanh() in NEAT_ActivationFunction.h (the "UseFastSigmoid" parameter).  No tables, no exp()
+     *   and no branches.  Max abs error is 9.6e-5 for the signed and 4.8e-5 for the unsigned sigmoid.
+     */
+    enum SigmoidMode
+    {
+        SIGMOID_MODE_TABLE = 0,
+        SIGMOID_MODE_TANH,
+        SIGMOID_MODE_FAST
+    };
+
+    class ProvisionalIDs;
+
     class Globals
     {
         friend class boost::serialization::access;
+        friend class RandomStreamScope;
+        friend class ProvisionalIDScope;
         template<class Archive>
             void save(Archive & ar, const unsigned int version) const
         {
@@ -39,7 +63,8 @@ namespace NEAT
             ar & linkCounter;
             ar & speciesCounter;
             ar & minPossibleFitness;
-            ar & linkGenesThisGeneration;
+            ar & linkInnovations;
+            ar & nodeInnovations;
 
             // Serialize the parameters
             int numParams = parameters.size();
@@ -60,7 +85,18 @@ namespace NEAT
             ar & linkCounter;
             ar & speciesCounter;
             ar & minPossibleFitness;
-            ar & linkGenesThisGeneration;
+            if (version<1)
+            {
+                //Older archives have the link history as a list of genes
+                vector<shared_ptr<GeneticLinkGene> > linkGenesThisGeneration;
+                ar & linkGenesThisGeneration;
+                loadLinkHistory(linkGenesThisGeneration);
+            }
+            else
+            {
+                ar & linkInnovations;
+                ar & nodeInnovations;
+            }
 
             // De-serialize the parameters
             int numParams;
@@ -85,17 +121,40 @@ namespace NEAT
 
         double minPossibleFitness;
 
-        vector<shared_ptr<GeneticLinkGene> > linkGenesThisGeneration;
+        /**
+         * linkInnovations: The ID of each (fromNodeID,toNodeID) link created this generation
+         */
+        InnovationTable linkInnovations;
+
+        /**
+         * nodeInnovations: The ID of the node made by splitting each (fromNodeID,toNodeID) link
+         * this generation
+         */
+        InnovationTable nodeInnovations;
 
         StackMap<string,double,4096> parameters;
 
         Random random;
 
+        /**
+         * threadRandom: The generator installed on the calling thread by a
+         * RandomStreamScope, if any.  Not owned.
+         */
+        NEAT_DLL_EXPORT static boost::thread_specific_ptr<Random> threadRandom;
+
+        /**
+         * threadProvisionalIDs: The ProvisionalIDs installed on the calling thread by a
+         * ProvisionalIDScope, if any.  Not owned.
+         */
+        NEAT_DLL_EXPORT static boost::thread_specific_ptr<ProvisionalIDs> threadProvisionalIDs;
+
 		int extraActivationUpdates;
 
 		bool signedActivation;
 
 		bool useTanhSigmoid;
+
+		bool useFastSigmoid;
     public:
         static inline Globals *getSingleton()
         {
@@ -143,6 +202,12 @@ namespace NEAT
 
         NEAT_DLL_EXPORT void assignNodeID(GeneticNodeGene *testNode);
 
+        /**
+         * assignNodeID: Gives a node made by splitting the fromNodeID->toNodeID link its ID.
+         * Nodes that split the same link in the same generation get the same ID.
+         */
+        NEAT_DLL_EXPORT void assignNodeID(GeneticNodeGene *testNode,int splitFromNodeID,int splitToNodeID);
+
         NEAT_DLL_EXPORT void assignLinkID(GeneticLinkGene *testLink,bool ignoreHistory=false);
 
         NEAT_DLL_EXPORT void clearLinkHistory();
@@ -159,6 +224,12 @@ namespace NEAT
 
         NEAT_DLL_EXPORT void setParameterValue(string name,double value);
 
+        /**
+         * getThreadCount: Reads a thread count parameter.  0, a negative value or no parameter
+         * at all means one thread per core.
+         */
+        NEAT_DLL_EXPORT int getThreadCount(const string &parameterName);
+
         inline StackMap<string,double,4096>::iterator getMapBegin()
         {
             return parameters.begin();
@@ -171,11 +242,24 @@ namespace NEAT
 
         NEAT_DLL_EXPORT void initRandom();
 
+        /**
+         * getRandom: The generator of the calling thread.  This is the master generator
+         * unless a RandomStreamScope is active on the thread.
+         */
         inline Random &getRandom()
         {
-            return random;
+            Random *streamRandom = threadRandom.get();
+            return streamRandom ? *streamRandom : random;
         }
 
+        /**
+         * getRandomStream: A generator derived from the master seed and streamId.  The same
+         * seed and streamId always give the same numbers, no matter which thread uses them,
+         * so work split across threads stays reproducible if each task gets its own id.
+         * The master generator is stream 0 and is never returned here.
+         */
+        NEAT_DLL_EXPORT Random getRandomStream(ulong streamId);
+
         NEAT_DLL_EXPORT void seedRandom(unsigned int newSeed);
 
         NEAT_DLL_EXPORT void dump(TiXmlElement *root);
@@ -195,6 +279,20 @@ namespace NEAT
 			return useTanhSigmoid;
 		}
 
+		inline bool isUsingFastSigmoid()
+		{
+			return useFastSigmoid;
+		}
+
+		inline SigmoidMode getSigmoidMode()
+		{
+			if (useFastSigmoid)
+			{
+				return SIGMOID_MODE_FAST;
+			}
+			return useTanhSigmoid ? SIGMOID_MODE_TANH : SIGMOID_MODE_TABLE;
+		}
+
     protected:
         NEAT_DLL_EXPORT Globals();
 
@@ -209,8 +307,95 @@ namespace NEAT
         int generateLinkID();
 
 		void cacheParameters();
+
+        void loadLinkHistory(const vector<shared_ptr<GeneticLinkGene> > &linkGenes);
+    };
+
+    /**
+     * RandomStreamScope: Makes Globals::getRandom() return 'stream' on the calling thread
+     * until the scope ends, so worker threads never draw from the shared master generator.
+     * Scopes can be nested.
+     */
+    class RandomStreamScope
+    {
+        Random *previous;
+
+    public:
+        NEAT_DLL_EXPORT RandomStreamScope(Random &stream);
+
+        NEAT_DLL_EXPORT ~RandomStreamScope();
+    };
+
+    /**
+     * ProvisionalIDs: Provisional IDs (PROVISIONAL_GENE_ID and up) for the genes of one individual
+     * built off the main thread, and the link each provisional node split.
+     * GeneticIndividual::commitProvisionalIDs() swaps them for real IDs later on one thread, so
+     * the IDs don't depend on the order the worker threads finish in.
+     */
+    class ProvisionalIDs
+    {
+        int nextNodeID,nextLinkID;
+
+        //(provisional node ID, (fromNodeID,toNodeID) of the split link)
+        vector<pair<int,pair<int,int> > > nodeSplits;
+
+    public:
+        ProvisionalIDs()
+                :
+                nextNodeID(PROVISIONAL_GENE_ID),
+                nextLinkID(PROVISIONAL_GENE_ID)
+        {
+        }
+
+        inline int generateNodeID()
+        {
+            return nextNodeID++;
+        }
+
+        inline int generateLinkID()
+        {
+            return nextLinkID++;
+        }
+
+        inline void addNodeSplit(int nodeID,int fromNodeID,int toNodeID)
+        {
+            nodeSplits.push_back(pair<int,pair<int,int> >(nodeID,pair<int,int>(fromNodeID,toNodeID)));
+        }
+
+        /**
+         * getNodeSplit: Returns false if the node wasn't made by splitting a link
+         */
+        inline bool getNodeSplit(int nodeID,int &fromNodeID,int &toNodeID) const
+        {
+            for (int a=0;a<(int)nodeSplits.size();a++)
+            {
+                if (nodeSplits[a].first==nodeID)
+                {
+                    fromNodeID = nodeSplits[a].second.first;
+                    toNodeID = nodeSplits[a].second.second;
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    /**
+     * ProvisionalIDScope: While the scope is alive, genes created on the calling thread take
+     * their IDs from 'ids' and leave the global counters and the innovation history alone.
+     */
+    class ProvisionalIDScope
+    {
+        ProvisionalIDs *previous;
+
+    public:
+        NEAT_DLL_EXPORT ProvisionalIDScope(ProvisionalIDs &ids);
+
+        NEAT_DLL_EXPORT ~ProvisionalIDScope();
     };
 
 }
 
+BOOST_CLASS_VERSION(NEAT::Globals, 1)
+
 #endif
@@ -0,0 +1,113 @@
+#ifndef __NEAT_INDEXEDPOPULATIONFILE_H__
+#define __NEAT_INDEXEDPOPULATIONFILE_H__
+
+#include "NEAT_Defines.h"
+#include "NEAT_STL.h"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace NEAT
+{
+    /**
+     * IndexedPopulationFile: A population file that one individual can be read from
+     * without decoding the rest.
+     *
+     * Layout (native byte order):
+     *   char[8]  magic "HNPOPIDX"
+     *   int      version, individualCount, generation, reserved
+     *   ulong    parametersOffset, archiveOffset, archiveSize
+     *   ulong    genomeOffsets[individualCount+1]
+     *   genomes  GeneticIndividual::dump(GenomeWriter&) records, uncompressed
+     *   params   int count, then (string name, double value) pairs: the Globals parameters
+     *   archive  the gzip'd boost archive of the whole population, byte for byte what
+     *            a .ser.gz file holds, so the two formats convert both ways losslessly
+     *
+     * The file is memory mapped, so reading individual N touches only the header, two
+     * offsets and that genome's bytes (plus the parameters, if loadParameters() is called).
+     */
+    class IndexedPopulationFile
+    {
+    protected:
+        boost::iostreams::mapped_file_source file;
+
+        int individualCount;
+
+        int generation;
+
+        const ulong *genomeOffsets;
+
+        ulong parametersOffset,archiveOffset,archiveSize;
+
+    public:
+        NEAT_DLL_EXPORT IndexedPopulationFile(const string &fileName);
+
+        NEAT_DLL_EXPORT virtual ~IndexedPopulationFile();
+
+        inline int getIndividualCount() const
+        {
+            return individualCount;
+        }
+
+        inline int getGeneration() const
+        {
+            return generation;
+        }
+
+        /**
+         * getIndividual: Decodes one individual of the saved generation
+         */
+        NEAT_DLL_EXPORT shared_ptr<GeneticIndividual> getIndividual(int individualIndex) const;
+
+        /**
+         * loadParameters: Restores the Globals parameters saved with the population and
+         * reseeds the random number generator, the same as loading the boost archive does
+         */
+        NEAT_DLL_EXPORT void loadParameters() const;
+
+        /**
+         * getArchive: The gzip'd boost archive of the whole population
+         */
+        inline const char *getArchiveData() const
+        {
+            return file.data()+archiveOffset;
+        }
+
+        inline size_t getArchiveSize() const
+        {
+            return size_t(archiveSize);
+        }
+
+        /**
+         * write: Saves the individuals of one generation and the Globals parameters along
+         * with the population archive
+         */
+        NEAT_DLL_EXPORT static void write(
+            const string &fileName,
+            const vector<shared_ptr<GeneticIndividual> > &individuals,
+            int generation,
+            const string &archive
+        );
+
+        /**
+         * isIndexedPopulationFile: Checks the magic number at the start of the file
+         */
+        NEAT_DLL_EXPORT static bool isIndexedPopulationFile(const string &fileName);
+
+    protected:
+        /**
+         * This class cannot be copied
+         */
+        IndexedPopulationFile(const IndexedPopulationFile &other)
+        {}
+
+        /**
+         * This class cannot be copied
+         */
+        const IndexedPopulationFile &operator=(const IndexedPopulationFile &other)
+        {
+            return *this;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef __NEAT_INNOVATIONTABLE_H__
+#define __NEAT_INNOVATIONTABLE_H__
+
+#include "NEAT_Defines.h"
+#include "NEAT_STL.h"
+
+#include <boost/serialization/vector.hpp>
+
+namespace NEAT
+{
+    /**
+     * InnovationTable: Maps a (fromNodeID,toNodeID) pair to the gene ID handed out for it.
+     * Open addressing with linear probing over a power-of-two array of plain ints, so a
+     * lookup is one hash and usually one or two compares, and nothing is allocated per gene.
+     */
+    class InnovationTable
+    {
+        friend class boost::serialization::access;
+        template<class Archive>
+            void save(Archive & ar, const unsigned int version) const
+        {
+            //Saved as (fromNodeID,toNodeID,ID) triples
+            vector<int> triples;
+            for (int a=0;a<(int)keys.size();a++)
+            {
+                if (keys[a]!=EMPTY_KEY)
+                {
+                    triples.push_back(int(keys[a]>>32));
+                    triples.push_back(int(keys[a]&0xFFFFFFFFULL));
+                    triples.push_back(values[a]);
+                }
+            }
+            ar & triples;
+        }
+        template<class Archive>
+            void load(Archive & ar, const unsigned int version)
+        {
+            vector<int> triples;
+            ar & triples;
+
+            clear();
+            for (int a=0;a+2<(int)triples.size();a+=3)
+            {
+                insert(triples[a],triples[a+1],triples[a+2]);
+            }
+        }
+        BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+        static const ulong EMPTY_KEY = ~0ULL;
+
+        vector<ulong> keys;
+
+        vector<int> values;
+
+        int count;
+
+        int shift;
+
+    public:
+        NEAT_DLL_EXPORT InnovationTable();
+
+        /**
+         * find: Returns the ID stored for the pair, or -1 if there is none
+         */
+        NEAT_DLL_EXPORT int find(int fromNodeID,int toNodeID) const;
+
+        /**
+         * insert: Stores the ID for the pair, replacing the old one if the pair is already there
+         */
+        NEAT_DLL_EXPORT void insert(int fromNodeID,int toNodeID,int ID);
+
+        /**
+         * clear: Empties the table.  The capacity is kept for the next generation.
+         */
+        NEAT_DLL_EXPORT void clear();
+
+        inline int size() const
+        {
+            return count;
+        }
+
+    protected:
+        static inline ulong makeKey(int fromNodeID,int toNodeID)
+        {
+            return (ulong((unsigned int)fromNodeID)<<32) | ulong((unsigned int)toNodeID);
+        }
+
+        //Fibonacci hashing: the top bits of the product are well mixed
+        inline int slotOf(ulong key) const
+        {
+            return int((key*0x9E3779B97F4A7C15ULL)>>shift);
+        }
+
+        void resize(int capacity);
+    };
+}
+
+#endif
@@ -12,6 +12,23 @@
 
 namespace NEAT
 {
+    class SubstrateQuery;
+
+    /**
+     * The CPPN inputs filled in for each substrate link query
+     */
+    enum CPPNInput
+    {
+        CPPN_INPUT_X1,
+        CPPN_INPUT_Y1,
+        CPPN_INPUT_X2,
+        CPPN_INPUT_Y2,
+        CPPN_INPUT_DELTAX,
+        CPPN_INPUT_DELTAY,
+        CPPN_INPUT_BIAS,
+        CPPN_NUM_INPUTS
+    };
+
     class LayeredSubstrateInfo
     {
     public:
@@ -105,6 +122,72 @@ namespace NEAT
 
 		NEAT_DLL_EXPORT void setValue(const Node &node,NetworkDataType _value);
 
+		/**
+		 * resolve: gets a handle to a substrate node.  Handles only depend on the
+		 * layer info, so they stay valid across calls to populateSubstrate().
+		 */
+		NEAT_DLL_EXPORT NodeHandle resolve(const Node &node);
+
+#ifdef USE_GPU
+		inline NetworkDataType getValue(const NodeHandle &node)
+		{
+			int stride = layerValidSizes[node.layer].x;
+			return gpuNetwork.getValue( Node(node.index%stride,node.index/stride,node.layer) );
+		}
+
+		inline void setValue(const NodeHandle &node,NetworkDataType _value)
+		{
+			int stride = layerValidSizes[node.layer].x;
+			gpuNetwork.setValue( Node(node.index%stride,node.index/stride,node.layer) ,_value);
+		}
+
+		inline void setLayerValues(int z,const NetworkDataType *values)
+		{
+			int stride = layerValidSizes[z].x;
+			for(int a=0;a<layerValidSizes[z].x*layerValidSizes[z].y;a++)
+			{
+				gpuNetwork.setValue( Node(a%stride,a/stride,z) ,values[a]);
+			}
+		}
+#else
+		/**
+		 * getValue: gets the value of a resolved substrate node
+		 */
+		inline NetworkDataType getValue(const NodeHandle &node) const
+		{
+			return network.getValue(node);
+		}
+
+		/**
+		 * setValue: sets the value of a resolved substrate node
+		 */
+		inline void setValue(const NodeHandle &node,NetworkDataType _value)
+		{
+			network.setValue(node,_value);
+		}
+
+		/**
+		 * setLayerValues: sets every node of layer z at once.  values holds one value
+		 * per node, at the indices of the resolved nodes.
+		 */
+		inline void setLayerValues(int z,const NetworkDataType *values)
+		{
+			network.setLayerValues(z,values);
+		}
+#endif
+
+		/**
+		 * setInputValues: sets every node of every input layer at once.  values holds
+		 * the input layers one after another in layer order, each laid out like
+		 * setLayerValues() reads it.
+		 */
+		NEAT_DLL_EXPORT void setInputValues(const NetworkDataType *values);
+
+		/**
+		 * getInputValueCount: the number of values setInputValues() reads
+		 */
+		NEAT_DLL_EXPORT int getInputValueCount();
+
 		inline int getNumLayers()
 		{
 			return (int)layerSizes.size();
@@ -160,6 +243,10 @@ namespace NEAT
         }
 		
 	protected:
+        /**
+         * getQueryInputs: computes the CPPN input values for a link query between layers z1 and z2
+         */
+        void getQueryInputs(const SubstrateQuery &query,int z1,int z2,NetworkDataType *inputs);
 	};
 }
 
@@ -6,6 +6,37 @@
 
 namespace NEAT
 {
+    /**
+    * NodeHandle: A node resolved once through a network's resolve() so that
+    * hot loops can read and write it without any name or position lookup.
+    * layer is only used by the layered networks; the other networks only
+    * use index.  A handle is only valid for the network (or the networks
+    * with the same layout) that it was resolved from.
+    */
+    class NodeHandle
+    {
+    public:
+        int layer;
+        int index;
+
+        NodeHandle()
+                :
+                layer(-1),
+                index(-1)
+        {}
+
+        NodeHandle(int _layer,int _index)
+                :
+                layer(_layer),
+                index(_index)
+        {}
+
+        inline bool isValid() const
+        {
+            return index>=0;
+        }
+    };
+
     /**
     * Network: This class is responsible for creating a neural network phenotype.
     * While this isn't as fast as FastNetwork, it allows you to have more control
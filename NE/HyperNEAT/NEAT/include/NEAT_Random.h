@@ -21,6 +21,12 @@ typedef boost::normal_distribution<> normal_distribution_type;
 
 namespace NEAT
 {
+    /**
+     * Random: A xoroshiro128+ generator.  The state is seeded with splitmix64 from the
+     * seed and a stream id, so generators with the same seed and different stream ids
+     * give independent sequences, and the same seed and stream id always give the same
+     * sequence.
+     */
     class Random
     {
     public:
@@ -28,23 +34,16 @@ namespace NEAT
     protected:
         unsigned int seed;
 
-        base_generator_type generator;
+        ulong stream;
 
-        int_distribution_type intDist;
-        variate_generator<base_generator_type,int_distribution_type> intGen;
-
-        real_distribution_type realDist;
-        variate_generator<base_generator_type,real_distribution_type> realGen;
-
-        normal_distribution_type normalDist;
-        variate_generator<base_generator_type,normal_distribution_type> normalGen;
+        ulong state[2];
 
     public:
         /**
          * Constructor:
          * Passing 0 for 'seed' sets the seed to the current time value
          */
-        NEAT_DLL_EXPORT Random(unsigned int _seed=0);
+        NEAT_DLL_EXPORT Random(unsigned int _seed=0,ulong _stream=0);
 
         ///Gets a random int 0 <= x < limit;
         NEAT_DLL_EXPORT int getRandomInt(int limit);
@@ -52,17 +51,35 @@ namespace NEAT
         ///Gets a random int min <= x <= max;
         NEAT_DLL_EXPORT int getRandomWithinRange(int min,int max);
 
-        ///Gets a random int min <= x <= max;
-        ///Gets a random floating point number low <= x <= high
+        ///Gets a random floating point number 0 <= x < 1
         NEAT_DLL_EXPORT double getRandomDouble();
 
+        ///Gets a random floating point number low <= x < high
         NEAT_DLL_EXPORT double getRandomDouble(double low,double high);
 
         inline unsigned int getSeed()
         {
             return seed;
         }
+
+        inline ulong getStream()
+        {
+            return stream;
+        }
+
     protected:
+        inline ulong next()
+        {
+            ulong s0 = state[0];
+            ulong s1 = state[1];
+            ulong result = s0 + s1;
+
+            s1 ^= s0;
+            state[0] = ((s0 << 24) | (s0 >> 40)) ^ s1 ^ (s1 << 16);
+            state[1] = (s1 << 37) | (s1 >> 27);
+
+            return result;
+        }
     };
 }
 
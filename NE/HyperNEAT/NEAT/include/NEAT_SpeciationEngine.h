@@ -0,0 +1,124 @@
+#ifndef __NEAT_SPECIATIONENGINE_H__
+#define __NEAT_SPECIATIONENGINE_H__
+
+#include "NEAT_Defines.h"
+#include "NEAT_STL.h"
+
+namespace NEAT
+{
+    class GeneticSpecies;
+
+    /**
+     * CompactGenome: The link gene IDs and weights of an individual as two flat arrays,
+     * which is all a compatibility test looks at.
+     */
+    class CompactGenome
+    {
+    public:
+        vector<int> linkIDs;
+
+        vector<double> weights;
+
+        CompactGenome()
+        {
+        }
+
+        NEAT_DLL_EXPORT CompactGenome(const GeneticIndividual *individual);
+    };
+
+    /**
+     * SpeciationEngine: Does the compatibility tests of GeneticPopulation::speciate().
+     * The coefficients are read once per call, species representatives are kept as
+     * CompactGenomes between generations, and the individuals are tested on
+     * "SpeciationThreads" threads.  The species assignment is the same as testing every
+     * individual against every species in order with GeneticIndividual::getCompatibility.
+     */
+    class SpeciationEngine
+    {
+        double disjointCoeff,excessCoeff,weightDiffCoeff,fitnessCoeff;
+
+        //Whether the cheap lower bound in canSkip() is valid for these coefficients
+        bool useLowerBound;
+
+        vector<shared_ptr<GeneticIndividual> > cachedRepresentatives;
+
+        vector<shared_ptr<CompactGenome> > cachedGenomes;
+
+    public:
+        NEAT_DLL_EXPORT SpeciationEngine();
+
+        /**
+         * speciate: Sets the species ID of every individual, appending new species to 'species'
+         * for the ones that don't fit an existing species.
+         */
+        NEAT_DLL_EXPORT void speciate(
+            const vector<shared_ptr<GeneticIndividual> > &individuals,
+            vector<shared_ptr<GeneticSpecies> > &species,
+            double compatThreshold
+        );
+
+        /**
+         * getCompatibility: Same as representative->getCompatibility(individual)
+         */
+        NEAT_DLL_EXPORT double getCompatibility(
+            const CompactGenome &representative,
+            double representativeFitness,
+            const CompactGenome &individual,
+            double individualFitness
+        ) const;
+
+        /**
+         * findSpecies: The index of the first representative compatible with the individual
+         * or -1 if there is none.
+         */
+        NEAT_DLL_EXPORT int findSpecies(
+            const vector<const CompactGenome*> &representatives,
+            const vector<double> &representativeFitness,
+            const CompactGenome &individual,
+            double individualFitness,
+            double compatThreshold
+        ) const;
+
+    protected:
+        /**
+         * canSkip: The excess and fitness terms only need the gene counts and the fitness.
+         * When the other two coefficients aren't negative, the full compatibility can't be
+         * less than these two terms, so if they already reach the threshold the merge of
+         * the gene lists is skipped.
+         */
+        inline bool canSkip(
+            const CompactGenome &representative,
+            double representativeFitness,
+            const CompactGenome &individual,
+            double individualFitness,
+            double compatThreshold
+        ) const
+        {
+            if (!useLowerBound)
+            {
+                return false;
+            }
+
+            int numExcess = abs(int(representative.linkIDs.size())-int(individual.linkIDs.size()));
+
+            return
+                excessCoeff*numExcess +
+                fitnessCoeff*getFitnessDifference(representativeFitness,individualFitness)
+                >= compatThreshold;
+        }
+
+        static inline double getFitnessDifference(double representativeFitness,double individualFitness)
+        {
+            double normalizedFitnessDifference = (representativeFitness/individualFitness);
+            if (normalizedFitnessDifference<1.0)
+            {
+                normalizedFitnessDifference = 1.0/normalizedFitnessDifference;
+            }
+            return normalizedFitnessDifference;
+        }
+
+        shared_ptr<CompactGenome> getRepresentativeGenome(shared_ptr<GeneticIndividual> representative);
+    };
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "NEAT_NetworkNode.h"
 #include "NEAT_NetworkLink.h"
 #include "NEAT_NetworkIndexedLink.h"
+#include "NEAT_ActivationFunction.h"
 
 namespace NEAT
 {
@@ -32,6 +33,12 @@ namespace NEAT
          */
         int numConstantNodes;
 
+        /**
+         * The activation functions, specialized for the Globals' activation settings
+         * when the network was built.  Applied to x and y separately.
+         */
+        ActivationKernel<Type> activationKernel;
+
     public:
         /**
          *  (Constructor) Create a Network with the inputed toplogy
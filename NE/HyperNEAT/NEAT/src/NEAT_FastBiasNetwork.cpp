@@ -17,9 +17,6 @@
 
 namespace NEAT
 {
-	extern double signedSigmoidTable[6001];
-	extern double unsignedSigmoidTable[6001];
-
 	template<class Type>
 	FastBiasNetwork<Type>::FastBiasNetwork(
 		const vector<NetworkNode *> &_nodes,
@@ -29,7 +26,8 @@ namespace NEAT
 		:
 	Network<Type>(),
 		numNodes(int(_nodes.size())),
-		numLinks(int(_links.size()))
+		numLinks(int(_links.size())),
+		activationKernel(ActivationKernel<Type>::fromGlobals())
 	{
 		data = (char*)malloc(
 			sizeof(Type)*2*numNodes +
@@ -129,7 +127,8 @@ namespace NEAT
 		:
 	Network<Type>(),
 		numNodes(_numNodes),
-		numLinks(_numLinks)
+		numLinks(_numLinks),
+		activationKernel(ActivationKernel<Type>::fromGlobals())
 	{
 		data = (char*)malloc(
 			sizeof(Type)*2*numNodes +
@@ -345,6 +344,7 @@ namespace NEAT
 			numLinks = other.numLinks;
 			nodeNameToIndex = other.nodeNameToIndex;
 			numConstantNodes = other.numConstantNodes;
+			activationKernel = other.activationKernel;
 
 			data = (char*)realloc(
 				data,
@@ -440,6 +440,17 @@ namespace NEAT
 		}
 	}
 
+	template<class Type>
+	NodeHandle FastBiasNetwork<Type>::resolve(const string &nodeName) const
+	{
+		map<string,int>::const_iterator it = nodeNameToIndex.find(nodeName);
+		if (it==nodeNameToIndex.end())
+		{
+			return NodeHandle();
+		}
+		return NodeHandle(0,it->second);
+	}
+
 	template<class Type>
 	void FastBiasNetwork<Type>::setBias(const string &nodeName,Type newBias)
 	{
@@ -556,10 +567,7 @@ namespace NEAT
 			}
 #endif
 
-			for (int a=numConstantNodes;a<numNodes;a++)
-			{
-				nodeNewValues[a] = runActivationFunction(nodeNewValues[a],activationFunctions[a]);
-			}
+			activationKernel.activateNodes(nodeNewValues,activationFunctions,numConstantNodes,numNodes);
 
 #if DEBUG_NETWORK
 			cout << "Before Copy: " << endl;
@@ -600,206 +608,6 @@ namespace NEAT
 		}
 	}
 
-	template<class Type>
-	Type FastBiasNetwork<Type>::runActivationFunction(Type tmpVal,ActivationFunction function)
-	{
-		Type retVal;
-
-		bool signedActivation=false;
-
-		if (Globals::getSingleton()->hasSignedActivation())
-		{
-			signedActivation=true;
-		}
-
-#if DEBUG_ACTIVATION_CALCULATION
-		cout << "Before: " << tmpVal;
-#endif
-
-		switch (function)
-		{
-		case ACTIVATION_FUNCTION_SIGMOID:
-			//newValue = fsigmoid(tmpVal,4.924273,2.4621365);
-
-			//try my own sigmoid
-
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Sigmoid> ";
-#endif
-				//signed sigmoid
-				if(Globals::getSingleton()->isUsingTanhSigmoid())
-				{
-					retVal = 2 / (1 + exp(-2 * tmpVal)) - 1;
-				}
-				else
-				{
-					if (tmpVal<-2.9||tmpVal>2.9)
-					{
-						retVal = (Type)( ((1.0 / (1+exp(-tmpVal))) - 0.5)*2.0 );
-					}
-					else
-					{
-						retVal = (Type)signedSigmoidTable[int(tmpVal*1000.0)+3000];
-					}
-				}
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Sigmoid> ";
-#endif
-				//unsigned sigmoid
-				if(Globals::getSingleton()->isUsingTanhSigmoid())
-				{
-					retVal = (1 + exp(-2 * tmpVal));
-				}
-				else
-				{
-					if (tmpVal<-2.9||tmpVal>2.9)
-					{
-						retVal = 1 / (1+exp(-tmpVal));
-					}
-					else
-					{
-						retVal = (Type)unsignedSigmoidTable[int(tmpVal*1000.0)+3000];
-					}
-				}
-			}
-			break;
-		case ACTIVATION_FUNCTION_SIN:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Sin> ";
-#endif
-				retVal = sin(tmpVal);
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Sin> ";
-#endif
-				retVal = (sin(tmpVal)+1)/2;
-			}
-			break;
-		case ACTIVATION_FUNCTION_COS:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Cos> ";
-#endif
-				retVal = cos(tmpVal);
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Cos> ";
-#endif
-				retVal = (cos(tmpVal)+1)/2;
-			}
-			break;
-		case ACTIVATION_FUNCTION_GAUSSIAN:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Gaussian> ";
-#endif
-				retVal = exp(-pow(tmpVal,2));
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Gaussian> ";
-#endif
-				retVal = exp(-pow(tmpVal,2));
-			}
-			break;
-		case ACTIVATION_FUNCTION_SQUARE:
-#if DEBUG_ACTIVATION_CALCULATION
-			cout << " <Square> ";
-#endif
-			retVal = tmpVal*tmpVal;
-			break;
-		case ACTIVATION_FUNCTION_ABS_ROOT:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Root> ";
-#endif
-				if (tmpVal<0.0)
-				{
-					retVal = -sqrt(fabs(tmpVal));
-				}
-				else
-				{
-					retVal = sqrt(fabs(tmpVal));
-				}
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Absolute Root> ";
-#endif
-				retVal = sqrt(fabs(tmpVal));
-			}
-			break;
-		case ACTIVATION_FUNCTION_LINEAR:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Linear> ";
-#endif
-				retVal = min(max(tmpVal,(Type)-3.0),(Type)3.0) / (Type)3.0;
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Absolute Linear> ";
-#endif
-				retVal = ((min(max(tmpVal,(Type)-3.0),(Type)3.0) / (Type)3.0) + 1) / (Type)2.0;
-			}
-			break;
-		case ACTIVATION_FUNCTION_ONES_COMPLIMENT:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Ones Compliment> ";
-#endif
-				Type tmpVal2 = min((Type)1.0,max((Type)-1.0,tmpVal/(Type)3.0));
-				if (tmpVal>-0.1)
-				{
-					retVal = max((Type)0.0,tmpVal2);
-					retVal = (Type)1.0-tmpVal2;
-				}
-				else
-				{
-					retVal = ((Type)-1.0) - tmpVal;
-				}
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Absolute Ones Compliment> ";
-#endif
-				Type tmpVal2 = (Type)min(1.0,max(0.0,tmpVal/3.0));
-				retVal = ((Type)1.0)-tmpVal2;
-			}
-			break;
-		default:
-			throw CREATE_LOCATEDEXCEPTION_INFO("Unknown activation function!!!");
-			break;
-		}
-
-#if DEBUG_ACTIVATION_CALCULATION
-		cout << " After: " << retVal << endl;
-#endif
-
-		return retVal;
-
-	}
-
 	template class FastBiasNetwork<float>; // explicit instantiation
 	template class FastBiasNetwork<double>; // explicit instantiation
 }
@@ -17,16 +17,228 @@
 
 #define DEBUG_NETWORK_UPDATE (0)
 
+// Use SSE for the float block kernels.  The lanes hold different destination nodes, so
+// every sum still adds its terms in source order and the results don't change.  Only
+// where the compiler targets SSE2 (-msse2, /arch:SSE2 or x64); otherwise the scalar
+// kernels are used.
+#ifndef FASTLAYEREDNETWORK_SIMD_ACCUMULATE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#define FASTLAYEREDNETWORK_SIMD_ACCUMULATE (1)
+#else
+#define FASTLAYEREDNETWORK_SIMD_ACCUMULATE (0)
+#endif
+#endif
+
+#if FASTLAYEREDNETWORK_SIMD_ACCUMULATE
+#include <emmintrin.h>
+#endif
+
 namespace NEAT
 {
     extern double signedSigmoidTable[6001];
     extern double unsignedSigmoidTable[6001];
 
+    //Weights from a source layer are stored compressed when at most this fraction is nonzero
+    static const double SPARSE_LINK_DENSITY = 0.5;
+
+    //Destination nodes per block of CompiledLayerLinks::blockWeights
+    static const int LINK_BLOCK_SIZE = 8;
+
+    //updateIncremental() rebuilds the input sums from scratch at least this often
+    static const int ACCUMULATOR_REFRESH_INTERVAL = 1024;
+
+    //Samples per register tile in updateBatch()
+    static const int SAMPLE_TILE_SIZE = 4;
+
+    //Samples per pass over the weights in updateBatch(), so the source rows of a pass stay in cache
+    static const int SAMPLE_CHUNK_SIZE = 64;
+
+    /**
+     * accumulateBlock: The sums of one block of destination nodes over the given source nodes
+     */
+    template<class Type>
+    inline void accumulateBlock(
+        const Type *blockWeights,
+        const Type *fromValues,
+        const int *fromNodes,
+        int numFromNodes,
+        Type *sums
+    )
+    {
+        Type blockSums[LINK_BLOCK_SIZE];
+        for (int lane=0;lane<LINK_BLOCK_SIZE;lane++)
+        {
+            blockSums[lane]=0;
+        }
+
+        for (int b=0;b<numFromNodes;b++)
+        {
+            Type fromValue = fromValues[fromNodes[b]];
+            const Type *weights = blockWeights + fromNodes[b]*LINK_BLOCK_SIZE;
+            for (int lane=0;lane<LINK_BLOCK_SIZE;lane++)
+            {
+                blockSums[lane] += fromValue * weights[lane];
+            }
+        }
+
+        for (int lane=0;lane<LINK_BLOCK_SIZE;lane++)
+        {
+            sums[lane]=blockSums[lane];
+        }
+    }
+
+    /**
+     * accumulateBlockTile: The sums of one block of destination nodes for up to
+     * SAMPLE_TILE_SIZE samples.  fromRows holds a row of samples for every source node,
+     * rowSize apart.  sums is [node][sample].
+     */
+    template<class Type>
+    inline void accumulateBlockTileScalar(
+        const Type *blockWeights,
+        const Type *fromRows,
+        size_t rowSize,
+        int numFromNodes,
+        int numSamples,
+        Type sums[LINK_BLOCK_SIZE][SAMPLE_TILE_SIZE]
+    )
+    {
+        for (int lane=0;lane<LINK_BLOCK_SIZE;lane++)
+        {
+            for (int sample=0;sample<numSamples;sample++)
+            {
+                sums[lane][sample]=0;
+            }
+        }
+
+        for (int fromNode=0;fromNode<numFromNodes;fromNode++)
+        {
+            const Type *weights = blockWeights + fromNode*LINK_BLOCK_SIZE;
+            const Type *fromValues = fromRows + fromNode*rowSize;
+            for (int sample=0;sample<numSamples;sample++)
+            {
+                for (int lane=0;lane<LINK_BLOCK_SIZE;lane++)
+                {
+                    sums[lane][sample] += fromValues[sample] * weights[lane];
+                }
+            }
+        }
+    }
+
+    template<class Type>
+    inline void accumulateBlockTile(
+        const Type *blockWeights,
+        const Type *fromRows,
+        size_t rowSize,
+        int numFromNodes,
+        int numSamples,
+        Type sums[LINK_BLOCK_SIZE][SAMPLE_TILE_SIZE]
+    )
+    {
+        accumulateBlockTileScalar(blockWeights,fromRows,rowSize,numFromNodes,numSamples,sums);
+    }
+
+#if FASTLAYEREDNETWORK_SIMD_ACCUMULATE
+    template<>
+    inline void accumulateBlock<float>(
+        const float *blockWeights,
+        const float *fromValues,
+        const int *fromNodes,
+        int numFromNodes,
+        float *sums
+    )
+    {
+        __m128 lowSums = _mm_setzero_ps();
+        __m128 highSums = _mm_setzero_ps();
+        for (int b=0;b<numFromNodes;b++)
+        {
+            __m128 fromValue = _mm_set1_ps(fromValues[fromNodes[b]]);
+            const float *weights = blockWeights + fromNodes[b]*LINK_BLOCK_SIZE;
+            lowSums = _mm_add_ps(lowSums,_mm_mul_ps(fromValue,_mm_loadu_ps(weights)));
+            highSums = _mm_add_ps(highSums,_mm_mul_ps(fromValue,_mm_loadu_ps(weights+4)));
+        }
+        _mm_storeu_ps(sums,lowSums);
+        _mm_storeu_ps(sums+4,highSums);
+    }
+
+    template<>
+    inline void accumulateBlockTile<float>(
+        const float *blockWeights,
+        const float *fromRows,
+        size_t rowSize,
+        int numFromNodes,
+        int numSamples,
+        float sums[LINK_BLOCK_SIZE][SAMPLE_TILE_SIZE]
+    )
+    {
+        if (numSamples<SAMPLE_TILE_SIZE)
+        {
+            //A partial tile, one sample at a time
+            for (int sample=0;sample<numSamples;sample++)
+            {
+                __m128 lowSums = _mm_setzero_ps();
+                __m128 highSums = _mm_setzero_ps();
+                for (int fromNode=0;fromNode<numFromNodes;fromNode++)
+                {
+                    const float *weights = blockWeights + fromNode*LINK_BLOCK_SIZE;
+                    __m128 fromValue = _mm_set1_ps(fromRows[fromNode*rowSize+sample]);
+                    lowSums = _mm_add_ps(lowSums,_mm_mul_ps(fromValue,_mm_loadu_ps(weights)));
+                    highSums = _mm_add_ps(highSums,_mm_mul_ps(fromValue,_mm_loadu_ps(weights+4)));
+                }
+
+                float lanes[LINK_BLOCK_SIZE];
+                _mm_storeu_ps(lanes,lowSums);
+                _mm_storeu_ps(lanes+4,highSums);
+                for (int lane=0;lane<LINK_BLOCK_SIZE;lane++)
+                {
+                    sums[lane][sample] = lanes[lane];
+                }
+            }
+            return;
+        }
+
+        //One pair of registers (the 8 nodes of the block) per sample
+        __m128 lowSums[SAMPLE_TILE_SIZE],highSums[SAMPLE_TILE_SIZE];
+        for (int sample=0;sample<SAMPLE_TILE_SIZE;sample++)
+        {
+            lowSums[sample] = _mm_setzero_ps();
+            highSums[sample] = _mm_setzero_ps();
+        }
+
+        for (int fromNode=0;fromNode<numFromNodes;fromNode++)
+        {
+            const float *weights = blockWeights + fromNode*LINK_BLOCK_SIZE;
+            __m128 lowWeights = _mm_loadu_ps(weights);
+            __m128 highWeights = _mm_loadu_ps(weights+4);
+            const float *fromValues = fromRows + fromNode*rowSize;
+            for (int sample=0;sample<SAMPLE_TILE_SIZE;sample++)
+            {
+                __m128 fromValue = _mm_set1_ps(fromValues[sample]);
+                lowSums[sample] = _mm_add_ps(lowSums[sample],_mm_mul_ps(fromValue,lowWeights));
+                highSums[sample] = _mm_add_ps(highSums[sample],_mm_mul_ps(fromValue,highWeights));
+            }
+        }
+
+        for (int sample=0;sample<SAMPLE_TILE_SIZE;sample++)
+        {
+            float lanes[LINK_BLOCK_SIZE];
+            _mm_storeu_ps(lanes,lowSums[sample]);
+            _mm_storeu_ps(lanes+4,highSums[sample]);
+            for (int lane=0;lane<LINK_BLOCK_SIZE;lane++)
+            {
+                sums[lane][sample] = lanes[lane];
+            }
+        }
+    }
+#endif
+
     template<class Type>
     FastLayeredNetwork<Type>::FastLayeredNetwork(const vector<NetworkLayer<Type> > &_layers)
         :
         Network<Type>(),
-        layers(_layers)
+        layers(_layers),
+        linksChanged(true),
+        totalNodeCount(0),
+        incrementalUpdates(0)
     {
         //Perform a sanity check on the layers
         for(size_t toLayer=0;toLayer<layers.size();toLayer++)
@@ -41,10 +253,20 @@ namespace NEAT
                 }
             }
         }
+
+        for(size_t a=0;a<layers.size();a++)
+        {
+            layerNodeOffsets.push_back(totalNodeCount);
+            totalNodeCount += layers[a].nodeValues.size();
+        }
     }
 
     template<class Type>
     FastLayeredNetwork<Type>::FastLayeredNetwork()
+        :
+        linksChanged(true),
+        totalNodeCount(0),
+        incrementalUpdates(0)
     {
     }
 
@@ -110,6 +332,25 @@ namespace NEAT
         layer.nodeValues[nodeArrayIndex] = newValue;
     }
 
+    template<class Type>
+    NodeHandle FastLayeredNetwork<Type>::resolve(const Node &nodeIndex)
+    {
+        if(nodeIndex.z>=(int)layers.size())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("OOPS");
+        }
+
+        NetworkLayer<Type> &layer = layers[nodeIndex.z];
+
+        int nodeArrayIndex = nodeIndex.y*layer.nodeStride + nodeIndex.x;
+        if(nodeArrayIndex>=(int)layer.nodeValues.size())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("OOPS");
+        }
+
+        return NodeHandle(nodeIndex.z,nodeArrayIndex);
+    }
+
     template<class Type>
     Type FastLayeredNetwork<Type>::getLink(const Node &fromNodeIndex,const Node &toNodeIndex)
     {
@@ -171,6 +412,7 @@ namespace NEAT
             }
 
             toLayer.fromWeights[a][toNodeArrayIndex*toLayer.nodeValues.size()+fromNodeArrayIndex] = weight;
+            linksChanged = true;
             return;
         }
 
@@ -187,52 +429,514 @@ namespace NEAT
     }
 
     template<class Type>
-    void FastLayeredNetwork<Type>::update()
+    void FastLayeredNetwork<Type>::compileLinks()
     {
-        for(typename vector<NetworkLayer<Type> >::iterator layer = layers.begin();layer != layers.end();layer++)
+        compiledLinks.assign(layers.size(),vector<CompiledLayerLinks<Type> >());
+
+        int maxFromNodes=0,maxToNodes=0;
+
+        for(size_t layerIndex=0;layerIndex<layers.size();layerIndex++)
         {
-            vector<Type> &toNodes = layer->nodeValues;
-            int numToNodes = (int)toNodes.size();
-            int toNode;
+            const NetworkLayer<Type> &layer = layers[layerIndex];
+            int numToNodes = (int)layer.nodeValues.size();
+            maxToNodes = max(maxToNodes,numToNodes);
+
+            compiledLinks[layerIndex].resize(layer.fromLayers.size());
 
-            //If you don't come from any layers, it's assumed that you are an input
-            //layer and your node values are constant
-            if(layer->fromLayers.size())
+            for(size_t a=0;a<layer.fromLayers.size();a++)
             {
-                for(toNode=0;toNode<numToNodes;toNode++)
+                int numFromNodes = (int)layers[layer.fromLayers[a]].nodeValues.size();
+                maxFromNodes = max(maxFromNodes,numFromNodes);
+
+                //Rows are numToNodes apart, the same as in setLink() and update()
+                const vector<Type> &weights = layer.fromWeights[a];
+                if(numToNodes==0 || size_t((numToNodes-1)*numToNodes+numFromNodes)>weights.size())
                 {
-                    toNodes[toNode]=0.0f;
+                    //The rows don't fit in the weight array, leave this to the dense loop
+                    continue;
                 }
 
-                for(size_t a=0;a<layer->fromLayers.size();a++)
+                int numLinks=0;
+                for(int toNode=0;toNode<numToNodes;toNode++)
                 {
-                    const NetworkLayer<Type> &fromLayer = layers[layer->fromLayers[a]];
+                    const Type *weightsPtr = &weights[toNode*numToNodes];
+                    for(int fromNode=0;fromNode<numFromNodes;fromNode++)
+                    {
+                        if(weightsPtr[fromNode]!=0)
+                        {
+                            numLinks++;
+                        }
+                    }
+                }
 
-                    const vector<Type> &fromNodes = fromLayer.nodeValues;
-                    const Type* fromNodesPtr = &(fromLayer.nodeValues[0]);
-                    int numFromNodes = (int)fromNodes.size();
+                CompiledLayerLinks<Type> &links = compiledLinks[layerIndex][a];
 
-                    Type nodeValue;
-                    int fromNode;
-                    Type* weightsPtr;
-                    for(toNode=0;toNode<numToNodes;toNode++)
+                if(numLinks > SPARSE_LINK_DENSITY*numToNodes*numFromNodes)
+                {
+                    int numBlocks = (numToNodes+LINK_BLOCK_SIZE-1)/LINK_BLOCK_SIZE;
+                    links.blockWeights.assign(size_t(numBlocks)*numFromNodes*LINK_BLOCK_SIZE,Type(0));
+                    for(int toNode=0;toNode<numToNodes;toNode++)
                     {
-                        nodeValue=0;
-                        weightsPtr = &(layer->fromWeights[a][toNode*layer->nodeValues.size()]);
-                        for(fromNode=0;fromNode<numFromNodes;fromNode++)
+                        const Type *weightsPtr = &weights[toNode*numToNodes];
+                        Type *blockWeightsPtr =
+                            &links.blockWeights[size_t(toNode-toNode%LINK_BLOCK_SIZE)*numFromNodes + toNode%LINK_BLOCK_SIZE];
+                        for(int fromNode=0;fromNode<numFromNodes;fromNode++)
                         {
-                            nodeValue += fromNodesPtr[fromNode] * weightsPtr[fromNode];
+                            blockWeightsPtr[fromNode*LINK_BLOCK_SIZE] = weightsPtr[fromNode];
                         }
+                    }
+                    continue;
+                }
+
+                links.columnStarts.assign(numFromNodes+1,0);
+                links.toNodes.resize(numLinks);
+                links.weights.resize(numLinks);
 
-                        toNodes[toNode] += nodeValue;
+                for(int toNode=0;toNode<numToNodes;toNode++)
+                {
+                    const Type *weightsPtr = &weights[toNode*numToNodes];
+                    for(int fromNode=0;fromNode<numFromNodes;fromNode++)
+                    {
+                        if(weightsPtr[fromNode]!=0)
+                        {
+                            links.columnStarts[fromNode+1]++;
+                        }
                     }
                 }
 
+                for(int fromNode=0;fromNode<numFromNodes;fromNode++)
+                {
+                    links.columnStarts[fromNode+1] += links.columnStarts[fromNode];
+                }
+
+                vector<int> nextLink(links.columnStarts.begin(),links.columnStarts.end()-1);
+                for(int toNode=0;toNode<numToNodes;toNode++)
+                {
+                    const Type *weightsPtr = &weights[toNode*numToNodes];
+                    for(int fromNode=0;fromNode<numFromNodes;fromNode++)
+                    {
+                        if(weightsPtr[fromNode]!=0)
+                        {
+                            int link = nextLink[fromNode]++;
+                            links.toNodes[link] = toNode;
+                            links.weights[link] = weightsPtr[fromNode];
+                        }
+                    }
+                }
+            }
+        }
+
+        activeNodes.reserve(maxFromNodes);
+        linkSums.reserve(maxToNodes);
+
+        //The input sums were built from the old weights
+        inputSums.clear();
+        cachedInputs.clear();
+
+        linksChanged = false;
+    }
+
+    template<class Type>
+    void FastLayeredNetwork<Type>::addLinkSums(
+        const CompiledLayerLinks<Type> &links,
+        int numToNodes,
+        int numFromNodes,
+        const Type *fromValues,
+        const int *fromNodes,
+        int numSumNodes,
+        Type *toValues
+    )
+    {
+        if(!links.columnStarts.empty())
+        {
+            linkSums.assign(numToNodes,Type(0));
+            for(int b=0;b<numSumNodes;b++)
+            {
+                int fromNode = fromNodes[b];
+                Type fromValue = fromValues[fromNode];
+                int linkEnd = links.columnStarts[fromNode+1];
+                for(int link=links.columnStarts[fromNode];link<linkEnd;link++)
+                {
+                    linkSums[links.toNodes[link]] += fromValue * links.weights[link];
+                }
+            }
+
+            for(int toNode=0;toNode<numToNodes;toNode++)
+            {
+                toValues[toNode] += linkSums[toNode];
+            }
+        }
+        else
+        {
+            Type blockSums[LINK_BLOCK_SIZE];
+            for(int blockStart=0;blockStart<numToNodes;blockStart+=LINK_BLOCK_SIZE)
+            {
+                accumulateBlock(
+                    &links.blockWeights[size_t(blockStart)*numFromNodes],
+                    fromValues,
+                    fromNodes,
+                    numSumNodes,
+                    blockSums
+                    );
+
+                int blockEnd = min(numToNodes,blockStart+LINK_BLOCK_SIZE);
+                for(int toNode=blockStart;toNode<blockEnd;toNode++)
+                {
+                    toValues[toNode] += blockSums[toNode-blockStart];
+                }
+            }
+        }
+    }
+
+    template<class Type>
+    void FastLayeredNetwork<Type>::updateLayer(size_t layerIndex,bool useInputSums)
+    {
+        NetworkLayer<Type> *layer = &layers[layerIndex];
+        vector<Type> &toNodes = layer->nodeValues;
+        int numToNodes = (int)toNodes.size();
+        int toNode;
+
+        //If you don't come from any layers, it's assumed that you are an input
+        //layer and your node values are constant
+        if(layer->fromLayers.empty())
+        {
+            return;
+        }
+
+        for(toNode=0;toNode<numToNodes;toNode++)
+        {
+            toNodes[toNode]=0.0f;
+        }
+
+        for(size_t a=0;a<layer->fromLayers.size();a++)
+        {
+            const NetworkLayer<Type> &fromLayer = layers[layer->fromLayers[a]];
+            const CompiledLayerLinks<Type> &links = compiledLinks[layerIndex][a];
+
+            if(useInputSums && fromLayer.fromLayers.empty() && links.isCompiled())
+            {
+                //The sums from an input layer are kept up to date by updateIncremental()
+                const vector<Type> &sums = inputSums[layerIndex][a];
+                for(toNode=0;toNode<numToNodes;toNode++)
+                {
+                    toNodes[toNode] += sums[toNode];
+                }
+                continue;
+            }
+
+            const vector<Type> &fromNodes = fromLayer.nodeValues;
+            const Type* fromNodesPtr = &(fromLayer.nodeValues[0]);
+            int numFromNodes = (int)fromNodes.size();
+
+            //Source nodes that are 0 add nothing to any sum, so they can be skipped.
+            //Every sum still adds its terms in source order, which keeps the sparse
+            //paths bit for bit identical to the dense loop.
+            activeNodes.clear();
+            for(int fromNode=0;fromNode<numFromNodes;fromNode++)
+            {
+                if(fromNodesPtr[fromNode]!=0)
+                {
+                    activeNodes.push_back(fromNode);
+                }
+            }
+            int numActiveNodes = (int)activeNodes.size();
+
+            Type nodeValue;
+            int fromNode;
+            Type* weightsPtr;
+            if(links.isCompiled())
+            {
+                addLinkSums(
+                    links,
+                    numToNodes,
+                    numFromNodes,
+                    fromNodesPtr,
+                    numActiveNodes ? &activeNodes[0] : NULL,
+                    numActiveNodes,
+                    &toNodes[0]
+                    );
+            }
+            else
+            {
                 for(toNode=0;toNode<numToNodes;toNode++)
                 {
-                    //Signed sigmoid activation function
-                    toNodes[toNode] = (2.0f / (1.0f + exp(-toNodes[toNode]))) - 1.0f;
+                    nodeValue=0;
+                    weightsPtr = &(layer->fromWeights[a][toNode*layer->nodeValues.size()]);
+                    for(fromNode=0;fromNode<numFromNodes;fromNode++)
+                    {
+                        nodeValue += fromNodesPtr[fromNode] * weightsPtr[fromNode];
+                    }
+
+                    toNodes[toNode] += nodeValue;
+                }
+            }
+        }
+
+        for(toNode=0;toNode<numToNodes;toNode++)
+        {
+            //Signed sigmoid activation function
+            toNodes[toNode] = (2.0f / (1.0f + exp(-toNodes[toNode]))) - 1.0f;
+        }
+    }
+
+    template<class Type>
+    void FastLayeredNetwork<Type>::update()
+    {
+        if(linksChanged)
+        {
+            compileLinks();
+        }
+
+        for(size_t layerIndex=0;layerIndex<layers.size();layerIndex++)
+        {
+            updateLayer(layerIndex,false);
+        }
+    }
+
+    template<class Type>
+    void FastLayeredNetwork<Type>::updateIncremental()
+    {
+        if(linksChanged)
+        {
+            compileLinks();
+        }
+
+        if(inputSums.size()!=layers.size())
+        {
+            inputSums.assign(layers.size(),vector<vector<Type> >());
+            for(size_t layerIndex=0;layerIndex<layers.size();layerIndex++)
+            {
+                inputSums[layerIndex].resize(layers[layerIndex].fromLayers.size());
+            }
+            cachedInputs.assign(layers.size(),vector<Type>());
+        }
+
+        //Rounding in the deltas adds up, so every so often the sums are rebuilt from scratch
+        bool refreshAll = (incrementalUpdates>=ACCUMULATOR_REFRESH_INTERVAL);
+        incrementalUpdates = refreshAll ? 0 : incrementalUpdates+1;
+
+        for(size_t inputIndex=0;inputIndex<layers.size();inputIndex++)
+        {
+            const vector<Type> &inputValues = layers[inputIndex].nodeValues;
+            int numInputs = (int)inputValues.size();
+            if(!layers[inputIndex].fromLayers.empty() || numInputs==0)
+            {
+                continue;
+            }
+
+            vector<Type> &cached = cachedInputs[inputIndex];
+
+            activeNodes.clear();
+            for(int fromNode=0;fromNode<numInputs;fromNode++)
+            {
+                if(inputValues[fromNode]!=0)
+                {
+                    activeNodes.push_back(fromNode);
+                }
+            }
+
+            changedNodes.clear();
+            bool refresh = refreshAll || int(cached.size())!=numInputs;
+            if(!refresh)
+            {
+                inputDeltas.resize(numInputs);
+                for(int fromNode=0;fromNode<numInputs;fromNode++)
+                {
+                    if(inputValues[fromNode]!=cached[fromNode])
+                    {
+                        changedNodes.push_back(fromNode);
+                        inputDeltas[fromNode] = inputValues[fromNode]-cached[fromNode];
+                    }
+                }
+
+                if(changedNodes.empty())
+                {
+                    continue;
                 }
+
+                //Rebuilding touches only the active inputs, so it is never more work
+                refresh = (changedNodes.size()>=activeNodes.size());
+            }
+
+            for(size_t layerIndex=0;layerIndex<layers.size();layerIndex++)
+            {
+                const NetworkLayer<Type> &layer = layers[layerIndex];
+                int numToNodes = (int)layer.nodeValues.size();
+                for(size_t a=0;a<layer.fromLayers.size();a++)
+                {
+                    const CompiledLayerLinks<Type> &links = compiledLinks[layerIndex][a];
+                    if(layer.fromLayers[a]!=int(inputIndex) || !links.isCompiled())
+                    {
+                        continue;
+                    }
+
+                    vector<Type> &sums = inputSums[layerIndex][a];
+                    if(refresh)
+                    {
+                        //Exactly the sums update() adds for this layer
+                        sums.assign(numToNodes,Type(0));
+                        addLinkSums(
+                            links,
+                            numToNodes,
+                            numInputs,
+                            &inputValues[0],
+                            activeNodes.empty() ? NULL : &activeNodes[0],
+                            (int)activeNodes.size(),
+                            &sums[0]
+                            );
+                    }
+                    else
+                    {
+                        //A rank-1 update for each input that changed
+                        addLinkSums(
+                            links,
+                            numToNodes,
+                            numInputs,
+                            &inputDeltas[0],
+                            &changedNodes[0],
+                            (int)changedNodes.size(),
+                            &sums[0]
+                            );
+                    }
+                }
+            }
+
+            cached = inputValues;
+        }
+
+        for(size_t layerIndex=0;layerIndex<layers.size();layerIndex++)
+        {
+            updateLayer(layerIndex,true);
+        }
+    }
+
+    template<class Type>
+    void FastLayeredNetwork<Type>::updateBatch(vector<Type> &batchValues,int batchSize)
+    {
+        if(batchSize<=0)
+        {
+            return;
+        }
+
+        if(batchValues.size()<getBatchValueCount(batchSize))
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("The batch values are too small for the batch size!");
+        }
+
+        if(linksChanged)
+        {
+            compileLinks();
+        }
+
+        size_t rowSize = size_t(batchSize);
+
+        for(size_t layerIndex=0;layerIndex<layers.size();layerIndex++)
+        {
+            const NetworkLayer<Type> &layer = layers[layerIndex];
+
+            //Input layers keep the values they were given
+            if(layer.fromLayers.empty())
+            {
+                continue;
+            }
+
+            int numToNodes = (int)layer.nodeValues.size();
+            Type *toRows = &batchValues[layerNodeOffsets[layerIndex]*rowSize];
+            size_t numToValues = size_t(numToNodes)*rowSize;
+            for(size_t b=0;b<numToValues;b++)
+            {
+                toRows[b]=0;
+            }
+
+            for(size_t a=0;a<layer.fromLayers.size();a++)
+            {
+                int fromLayerIndex = layer.fromLayers[a];
+                int numFromNodes = (int)layers[fromLayerIndex].nodeValues.size();
+                const Type *fromRows = &batchValues[layerNodeOffsets[fromLayerIndex]*rowSize];
+
+                const CompiledLayerLinks<Type> &links = compiledLinks[layerIndex][a];
+
+                if(!links.columnStarts.empty())
+                {
+                    //Scatter every link to the whole row of samples
+                    linkSums.assign(numToValues,Type(0));
+                    for(int fromNode=0;fromNode<numFromNodes;fromNode++)
+                    {
+                        const Type *fromRow = fromRows + fromNode*rowSize;
+                        int linkEnd = links.columnStarts[fromNode+1];
+                        for(int link=links.columnStarts[fromNode];link<linkEnd;link++)
+                        {
+                            Type weight = links.weights[link];
+                            Type *sumRow = &linkSums[links.toNodes[link]*rowSize];
+                            for(size_t sample=0;sample<rowSize;sample++)
+                            {
+                                sumRow[sample] += fromRow[sample] * weight;
+                            }
+                        }
+                    }
+
+                    for(size_t b=0;b<numToValues;b++)
+                    {
+                        toRows[b] += linkSums[b];
+                    }
+                }
+                else if(!links.blockWeights.empty())
+                {
+                    Type tileSums[LINK_BLOCK_SIZE][SAMPLE_TILE_SIZE];
+                    for(int chunkStart=0;chunkStart<batchSize;chunkStart+=SAMPLE_CHUNK_SIZE)
+                    {
+                        int chunkEnd = min(batchSize,chunkStart+SAMPLE_CHUNK_SIZE);
+                        for(int blockStart=0;blockStart<numToNodes;blockStart+=LINK_BLOCK_SIZE)
+                        {
+                            const Type *blockWeights = &links.blockWeights[size_t(blockStart)*numFromNodes];
+                            int blockEnd = min(numToNodes,blockStart+LINK_BLOCK_SIZE);
+                            for(int tileStart=chunkStart;tileStart<chunkEnd;tileStart+=SAMPLE_TILE_SIZE)
+                            {
+                                int numSamples = min(SAMPLE_TILE_SIZE,chunkEnd-tileStart);
+                                accumulateBlockTile(
+                                    blockWeights,
+                                    fromRows+tileStart,
+                                    rowSize,
+                                    numFromNodes,
+                                    numSamples,
+                                    tileSums
+                                    );
+
+                                for(int toNode=blockStart;toNode<blockEnd;toNode++)
+                                {
+                                    Type *toRow = toRows + toNode*rowSize + tileStart;
+                                    for(int sample=0;sample<numSamples;sample++)
+                                    {
+                                        toRow[sample] += tileSums[toNode-blockStart][sample];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    for(size_t sample=0;sample<rowSize;sample++)
+                    {
+                        for(int toNode=0;toNode<numToNodes;toNode++)
+                        {
+                            Type nodeValue=0;
+                            const Type *weightsPtr = &(layer.fromWeights[a][toNode*layer.nodeValues.size()]);
+                            for(int fromNode=0;fromNode<numFromNodes;fromNode++)
+                            {
+                                nodeValue += fromRows[fromNode*rowSize+sample] * weightsPtr[fromNode];
+                            }
+
+                            toRows[toNode*rowSize+sample] += nodeValue;
+                        }
+                    }
+                }
+            }
+
+            for(size_t b=0;b<numToValues;b++)
+            {
+                //Signed sigmoid activation function
+                toRows[b] = (2.0f / (1.0f + exp(-toRows[b]))) - 1.0f;
             }
         }
     }
@@ -17,17 +17,35 @@
 
 #define DEBUG_NETWORK_UPDATE (0)
 
+// Use the compiled (target-sorted) link layout in update() by default
+#define FASTNETWORK_COMPILED_UPDATE (1)
+
 namespace NEAT
 {
-    extern double signedSigmoidTable[6001];
-    extern double unsignedSigmoidTable[6001];
+
+    /**
+     * accumulateLinks: sums the weighted values of one row of the compiled link layout
+     */
+    template<class Type>
+    inline Type accumulateLinks(const Type *values,const int *fromNodes,const Type *weights,int count)
+    {
+        Type sum=0;
+        for (int a=0;a<count;a++)
+        {
+            sum += values[fromNodes[a]]*weights[a];
+        }
+        return sum;
+    }
 
     template<class Type>
     FastNetwork<Type>::FastNetwork(const vector<NetworkNode *> &_nodes,const vector<NetworkLink *> &_links)
         :
     Network<Type>(),
         numNodes(int(_nodes.size())),
-        numLinks(int(_links.size()))
+        numLinks(int(_links.size())),
+        compiledUpdate(FASTNETWORK_COMPILED_UPDATE),
+        compiledWeightsDirty(false),
+        activationKernel(ActivationKernel<Type>::fromGlobals())
     {
         data = (char*)malloc(
             sizeof(Type)*2*numNodes +
@@ -104,6 +122,8 @@ namespace NEAT
 
                 nodeLinkMap[pair<int,int>(links[a].fromNode,links[a].toNode)] = a;
             }
+
+            buildCompiledLinks();
     }
 
     template<class Type>
@@ -111,7 +131,10 @@ namespace NEAT
         :
     Network<Type>(),
         numNodes(_numNodes),
-        numLinks(_numLinks)
+        numLinks(_numLinks),
+        compiledUpdate(FASTNETWORK_COMPILED_UPDATE),
+        compiledWeightsDirty(false),
+        activationKernel(ActivationKernel<Type>::fromGlobals())
     {
         data = (char*)malloc(
             sizeof(Type)*2*numNodes +
@@ -188,6 +211,8 @@ namespace NEAT
 
                 nodeLinkMap[pair<int,int>(links[a].fromNode,links[a].toNode)] = a;
             }
+
+            buildCompiledLinks();
     }
 
     template<class Type>
@@ -198,7 +223,10 @@ namespace NEAT
         :
     Network<Type>(),
         numNodes(int(_nodes.size())),
-        numLinks(int(_links.size()))
+        numLinks(int(_links.size())),
+        compiledUpdate(FASTNETWORK_COMPILED_UPDATE),
+        compiledWeightsDirty(false),
+        activationKernel(ActivationKernel<Type>::fromGlobals())
     {
         data = (char*)malloc(
             sizeof(Type)*2*numNodes +
@@ -279,6 +307,7 @@ namespace NEAT
                 nodeLinkMap[pair<int,int>(links[a].fromNode,links[a].toNode)] = a;
             }
 
+            buildCompiledLinks();
     }
 
     template<class Type>
@@ -287,7 +316,9 @@ namespace NEAT
     Network<Type>(),
         numNodes(0),
         numLinks(0),
-        data(NULL)
+        data(NULL),
+        compiledUpdate(FASTNETWORK_COMPILED_UPDATE),
+        compiledWeightsDirty(false)
     {
 	}
 
@@ -325,6 +356,15 @@ namespace NEAT
             nodeNameToIndex = other.nodeNameToIndex;
             numConstantNodes = other.numConstantNodes;
             nodeLinkMap = other.nodeLinkMap;
+            compiledUpdate = other.compiledUpdate;
+            compiledWeightsDirty = other.compiledWeightsDirty;
+            compiledRowStart = other.compiledRowStart;
+            compiledFromNodes = other.compiledFromNodes;
+            compiledWeights = other.compiledWeights;
+            compiledLinkOrder = other.compiledLinkOrder;
+            activationGroupNodes = other.activationGroupNodes;
+            activationGroupStart = other.activationGroupStart;
+            activationKernel = other.activationKernel;
 
             data = (char*)realloc(
                 data,
@@ -357,6 +397,66 @@ namespace NEAT
         }
     }
 
+    template<class Type>
+    void FastNetwork<Type>::buildCompiledLinks()
+    {
+        int numUpdatedNodes = numNodes-numConstantNodes;
+
+        //Count the incoming links of each updated node.  Links into constant
+        //nodes never change anything, so they are left out.
+        compiledRowStart.assign(numUpdatedNodes+1,0);
+        for (int a=0;a<numLinks;a++)
+        {
+            if (links[a].toNode>=numConstantNodes)
+            {
+                compiledRowStart[links[a].toNode-numConstantNodes+1]++;
+            }
+        }
+        for (int a=0;a<numUpdatedNodes;a++)
+        {
+            compiledRowStart[a+1] += compiledRowStart[a];
+        }
+
+        //Keep the links of each row in creation order so every node sums its
+        //inputs in the same order as the link-order kernel
+        int numCompiledLinks = compiledRowStart[numUpdatedNodes];
+        compiledFromNodes.resize(numCompiledLinks);
+        compiledWeights.resize(numCompiledLinks);
+        compiledLinkOrder.resize(numCompiledLinks);
+
+        vector<int> rowCursor(compiledRowStart.begin(),compiledRowStart.end()-1);
+        for (int a=0;a<numLinks;a++)
+        {
+            if (links[a].toNode>=numConstantNodes)
+            {
+                int slot = rowCursor[links[a].toNode-numConstantNodes]++;
+                compiledFromNodes[slot] = links[a].fromNode;
+                compiledWeights[slot] = links[a].weight;
+                compiledLinkOrder[slot] = a;
+            }
+        }
+
+        //Group the updated nodes by activation function
+        activationGroupStart.assign(ACTIVATION_FUNCTION_END+1,0);
+        for (int a=numConstantNodes;a<numNodes;a++)
+        {
+            activationGroupStart[activationFunctions[a]+1]++;
+        }
+        for (int a=0;a<ACTIVATION_FUNCTION_END;a++)
+        {
+            activationGroupStart[a+1] += activationGroupStart[a];
+        }
+
+        activationGroupNodes.resize(numUpdatedNodes);
+        vector<int> groupCursor(activationGroupStart.begin(),activationGroupStart.end()-1);
+        for (int a=numConstantNodes;a<numNodes;a++)
+        {
+            activationGroupNodes[groupCursor[activationFunctions[a]]++] = a;
+        }
+
+        compiledWeightsDirty=false;
+    }
+
     template<class Type>
     FastNetwork<Type>::~FastNetwork()
     {
@@ -418,6 +518,23 @@ namespace NEAT
         }
     }
 
+    template<class Type>
+    int FastNetwork<Type>::getNodeIndex(const string &nodeName) const
+    {
+        map<string,int>::const_iterator it = nodeNameToIndex.find(nodeName);
+        if(it==nodeNameToIndex.end())
+        {
+            return -1;
+        }
+        return it->second;
+    }
+
+    template<class Type>
+    NodeHandle FastNetwork<Type>::resolve(const string &nodeName) const
+    {
+        return NodeHandle(0,getNodeIndex(nodeName));
+    }
+
     template<class Type>
     NetworkIndexedLink<Type> *FastNetwork<Type>::getLink(const string &fromNodeName,const string &toNodeName)
     {
@@ -439,6 +556,8 @@ namespace NEAT
         }
         else
         {
+            //The caller may change the weight
+            compiledWeightsDirty=true;
             return &links[it->second];
         }
     }
@@ -476,6 +595,50 @@ namespace NEAT
         memset(nodeValues,0,sizeof(Type)*numNodes);
     }
 
+    template<class Type>
+    void FastNetwork<Type>::updateCompiledIteration()
+    {
+        if (compiledRowStart.empty())
+        {
+            //Empty network
+            return;
+        }
+
+        int numUpdatedNodes = numNodes-numConstantNodes;
+        const int *rowStart = &compiledRowStart[0];
+        const int *fromNodes = compiledFromNodes.empty()?NULL:&compiledFromNodes[0];
+        const Type *weights = compiledWeights.empty()?NULL:&compiledWeights[0];
+
+        for (int a=0;a<numUpdatedNodes;a++)
+        {
+            nodeNewValues[numConstantNodes+a] = accumulateLinks(
+                nodeValues,
+                fromNodes+rowStart[a],
+                weights+rowStart[a],
+                rowStart[a+1]-rowStart[a]
+                );
+        }
+
+        for (int function=0;function<ACTIVATION_FUNCTION_END;function++)
+        {
+            int groupSize = activationGroupStart[function+1]-activationGroupStart[function];
+            if (groupSize)
+            {
+                activationKernel.activateGroup[function](
+                    nodeNewValues,
+                    &activationGroupNodes[activationGroupStart[function]],
+                    groupSize
+                    );
+            }
+        }
+
+        memcpy(
+            nodeValues+numConstantNodes,
+            nodeNewValues+numConstantNodes,
+            sizeof(Type)*numUpdatedNodes
+            );
+    }
+
     template<class Type>
     void FastNetwork<Type>::updateFixedIterations(int iterations)
     {
@@ -494,6 +657,24 @@ namespace NEAT
             //throw CREATE_LOCATEDEXCEPTION_INFO("THE NETWORK HAS BEEN UPDATED WHILE ALREADY ACTIVE!");
         }
 
+        if (compiledUpdate)
+        {
+            if (compiledWeightsDirty)
+            {
+                for (int a=0;a<(int)compiledLinkOrder.size();a++)
+                {
+                    compiledWeights[a] = links[compiledLinkOrder[a]].weight;
+                }
+                compiledWeightsDirty=false;
+            }
+
+            for (int a=0;a<count;a++)
+            {
+                updateCompiledIteration();
+            }
+            return;
+        }
+
         for (int a=0;a<count;a++)
         {
             /*for (int a=0;a<nodes.size();a++)
@@ -532,19 +713,7 @@ namespace NEAT
             }
 #endif
 
-			bool signedActivation=false;
-
-			if (Globals::getSingleton()->hasSignedActivation())
-			{
-				signedActivation=true;
-			}
-
-			bool usingTanhSigmoid = Globals::getSingleton()->isUsingTanhSigmoid();
-
-            for (int a=numConstantNodes;a<numNodes;a++)
-            {
-                nodeNewValues[a] = runActivationFunction(nodeNewValues[a],activationFunctions[a],signedActivation,usingTanhSigmoid);
-            }
+            activationKernel.activateNodes(nodeNewValues,activationFunctions,numConstantNodes,numNodes);
 
 #if DEBUG_NETWORK_UPDATE
             cout << "Before Copy: " << endl;
@@ -578,6 +747,89 @@ namespace NEAT
         }
     }
 
+    template<class Type>
+    void FastNetwork<Type>::updateBatch(
+        const int *inputIndices,
+        int numInputs,
+        const Type *inputValues,
+        int batchSize,
+        vector<Type> &batchValues
+        )
+    {
+        if(batchSize<=0)
+        {
+            return;
+        }
+
+        size_t rowSize = size_t(batchSize);
+        batchValues.resize(rowSize*numNodes*2);
+
+        Type *values = &batchValues[0];
+        Type *newValues = values + rowSize*numNodes;
+
+        memset(values,0,sizeof(Type)*rowSize*numNodes);
+        for (int a=0;a<numInputs;a++)
+        {
+            if(inputIndices[a]<0 || inputIndices[a]>=numConstantNodes)
+            {
+                throw CREATE_LOCATEDEXCEPTION_INFO("Batch input is not a constant node!");
+            }
+
+            memcpy(
+                values+rowSize*inputIndices[a],
+                inputValues+rowSize*a,
+                sizeof(Type)*rowSize
+                );
+        }
+
+        //Same as the first update() after reinitialize()
+        int count = 1+Globals::getSingleton()->getExtraActivationUpdates();
+
+        for (int iteration=0;iteration<count;iteration++)
+        {
+            //Constant nodes are never copied back, so they don't need new values
+            memset(
+                newValues+rowSize*numConstantNodes,
+                0,
+                sizeof(Type)*rowSize*(numNodes-numConstantNodes)
+                );
+
+            for (int a=0;a<numLinks;a++)
+            {
+                if(links[a].toNode<numConstantNodes)
+                {
+                    continue;
+                }
+
+                const Type *fromRow = values+rowSize*links[a].fromNode;
+                Type *toRow = newValues+rowSize*links[a].toNode;
+                Type weight = links[a].weight;
+
+                for (int b=0;b<batchSize;b++)
+                {
+                    toRow[b] += fromRow[b]*weight;
+                }
+            }
+
+            for (int a=numConstantNodes;a<numNodes;a++)
+            {
+                ActivationFunction function = activationFunctions[a];
+                if (function<0 || function>=ACTIVATION_FUNCTION_END)
+                {
+                    throw CREATE_LOCATEDEXCEPTION_INFO("Unknown activation function!!!");
+                }
+
+                activationKernel.activateRow[function](newValues+rowSize*a,batchSize);
+            }
+
+            memcpy(
+                values+rowSize*numConstantNodes,
+                newValues+rowSize*numConstantNodes,
+                sizeof(Type)*rowSize*(numNodes-numConstantNodes)
+                );
+        }
+    }
+
     template<class Type>
     void FastNetwork<Type>::print()
     {
@@ -599,6 +851,7 @@ namespace NEAT
         {
             links[a].weight = (Type)0.0;
         }
+        compiledWeightsDirty=true;
     }
 
     const float LEARNING_RATE = (0.5f);//(0.5f);
@@ -708,205 +961,8 @@ namespace NEAT
 
             links[linkErrorIterator->first].weight += deltaWeight;
         }
-    }
-
-    template<class Type>
-    Type FastNetwork<Type>::runActivationFunction(Type tmpVal,ActivationFunction function,bool signedActivation,bool usingTanhSigmoid)
-    {
-        Type retVal;
-
-
-#if DEBUG_ACTIVATION_CALCULATION
-        cout << "Before: " << tmpVal;
-#endif
-
-        switch (function)
-        {
-        case ACTIVATION_FUNCTION_SIGMOID:
-            //newValue = fsigmoid(tmpVal,4.924273,2.4621365);
-
-            //try my own sigmoid
-
-            if (signedActivation)
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Signed Sigmoid> ";
-#endif
-                if(usingTanhSigmoid)
-                {
-                    retVal = 2 / (1 + exp(-2 * tmpVal)) - 1;
-                }
-                else
-                {
-                    //signed sigmoid
-                    if (tmpVal<-2.9||tmpVal>2.9)
-                    {
-                        retVal = (Type)( ((1.0 / (1+exp(-tmpVal))) - 0.5)*2.0 );
-                    }
-                    else
-                    {
-						int sigmoidIndex = int(tmpVal*1000.0)+3000;
-						if(sigmoidIndex<0 || sigmoidIndex>6000)
-						{
-							throw CREATE_LOCATEDEXCEPTION_INFO("OOPS");
-						}
-                        retVal = (Type)signedSigmoidTable[sigmoidIndex];
-                    }
-                }
-            }
-            else
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Unsigned Sigmoid> ";
-#endif
-                //unsigned sigmoid
-                if(usingTanhSigmoid)
-                {
-                    retVal = (1 + exp(-2 * tmpVal));
-                }
-                else
-                {
-                    if (tmpVal<-2.9||tmpVal>2.9)
-                    {
-                        retVal = 1 / (1+exp(-tmpVal));
-                    }
-                    else
-                    {
-                        retVal = (Type)unsignedSigmoidTable[int(tmpVal*1000.0)+3000];
-                    }
-                }
-            }
-            break;
-        case ACTIVATION_FUNCTION_SIN:
-            if (signedActivation)
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Signed Sin> ";
-#endif
-                retVal = sin(tmpVal);
-            }
-            else
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Unsigned Sin> ";
-#endif
-                retVal = (sin(tmpVal)+1)/2;
-            }
-            break;
-        case ACTIVATION_FUNCTION_COS:
-            if (signedActivation)
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Signed Cos> ";
-#endif
-                retVal = cos(tmpVal);
-            }
-            else
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Unsigned Cos> ";
-#endif
-                retVal = (cos(tmpVal)+1)/2;
-            }
-            break;
-        case ACTIVATION_FUNCTION_GAUSSIAN:
-            if (signedActivation)
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Unsigned Gaussian> ";
-#endif
-                retVal = exp(-pow(tmpVal,2));
-            }
-            else
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Unsigned Gaussian> ";
-#endif
-                retVal = exp(-pow(tmpVal,2));
-            }
-            break;
-        case ACTIVATION_FUNCTION_SQUARE:
-#if DEBUG_ACTIVATION_CALCULATION
-            cout << " <Square> ";
-#endif
-            retVal = tmpVal*tmpVal;
-            break;
-        case ACTIVATION_FUNCTION_ABS_ROOT:
-            if (signedActivation)
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Signed Root> ";
-#endif
-                if (tmpVal<0.0)
-                {
-                    retVal = -sqrt(fabs(tmpVal));
-                }
-                else
-                {
-                    retVal = sqrt(fabs(tmpVal));
-                }
-            }
-            else
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Absolute Root> ";
-#endif
-                retVal = sqrt(fabs(tmpVal));
-            }
-            break;
-        case ACTIVATION_FUNCTION_LINEAR:
-            if (signedActivation)
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Signed Linear> ";
-#endif
-                retVal = min(max(tmpVal,(Type)-3.0),(Type)3.0) / (Type)3.0;
-            }
-            else
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Absolute Linear> ";
-#endif
-                retVal = ((min(max(tmpVal,(Type)-3.0),(Type)3.0) / (Type)3.0) + 1) / (Type)2.0;
-            }
-            break;
-        case ACTIVATION_FUNCTION_ONES_COMPLIMENT:
-            if (signedActivation)
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Signed Ones Compliment> ";
-#endif
-                Type tmpVal2 = (Type)min(1.0,max(-1.0,tmpVal/3.0));
-                if (tmpVal>-0.1)
-                {
-                    retVal = max((Type)0.0,tmpVal2);
-                    retVal = (Type)1.0-tmpVal2;
-                }
-                else
-                {
-                    retVal = ((Type)-1.0) - tmpVal;
-                }
-            }
-            else
-            {
-#if DEBUG_ACTIVATION_CALCULATION
-                cout << " <Absolute Ones Compliment> ";
-#endif
-                Type tmpVal2 = (Type)min(1.0,max(0.0,tmpVal/3.0));
-                retVal = ((Type)1.0)-tmpVal2;
-            }
-            break;
-        default:
-            throw CREATE_LOCATEDEXCEPTION_INFO("Unknown activation function!!!");
-            break;
-        }
-
-#if DEBUG_ACTIVATION_CALCULATION
-        cout << " After: " << retVal << endl;
-#endif
-
-        return retVal;
 
+        compiledWeightsDirty=true;
     }
 
     template<class Type>
@@ -17,16 +17,14 @@
 
 namespace NEAT
 {
-	extern double signedSigmoidTable[6001];
-	extern double unsignedSigmoidTable[6001];
-
 	FractalNetwork::FractalNetwork(const vector<NetworkNode *> &_nodes,const vector<NetworkLink *> &_links)
 		:
 	Network<double>(),
 		numNodes(int(_nodes.size())),
 		numLinks(int(_links.size())),
 		numConstantNodes(0),
-		numForwardLinks(0)
+		numForwardLinks(0),
+		activationKernel(ActivationKernel<double>::fromGlobals())
 	{
 		data = (char*)malloc(
 			sizeof(double)*2*numNodes +
@@ -125,7 +123,8 @@ namespace NEAT
 		numNodes(_numNodes),
 		numLinks(_numLinks),
 		numConstantNodes(0),
-		numForwardLinks(0)
+		numForwardLinks(0),
+		activationKernel(ActivationKernel<double>::fromGlobals())
 	{
 		data = (char*)malloc(
 			sizeof(double)*2*numNodes +
@@ -227,7 +226,8 @@ namespace NEAT
 		numNodes(int(_nodes.size())),
 		numLinks(int(_links.size())),
 		numConstantNodes(0),
-		numForwardLinks(0)
+		numForwardLinks(0),
+		activationKernel(ActivationKernel<double>::fromGlobals())
 	{
 		data = (char*)malloc(
 			sizeof(double)*2*numNodes +
@@ -373,6 +373,7 @@ namespace NEAT
 			nodeNameToIndex = other.nodeNameToIndex;
 			numConstantNodes = other.numConstantNodes;
 			numForwardLinks = other.numForwardLinks;
+			activationKernel = other.activationKernel;
 
 			data = (char*)realloc(
 				data,
@@ -546,10 +547,7 @@ namespace NEAT
 				}
 #endif
 
-				for (int a=numConstantNodes;a<numNodes;a++)
-				{
-					nodeNewValues[a] = runActivationFunction(nodeNewValues[a],activationFunctions[a]);
-				}
+				activationKernel.activateNodes(nodeNewValues,activationFunctions,numConstantNodes,numNodes);
 
 #if DEBUG_NETWORK
 				cout << "Before Copy: " << endl;
@@ -628,10 +626,7 @@ namespace NEAT
 				}
 #endif
 
-				for (int a=numConstantNodes;a<numNodes;a++)
-				{
-					nodeNewValues[a] = runActivationFunction(nodeNewValues[a],activationFunctions[a]);
-				}
+				activationKernel.activateNodes(nodeNewValues,activationFunctions,numConstantNodes,numNodes);
 
 #if DEBUG_NETWORK
 				cout << "Before Copy: " << endl;
@@ -666,203 +661,4 @@ namespace NEAT
 
 		}
 	}
-
-	double FractalNetwork::runActivationFunction(double tmpVal,ActivationFunction function)
-	{
-		double retVal;
-
-		bool signedActivation=false;
-
-		if (Globals::getSingleton()->hasSignedActivation())
-		{
-			signedActivation=true;
-		}
-
-#if DEBUG_ACTIVATION_CALCULATION
-		cout << "Before: " << tmpVal;
-#endif
-
-		switch (function)
-		{
-		case ACTIVATION_FUNCTION_SIGMOID:
-			//newValue = fsigmoid(tmpVal,4.924273,2.4621365);
-
-			//try my own sigmoid
-
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Sigmoid> ";
-#endif
-				//signed sigmoid
-				if(Globals::getSingleton()->isUsingTanhSigmoid())
-				{
-					retVal = 2 / (1 + exp(-2 * tmpVal)) - 1;
-				}
-				else
-				{
-					if (tmpVal<-2.9||tmpVal>2.9)
-					{
-						retVal = ((1 / (1+exp(-tmpVal))) - 0.5)*2.0;
-					}
-					else
-					{
-						retVal = signedSigmoidTable[int(tmpVal*1000.0)+3000];
-					}
-				}
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Sigmoid> ";
-#endif
-				//unsigned sigmoid
-				if(Globals::getSingleton()->isUsingTanhSigmoid())
-				{
-					retVal = (1 + exp(-2 * tmpVal));
-				}
-				else
-				{
-					if (tmpVal<-2.9||tmpVal>2.9)
-					{
-						retVal = 1 / (1+exp(-tmpVal));
-					}
-					else
-					{
-						retVal = unsignedSigmoidTable[int(tmpVal*1000.0)+3000];
-					}
-				}
-			}
-			break;
-		case ACTIVATION_FUNCTION_SIN:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Sin> ";
-#endif
-				retVal = sin(tmpVal);
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Sin> ";
-#endif
-				retVal = (sin(tmpVal)+1)/2;
-			}
-			break;
-		case ACTIVATION_FUNCTION_COS:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Cos> ";
-#endif
-				retVal = cos(tmpVal);
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Cos> ";
-#endif
-				retVal = (cos(tmpVal)+1)/2;
-			}
-			break;
-		case ACTIVATION_FUNCTION_GAUSSIAN:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Gaussian> ";
-#endif
-				retVal = exp(-pow(tmpVal,2));
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Gaussian> ";
-#endif
-				retVal = exp(-pow(tmpVal,2));
-			}
-			break;
-		case ACTIVATION_FUNCTION_SQUARE:
-#if DEBUG_ACTIVATION_CALCULATION
-			cout << " <Square> ";
-#endif
-			retVal = tmpVal*tmpVal;
-			break;
-		case ACTIVATION_FUNCTION_ABS_ROOT:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Root> ";
-#endif
-				if (tmpVal<0.0)
-				{
-					retVal = -sqrt(fabs(tmpVal));
-				}
-				else
-				{
-					retVal = sqrt(fabs(tmpVal));
-				}
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Absolute Root> ";
-#endif
-				retVal = sqrt(fabs(tmpVal));
-			}
-			break;
-		case ACTIVATION_FUNCTION_LINEAR:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Linear> ";
-#endif
-				retVal = min(max(tmpVal,-3.0),3.0) / 3.0;
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Absolute Linear> ";
-#endif
-				retVal = ((min(max(tmpVal,-3.0),3.0) / 3.0) + 1) / 2.0;
-			}
-			break;
-		case ACTIVATION_FUNCTION_ONES_COMPLIMENT:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Ones Compliment> ";
-#endif
-				double tmpVal2 = min(1.0,max(-1.0,tmpVal/3.0));
-				if (tmpVal>-0.1)
-				{
-					retVal = max(0.0,tmpVal2);
-					retVal = 1.0-tmpVal2;
-				}
-				else
-				{
-					retVal = (-1.0) - tmpVal;
-				}
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Absolute Ones Compliment> ";
-#endif
-				double tmpVal2 = min(1.0,max(0.0,tmpVal/3.0));
-				retVal = 1.0-tmpVal2;
-			}
-			break;
-		default:
-			throw CREATE_LOCATEDEXCEPTION_INFO("Unknown activation function!!!");
-			break;
-		}
-
-#if DEBUG_ACTIVATION_CALCULATION
-		cout << " After: " << retVal << endl;
-#endif
-
-		return retVal;
-
-	}
 }
@@ -28,6 +28,13 @@ namespace NEAT
 #endif
     }
 
+    GeneticGene::GeneticGene(GenomeReader &reader)
+    {
+        ID = reader.read<int>();
+        enabled = reader.readBool();
+        age = reader.read<int>();
+    }
+
     GeneticGene::~GeneticGene()
     {}
 
@@ -50,4 +57,11 @@ namespace NEAT
     {
         ostr << ID << ' ' << enabled << ' ';
     }
+
+    void GeneticGene::dump(GenomeWriter &writer)
+    {
+        writer.write(ID);
+        writer.write(enabled);
+        writer.write(age);
+    }
 }
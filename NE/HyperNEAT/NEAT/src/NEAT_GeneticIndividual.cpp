@@ -276,6 +276,49 @@ namespace NEAT
 		isValid();
     }
 
+    GeneticIndividual::GeneticIndividual(GenomeReader &reader)
+        :
+    canReproduce(true)
+    {
+        int length = reader.read<int>();
+        const char *start = reader.getPosition();
+
+        fitness = reader.read<double>();
+        speciesID = reader.read<int>();
+        userData = reader.readString();
+
+        //The sender's genes are already sorted by ID, so they go straight in instead of
+        //through addNode()/addLink()
+        int numNodes = reader.read<int>();
+        nodes.reserve(numNodes);
+        for (int a=0;a<numNodes;a++)
+        {
+            nodes.push_back(GeneticNodeGene(reader));
+            if (a>0 && nodes[a].getID()<nodes[a-1].getID())
+            {
+                throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Node genes in a genome buffer are out of order!");
+            }
+        }
+
+        int numLinks = reader.read<int>();
+        links.reserve(numLinks);
+        for (int a=0;a<numLinks;a++)
+        {
+            links.push_back(GeneticLinkGene(reader));
+            if (a>0 && links[a].getID()<links[a-1].getID())
+            {
+                throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Link genes in a genome buffer are out of order!");
+            }
+        }
+
+        if (reader.getPosition()-start != length)
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Genome length prefix doesn't match its contents!");
+        }
+
+        isValid();
+    }
+
     GeneticIndividual::GeneticIndividual(shared_ptr<GeneticIndividual> parent1,shared_ptr<GeneticIndividual> parent2,bool mate_multipoint_avg, double minFitness)
         :
     fitness(0),
@@ -688,6 +731,81 @@ namespace NEAT
         links.push_back(link);
     }
 
+    static bool nodeIDLessThan(const GeneticNodeGene &node1,const GeneticNodeGene &node2)
+    {
+        return node1.getID()<node2.getID();
+    }
+
+    static bool linkIDLessThan(const GeneticLinkGene &link1,const GeneticLinkGene &link2)
+    {
+        return link1.getID()<link2.getID();
+    }
+
+    void GeneticIndividual::commitProvisionalIDs(const ProvisionalIDs &ids)
+    {
+        //Genes are sorted by ID, so the provisional ones are at the end in the order they were made
+        map<int,int> nodeIDs;
+
+        bool nodeIDsChanged=false;
+
+        for (int a=0;a<(int)nodes.size();a++)
+        {
+            int provisionalID = nodes[a].getID();
+            if (provisionalID>=PROVISIONAL_GENE_ID)
+            {
+                int fromNodeID,toNodeID;
+                if (ids.getNodeSplit(provisionalID,fromNodeID,toNodeID))
+                {
+                    if (fromNodeID>=PROVISIONAL_GENE_ID)
+                        fromNodeID = nodeIDs[fromNodeID];
+                    if (toNodeID>=PROVISIONAL_GENE_ID)
+                        toNodeID = nodeIDs[toNodeID];
+
+                    Globals::getSingleton()->assignNodeID(&nodes[a],fromNodeID,toNodeID);
+                }
+                else
+                {
+                    Globals::getSingleton()->assignNodeID(&nodes[a]);
+                }
+                nodeIDs[provisionalID] = nodes[a].getID();
+                nodeIDsChanged=true;
+            }
+        }
+
+        if (nodeIDsChanged)
+        {
+            //Nodes that matched the history can have lower IDs than other new nodes
+            stable_sort(nodes.begin(),nodes.end(),nodeIDLessThan);
+        }
+
+        bool linkIDsChanged=false;
+
+        for (int a=0;a<(int)links.size();a++)
+        {
+            int fromNodeID = links[a].getFromNodeID();
+            int toNodeID = links[a].getToNodeID();
+
+            if (fromNodeID>=PROVISIONAL_GENE_ID)
+                fromNodeID = nodeIDs[fromNodeID];
+            if (toNodeID>=PROVISIONAL_GENE_ID)
+                toNodeID = nodeIDs[toNodeID];
+
+            links[a].updateLegacy(fromNodeID,toNodeID);
+
+            if (links[a].getID()>=PROVISIONAL_GENE_ID)
+            {
+                Globals::getSingleton()->assignLinkID(&links[a]);
+                linkIDsChanged=true;
+            }
+        }
+
+        if (linkIDsChanged)
+        {
+            //Links that matched the history can have lower IDs than other new links
+            stable_sort(links.begin(),links.end(),linkIDLessThan);
+        }
+    }
+
     int GeneticIndividual::getLinksCount() const
     {
         return (int)links.size();
@@ -797,6 +915,29 @@ namespace NEAT
         }
     }
 
+    void GeneticIndividual::dump(GenomeWriter &writer)
+    {
+        size_t lengthOffset = writer.reserveLength();
+
+        writer.write(fitness);
+        writer.write(speciesID);
+        writer.write(userData);
+
+        writer.write(int(nodes.size()));
+        for (int a=0;a<(int)nodes.size();a++)
+        {
+            nodes[a].dump(writer);
+        }
+
+        writer.write(int(links.size()));
+        for (int a=0;a<(int)links.size();a++)
+        {
+            links[a].dump(writer);
+        }
+
+        writer.writeLength(lengthOffset);
+    }
+
     void GeneticIndividual::print() const
     {
         cout << "NEW INDIVIDUAL:\n";
@@ -1055,6 +1196,7 @@ namespace NEAT
                 randomActivation=true;
 
             GeneticNodeGene newNode = GeneticNodeGene("","HiddenNode",newPosition,randomActivation);
+            Globals::getSingleton()->assignNodeID(&newNode,randomLink->getFromNodeID(),randomLink->getToNodeID());
 
             GeneticLinkGene sourceLink = GeneticLinkGene(randomLink->getFromNodeID(),newNode.getID(),1.0);
             GeneticLinkGene destLink = GeneticLinkGene(newNode.getID(),randomLink->getToNodeID(),randomLink->getWeight()/2.0);
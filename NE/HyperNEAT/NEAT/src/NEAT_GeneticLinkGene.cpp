@@ -70,6 +70,16 @@ namespace NEAT
         istr >> fromNodeID >> toNodeID >> fixed >> setprecision(15) >> weight;
     }
 
+    GeneticLinkGene::GeneticLinkGene(GenomeReader &reader)
+            :
+            GeneticGene(reader)
+    {
+        fromNodeID = reader.read<int>();
+        toNodeID = reader.read<int>();
+        weight = reader.read<double>();
+        fixed = reader.readBool();
+    }
+
     GeneticLinkGene::~GeneticLinkGene()
     {}
 
@@ -117,4 +127,14 @@ namespace NEAT
 
         ostr << fromNodeID << ' ' << toNodeID << ' ' << fixed << ' ' << setprecision(15) << weight << ' ';
     }
+
+    void GeneticLinkGene::dump(GenomeWriter &writer)
+    {
+        GeneticGene::dump(writer);
+
+        writer.write(fromNodeID);
+        writer.write(toNodeID);
+        writer.write(weight);
+        writer.write(fixed);
+    }
 }
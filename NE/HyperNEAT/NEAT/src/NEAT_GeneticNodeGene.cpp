@@ -158,6 +158,17 @@ namespace NEAT
 #endif
     }
 
+    GeneticNodeGene::GeneticNodeGene(GenomeReader &reader)
+            :
+            GeneticGene(reader)
+    {
+        name = reader.readString();
+        type = reader.readString();
+        drawingPosition = reader.read<double>();
+        topologyFrozen = reader.readBool();
+        activationFunction = (ActivationFunction)reader.read<int>();
+    }
+
     GeneticNodeGene::~GeneticNodeGene()
     {}
 
@@ -203,6 +214,17 @@ namespace NEAT
             << ((int)activationFunction) << ' ';
     }
 
+    void GeneticNodeGene::dump(GenomeWriter &writer)
+    {
+        GeneticGene::dump(writer);
+
+        writer.write(name);
+        writer.write(type);
+        writer.write(drawingPosition);
+        writer.write(topologyFrozen);
+        writer.write(int(activationFunction));
+    }
+
     void GeneticNodeGene::mutate()
     {
         throw CREATE_LOCATEDEXCEPTION_INFO("Don\'t try to mutate node genes!");
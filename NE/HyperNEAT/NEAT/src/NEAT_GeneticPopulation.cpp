@@ -11,8 +11,91 @@
 #include "NEAT_GeneticIndividual.h"
 #include "NEAT_Random.h"
 
+#include <boost/thread.hpp>
+
+#define DEBUG_PARALLEL_REPRODUCTION (0)
+
 namespace NEAT
 {
+    static shared_ptr<GeneticIndividual> makeBabyOnStream(const OffspringPlan &plan,ulong streamId,ProvisionalIDs &ids)
+    {
+        Random stream = Globals::getSingleton()->getRandomStream(streamId);
+        RandomStreamScope randomScope(stream);
+        ProvisionalIDScope idScope(ids);
+
+        return plan.makeBaby();
+    }
+
+    /**
+     * OffspringQueue: Hands the offspring plans out to the reproduction threads one at a time
+     */
+    class OffspringQueue
+    {
+        const vector<OffspringPlan> &plans;
+
+        vector<shared_ptr<GeneticIndividual> > &babies;
+
+        vector<ProvisionalIDs> &babyIDs;
+
+        ulong streamBase;
+
+        boost::mutex queueMutex;
+
+        int nextPlan;
+
+        string error;
+
+    public:
+        OffspringQueue(
+            const vector<OffspringPlan> &_plans,
+            vector<shared_ptr<GeneticIndividual> > &_babies,
+            vector<ProvisionalIDs> &_babyIDs,
+            ulong _streamBase
+        )
+                :
+                plans(_plans),
+                babies(_babies),
+                babyIDs(_babyIDs),
+                streamBase(_streamBase),
+                nextPlan(0)
+        {
+        }
+
+        void run()
+        {
+            while (true)
+            {
+                int planIndex;
+                {
+                    boost::mutex::scoped_lock lock(queueMutex);
+                    if (nextPlan>=(int)plans.size() || error.length())
+                    {
+                        return;
+                    }
+                    planIndex = nextPlan++;
+                }
+
+                try
+                {
+                    babies[planIndex] = makeBabyOnStream(plans[planIndex],streamBase+planIndex,babyIDs[planIndex]);
+                }
+                catch (const std::exception &ex)
+                {
+                    boost::mutex::scoped_lock lock(queueMutex);
+                    if (!error.length())
+                    {
+                        error = ex.what();
+                    }
+                    return;
+                }
+            }
+        }
+
+        inline const string &getError()
+        {
+            return error;
+        }
+    };
 
     GeneticPopulation::GeneticPopulation()
             : onGeneration(0)
@@ -245,32 +328,14 @@ namespace NEAT
     {
         double compatThreshold = Globals::getSingleton()->getParameterValue("CompatibilityThreshold");
 
+        vector<shared_ptr<GeneticIndividual> > individuals;
         for (int a=0;a<generations[onGeneration]->getIndividualCount();a++)
         {
-            shared_ptr<GeneticIndividual> individual = generations[onGeneration]->getIndividual(a);
-
-            bool makeNewSpecies=true;
-
-            for (int b=0;b<(int)species.size();b++)
-            {
-                double compatibility = species[b]->getBestIndividual()->getCompatibility(individual);
-                if (compatibility<compatThreshold)
-                {
-                    //Found a compatible species
-                    individual->setSpeciesID(species[b]->getID());
-                    makeNewSpecies=false;
-                    break;
-                }
-            }
-
-            if (makeNewSpecies)
-            {
-                //Make a new species.  The process of making a new speceis sets the ID for the individual.
-                shared_ptr<GeneticSpecies> newSpecies(new GeneticSpecies(individual));
-                species.push_back(newSpecies);
-            }
+            individuals.push_back(generations[onGeneration]->getIndividual(a));
         }
 
+        speciationEngine.speciate(individuals,species,compatThreshold);
+
         int speciesTarget = int(Globals::getSingleton()->getParameterValue("SpeciesSizeTarget"));
 
         double compatMod;
@@ -503,11 +568,13 @@ namespace NEAT
         cout << "# of Species: " << int(species.size()) << endl;
         cout << "compat threshold: " << Globals::getSingleton()->getParameterValue("CompatibilityThreshold") << endl;
 
+        vector<OffspringPlan> plans;
         for (int a=0;a<(int)species.size();a++)
         {
             //cout << "Making babies\n";
-            species[a]->makeBabies(babies, minFitness);
+            species[a]->planBabies(plans, minFitness);
         }
+        makeBabies(plans,babies,ulong(onGeneration)<<32);
         if ((int)babies.size()!=generations[onGeneration]->getIndividualCount())
         {
             cout << "Population size changed!\n";
@@ -534,6 +601,55 @@ namespace NEAT
     }
 
 
+    void GeneticPopulation::makeBabies(
+        const vector<OffspringPlan> &plans,
+        vector<shared_ptr<GeneticIndividual> > &babies,
+        ulong streamBase
+    )
+    {
+        int numThreads = Globals::getSingleton()->getThreadCount("ReproductionThreads");
+        numThreads = max(1,min(numThreads,(int)plans.size()));
+
+        vector<shared_ptr<GeneticIndividual> > newBabies(plans.size());
+        vector<ProvisionalIDs> babyIDs(plans.size());
+        OffspringQueue queue(plans,newBabies,babyIDs,streamBase);
+
+        if (numThreads==1)
+        {
+            queue.run();
+        }
+        else
+        {
+            boost::thread_group threads;
+            for (int a=0;a<numThreads;a++)
+            {
+                threads.create_thread(boost::bind(&OffspringQueue::run,&queue));
+            }
+            threads.join_all();
+        }
+
+        if (queue.getError().length())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(queue.getError());
+        }
+
+        for (int a=0;a<(int)newBabies.size();a++)
+        {
+#if DEBUG_PARALLEL_REPRODUCTION
+            ProvisionalIDs serialIDs;
+            shared_ptr<GeneticIndividual> serialBaby = makeBabyOnStream(plans[a],streamBase+a,serialIDs);
+            if (!(*serialBaby==*newBabies[a]))
+            {
+                throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Baby made on a reproduction thread differs from the serial one!");
+            }
+#endif
+
+            //IDs are committed in plan order, which keeps the link history matching deterministic
+            newBabies[a]->commitProvisionalIDs(babyIDs[a]);
+            babies.push_back(newBabies[a]);
+        }
+    }
+
     void GeneticPopulation::dump(string filename,bool includeGenes,bool doGZ)
     {
         TiXmlDocument doc( filename );
@@ -86,7 +86,7 @@ namespace NEAT
         }
     }
 
-    void GeneticSpecies::makeBabies(vector<shared_ptr<GeneticIndividual> > &babies, double minGenerationalFitness)
+    void GeneticSpecies::planBabies(vector<OffspringPlan> &plans, double minGenerationalFitness)
     {
         int lastIndex = int(Globals::getSingleton()->getParameterValue("SurvivalThreshold")*currentIndividuals.size());
 
@@ -104,7 +104,7 @@ namespace NEAT
                 //Something messed up, bail
                 int parent = 0;
                 shared_ptr<GeneticIndividual> ind = currentIndividuals[parent];
-                babies.push_back(shared_ptr<GeneticIndividual>(new GeneticIndividual(ind,true)));
+                plans.push_back(OffspringPlan(ind,shared_ptr<GeneticIndividual>(),minGenerationalFitness));
                 offspringCount--;
                 continue;
             }
@@ -114,7 +114,7 @@ namespace NEAT
             {
                 int parent = Globals::getSingleton()->getRandom().getRandomWithinRange(0,int(lastIndex));
                 shared_ptr<GeneticIndividual> ind = currentIndividuals[parent];
-                babies.push_back(shared_ptr<GeneticIndividual>(new GeneticIndividual(ind,true)));
+                plans.push_back(OffspringPlan(ind,shared_ptr<GeneticIndividual>(),minGenerationalFitness));
                 offspringCount--;
             }
             else
@@ -145,15 +145,25 @@ namespace NEAT
 
                 if (parent1==parent2)
                 {
-                    babies.push_back(shared_ptr<GeneticIndividual>(new GeneticIndividual(parent1,true)));
+                    plans.push_back(OffspringPlan(parent1,shared_ptr<GeneticIndividual>(),minGenerationalFitness));
                 }
                 else
                 {
-                    babies.push_back(shared_ptr<GeneticIndividual>(new GeneticIndividual(parent1,parent2,false,minGenerationalFitness)));
+                    plans.push_back(OffspringPlan(parent1,parent2,minGenerationalFitness));
                 }
                 offspringCount--;
             }
         }
     }
 
+    shared_ptr<GeneticIndividual> OffspringPlan::makeBaby() const
+    {
+        if (!parent2)
+        {
+            return shared_ptr<GeneticIndividual>(new GeneticIndividual(parent1,true));
+        }
+
+        return shared_ptr<GeneticIndividual>(new GeneticIndividual(parent1,parent2,false,minGenerationalFitness));
+    }
+
 }
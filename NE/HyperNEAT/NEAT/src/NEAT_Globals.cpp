@@ -8,6 +8,7 @@
 #define DEBUG_NEAT_GLOBALS (0)
 
 #include <boost/algorithm/string.hpp>
+#include <boost/thread.hpp>
 
 const char* activationFunctionNames[ACTIVATION_FUNCTION_END] =
 {
@@ -27,33 +28,96 @@ namespace NEAT
     double unsignedSigmoidTable[6001];
 
     Globals *Globals::singleton = NULL;
+
+    static void releaseThreadRandom(Random *)
+    {
+        //The stream belongs to the RandomStreamScope's owner
+    }
+
+    boost::thread_specific_ptr<Random> Globals::threadRandom(releaseThreadRandom);
+
+    static void releaseThreadProvisionalIDs(ProvisionalIDs *)
+    {
+        //The IDs belong to the ProvisionalIDScope's owner
+    }
+
+    boost::thread_specific_ptr<ProvisionalIDs> Globals::threadProvisionalIDs(releaseThreadProvisionalIDs);
+
     void Globals::assignNodeID(GeneticNodeGene *testNode)
     {
+        ProvisionalIDs *provisionalIDs = threadProvisionalIDs.get();
+        if (provisionalIDs)
+        {
+            testNode->setID(provisionalIDs->generateNodeID());
+            return;
+        }
+
         testNode->setID(generateNodeID());
     }
 
+    void Globals::assignNodeID(GeneticNodeGene *testNode,int splitFromNodeID,int splitToNodeID)
+    {
+        ProvisionalIDs *provisionalIDs = threadProvisionalIDs.get();
+        if (provisionalIDs)
+        {
+            //The split is matched when the ID is committed
+            provisionalIDs->addNodeSplit(testNode->getID(),splitFromNodeID,splitToNodeID);
+            return;
+        }
+
+        int nodeID = nodeInnovations.find(splitFromNodeID,splitToNodeID);
+        if (nodeID>=0)
+        {
+            //This link was already split this generation, so it's the same node.
+            testNode->setID(nodeID);
+            return;
+        }
+
+        if (testNode->getID()>=PROVISIONAL_GENE_ID)
+        {
+            testNode->setID(generateNodeID());
+        }
+        nodeInnovations.insert(splitFromNodeID,splitToNodeID,testNode->getID());
+    }
+
     void Globals::assignLinkID(GeneticLinkGene *testLink,bool ignoreHistory)
     {
+        ProvisionalIDs *provisionalIDs = threadProvisionalIDs.get();
+        if (provisionalIDs)
+        {
+            //The link history is matched when the ID is committed
+            testLink->setID(provisionalIDs->generateLinkID());
+            return;
+        }
+
         if (ignoreHistory)
         {
             testLink->setID(generateLinkID());
+            return;
         }
-        for (int a=0;a<(int)linkGenesThisGeneration.size();a++)
+
+        int linkID = linkInnovations.find(testLink->getFromNodeID(),testLink->getToNodeID());
+        if (linkID<0)
         {
-            shared_ptr<GeneticLinkGene> link = linkGenesThisGeneration[a];
-            if (link->getFromNodeID()==testLink->getFromNodeID()&&link->getToNodeID()==testLink->getToNodeID())
-            {
-                testLink->setID( link->getID() );
-                return;
-            }
+            linkID = generateLinkID();
+            linkInnovations.insert(testLink->getFromNodeID(),testLink->getToNodeID(),linkID);
         }
-        testLink->setID(generateLinkID());
-        linkGenesThisGeneration.push_back(shared_ptr<GeneticLinkGene>(new GeneticLinkGene(*testLink)));
+        testLink->setID(linkID);
     }
 
     void Globals::clearLinkHistory()
     {
-        linkGenesThisGeneration.clear();
+        linkInnovations.clear();
+        nodeInnovations.clear();
+    }
+
+    void Globals::loadLinkHistory(const vector<shared_ptr<GeneticLinkGene> > &linkGenes)
+    {
+        linkInnovations.clear();
+        for (int a=0;a<(int)linkGenes.size();a++)
+        {
+            linkInnovations.insert(linkGenes[a]->getFromNodeID(),linkGenes[a]->getToNodeID(),linkGenes[a]->getID());
+        }
     }
 
     int Globals::generateSpeciesID()
@@ -273,6 +337,35 @@ namespace NEAT
         random = Random(newSeed);
     }
 
+    Random Globals::getRandomStream(ulong streamId)
+    {
+        return Random(random.getSeed(),streamId+1);
+    }
+
+    RandomStreamScope::RandomStreamScope(Random &stream)
+            :
+            previous(Globals::threadRandom.get())
+    {
+        Globals::threadRandom.reset(&stream);
+    }
+
+    RandomStreamScope::~RandomStreamScope()
+    {
+        Globals::threadRandom.reset(previous);
+    }
+
+    ProvisionalIDScope::ProvisionalIDScope(ProvisionalIDs &ids)
+            :
+            previous(Globals::threadProvisionalIDs.get())
+    {
+        Globals::threadProvisionalIDs.reset(&ids);
+    }
+
+    ProvisionalIDScope::~ProvisionalIDScope()
+    {
+        Globals::threadProvisionalIDs.reset(previous);
+    }
+
     void Globals::dump(TiXmlElement *root)
     {
         root->SetAttribute("ActualRandomSeed",getRandom().getSeed());
@@ -306,6 +399,20 @@ namespace NEAT
 		return parameters.getDataRef(name);
     }
 
+    int Globals::getThreadCount(const string &parameterName)
+    {
+        int numThreads=0;
+        if (hasParameterValue(parameterName))
+        {
+            numThreads = int(getParameterValue(parameterName));
+        }
+        if (numThreads<=0)
+        {
+            numThreads = max(1,int(boost::thread::hardware_concurrency()));
+        }
+        return numThreads;
+    }
+
     Globals::~Globals()
     {}
 
@@ -333,5 +440,15 @@ namespace NEAT
 		{
 			useTanhSigmoid = false;
 		}
+
+		//cout << "UseFastSigmoid" << endl;
+		if(hasParameterValue("UseFastSigmoid") && getParameterValue("UseFastSigmoid")>0.5)
+		{
+			useFastSigmoid = true;
+		}
+		else
+		{
+			useFastSigmoid = false;
+		}
 	}
 }
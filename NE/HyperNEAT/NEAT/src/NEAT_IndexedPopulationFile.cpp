@@ -0,0 +1,179 @@
+#include "NEAT_Defines.h"
+
+#include "NEAT_IndexedPopulationFile.h"
+
+#include "NEAT_GeneticIndividual.h"
+#include "NEAT_Globals.h"
+#include "NEAT_GenomeBuffer.h"
+
+namespace NEAT
+{
+    static const char INDEXED_POPULATION_MAGIC[8] = {'H','N','P','O','P','I','D','X'};
+
+    static const int INDEXED_POPULATION_VERSION = 1;
+
+    //magic, four ints and three ulongs
+    static const size_t INDEXED_POPULATION_HEADER_SIZE = 8 + 4*sizeof(int) + 3*sizeof(ulong);
+
+    IndexedPopulationFile::IndexedPopulationFile(const string &fileName)
+            :
+            file(fileName),
+            individualCount(0),
+            generation(0),
+            genomeOffsets(NULL),
+            parametersOffset(0),
+            archiveOffset(0),
+            archiveSize(0)
+    {
+        if (file.size()<INDEXED_POPULATION_HEADER_SIZE || memcmp(file.data(),INDEXED_POPULATION_MAGIC,8))
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(string("ERROR: Not an indexed population file: ")+fileName);
+        }
+
+        GenomeReader header(file.data()+8,INDEXED_POPULATION_HEADER_SIZE-8);
+        int version = header.read<int>();
+        individualCount = header.read<int>();
+        generation = header.read<int>();
+        header.read<int>();
+        parametersOffset = header.read<ulong>();
+        archiveOffset = header.read<ulong>();
+        archiveSize = header.read<ulong>();
+
+        if (version!=INDEXED_POPULATION_VERSION)
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(string("ERROR: Unknown indexed population version in ")+fileName);
+        }
+
+        size_t indexEnd = INDEXED_POPULATION_HEADER_SIZE + sizeof(ulong)*(individualCount+1);
+        if (
+            individualCount<0 ||
+            indexEnd>file.size() ||
+            parametersOffset>archiveOffset ||
+            archiveOffset+archiveSize>file.size()
+        )
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(string("ERROR: Indexed population file is truncated: ")+fileName);
+        }
+
+        //The header is a multiple of 8 bytes and the mapping is page aligned
+        genomeOffsets = (const ulong*)(file.data()+INDEXED_POPULATION_HEADER_SIZE);
+    }
+
+    IndexedPopulationFile::~IndexedPopulationFile()
+    {
+    }
+
+    shared_ptr<GeneticIndividual> IndexedPopulationFile::getIndividual(int individualIndex) const
+    {
+        if (individualIndex<0 || individualIndex>=individualCount)
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Individual index out of range in indexed population file!");
+        }
+
+        ulong begin = genomeOffsets[individualIndex];
+        ulong end = genomeOffsets[individualIndex+1];
+        if (begin>end || end>file.size())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Bad genome offset in indexed population file!");
+        }
+
+        GenomeReader reader(file.data()+begin,size_t(end-begin));
+        return shared_ptr<GeneticIndividual>(new GeneticIndividual(reader));
+    }
+
+    void IndexedPopulationFile::loadParameters() const
+    {
+        Globals *globals = Globals::getSingleton();
+
+        GenomeReader reader(file.data()+parametersOffset,size_t(archiveOffset-parametersOffset));
+        int parameterCount = reader.read<int>();
+        for (int a=0;a<parameterCount;a++)
+        {
+            string name = reader.readString();
+            double value = reader.read<double>();
+            globals->setParameterValue(name,value);
+        }
+
+        globals->initRandom();
+    }
+
+    void IndexedPopulationFile::write(
+        const string &fileName,
+        const vector<shared_ptr<GeneticIndividual> > &individuals,
+        int generation,
+        const string &archive
+    )
+    {
+        int individualCount = (int)individuals.size();
+
+        vector<char> genomes;
+        vector<ulong> genomeOffsets;
+        genomeOffsets.reserve(individualCount+1);
+        {
+            GenomeWriter writer(genomes);
+            ulong genomeStart = INDEXED_POPULATION_HEADER_SIZE + sizeof(ulong)*(individualCount+1);
+            for (int a=0;a<individualCount;a++)
+            {
+                genomeOffsets.push_back(genomeStart+genomes.size());
+                individuals[a]->dump(writer);
+            }
+            genomeOffsets.push_back(genomeStart+genomes.size());
+
+            Globals *globals = Globals::getSingleton();
+            size_t countOffset = writer.size();
+            writer.write(int(0));
+            int parameterCount=0;
+            StackMap<string,double,4096>::iterator mapIterator = globals->getMapBegin();
+            StackMap<string,double,4096>::iterator mapEnd = globals->getMapEnd();
+            for (;mapIterator!=mapEnd;mapIterator++,parameterCount++)
+            {
+                writer.write(mapIterator->first);
+                writer.write(mapIterator->second);
+            }
+            memcpy(&genomes[countOffset],&parameterCount,sizeof(int));
+        }
+
+        ulong genomeStart = INDEXED_POPULATION_HEADER_SIZE + sizeof(ulong)*(individualCount+1);
+
+        vector<char> header;
+        {
+            GenomeWriter writer(header);
+            header.insert(header.end(),INDEXED_POPULATION_MAGIC,INDEXED_POPULATION_MAGIC+8);
+            writer.write(INDEXED_POPULATION_VERSION);
+            writer.write(individualCount);
+            writer.write(generation);
+            writer.write(int(0));
+            writer.write(genomeOffsets.back());
+            writer.write(ulong(genomeStart+genomes.size()));
+            writer.write(ulong(archive.size()));
+            for (int a=0;a<(int)genomeOffsets.size();a++)
+            {
+                writer.write(genomeOffsets[a]);
+            }
+        }
+
+        ofstream ofs(fileName.c_str(),ios::out|ios::binary|ios::trunc);
+        ofs.write(&header[0],header.size());
+        if (!genomes.empty())
+        {
+            ofs.write(&genomes[0],genomes.size());
+        }
+        ofs.write(archive.data(),archive.size());
+
+        if (!ofs)
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(string("ERROR: Could not write indexed population file: ")+fileName);
+        }
+    }
+
+    bool IndexedPopulationFile::isIndexedPopulationFile(const string &fileName)
+    {
+        ifstream ifs(fileName.c_str(),ios::in|ios::binary);
+        char magic[8];
+        if (!ifs.read(magic,8))
+        {
+            return false;
+        }
+        return memcmp(magic,INDEXED_POPULATION_MAGIC,8)==0;
+    }
+}
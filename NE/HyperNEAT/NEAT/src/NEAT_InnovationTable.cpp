@@ -0,0 +1,118 @@
+#include "NEAT_Defines.h"
+
+#include "NEAT_InnovationTable.h"
+
+#define DEBUG_INNOVATION_TABLE (0)
+
+namespace NEAT
+{
+    const ulong InnovationTable::EMPTY_KEY;
+
+    InnovationTable::InnovationTable()
+            :
+            count(0)
+    {
+        resize(1024);
+    }
+
+    int InnovationTable::find(int fromNodeID,int toNodeID) const
+    {
+        ulong key = makeKey(fromNodeID,toNodeID);
+        int mask = int(keys.size())-1;
+
+        for (int slot = slotOf(key);;slot = (slot+1)&mask)
+        {
+            if (keys[slot]==key)
+            {
+                return values[slot];
+            }
+            if (keys[slot]==EMPTY_KEY)
+            {
+                return -1;
+            }
+        }
+    }
+
+    void InnovationTable::insert(int fromNodeID,int toNodeID,int ID)
+    {
+        ulong key = makeKey(fromNodeID,toNodeID);
+
+        if (key==EMPTY_KEY)
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Tried to store an innovation for node IDs -1,-1!");
+        }
+
+        //Keep the load factor at or below 1/2 so probe runs stay short
+        if ((count+1)*2 > (int)keys.size())
+        {
+            resize(int(keys.size())*2);
+        }
+
+        int mask = int(keys.size())-1;
+
+        for (int slot = slotOf(key);;slot = (slot+1)&mask)
+        {
+            if (keys[slot]==key)
+            {
+                values[slot] = ID;
+                return;
+            }
+            if (keys[slot]==EMPTY_KEY)
+            {
+                keys[slot] = key;
+                values[slot] = ID;
+                count++;
+                return;
+            }
+        }
+    }
+
+    void InnovationTable::clear()
+    {
+        if (count)
+        {
+            fill(keys.begin(),keys.end(),EMPTY_KEY);
+            count=0;
+        }
+    }
+
+    void InnovationTable::resize(int capacity)
+    {
+        vector<ulong> oldKeys;
+        vector<int> oldValues;
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+
+        keys.assign(capacity,EMPTY_KEY);
+        values.assign(capacity,-1);
+        count=0;
+
+        shift=64;
+        for (int a=capacity;a>1;a>>=1)
+        {
+            shift--;
+        }
+
+        int mask = capacity-1;
+        for (int a=0;a<(int)oldKeys.size();a++)
+        {
+            if (oldKeys[a]==EMPTY_KEY)
+            {
+                continue;
+            }
+
+            int slot = slotOf(oldKeys[a]);
+            while (keys[slot]!=EMPTY_KEY)
+            {
+                slot = (slot+1)&mask;
+            }
+            keys[slot] = oldKeys[a];
+            values[slot] = oldValues[a];
+            count++;
+        }
+
+#if DEBUG_INNOVATION_TABLE
+        cout << "Innovation table resized to " << capacity << " slots, " << count << " entries\n";
+#endif
+    }
+}
@@ -15,6 +15,12 @@
 
 #define DEBUG_MAX_DELTA_RANGE (2)
 
+// Cross-checks every batched CPPN query against the per-query path
+#define DEBUG_BATCHED_CPPN_QUERY (0)
+
+// Number of CPPN queries evaluated together by FastNetwork::updateBatch
+#define CPPN_QUERY_BATCH_SIZE (256)
+
 namespace NEAT
 {
     template<class NetworkDataType>
@@ -35,6 +41,27 @@ namespace NEAT
             }
     };
 
+    class SubstrateQuery
+    {
+    public:
+        int x1,y1,x2,y2;
+
+        SubstrateQuery(int _x1,int _y1,int _x2,int _y2)
+            :
+            x1(_x1),
+            y1(_y1),
+            x2(_x2),
+            y2(_y2)
+            {
+            }
+    };
+
+    // Inputs a CPPN may have, in the order filled in by getQueryInputs
+    static const char *cppnInputNames[CPPN_NUM_INPUTS] =
+    {
+        "X1","Y1","X2","Y2","DeltaX","DeltaY","Bias"
+    };
+
     template< class NetworkDataType >
     LayeredSubstrate<NetworkDataType>::LayeredSubstrate()
     {
@@ -103,6 +130,99 @@ namespace NEAT
         */
     }
 
+    template< class NetworkDataType >
+    void LayeredSubstrate<NetworkDataType>::getQueryInputs(
+        const SubstrateQuery &query,
+        int z1,
+        int z2,
+        NetworkDataType *inputs
+        )
+    {
+        int x1 = query.x1;
+        int y1 = query.y1;
+        int x2 = query.x2;
+        int y2 = query.y2;
+
+        int chessDistance = max(abs(x1-x2),abs(y1-y2));
+
+        /*Remap the nodes to the [-1,1] domain*/
+        NetworkDataType x1normal,y1normal,x2normal,y2normal;
+
+        if (layerSizes[z1].x>1)
+        {
+            x1normal = -1.0f + (NetworkDataType(x1)/(layerSizes[z1].x-1))*2.0f;
+        }
+        else
+        {
+            x1normal = 0.0f;
+        }
+
+        if (layerSizes[z1].y>1)
+        {
+            y1normal = -1.0f + (NetworkDataType(y1)/(layerSizes[z1].y-1))*2.0f;
+        }
+        else
+        {
+            y1normal = 0.0f;
+        }
+
+        if (layerSizes[z2].x>1)
+        {
+            x2normal = -1.0f + (NetworkDataType(x2)/(layerSizes[z2].x-1))*2.0f;
+        }
+        else
+        {
+            x2normal = 0.0f;
+        }
+
+        if (layerSizes[z2].y>1)
+        {
+            y2normal = -1.0f + (NetworkDataType(y2)/(layerSizes[z2].y-1))*2.0f;
+        }
+        else
+        {
+            y2normal = 0.0f;
+        }
+
+        inputs[CPPN_INPUT_X1] = x1normal;
+        inputs[CPPN_INPUT_Y1] = y1normal;
+        inputs[CPPN_INPUT_X2] = x2normal;
+        inputs[CPPN_INPUT_Y2] = y2normal;
+
+        // This is a specialized handler for Atari Game CPPNs
+        // for (int inputSubstrate=0; ; inputSubstrate++) {
+        //   string name("Input" + boost::lexical_cast<std::string>(inputSubstrate));
+        //   if (cppn.hasNode(name)) {
+        //     if (layerNames[z1] == name) {
+        //       printf("Activating Atari Specific input node: %s\n",name.c_str());
+        //       cppn.setValue(name,1.0);
+        //     } else {
+        //       cppn.setValue(name,0.0);
+        //     }
+        //   } else
+        //     break;
+        // }
+        // TODO self input node
+        if(
+#if DEBUG_USE_DELTAS_ON_LONG_RANGE
+#else
+            max(abs(x2-x1),abs(y2-y1))<=DEBUG_MAX_DELTA_RANGE && 
+#endif
+            chessDistance<=maxDeltaLength
+            )
+        {
+            inputs[CPPN_INPUT_DELTAX] = x2normal-x1normal;
+            inputs[CPPN_INPUT_DELTAY] = y2normal-y1normal;
+        }
+        else
+        {
+            inputs[CPPN_INPUT_DELTAX] = 0;
+            inputs[CPPN_INPUT_DELTAY] = 0;
+        }
+
+        inputs[CPPN_INPUT_BIAS] = (NetworkDataType)0.3;
+    }
+
     template< class NetworkDataType >
     void LayeredSubstrate<NetworkDataType>::populateSubstrate(
         shared_ptr<NEAT::GeneticIndividual> individual
@@ -124,6 +244,23 @@ namespace NEAT
 
         vector<NetworkLayer<NetworkDataType> > layers;
 
+        // Resolve the CPPN inputs once instead of looking them up by name for every query
+        vector<int> inputIndices;
+        vector<int> inputSlots;
+        for(int a=0;a<CPPN_NUM_INPUTS;a++)
+        {
+            int nodeIndex = cppn.getNodeIndex(cppnInputNames[a]);
+            if(nodeIndex>=0)
+            {
+                inputIndices.push_back(nodeIndex);
+                inputSlots.push_back(a);
+            }
+        }
+
+        vector<SubstrateQuery> queries;
+        vector<NetworkDataType> inputValues;
+        vector<NetworkDataType> batchValues;
+
         // Parse the layer adjacency list
         for(int a=0;a<int(layerNames.size());a++) //For each layer 'a'
         {
@@ -159,7 +296,8 @@ namespace NEAT
                 }
 
                 // Check if the CPPN has an output node for this pair of layers
-                if(cppn.hasNode(outputNodeName)==false)
+                int outputNodeIndex = cppn.getNodeIndex(outputNodeName);
+                if(outputNodeIndex<0)
                 {
                     continue;
                 }
@@ -173,6 +311,9 @@ namespace NEAT
                 JGTL::Vector2<int> validOutputStart = (layerSizes[z2] - layerValidSizes[z2])/2;
                 JGTL::Vector2<int> validOutputEnd = ((layerSizes[z2] - layerValidSizes[z2])/2) + layerValidSizes[z2];
 
+                // Gather all of the queries for this pair of layers first.  They are
+                // evaluated (and their links stored) in the order they are visited here.
+                queries.clear();
                 for (int y1=validInputStart.y;y1<validInputEnd.y;y1++)
                 {
                     for (int x1=validInputStart.x;x1<validInputEnd.x;x1++)
@@ -196,177 +337,140 @@ namespace NEAT
                                 }
 #endif
 
-                                /*Remap the nodes to the [-1,1] domain*/
-                                NetworkDataType x1normal,y1normal,x2normal,y2normal;
+                                queries.push_back(SubstrateQuery(x1,y1,x2,y2));
+                            }
+                        }
+                    }
+                }
 
-                                if (layerSizes[z1].x>1)
-                                {
-                                    x1normal = -1.0f + (NetworkDataType(x1)/(layerSizes[z1].x-1))*2.0f;
-                                }
-                                else
-                                {
-                                    x1normal = 0.0f;
-                                }
+                for (int blockStart=0;blockStart<(int)queries.size();blockStart+=CPPN_QUERY_BATCH_SIZE)
+                {
+                    int blockSize = min(CPPN_QUERY_BATCH_SIZE,int(queries.size())-blockStart);
 
-                                if (layerSizes[z1].y>1)
-                                {
-                                    y1normal = -1.0f + (NetworkDataType(y1)/(layerSizes[z1].y-1))*2.0f;
-                                }
-                                else
-                                {
-                                    y1normal = 0.0f;
-                                }
+                    inputValues.resize(inputIndices.size()*blockSize);
 
-                                if (layerSizes[z2].x>1)
-                                {
-                                    x2normal = -1.0f + (NetworkDataType(x2)/(layerSizes[z2].x-1))*2.0f;
-                                }
-                                else
-                                {
-                                    x2normal = 0.0f;
-                                }
+                    for (int q=0;q<blockSize;q++)
+                    {
+                        NetworkDataType queryInputs[CPPN_NUM_INPUTS];
+                        getQueryInputs(queries[blockStart+q],z1,z2,queryInputs);
 
-                                if (layerSizes[z2].y>1)
-                                {
-                                    y2normal = -1.0f + (NetworkDataType(y2)/(layerSizes[z2].y-1))*2.0f;
-                                }
-                                else
-                                {
-                                    y2normal = 0.0f;
-                                }
+                        for (int a=0;a<(int)inputIndices.size();a++)
+                        {
+                            inputValues[a*blockSize+q] = queryInputs[inputSlots[a]];
+                        }
+                    }
 
-                                // Set the values of the CPPNs inputs
-                                cppn.reinitialize();
-                                if (cppn.hasNode("X1"))
-                                {
-                                    cppn.setValue("X1",x1normal);
-                                    cppn.setValue("Y1",y1normal);
-                                }
-                                if (cppn.hasNode("X2"))
-                                {
-                                    cppn.setValue("X2",x2normal);
-                                    cppn.setValue("Y2",y2normal);
-                                }
-                                // This is a specialized handler for Atari Game CPPNs
-                                // for (int inputSubstrate=0; ; inputSubstrate++) {
-                                //   string name("Input" + boost::lexical_cast<std::string>(inputSubstrate));
-                                //   if (cppn.hasNode(name)) {
-                                //     if (layerNames[z1] == name) {
-                                //       printf("Activating Atari Specific input node: %s\n",name.c_str());
-                                //       cppn.setValue(name,1.0);
-                                //     } else {
-                                //       cppn.setValue(name,0.0);
-                                //     }
-                                //   } else
-                                //     break;
-                                // }
-                                // TODO self input node
-                                if(cppn.hasNode("DeltaX"))
-                                {
-                                    if(
-#if DEBUG_USE_DELTAS_ON_LONG_RANGE
-#else
-                                        max(abs(x2-x1),abs(y2-y1))<=DEBUG_MAX_DELTA_RANGE && 
-#endif
-                                        chessDistance<=maxDeltaLength
-                                        )
-                                    {
-                                        //cout << x1 << ',' << x2 << ',' << y1 << ',' << y2 << endl;
-                                        //cout << x1normal << ',' << x2normal << ',' << y1normal << ',' << y2normal << endl;
-                                        //cout << "DeltaX:" << (x2normal-x1normal)
-                                        //<< ", DeltaY: " << (y2normal-y1normal)
-                                        //<< endl;
-                                        cppn.setValue("DeltaX",x2normal-x1normal);
-                                        cppn.setValue("DeltaY",y2normal-y1normal);
-                                    }
-                                    else
-                                    {
-                                        cppn.setValue("DeltaX",0);
-                                        cppn.setValue("DeltaY",0);
-                                    }
-                                }
+                    cppn.updateBatch(
+                        &inputIndices[0],
+                        (int)inputIndices.size(),
+                        &inputValues[0],
+                        blockSize,
+                        batchValues
+                        );
 
-                                if(cppn.hasNode("Bias"))
-                                {
-                                    cppn.setValue("Bias",(NetworkDataType)0.3);
-                                }
+                    const NetworkDataType *outputs = cppn.getBatchValues(batchValues,outputNodeIndex,blockSize);
 
-                                cppn.update();
+                    for (int q=0;q<blockSize;q++)
+                    {
+                        const SubstrateQuery &query = queries[blockStart+q];
+                        int x1 = query.x1;
+                        int y1 = query.y1;
+                        int x2 = query.x2;
+                        int y2 = query.y2;
 
-                                NetworkDataType output;
+                        NetworkDataType output = outputs[q];
 
-                                output = cppn.getValue(outputNodeName);
+#if DEBUG_BATCHED_CPPN_QUERY
+                        {
+                            // Run the query through the per-query path and make sure
+                            // the batched result is bit-for-bit identical
+                            NetworkDataType queryInputs[CPPN_NUM_INPUTS];
+                            getQueryInputs(query,z1,z2,queryInputs);
 
-                                output = convertOutputToWeight(output);
+                            cppn.reinitialize();
+                            for (int a=0;a<(int)inputIndices.size();a++)
+                            {
+                                cppn.setValue(cppnInputNames[inputSlots[a]],queryInputs[inputSlots[a]]);
+                            }
+                            cppn.update();
 
-                                JGTL::Vector3<int> inputNode(x1,y1,z1);
-                                JGTL::Vector3<int> outputNode(x2,y2,z2);
-                                if(allIncomingLinks.find(outputNode)==allIncomingLinks.end())
-                                {
-                                    allIncomingLinks[outputNode] = vector<LinkWeightPair<NetworkDataType> >();
-                                }
+                            NetworkDataType singleOutput = cppn.getValue(outputNodeName);
+                            if(memcmp(&singleOutput,&output,sizeof(NetworkDataType)))
+                            {
+                                cout << "Batched: " << output << " Per-query: " << singleOutput << endl;
+                                throw CREATE_LOCATEDEXCEPTION_INFO("Batched CPPN query does not match the per-query result!");
+                            }
+                        }
+#endif
 
-                                vector<LinkWeightPair<NetworkDataType> > &incomingLinks = allIncomingLinks[outputNode];
-                                // Set the output value for this link
-                                if(fabs(output)>0.0)
-                                {
-                                    incomingLinks.push_back(LinkWeightPair<NetworkDataType> (inputNode,output));
-                                }
+                        output = convertOutputToWeight(output);
+
+                        JGTL::Vector3<int> inputNode(x1,y1,z1);
+                        JGTL::Vector3<int> outputNode(x2,y2,z2);
+                        if(allIncomingLinks.find(outputNode)==allIncomingLinks.end())
+                        {
+                            allIncomingLinks[outputNode] = vector<LinkWeightPair<NetworkDataType> >();
+                        }
+
+                        vector<LinkWeightPair<NetworkDataType> > &incomingLinks = allIncomingLinks[outputNode];
+                        // Set the output value for this link
+                        if(fabs(output)>0.0)
+                        {
+                            incomingLinks.push_back(LinkWeightPair<NetworkDataType> (inputNode,output));
+                        }
 
-                                linkCounter++;
+                        linkCounter++;
 
 #if LAYERED_SUBSTRATE_ENABLE_BIASES
-                                throw CREATE_LOCATEDEXCEPTION_INFO("NOT SUPPORTED YET");
-                                if (x1==0&&y1==0&&z1==0)
-                                {
-                                    NetworkDataType nodeBias;
-
-                                    if (z2==1)
-                                    {
-                                        nodeBias = network.getValue("Bias_b");
-
-                                        nodeBias = convertOutputToWeight(nodeBias);
-
-                                        /*{
-                                          cout << "Setting bias for "
-                                          << nameLookup[Node(x2-layerSizes[z2].x/2,y2-layerSizes[z2].y/2,1)]
-                                          << endl;
-                                          cout << "Bias: " << nodeBias << endl;
-                                          CREATE_PAUSE("");
-                                          }*/
-
-                                        substrate.setBias(
-                                            *nameLookup.getData(Node(x2,y2,z2)),
-                                            nodeBias
-                                            );
-                                    }
-                                    else if (z2==2)
-                                    {
-                                        nodeBias = network.getValue("Bias_c");
-
-                                        nodeBias = convertOutputToWeight(nodeBias);
-
-                                        /*{
-                                          cout << "Setting bias for "
-                                          << nameLookup[Node(x2-layerSizes[z2].x/2,y2-layerSizes[z2].y/2,2)]
-                                          << endl;
-                                          cout << "Bias: " << nodeBias << endl;
-                                          CREATE_PAUSE("");
-                                          }*/
-
-                                        substrate.setBias(
-                                            *nameLookup.getData(Node(x2,y2,z2)),
-                                            nodeBias
-                                            );
-                                    }
-                                    else
-                                    {
-                                        throw CREATE_LOCATEDEXCEPTION_INFO("wtf");
-                                    }
-                                }
-#endif
+                        throw CREATE_LOCATEDEXCEPTION_INFO("NOT SUPPORTED YET");
+                        if (x1==0&&y1==0&&z1==0)
+                        {
+                            NetworkDataType nodeBias;
+
+                            if (z2==1)
+                            {
+                                nodeBias = network.getValue("Bias_b");
+
+                                nodeBias = convertOutputToWeight(nodeBias);
+
+                                /*{
+                                  cout << "Setting bias for "
+                                  << nameLookup[Node(x2-layerSizes[z2].x/2,y2-layerSizes[z2].y/2,1)]
+                                  << endl;
+                                  cout << "Bias: " << nodeBias << endl;
+                                  CREATE_PAUSE("");
+                                  }*/
+
+                                substrate.setBias(
+                                    *nameLookup.getData(Node(x2,y2,z2)),
+                                    nodeBias
+                                    );
+                            }
+                            else if (z2==2)
+                            {
+                                nodeBias = network.getValue("Bias_c");
+
+                                nodeBias = convertOutputToWeight(nodeBias);
+
+                                /*{
+                                  cout << "Setting bias for "
+                                  << nameLookup[Node(x2-layerSizes[z2].x/2,y2-layerSizes[z2].y/2,2)]
+                                  << endl;
+                                  cout << "Bias: " << nodeBias << endl;
+                                  CREATE_PAUSE("");
+                                  }*/
+
+                                substrate.setBias(
+                                    *nameLookup.getData(Node(x2,y2,z2)),
+                                    nodeBias
+                                    );
+                            }
+                            else
+                            {
+                                throw CREATE_LOCATEDEXCEPTION_INFO("wtf");
                             }
                         }
+#endif
                     }
                 }
             }
@@ -640,6 +744,52 @@ namespace NEAT
 #endif
     }
 
+    template< class NetworkDataType >
+    NodeHandle LayeredSubstrate<NetworkDataType>::resolve(const Node &node)
+    {
+        if(node.z<0 || node.z>=(int)layerSizes.size())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("OOPS");
+        }
+
+        // Same position as getValue()/setValue() use in the layer built by populateSubstrate()
+        JGTL::Vector2<int> validInputStart = (layerSizes[node.z] - layerValidSizes[node.z])/2;
+        int nodeArrayIndex = (node.y+validInputStart.y)*layerValidSizes[node.z].x + (node.x+validInputStart.x);
+        if(nodeArrayIndex<0 || nodeArrayIndex>=layerValidSizes[node.z].x*layerValidSizes[node.z].y)
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO("OOPS");
+        }
+
+        return NodeHandle(node.z,nodeArrayIndex);
+    }
+
+    template< class NetworkDataType >
+    void LayeredSubstrate<NetworkDataType>::setInputValues(const NetworkDataType *values)
+    {
+        for (int z=0;z<(int)layerValidSizes.size();z++)
+        {
+            if (layerIsInput[z])
+            {
+                setLayerValues(z,values);
+                values += layerValidSizes[z].x*layerValidSizes[z].y;
+            }
+        }
+    }
+
+    template< class NetworkDataType >
+    int LayeredSubstrate<NetworkDataType>::getInputValueCount()
+    {
+        int count=0;
+        for (int z=0;z<(int)layerValidSizes.size();z++)
+        {
+            if (layerIsInput[z])
+            {
+                count += layerValidSizes[z].x*layerValidSizes[z].y;
+            }
+        }
+        return count;
+    }
+
     template< class NetworkDataType >
     void LayeredSubstrate<NetworkDataType>::getWeightRGB(float &r,float &g,float &b,const Node &currentNode,const Node &sourceNode)
     {
@@ -4,25 +4,32 @@
 
 #include "NEAT_STL.h"
 
-#define DEBUG_RANDOM (1)
+#define DEBUG_RANDOM (0)
 
 namespace NEAT
 {
-    Random::Random(unsigned int _seed)
+    static inline ulong splitMix64(ulong &x)
+    {
+        ulong z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    Random::Random(unsigned int _seed,ulong _stream)
             :
             seed(_seed?_seed:static_cast<unsigned int>( ( (std::time(0)&0x0FFF)<<16) + (std::time(0)%0xFFFF) )),
-            generator(seed),
-            intDist(0,INT_MAX/2),
-            intGen(generator,intDist),
-            realDist(0,1.0 - 1e-6),
-            realGen(generator,realDist),
-            normalDist(0,1.0 - 1e-6),
-            normalGen(generator,normalDist)
-    {}
+            stream(_stream)
+    {
+        ulong x = (ulong(seed) << 32) ^ splitMix64(_stream);
+        state[0] = splitMix64(x);
+        state[1] = splitMix64(x);
+    }
 
     int Random::getRandomInt(int limit)
     {
-        int randNum = intGen()%limit;
+        //Scale the high 32 bits, the low bits of xoroshiro128+ are weaker
+        int randNum = int( ((next() >> 32) * ulong(limit)) >> 32 );
 
 #if DEBUG_RANDOM
         if(randNum<0 || randNum>=limit)
@@ -36,7 +43,7 @@ namespace NEAT
 
     int Random::getRandomWithinRange(int min,int max)
     {
-        int randNum = min + (intGen()%( (max-min) + 1));
+        int randNum = min + getRandomInt( (max-min) + 1 );
 
 #if DEBUG_RANDOM
         if(randNum<min || randNum>max)
@@ -50,7 +57,7 @@ namespace NEAT
 
     double Random::getRandomDouble()
     {
-        double randNum = realGen();
+        double randNum = double(next() >> 11) * (1.0/9007199254740992.0);
 
 #if DEBUG_RANDOM
         if(randNum<0.0 || randNum>=1.0)
@@ -59,12 +66,12 @@ namespace NEAT
         }
 #endif
 
-        return realGen();
+        return randNum;
     }
 
     double Random::getRandomDouble(double low,double high)
     {
-        double randNum = realGen()*(high-low) + low;
+        double randNum = getRandomDouble()*(high-low) + low;
 
 #if DEBUG_RANDOM
         if(randNum<low || randNum>=high)
@@ -0,0 +1,349 @@
+#include "NEAT_Defines.h"
+
+#include "NEAT_SpeciationEngine.h"
+
+#include "NEAT_GeneticIndividual.h"
+#include "NEAT_GeneticLinkGene.h"
+#include "NEAT_GeneticSpecies.h"
+#include "NEAT_Globals.h"
+
+#include <boost/thread.hpp>
+
+#define DEBUG_SPECIATION_ENGINE (0)
+
+namespace NEAT
+{
+    CompactGenome::CompactGenome(const GeneticIndividual *individual)
+    {
+        int numLinks = individual->getLinksCount();
+        linkIDs.resize(numLinks);
+        weights.resize(numLinks);
+
+        for (int a=0;a<numLinks;a++)
+        {
+            const GeneticLinkGene *link = individual->getLink(a);
+            linkIDs[a] = link->getID();
+            weights[a] = link->getWeight();
+        }
+    }
+
+    /**
+     * SpeciationQueue: Hands blocks of individuals out to the speciation threads
+     */
+    class SpeciationQueue
+    {
+        const SpeciationEngine &engine;
+
+        const vector<shared_ptr<GeneticIndividual> > &individuals;
+
+        vector<CompactGenome> &genomes;
+
+        const vector<const CompactGenome*> &representatives;
+
+        const vector<double> &representativeFitness;
+
+        double compatThreshold;
+
+        vector<int> &matches;
+
+        boost::mutex queueMutex;
+
+        int nextIndividual;
+
+        string error;
+
+    public:
+        SpeciationQueue(
+            const SpeciationEngine &_engine,
+            const vector<shared_ptr<GeneticIndividual> > &_individuals,
+            vector<CompactGenome> &_genomes,
+            const vector<const CompactGenome*> &_representatives,
+            const vector<double> &_representativeFitness,
+            double _compatThreshold,
+            vector<int> &_matches
+        )
+                :
+                engine(_engine),
+                individuals(_individuals),
+                genomes(_genomes),
+                representatives(_representatives),
+                representativeFitness(_representativeFitness),
+                compatThreshold(_compatThreshold),
+                matches(_matches),
+                nextIndividual(0)
+        {
+        }
+
+        void run()
+        {
+            const int blockSize=16;
+
+            while (true)
+            {
+                int begin;
+                {
+                    boost::mutex::scoped_lock lock(queueMutex);
+                    if (nextIndividual>=(int)individuals.size() || error.length())
+                    {
+                        return;
+                    }
+                    begin = nextIndividual;
+                    nextIndividual += blockSize;
+                }
+                int end = min(begin+blockSize,(int)individuals.size());
+
+                try
+                {
+                    for (int a=begin;a<end;a++)
+                    {
+                        genomes[a] = CompactGenome(individuals[a].get());
+                        matches[a] = engine.findSpecies(
+                                         representatives,
+                                         representativeFitness,
+                                         genomes[a],
+                                         individuals[a]->getFitness(),
+                                         compatThreshold
+                                     );
+                    }
+                }
+                catch (const std::exception &ex)
+                {
+                    boost::mutex::scoped_lock lock(queueMutex);
+                    if (!error.length())
+                    {
+                        error = ex.what();
+                    }
+                    return;
+                }
+            }
+        }
+
+        inline const string &getError()
+        {
+            return error;
+        }
+    };
+
+    SpeciationEngine::SpeciationEngine()
+            :
+            disjointCoeff(0),
+            excessCoeff(0),
+            weightDiffCoeff(0),
+            fitnessCoeff(0),
+            useLowerBound(false)
+    {
+    }
+
+    double SpeciationEngine::getCompatibility(
+        const CompactGenome &representative,
+        double representativeFitness,
+        const CompactGenome &individual,
+        double individualFitness
+    ) const
+    {
+        //Keep this in step with GeneticIndividual::getCompatibility
+        const int *ids1 = representative.linkIDs.empty() ? NULL : &representative.linkIDs[0];
+        const int *ids2 = individual.linkIDs.empty() ? NULL : &individual.linkIDs[0];
+        int numLinks1 = (int)representative.linkIDs.size();
+        int numLinks2 = (int)individual.linkIDs.size();
+
+        int numExcess = abs(numLinks1-numLinks2);
+
+        int numDisjoint=0,numMatching=0;
+
+        double weightDiffTotal=0;
+
+        int link1index=0,link2index=0;
+
+        while (link1index<numLinks1&&link2index<numLinks2)
+        {
+            if (ids2[link2index]<ids1[link1index])
+            {
+                numDisjoint++;
+                link2index++;
+            }
+            else if (ids1[link1index]<ids2[link2index])
+            {
+                numDisjoint++;
+                link1index++;
+            }
+            else //both links have the same ID
+            {
+                weightDiffTotal += fabs(representative.weights[link1index]-individual.weights[link2index]);
+                numMatching++;
+                link1index++;
+                link2index++;
+            }
+        }
+
+        return (
+                   disjointCoeff*numDisjoint+
+                   excessCoeff*numExcess+
+                   weightDiffCoeff*(weightDiffTotal/numMatching)+
+                   fitnessCoeff*getFitnessDifference(representativeFitness,individualFitness)
+               );
+    }
+
+    int SpeciationEngine::findSpecies(
+        const vector<const CompactGenome*> &representatives,
+        const vector<double> &representativeFitness,
+        const CompactGenome &individual,
+        double individualFitness,
+        double compatThreshold
+    ) const
+    {
+        for (int b=0;b<(int)representatives.size();b++)
+        {
+            if (canSkip(*representatives[b],representativeFitness[b],individual,individualFitness,compatThreshold))
+            {
+                continue;
+            }
+
+            double compatibility = getCompatibility(*representatives[b],representativeFitness[b],individual,individualFitness);
+            if (compatibility<compatThreshold)
+            {
+                return b;
+            }
+        }
+
+        return -1;
+    }
+
+    shared_ptr<CompactGenome> SpeciationEngine::getRepresentativeGenome(shared_ptr<GeneticIndividual> representative)
+    {
+        //Genes don't change after an individual is made, so the compact copy stays valid
+        for (int a=0;a<(int)cachedRepresentatives.size();a++)
+        {
+            if (cachedRepresentatives[a]==representative)
+            {
+                return cachedGenomes[a];
+            }
+        }
+
+        return shared_ptr<CompactGenome>(new CompactGenome(representative.get()));
+    }
+
+    void SpeciationEngine::speciate(
+        const vector<shared_ptr<GeneticIndividual> > &individuals,
+        vector<shared_ptr<GeneticSpecies> > &species,
+        double compatThreshold
+    )
+    {
+        Globals *globals = Globals::getSingleton();
+        disjointCoeff = globals->getParameterValue("DisjointCoefficient");
+        excessCoeff = globals->getParameterValue("ExcessCoefficient");
+        weightDiffCoeff = globals->getParameterValue("WeightDifferenceCoefficient");
+        fitnessCoeff = globals->getParameterValue("FitnessCoefficient");
+        useLowerBound = (disjointCoeff>=0.0 && weightDiffCoeff>=0.0);
+
+        //Only the current representatives stay in the cache
+        vector<shared_ptr<GeneticIndividual> > representativeIndividuals;
+        vector<shared_ptr<CompactGenome> > representativeGenomes;
+        for (int b=0;b<(int)species.size();b++)
+        {
+            representativeIndividuals.push_back(species[b]->getBestIndividual());
+            representativeGenomes.push_back(getRepresentativeGenome(representativeIndividuals.back()));
+        }
+        cachedRepresentatives = representativeIndividuals;
+        cachedGenomes = representativeGenomes;
+
+        vector<const CompactGenome*> representatives;
+        vector<double> representativeFitness;
+        for (int b=0;b<(int)species.size();b++)
+        {
+            representatives.push_back(representativeGenomes[b].get());
+            representativeFitness.push_back(representativeIndividuals[b]->getFitness());
+        }
+
+        //Test everyone against the species that existed before this call
+        vector<CompactGenome> genomes(individuals.size());
+        vector<int> matches(individuals.size(),-1);
+        SpeciationQueue queue(
+            *this,
+            individuals,
+            genomes,
+            representatives,
+            representativeFitness,
+            compatThreshold,
+            matches
+        );
+
+        int numThreads = min(globals->getThreadCount("SpeciationThreads"),max(1,int(individuals.size())/64));
+        if (numThreads<=1)
+        {
+            queue.run();
+        }
+        else
+        {
+            boost::thread_group threads;
+            for (int a=0;a<numThreads;a++)
+            {
+                threads.create_thread(boost::bind(&SpeciationQueue::run,&queue));
+            }
+            threads.join_all();
+        }
+
+        if (queue.getError().length())
+        {
+            throw CREATE_LOCATEDEXCEPTION_INFO(queue.getError());
+        }
+
+        //Species made during this call come after the old ones, so they are only tried when
+        //no old species matched.  This has to go in order.
+        int numOldSpecies = (int)species.size();
+        vector<const CompactGenome*> newRepresentatives;
+        vector<double> newRepresentativeFitness;
+
+        for (int a=0;a<(int)individuals.size();a++)
+        {
+            shared_ptr<GeneticIndividual> individual = individuals[a];
+
+            int speciesIndex = matches[a];
+            if (speciesIndex<0)
+            {
+                speciesIndex = findSpecies(
+                                   newRepresentatives,
+                                   newRepresentativeFitness,
+                                   genomes[a],
+                                   individual->getFitness(),
+                                   compatThreshold
+                               );
+                if (speciesIndex>=0)
+                {
+                    speciesIndex += numOldSpecies;
+                }
+            }
+
+#if DEBUG_SPECIATION_ENGINE
+            int serialIndex=-1;
+            for (int b=0;b<(int)species.size();b++)
+            {
+                if (species[b]->getBestIndividual()->getCompatibility(individual)<compatThreshold)
+                {
+                    serialIndex=b;
+                    break;
+                }
+            }
+            if (serialIndex!=speciesIndex)
+            {
+                throw CREATE_LOCATEDEXCEPTION_INFO("ERROR: Speciation engine disagrees with getCompatibility!");
+            }
+#endif
+
+            if (speciesIndex>=0)
+            {
+                //Found a compatible species
+                individual->setSpeciesID(species[speciesIndex]->getID());
+            }
+            else
+            {
+                //Make a new species.  The process of making a new speceis sets the ID for the individual.
+                shared_ptr<GeneticSpecies> newSpecies(new GeneticSpecies(individual));
+                species.push_back(newSpecies);
+
+                newRepresentatives.push_back(&genomes[a]);
+                newRepresentativeFitness.push_back(individual->getFitness());
+            }
+        }
+    }
+}
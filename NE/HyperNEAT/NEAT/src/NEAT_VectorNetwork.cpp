@@ -17,15 +17,13 @@
 
 namespace NEAT
 {
-	extern double signedSigmoidTable[6001];
-	extern double unsignedSigmoidTable[6001];
-
 	template<class Type>
 	VectorNetwork<Type>::VectorNetwork(const vector<NetworkNode *> &_nodes,const vector<NetworkLink *> &_links)
 		:
 	Network<Vector2<Type> >(),
 		numNodes(int(_nodes.size())),
-		numLinks(int(_links.size()))
+		numLinks(int(_links.size())),
+		activationKernel(ActivationKernel<Type>::fromGlobals())
 	{
 		data = (char*)malloc(
 			sizeof(Vector2<Type>)*2*numNodes +
@@ -107,7 +105,8 @@ namespace NEAT
 		:
 	Network<Vector2<Type> >(),
 		numNodes(_numNodes),
-		numLinks(_numLinks)
+		numLinks(_numLinks),
+		activationKernel(ActivationKernel<Type>::fromGlobals())
 	{
 		data = (char*)malloc(
 			sizeof(Vector2<Type>)*2*numNodes +
@@ -192,7 +191,8 @@ namespace NEAT
 		:
 	Network<Vector2<Type> >(),
 		numNodes(int(_nodes.size())),
-		numLinks(int(_links.size()))
+		numLinks(int(_links.size())),
+		activationKernel(ActivationKernel<Type>::fromGlobals())
 	{
 		data = (char*)malloc(
 			sizeof(Vector2<Type>)*2*numNodes +
@@ -314,6 +314,7 @@ namespace NEAT
 			numLinks = other.numLinks;
 			nodeNameToIndex = other.nodeNameToIndex;
 			numConstantNodes = other.numConstantNodes;
+			activationKernel = other.activationKernel;
 
 			data = (char*)realloc(
 				data,
@@ -529,251 +530,20 @@ namespace NEAT
 	template<class Type>
 	Vector2<Type> VectorNetwork<Type>::runActivationFunction(Vector2<Type> tmpVal,ActivationFunction function)
 	{
-		Vector2<Type> retVal;
-
-		bool signedActivation=false;
-
-		if (Globals::getSingleton()->hasSignedActivation())
-		{
-			signedActivation=true;
-		}
-
-#if DEBUG_ACTIVATION_CALCULATION
-		cout << "Before: " << tmpVal;
-#endif
-
 		switch (function)
 		{
-		case ACTIVATION_FUNCTION_SIGMOID:
-			//newValue = fsigmoid(tmpVal,4.924273,2.4621365);
-
-			//try my own sigmoid
-
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Sigmoid> ";
-#endif
-				//signed sigmoid
-				if(Globals::getSingleton()->isUsingTanhSigmoid())
-				{
-					retVal.x = 2 / (1 + exp(-2 * tmpVal.x)) - 1;
-					retVal.y = 2 / (1 + exp(-2 * tmpVal.y)) - 1;
-				}
-				else
-				{
-					if (tmpVal.x<-2.9||tmpVal.x>2.9)
-					{
-						retVal.x = ((1 / (1+exp(-tmpVal.x))) - (Type)0.5)*(Type)2.0;
-					}
-					else
-					{
-						retVal.x = (Type)signedSigmoidTable[int(tmpVal.x*(Type)1000.0)+3000];
-					}
-
-					if (tmpVal.y<-2.9||tmpVal.y>2.9)
-					{
-						retVal.y = (Type)( ((1.0 / (1+exp(-tmpVal.y))) - 0.5)*2.0 );
-					}
-					else
-					{
-						retVal.y = (Type)signedSigmoidTable[int(tmpVal.y*1000.0)+3000];
-					}
-				}
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Sigmoid> ";
-#endif
-				//unsigned sigmoid
-				if(Globals::getSingleton()->isUsingTanhSigmoid())
-				{
-					retVal.x = (1 + exp(-2 * tmpVal.x));
-					retVal.y = (1 + exp(-2 * tmpVal.y));
-				}
-				else
-				{
-					if (tmpVal.x<-2.9||tmpVal.x>2.9)
-					{
-						retVal.x = 1 / (1+exp(-tmpVal.x));
-					}
-					else
-					{
-						retVal.x = (Type)unsignedSigmoidTable[int(tmpVal.x*1000.0)+3000];
-					}
-
-					if (tmpVal.y<-2.9||tmpVal.y>2.9)
-					{
-						retVal.y = 1 / (1+exp(-tmpVal.y));
-					}
-					else
-					{
-						retVal.y = (Type)unsignedSigmoidTable[int(tmpVal.y*1000.0)+3000];
-					}
-				}
-			}
-			break;
-		case ACTIVATION_FUNCTION_SIN:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Sin> ";
-#endif
-				retVal.x = sin(tmpVal.x);
-				retVal.y = sin(tmpVal.y);
-
-				/* Rotation */
-				/*
-				double tempx = retVal.x;
-
-				retVal.x = retVal.x*cos(90.0) + retVal.y*sin(90.0);
-				retVal.y = retVal.y*cos(90.0) - tempx*sin(90.0);
-				*/
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Sin> ";
-#endif
-				retVal.x = (sin(tmpVal.x)+1)/2;
-				retVal.y = (sin(tmpVal.y)+1)/2;
-			}
-			break;
-		case ACTIVATION_FUNCTION_COS:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Cos> ";
-#endif
-				retVal.x = cos(tmpVal.x);
-				retVal.y = cos(tmpVal.y);
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Cos> ";
-#endif
-				retVal.x = (cos(tmpVal.x)+1)/2;
-				retVal.y = (cos(tmpVal.y)+1)/2;
-			}
-			break;
-		case ACTIVATION_FUNCTION_GAUSSIAN:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Gaussian> ";
-#endif
-				retVal.x = exp(-pow(tmpVal.x,2));
-				retVal.y = exp(-pow(tmpVal.y,2));
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Unsigned Gaussian> ";
-#endif
-				retVal.x = exp(-pow(tmpVal.x,2));
-				retVal.y = exp(-pow(tmpVal.y,2));
-			}
-			break;
 		case ACTIVATION_FUNCTION_SQUARE:
-#if DEBUG_ACTIVATION_CALCULATION
-			cout << " <Square> ";
-#endif
 			//Not used
-			break;
-		case ACTIVATION_FUNCTION_ABS_ROOT:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Root> ";
-#endif
-				if (tmpVal.x<0.0)
-				{
-					retVal.x = -sqrt(fabs(tmpVal.x));
-				}
-				else
-				{
-					retVal.x = sqrt(fabs(tmpVal.x));
-				}
-				if (tmpVal.y<0.0)
-				{
-					retVal.y = -sqrt(fabs(tmpVal.y));
-				}
-				else
-				{
-					retVal.y = sqrt(fabs(tmpVal.y));
-				}
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Absolute Root> ";
-#endif
-				retVal.x = sqrt(fabs(tmpVal.x));
-				retVal.y = sqrt(fabs(tmpVal.y));
-			}
-			break;
-		case ACTIVATION_FUNCTION_LINEAR:
-			if (signedActivation)
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Signed Linear> ";
-#endif
-				retVal.x = min(max(tmpVal.x,(Type)-3.0),(Type)3.0) / (Type)3.0;
-				retVal.y = min(max(tmpVal.y,(Type)-3.0),(Type)3.0) / (Type)3.0;
-			}
-			else
-			{
-#if DEBUG_ACTIVATION_CALCULATION
-				cout << " <Absolute Linear> ";
-#endif
-				retVal.x = ((min(max(tmpVal.x,(Type)-3.0),(Type)3.0) / (Type)3.0) + 1) / (Type)2.0;
-				retVal.y = ((min(max(tmpVal.y,(Type)-3.0),(Type)3.0) / (Type)3.0) + 1) / (Type)2.0;
-			}
-			break;
+			return Vector2<Type>();
 		case ACTIVATION_FUNCTION_ONES_COMPLIMENT:
 			//not set up
-
-			/*
-			if (signedActivation)
-			{
-			#if DEBUG_ACTIVATION_CALCULATION
-			cout << " <Signed Ones Compliment> ";
-			#endif
-			Vector2<Type> tmpVal2 = min(1.0,max(-1.0,tmpVal/3.0));
-			if (tmpVal>-0.1)
-			{
-			retVal = max(0.0,tmpVal2);
-			retVal = 1.0-tmpVal2;
-			}
-			else
-			{
-			retVal = (-1.0) - tmpVal;
-			}
-			}
-			else
-			{
-			#if DEBUG_ACTIVATION_CALCULATION
-			cout << " <Absolute Ones Compliment> ";
-			#endif
-			Vector2<Type> tmpVal2 = min(1.0,max(0.0,tmpVal/3.0));
-			retVal = 1.0-tmpVal2;
-			}
-			*/
-			retVal = tmpVal;
-			break;
+			return tmpVal;
 		default:
-			throw CREATE_LOCATEDEXCEPTION_INFO("Unknown activation function!!!");
-			break;
+			return Vector2<Type>(
+				activationKernel.activate(tmpVal.x,function),
+				activationKernel.activate(tmpVal.y,function)
+				);
 		}
-
-#if DEBUG_ACTIVATION_CALCULATION
-		cout << " After: " << retVal << endl;
-#endif
-
-		return retVal;
-
 	}
 
 	template class VectorNetwork<float>; // explicit instantiation
@@ -0,0 +1,133 @@
+#include "NEAT_TestCommon.h"
+
+using namespace NEAT;
+using namespace std;
+
+// Checks that FastNetwork::updateBatch, as used by LayeredSubstrate::populateSubstrate,
+// gives bit-identical outputs to one reinitialize()/setValue()/update() per query.
+
+static const char *inputNames[] =
+{
+    "X1","Y1","X2","Y2","DeltaX","DeltaY","Bias"
+};
+
+#define NUM_INPUTS (7)
+
+// Substrate side used to generate the queries (SIDE^4 queries per CPPN)
+#define SIDE (9)
+
+int checkIndividual(shared_ptr<GeneticIndividual> individual,int batchSize)
+{
+    FastNetwork<float> cppn = individual->spawnFastPhenotypeStack<float>();
+
+    vector<int> inputIndices;
+    for(int a=0;a<NUM_INPUTS;a++)
+    {
+        inputIndices.push_back(cppn.getNodeIndex(inputNames[a]));
+    }
+
+    vector<string> outputNames;
+    vector<int> outputIndices;
+    for(int a=0;a<individual->getNodesCount();a++)
+    {
+        if(individual->getNode(a)->getType()=="NetworkOutputNode")
+        {
+            outputNames.push_back(individual->getNode(a)->getName());
+            outputIndices.push_back(cppn.getNodeIndex(outputNames.back()));
+        }
+    }
+
+    // Same [-1,1] remapping as LayeredSubstrate::getQueryInputs
+    vector<float> queries;
+    for(int y1=0;y1<SIDE;y1++)
+        for(int x1=0;x1<SIDE;x1++)
+            for(int y2=0;y2<SIDE;y2++)
+                for(int x2=0;x2<SIDE;x2++)
+                {
+                    float x1normal = -1.0f + (float(x1)/(SIDE-1))*2.0f;
+                    float y1normal = -1.0f + (float(y1)/(SIDE-1))*2.0f;
+                    float x2normal = -1.0f + (float(x2)/(SIDE-1))*2.0f;
+                    float y2normal = -1.0f + (float(y2)/(SIDE-1))*2.0f;
+                    queries.push_back(x1normal);
+                    queries.push_back(y1normal);
+                    queries.push_back(x2normal);
+                    queries.push_back(y2normal);
+                    queries.push_back(x2normal-x1normal);
+                    queries.push_back(y2normal-y1normal);
+                    queries.push_back(0.3f);
+                }
+
+    int numQueries = int(queries.size())/NUM_INPUTS;
+    int mismatches=0;
+
+    vector<float> inputValues;
+    vector<float> batchValues;
+    for(int blockStart=0;blockStart<numQueries;blockStart+=batchSize)
+    {
+        int blockSize = min(batchSize,numQueries-blockStart);
+
+        inputValues.resize(NUM_INPUTS*blockSize);
+        for(int q=0;q<blockSize;q++)
+        {
+            for(int a=0;a<NUM_INPUTS;a++)
+            {
+                inputValues[a*blockSize+q] = queries[(blockStart+q)*NUM_INPUTS+a];
+            }
+        }
+
+        cppn.updateBatch(&inputIndices[0],NUM_INPUTS,&inputValues[0],blockSize,batchValues);
+
+        for(int q=0;q<blockSize;q++)
+        {
+            cppn.reinitialize();
+            for(int a=0;a<NUM_INPUTS;a++)
+            {
+                cppn.setValue(inputNames[a],queries[(blockStart+q)*NUM_INPUTS+a]);
+            }
+            cppn.update();
+
+            for(int a=0;a<(int)outputNames.size();a++)
+            {
+                float single = cppn.getValue(outputNames[a]);
+                float batched = cppn.getBatchValues(batchValues,outputIndices[a],blockSize)[q];
+                if(!sameBits(single,batched))
+                {
+                    if(mismatches<10)
+                    {
+                        cout << "MISMATCH on " << outputNames[a] << " query " << (blockStart+q)
+                             << ": batched " << batched << " per-query " << single << endl;
+                    }
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+int main()
+{
+    Globals::init();
+    Globals::getSingleton()->seedRandom(17);
+
+    int batchSizes[] = {1,7,256};
+
+    int mismatches=0;
+    int checked=0;
+    for(int individualIndex=0;individualIndex<20;individualIndex++)
+    {
+        shared_ptr<GeneticIndividual> individual = createTestIndividual(10+individualIndex*4);
+        for(int a=0;a<3;a++)
+        {
+            mismatches += checkIndividual(individual,batchSizes[a]);
+            checked++;
+        }
+    }
+
+    cout << "Checked " << checked << " CPPN/batch size pairs, " << mismatches << " mismatched outputs\n";
+
+    Globals::deinit();
+
+    return (mismatches==0)?0:1;
+}
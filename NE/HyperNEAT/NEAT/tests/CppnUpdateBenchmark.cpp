@@ -0,0 +1,120 @@
+#include "NEAT_TestCommon.h"
+
+using namespace NEAT;
+using namespace std;
+
+// Times FastNetwork::update() with the compiled (target-sorted) link layout against
+// the original kernel that walks the links in creation order.  The checksums of both
+// kernels must match, since the compiled layout keeps each node's links in order.
+
+static const char *inputNames[] =
+{
+    "X1","Y1","X2","Y2","DeltaX","DeltaY","Bias"
+};
+
+#define NUM_INPUTS (7)
+
+bool benchmark(FastNetwork<float> cppn,const string &description,int updates)
+{
+    vector<int> inputIndices;
+    for(int a=0;a<NUM_INPUTS;a++)
+    {
+        inputIndices.push_back(cppn.getNodeIndex(inputNames[a]));
+    }
+
+    cout << description << ": " << cppn.getNodeCount() << " nodes, " << cppn.getLinkCount() << " links\n";
+
+    float checksums[2] = {0,0};
+    for(int pass=0;pass<2;pass++)
+    {
+        cppn.setCompiledUpdate(pass==1);
+
+        double start = getMicroseconds();
+        for(int b=0;b<updates;b++)
+        {
+            cppn.reinitialize();
+            for(int a=0;a<NUM_INPUTS;a++)
+            {
+                if(inputIndices[a]>=0)
+                {
+                    cppn.setValue(NodeHandle(0,inputIndices[a]),float((b+a*37)%200-100)/100);
+                }
+            }
+            cppn.update();
+            for(int a=NUM_INPUTS;a<cppn.getNodeCount();a+=7)
+            {
+                checksums[pass] += cppn.getValue(NodeHandle(0,a));
+            }
+        }
+        double elapsed = getMicroseconds()-start;
+
+        cout << ((pass==0)?"    link-order kernel: ":"    compiled kernel:   ")
+             << (elapsed/updates) << " us/update\n";
+    }
+
+    cout << "    checksums: " << checksums[0] << " " << checksums[1] << endl;
+    return sameBits(checksums[0],checksums[1]);
+}
+
+int main(int argc,char **argv)
+{
+    Globals::init();
+    Globals::getSingleton()->seedRandom(23);
+
+    bool matched=true;
+
+    int mutationCounts[] = {10,50,200};
+    for(int a=0;a<3;a++)
+    {
+        shared_ptr<GeneticIndividual> individual = createTestIndividual(mutationCounts[a]);
+        matched &= benchmark(
+            individual->spawnFastPhenotypeStack<float>(),
+            "CPPN after "+toString(mutationCounts[a])+" mutations",
+            100000
+            );
+    }
+
+    {
+        // A large network in the shape the compiled layout is meant for: 800 nodes and
+        // 60000 links, each link going from a lower to a higher node
+        int numNodes=800;
+        int numLinks=60000;
+        NEAT::Random &random = Globals::getSingleton()->getRandom();
+
+        vector<NetworkNode> nodes;
+        for(int a=0;a<numNodes;a++)
+        {
+            if(a<NUM_INPUTS)
+            {
+                nodes.push_back(NetworkNode(inputNames[a],false));
+            }
+            else
+            {
+                nodes.push_back(NetworkNode("Hidden"+toString(a),true,(a%2)?ACTIVATION_FUNCTION_SIGMOID:ACTIVATION_FUNCTION_GAUSSIAN));
+            }
+        }
+
+        vector<NetworkLink> links;
+        for(int a=0;a<numLinks;a++)
+        {
+            int to = NUM_INPUTS+random.getRandomInt(numNodes-NUM_INPUTS);
+            int from = random.getRandomInt(to);
+            links.push_back(NetworkLink(&nodes[from],&nodes[to],random.getRandomDouble(-1,1)));
+        }
+
+        matched &= benchmark(
+            FastNetwork<float>(&nodes[0],numNodes,&links[0],numLinks),
+            "Synthetic network",
+            2000
+            );
+    }
+
+    Globals::deinit();
+
+    if(!matched)
+    {
+        cout << "The kernels' checksums do not match!\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "NEAT_TestCommon.h"
+
+using namespace NEAT;
+using namespace std;
+
+// Times FastLayeredNetwork on Atari-style substrates: the original dense loop, update()
+// (one matrix-vector product per layer pair) and updateBatch() (one matrix-matrix product
+// for a whole batch).  Times are per frame and include setting the inputs.  Every frame of
+// update() and of updateBatch() must match the dense loop bit for bit.
+
+#define NUM_NETWORKS (5)
+
+#define NUM_FRAMES (1024)
+
+/**
+ * createFrames: NUM_FRAMES input vectors, each input set with the given probability
+ */
+vector<vector<float> > createFrames(int numInputs,double inputDensity)
+{
+    NEAT::Random &random = Globals::getSingleton()->getRandom();
+
+    vector<vector<float> > frames(NUM_FRAMES,vector<float>(numInputs,0.0f));
+    for(int frame=0;frame<NUM_FRAMES;frame++)
+    {
+        for(int a=0;a<numInputs;a++)
+        {
+            if(random.getRandomDouble()<inputDensity)
+            {
+                frames[frame][a] = float(random.getRandomDouble(-1,1));
+            }
+        }
+    }
+    return frames;
+}
+
+bool benchmark(int width,int height,int numOutputs,double inputDensity,const string &description)
+{
+    int numInputs = width*height;
+    int batchSizes[] = {1,4,16,64};
+    const int numBatchSizes = 4;
+
+    vector<vector<float> > frames = createFrames(numInputs,inputDensity);
+
+    double referenceTime=0,updateTime=0,batchTimes[numBatchSizes] = {0,0,0,0};
+    int mismatches=0;
+
+    for(int n=0;n<NUM_NETWORKS;n++)
+    {
+        //About as dense as the weights of the Atari CPPNs
+        vector<NetworkLayer<float> > referenceLayers = createTestLayers<float>(width,height,numOutputs,0.7);
+        FastLayeredNetwork<float> network(referenceLayers);
+        int outputLayer = (int)referenceLayers.size()-1;
+
+        //The outputs of the dense loop for every frame
+        vector<float> referenceOutputs(NUM_FRAMES*numOutputs);
+        double start = getMicroseconds();
+        for(int frame=0;frame<NUM_FRAMES;frame++)
+        {
+            for(int layer=0;layer<(int)referenceLayers.size();layer++)
+            {
+                referenceLayers[layer].initialize();
+            }
+            referenceLayers[0].nodeValues = frames[frame];
+            referenceLayeredUpdate(referenceLayers);
+            memcpy(&referenceOutputs[frame*numOutputs],&referenceLayers[outputLayer].nodeValues[0],sizeof(float)*numOutputs);
+        }
+        referenceTime += getMicroseconds()-start;
+
+        start = getMicroseconds();
+        for(int frame=0;frame<NUM_FRAMES;frame++)
+        {
+            network.reinitialize();
+            network.setLayerValues(0,&frames[frame][0]);
+            network.update();
+            for(int a=0;a<numOutputs;a++)
+            {
+                if(!sameBits(network.getValue(NodeHandle(outputLayer,a)),referenceOutputs[frame*numOutputs+a]))
+                {
+                    mismatches++;
+                }
+            }
+        }
+        updateTime += getMicroseconds()-start;
+
+        for(int b=0;b<numBatchSizes;b++)
+        {
+            int batchSize = batchSizes[b];
+            vector<float> batchValues(network.getBatchValueCount(batchSize));
+
+            start = getMicroseconds();
+            for(int firstFrame=0;firstFrame<NUM_FRAMES;firstFrame+=batchSize)
+            {
+                for(int a=0;a<numInputs;a++)
+                {
+                    float *row = network.getBatchValues(batchValues,NodeHandle(0,a),batchSize);
+                    for(int sample=0;sample<batchSize;sample++)
+                    {
+                        row[sample] = frames[firstFrame+sample][a];
+                    }
+                }
+                network.updateBatch(batchValues,batchSize);
+                for(int a=0;a<numOutputs;a++)
+                {
+                    const float *row = network.getBatchValues(batchValues,NodeHandle(outputLayer,a),batchSize);
+                    for(int sample=0;sample<batchSize;sample++)
+                    {
+                        if(!sameBits(row[sample],referenceOutputs[(firstFrame+sample)*numOutputs+a]))
+                        {
+                            mismatches++;
+                        }
+                    }
+                }
+            }
+            batchTimes[b] += getMicroseconds()-start;
+        }
+    }
+
+    double frameCount = double(NUM_NETWORKS)*NUM_FRAMES;
+    cout << description << ", " << width << "x" << height << " -> " << numOutputs << ":\n";
+    cout << "    dense loop: " << (referenceTime/frameCount) << " us/frame\n";
+    cout << "    update():   " << (updateTime/frameCount) << " us/frame\n";
+    for(int b=0;b<numBatchSizes;b++)
+    {
+        cout << "    batch " << batchSizes[b] << ": " << (batchTimes[b]/frameCount) << " us/frame\n";
+    }
+    cout << "    " << mismatches << " mismatched outputs\n";
+
+    return mismatches==0;
+}
+
+int main(int argc,char **argv)
+{
+    Globals::init();
+    Globals::getSingleton()->seedRandom(29);
+
+    bool matched=true;
+
+    matched &= benchmark(8,10,18,1.0,"Dense inputs");
+    matched &= benchmark(16,21,18,1.0,"Dense inputs");
+    matched &= benchmark(8,10,18,3.0/80,"Sparse inputs");
+    matched &= benchmark(16,21,18,3.0/336,"Sparse inputs");
+
+    Globals::deinit();
+
+    if(!matched)
+    {
+        cout << "The outputs do not match the dense loop!\n";
+        return 1;
+    }
+    return 0;
+}
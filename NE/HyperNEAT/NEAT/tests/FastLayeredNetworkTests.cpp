@@ -0,0 +1,84 @@
+#include "NEAT_TestCommon.h"
+
+using namespace NEAT;
+using namespace std;
+
+// Checks that FastLayeredNetwork::update(), which skips zero source nodes and scatters
+// through compressed weights, gives bit for bit the values of the dense loop it replaced.
+// The weights and the inputs are random and mostly zero, at densities that send each
+// layer pair down each of the update paths.
+
+template<class Type>
+int checkNetwork(int width,int height,int numOutputs,double weightDensity,int frames)
+{
+    NEAT::Random &random = Globals::getSingleton()->getRandom();
+
+    vector<NetworkLayer<Type> > referenceLayers = createTestLayers<Type>(width,height,numOutputs,weightDensity);
+    FastLayeredNetwork<Type> network(referenceLayers);
+
+    int numInputs = width*height;
+    vector<Type> inputs(numInputs);
+
+    //A few objects, half of the inputs and every input
+    double inputDensities[] = {3.0/numInputs,0.5,1.0};
+
+    int mismatches=0;
+    for(int frame=0;frame<frames;frame++)
+    {
+        double inputDensity = inputDensities[frame%3];
+        for(int a=0;a<numInputs;a++)
+        {
+            inputs[a] = (random.getRandomDouble()<inputDensity) ? Type(random.getRandomDouble(-1,1)) : Type(0);
+        }
+
+        network.reinitialize();
+        network.setLayerValues(0,&inputs[0]);
+        network.update();
+
+        for(int layer=0;layer<(int)referenceLayers.size();layer++)
+        {
+            referenceLayers[layer].initialize();
+        }
+        referenceLayers[0].nodeValues = inputs;
+        referenceLayeredUpdate(referenceLayers);
+
+        for(int layer=1;layer<(int)referenceLayers.size();layer++)
+        {
+            for(int a=0;a<(int)referenceLayers[layer].nodeValues.size();a++)
+            {
+                if(!sameBits(network.getValue(NodeHandle(layer,a)),referenceLayers[layer].nodeValues[a]))
+                {
+                    mismatches++;
+                }
+            }
+        }
+    }
+
+    cout << width << "x" << height << " -> " << numOutputs << ", weight density " << weightDensity
+         << ", " << (sizeof(Type)==sizeof(float)?"float":"double") << ": input->processing "
+         << (network.isSparse(1,0)?"sparse":"dense") << ", " << mismatches << " mismatched values\n";
+
+    return mismatches;
+}
+
+int main()
+{
+    Globals::init();
+    Globals::getSingleton()->seedRandom(13);
+
+    int mismatches=0;
+
+    double weightDensities[] = {0.01,0.1,0.4,0.6,1.0};
+    for(int a=0;a<5;a++)
+    {
+        mismatches += checkNetwork<float>(8,10,18,weightDensities[a],60);
+        mismatches += checkNetwork<double>(8,10,18,weightDensities[a],60);
+        mismatches += checkNetwork<float>(16,21,18,weightDensities[a],12);
+    }
+
+    cout << mismatches << " mismatches\n";
+
+    Globals::deinit();
+
+    return (mismatches==0)?0:1;
+}
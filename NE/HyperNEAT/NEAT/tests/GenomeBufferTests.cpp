@@ -0,0 +1,171 @@
+#include "NEAT_TestCommon.h"
+
+#include <sstream>
+
+using namespace NEAT;
+using namespace std;
+
+// Checks that individuals sent through GenomeWriter/GenomeReader (the MPI wire format)
+// come back identical to the originals, compares the round trip with the text format
+// it replaced, and makes sure corrupt buffers are rejected.
+
+string dumpText(GeneticIndividual &individual)
+{
+    ostringstream ostr;
+    individual.dump(ostr);
+    return ostr.str();
+}
+
+int checkRoundTrip(vector<shared_ptr<GeneticIndividual> > &individuals)
+{
+    int mismatches=0;
+
+    //Several individuals back to back, the way HCUBE_MPIEvaluationSet sends them
+    vector<char> buffer;
+    GenomeWriter writer(buffer);
+    for (int a=0;a<(int)individuals.size();a++)
+    {
+        individuals[a]->dump(writer);
+    }
+
+    GenomeReader reader(&buffer[0],buffer.size());
+    for (int a=0;a<(int)individuals.size();a++)
+    {
+        GeneticIndividual decoded(reader);
+
+        GeneticIndividual &original = *individuals[a];
+        bool same =
+            dumpText(decoded)==dumpText(original) &&
+            decoded==original &&
+            decoded.getFitness()==original.getFitness() &&
+            decoded.getSpeciesID()==original.getSpeciesID() &&
+            decoded.getUserData()==original.getUserData();
+
+        //The text format drops the gene ages, the binary format keeps them
+        for (int b=0;same && b<decoded.getNodesCount();b++)
+        {
+            same = decoded.getNode(b)->getAge()==original.getNode(b)->getAge();
+        }
+        for (int b=0;same && b<decoded.getLinksCount();b++)
+        {
+            same = decoded.getLink(b)->getAge()==original.getLink(b)->getAge();
+        }
+
+        if (!same)
+        {
+            cout << "Individual " << a << " did not survive the binary round trip\n";
+            mismatches++;
+        }
+    }
+
+    if (reader.getBytesLeft()!=0)
+    {
+        cout << "The reader did not consume the whole buffer\n";
+        mismatches++;
+    }
+
+    return mismatches;
+}
+
+bool decodeThrows(const vector<char> &buffer)
+{
+    try
+    {
+        GenomeReader reader(&buffer[0],buffer.size());
+        GeneticIndividual decoded(reader);
+    }
+    catch (const std::exception &)
+    {
+        return true;
+    }
+    return false;
+}
+
+int checkCorruptBuffers(shared_ptr<GeneticIndividual> individual)
+{
+    vector<char> buffer;
+    GenomeWriter writer(buffer);
+    individual->dump(writer);
+
+    int mismatches=0;
+
+    vector<char> truncated(buffer.begin(),buffer.end()-5);
+    if (!decodeThrows(truncated))
+    {
+        cout << "A truncated buffer was accepted\n";
+        mismatches++;
+    }
+
+    vector<char> wrongLength(buffer);
+    int length;
+    memcpy(&length,&wrongLength[0],sizeof(int));
+    length -= 4;
+    memcpy(&wrongLength[0],&length,sizeof(int));
+    if (!decodeThrows(wrongLength))
+    {
+        cout << "A wrong length prefix was accepted\n";
+        mismatches++;
+    }
+
+    return mismatches;
+}
+
+void timeRoundTrips(vector<shared_ptr<GeneticIndividual> > &individuals)
+{
+    int count = (int)individuals.size();
+
+    double start = getMicroseconds();
+    for (int a=0;a<count;a++)
+    {
+        istringstream istr(dumpText(*individuals[a]));
+        GeneticIndividual decoded(istr);
+    }
+    double textTime = getMicroseconds()-start;
+
+    start = getMicroseconds();
+    vector<char> buffer;
+    for (int a=0;a<count;a++)
+    {
+        buffer.clear();
+        GenomeWriter writer(buffer);
+        individuals[a]->dump(writer);
+        GenomeReader reader(&buffer[0],buffer.size());
+        GeneticIndividual decoded(reader);
+    }
+    double binaryTime = getMicroseconds()-start;
+
+    cout << count << " genomes: text " << (textTime/1000.0) << " ms, binary "
+         << (binaryTime/1000.0) << " ms\n";
+}
+
+int main()
+{
+    Globals::init();
+    Globals::getSingleton()->seedRandom(31);
+
+    vector<shared_ptr<GeneticIndividual> > individuals;
+    for (int a=0;a<200;a++)
+    {
+        shared_ptr<GeneticIndividual> individual = createTestIndividual(5+a/4);
+        individual->setFitness(1000.0/(a+3));
+        individual->setSpeciesID(a%7);
+        individual->setUserData((a%3)?string("user data ")+toString(a):string());
+        for (int b=0;b<a%4;b++)
+        {
+            individual->incrementAge();
+        }
+        individuals.push_back(individual);
+    }
+
+    int mismatches=0;
+    mismatches += checkRoundTrip(individuals);
+    mismatches += checkCorruptBuffers(individuals.back());
+
+    timeRoundTrips(individuals);
+
+    cout << mismatches << " mismatches\n";
+
+    Globals::deinit();
+
+    return (mismatches==0)?0:1;
+}
@@ -0,0 +1,124 @@
+#include "NEAT_TestCommon.h"
+#include "NEAT_IndexedPopulationFile.h"
+
+#include <sstream>
+#include <cstdio>
+
+using namespace NEAT;
+using namespace std;
+
+// Writes an indexed population file, loads single individuals back out of it and checks
+// that each one dumps the same as the genome the text loader reads from the same
+// individual's dump, and equals the saved individual exactly.  Also checks the saved
+// parameters and the embedded archive.
+
+static const char *testFileName = "IndexedPopulationFileTests.idx";
+
+string dumpText(GeneticIndividual &individual)
+{
+    ostringstream ostr;
+    individual.dump(ostr);
+    return ostr.str();
+}
+
+int checkIndividuals(const IndexedPopulationFile &indexedFile,vector<shared_ptr<GeneticIndividual> > &individuals)
+{
+    int mismatches=0;
+
+    if (indexedFile.getIndividualCount()!=(int)individuals.size())
+    {
+        cout << "The file holds " << indexedFile.getIndividualCount() << " individuals instead of "
+             << individuals.size() << endl;
+        return 1;
+    }
+
+    //In reverse, so no individual is found by reading from the start of the file
+    for (int a=(int)individuals.size()-1;a>=0;a--)
+    {
+        istringstream istr(dumpText(*individuals[a]));
+        GeneticIndividual textLoaded(istr);
+
+        shared_ptr<GeneticIndividual> indexedLoaded = indexedFile.getIndividual(a);
+
+        //The text format rounds the weights, so only the original has the exact genome
+        if (dumpText(*indexedLoaded)!=dumpText(textLoaded))
+        {
+            cout << "Individual " << a << " differs from the text loader's genome\n";
+            mismatches++;
+        }
+        else if (!(*indexedLoaded==*individuals[a]))
+        {
+            cout << "Individual " << a << " differs from the saved genome\n";
+            mismatches++;
+        }
+    }
+
+    return mismatches;
+}
+
+int checkParameters(const IndexedPopulationFile &indexedFile)
+{
+    Globals *globals = Globals::getSingleton();
+    double savedValue = globals->getParameterValue("PopulationSize");
+    globals->setParameterValue("PopulationSize",savedValue+1);
+
+    indexedFile.loadParameters();
+
+    if (globals->getParameterValue("PopulationSize")!=savedValue)
+    {
+        cout << "loadParameters() did not restore the saved parameters\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    Globals::init();
+    Globals::getSingleton()->seedRandom(17);
+
+    vector<shared_ptr<GeneticIndividual> > individuals;
+    for (int a=0;a<50;a++)
+    {
+        shared_ptr<GeneticIndividual> individual = createTestIndividual(5+a);
+        individual->setFitness(100.0/(a+1));
+        individuals.push_back(individual);
+    }
+
+    string archive = "stand-in for the gzip'd boost archive";
+    IndexedPopulationFile::write(testFileName,individuals,12,archive);
+
+    int mismatches=0;
+
+    if (!IndexedPopulationFile::isIndexedPopulationFile(testFileName))
+    {
+        cout << "The written file is not recognized as an indexed population file\n";
+        mismatches++;
+    }
+    else
+    {
+        IndexedPopulationFile indexedFile(testFileName);
+
+        mismatches += checkIndividuals(indexedFile,individuals);
+        mismatches += checkParameters(indexedFile);
+
+        if (indexedFile.getGeneration()!=12)
+        {
+            cout << "The generation was not saved\n";
+            mismatches++;
+        }
+        if (string(indexedFile.getArchiveData(),indexedFile.getArchiveSize())!=archive)
+        {
+            cout << "The embedded archive was not saved unchanged\n";
+            mismatches++;
+        }
+    }
+
+    remove(testFileName);
+
+    cout << mismatches << " mismatches\n";
+
+    Globals::deinit();
+
+    return (mismatches==0)?0:1;
+}
@@ -0,0 +1,168 @@
+#include "NEAT_TestCommon.h"
+
+using namespace NEAT;
+using namespace std;
+
+// Checks the hashed innovation history behind Globals::assignLinkID against the
+// linear scan of this generation's link genes that it replaced, and times both.
+
+/**
+ * ReferenceLinkHistory: The old history, a list of copies of every new link gene
+ * that is scanned from the start for each new gene
+ */
+class ReferenceLinkHistory
+{
+    vector<shared_ptr<GeneticLinkGene> > linkGenesThisGeneration;
+
+public:
+    int find(int fromNodeID,int toNodeID)
+    {
+        for (int a=0;a<(int)linkGenesThisGeneration.size();a++)
+        {
+            shared_ptr<GeneticLinkGene> link = linkGenesThisGeneration[a];
+            if (link->getFromNodeID()==fromNodeID&&link->getToNodeID()==toNodeID)
+            {
+                return link->getID();
+            }
+        }
+        return -1;
+    }
+
+    void add(const GeneticLinkGene &link)
+    {
+        linkGenesThisGeneration.push_back(shared_ptr<GeneticLinkGene>(new GeneticLinkGene(link)));
+    }
+};
+
+int checkLinkIDs(int numGenes)
+{
+    NEAT::Random &random = Globals::getSingleton()->getRandom();
+    Globals::getSingleton()->clearLinkHistory();
+
+    //Half of the genes repeat a pair that was already created this generation
+    vector<pair<int,int> > pairs;
+    for (int a=0;a<numGenes;a++)
+    {
+        if (a>0 && random.getRandomInt(2)==0)
+        {
+            pairs.push_back(pairs[random.getRandomInt(a)]);
+        }
+        else
+        {
+            pairs.push_back(pair<int,int>(random.getRandomInt(100000),random.getRandomInt(100000)));
+        }
+    }
+
+    vector<GeneticLinkGene> genes;
+    genes.reserve(numGenes);
+
+    double start = getMicroseconds();
+    for (int a=0;a<numGenes;a++)
+    {
+        genes.push_back(GeneticLinkGene(pairs[a].first,pairs[a].second,0.5));
+    }
+    double hashedTime = getMicroseconds()-start;
+
+    int mismatches=0;
+    int lastNewID=-1;
+    ReferenceLinkHistory reference;
+
+    start = getMicroseconds();
+    for (int a=0;a<numGenes;a++)
+    {
+        int referenceID = reference.find(pairs[a].first,pairs[a].second);
+        if (referenceID>=0)
+        {
+            //A repeated pair must get the ID of its first gene
+            if (genes[a].getID()!=referenceID)
+            {
+                mismatches++;
+            }
+        }
+        else
+        {
+            //A new pair must get a new ID
+            if (genes[a].getID()<=lastNewID)
+            {
+                mismatches++;
+            }
+            lastNewID = genes[a].getID();
+            reference.add(genes[a]);
+        }
+    }
+    double referenceTime = getMicroseconds()-start;
+
+    cout << numGenes << " new link genes: hashed " << (hashedTime/1000.0) << " ms, linear scan "
+         << (referenceTime/1000.0) << " ms, " << mismatches << " mismatched IDs\n";
+
+    return mismatches;
+}
+
+int checkClearedHistory()
+{
+    Globals::getSingleton()->clearLinkHistory();
+    GeneticLinkGene first(1,2,0.5);
+    GeneticLinkGene repeat(1,2,0.5);
+
+    Globals::getSingleton()->clearLinkHistory();
+    GeneticLinkGene nextGeneration(1,2,0.5);
+
+    int mismatches=0;
+    if (repeat.getID()!=first.getID())
+    {
+        cout << "A repeated link did not get the same ID\n";
+        mismatches++;
+    }
+    if (nextGeneration.getID()==first.getID())
+    {
+        cout << "clearLinkHistory() did not forget the link\n";
+        mismatches++;
+    }
+    return mismatches;
+}
+
+int checkNodeSplits()
+{
+    Globals::getSingleton()->clearLinkHistory();
+
+    //Two nodes that split the same link in one generation are the same node
+    GeneticNodeGene first("","HiddenNode",0.5,false);
+    Globals::getSingleton()->assignNodeID(&first,3,4);
+    GeneticNodeGene repeat("","HiddenNode",0.5,false);
+    Globals::getSingleton()->assignNodeID(&repeat,3,4);
+    GeneticNodeGene other("","HiddenNode",0.5,false);
+    Globals::getSingleton()->assignNodeID(&other,4,3);
+
+    int mismatches=0;
+    if (repeat.getID()!=first.getID())
+    {
+        cout << "A repeated split did not get the same node ID\n";
+        mismatches++;
+    }
+    if (other.getID()==first.getID())
+    {
+        cout << "Splits of different links got the same node ID\n";
+        mismatches++;
+    }
+    return mismatches;
+}
+
+int main()
+{
+    Globals::init();
+    Globals::getSingleton()->seedRandom(5);
+
+    int mismatches=0;
+    mismatches += checkClearedHistory();
+    mismatches += checkNodeSplits();
+
+    int geneCounts[] = {1000,4000,16000};
+    for (int a=0;a<3;a++)
+    {
+        mismatches += checkLinkIDs(geneCounts[a]);
+    }
+
+    Globals::deinit();
+
+    return (mismatches==0)?0:1;
+}
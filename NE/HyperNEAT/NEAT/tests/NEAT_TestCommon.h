@@ -0,0 +1,155 @@
+#ifndef NEAT_TESTCOMMON_H_INCLUDED
+#define NEAT_TESTCOMMON_H_INCLUDED
+
+#include "NEAT.h"
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace NEAT
+{
+    /**
+     * createTestIndividual: Builds a CPPN with the same inputs LayeredSubstrate queries
+     * and grows it with the given number of testMutate() calls, the way the experiments
+     * build their initial populations
+     */
+    inline shared_ptr<GeneticIndividual> createTestIndividual(int mutations,int numOutputs=2)
+    {
+        vector<GeneticNodeGene> genes;
+
+        genes.push_back(GeneticNodeGene("Bias","NetworkSensor",0,false));
+        genes.push_back(GeneticNodeGene("X1","NetworkSensor",0,false));
+        genes.push_back(GeneticNodeGene("Y1","NetworkSensor",0,false));
+        genes.push_back(GeneticNodeGene("X2","NetworkSensor",0,false));
+        genes.push_back(GeneticNodeGene("Y2","NetworkSensor",0,false));
+        genes.push_back(GeneticNodeGene("DeltaX","NetworkSensor",0,false));
+        genes.push_back(GeneticNodeGene("DeltaY","NetworkSensor",0,false));
+
+        for(int a=0;a<numOutputs;a++)
+        {
+            genes.push_back(GeneticNodeGene(
+                "Output_Layer"+toString(a)+"_Layer"+toString(a+1),
+                "NetworkOutputNode",1,false,
+                ACTIVATION_FUNCTION_SIGMOID));
+        }
+
+        shared_ptr<GeneticIndividual> individual(new GeneticIndividual(genes,true,1.0));
+        for(int a=0;a<mutations;a++)
+        {
+            individual->testMutate();
+        }
+        return individual;
+    }
+
+    /**
+     * referenceLayeredUpdate: The original update(), the dense loop over every source node
+     */
+    template<class Type>
+    void referenceLayeredUpdate(vector<NetworkLayer<Type> > &layers)
+    {
+        for(typename vector<NetworkLayer<Type> >::iterator layer = layers.begin();layer != layers.end();layer++)
+        {
+            vector<Type> &toNodes = layer->nodeValues;
+            int numToNodes = (int)toNodes.size();
+            int toNode;
+
+            if(layer->fromLayers.size())
+            {
+                for(toNode=0;toNode<numToNodes;toNode++)
+                {
+                    toNodes[toNode]=0.0f;
+                }
+
+                for(size_t a=0;a<layer->fromLayers.size();a++)
+                {
+                    const NetworkLayer<Type> &fromLayer = layers[layer->fromLayers[a]];
+
+                    const vector<Type> &fromNodes = fromLayer.nodeValues;
+                    const Type* fromNodesPtr = &(fromLayer.nodeValues[0]);
+                    int numFromNodes = (int)fromNodes.size();
+
+                    Type nodeValue;
+                    int fromNode;
+                    Type* weightsPtr;
+                    for(toNode=0;toNode<numToNodes;toNode++)
+                    {
+                        nodeValue=0;
+                        weightsPtr = &(layer->fromWeights[a][toNode*layer->nodeValues.size()]);
+                        for(fromNode=0;fromNode<numFromNodes;fromNode++)
+                        {
+                            nodeValue += fromNodesPtr[fromNode] * weightsPtr[fromNode];
+                        }
+
+                        toNodes[toNode] += nodeValue;
+                    }
+                }
+
+                for(toNode=0;toNode<numToNodes;toNode++)
+                {
+                    toNodes[toNode] = (2.0f / (1.0f + exp(-toNodes[toNode]))) - 1.0f;
+                }
+            }
+        }
+    }
+
+    /**
+     * createTestLayers: An Atari-style substrate: a width x height input sheet feeding a
+     * processing sheet of the same size, and an output layer fed by both
+     */
+    template<class Type>
+    vector<NetworkLayer<Type> > createTestLayers(int width,int height,int numOutputs,double weightDensity)
+    {
+        NEAT::Random &random = Globals::getSingleton()->getRandom();
+
+        vector<JGTL::Vector2<int> > sheetSize(1,JGTL::Vector2<int>(width,height));
+        vector<JGTL::Vector2<int> > bothSizes(2,JGTL::Vector2<int>(width,height));
+
+        vector<NetworkLayer<Type> > layers;
+        layers.push_back(NetworkLayer<Type>("Input",width*height,width,vector<int>(),vector<JGTL::Vector2<int> >()));
+        layers.push_back(NetworkLayer<Type>("Processing",width*height,width,vector<int>(1,0),sheetSize));
+        vector<int> outputFromLayers;
+        outputFromLayers.push_back(0);
+        outputFromLayers.push_back(1);
+        layers.push_back(NetworkLayer<Type>("Output",numOutputs,numOutputs,outputFromLayers,bothSizes));
+
+        for(int layer=1;layer<(int)layers.size();layer++)
+        {
+            for(int a=0;a<(int)layers[layer].fromWeights.size();a++)
+            {
+                vector<Type> &weights = layers[layer].fromWeights[a];
+                for(int b=0;b<(int)weights.size();b++)
+                {
+                    if(random.getRandomDouble()<weightDensity)
+                    {
+                        weights[b] = Type(random.getRandomDouble(-3,3));
+                    }
+                }
+            }
+        }
+
+        return layers;
+    }
+
+    /**
+     * sameBits: true if both values have the same bit pattern
+     */
+    template<class Type>
+    inline bool sameBits(Type a,Type b)
+    {
+        return memcmp(&a,&b,sizeof(Type))==0;
+    }
+
+    /**
+     * getMicroseconds: wall clock time for the benchmarks
+     */
+    inline double getMicroseconds()
+    {
+        boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+        return double((now - boost::posix_time::ptime(boost::gregorian::date(1970,1,1))).total_microseconds());
+    }
+}
+
+#endif // NEAT_TESTCOMMON_H_INCLUDED
@@ -41,19 +41,22 @@ int max(int a,int b)
 #endif
 
 //-------------------------------------------------------------------------------//
-// globals below here are shared - even with these, cake *should* be thread-safe //
+// globals below here are shared - they are set up by initcake and only read      //
+// during a search. the tables a search writes to are in its SEARCHCONTEXT        //
 //-------------------------------------------------------------------------------//
 
-static int iscapture[MAXDEPTH];		// tells whether move at realdepth was a capture
-
 int hashmegabytes = 64;				// default hashtable size in MB if no value in registry is found
 int dbmegabytes = 128;				// default db cache size in MB if no value in registry is found
 int usethebook = BOOKALLKINDS;					// default: use best moves if no value in the registry is found
 
-static HASHENTRY *hashtable;		// pointer to the hashtable, is allocated at startup
 static HASHENTRY *book;				// pointer to the book hashtable, is allocated at startup
 
-int hashsize = HASHSIZE;
+int hashsize = HASHSIZE;			// size of the hashtable of new search contexts
+
+static SEARCHCONTEXT *defaultcontext;	// for callers that don't make contexts of their own
+
+static SEARCHCONTEXT *defaultsearchcontext(void);
+static int bookrandom(SEARCHCONTEXT *c);
 
 #ifdef SPA
 static SPA_ENTRY *spatable;
@@ -65,11 +68,6 @@ int maxNdb=0;						// the largest number of stones which is still in the databas
 
 static int cakeisinit = 0;			// is set to 1 after cake is initialized, i.e. initcake has been called
 
-// history table array
-#ifdef MOHISTORY
-int32 history[32][32];
-#endif
-
 // hashxors array.
 int32 hashxors[2][4][32];			// this is initialized to constant hashxors stored in the code.
 
@@ -78,8 +76,6 @@ static unsigned char bitsinword[65536];
 static unsigned char bitsinbyte[256];
 static unsigned char LSBarray[256];
 
-static int   norefresh;
-
 int bookentries = 0; // number of entries in book hashtable
 int bookmovenum = 0; // number of used entries in book
 
@@ -141,12 +137,6 @@ int initcake(char str[1024])
 	book = loadbook(&bookentries, &bookmovenum);
 #endif
 
-	// allocate hashtable
-	sprintf(str,"allocating hashtable...");
-	printf("Allocating hashtable...");
-	hashtable = inithashtable(hashsize);
-	printf("Done!\n");
-
 	// initialize xors 
 	initxors((int*)hashxors);
 
@@ -180,7 +170,8 @@ void resetsearchinfo(SEARCHINFO *s)
 {
 	// resets the search info structure nearly completely, with the exception of
 	// the pointer si.repcheck, to which we allocated memory during initialization - 
-	// we don't want to create a memory leak here.
+	// we don't want to create a memory leak here. si.context is kept too, it
+	// belongs to the caller.
 	s->aborttime = 0;
 	s->allscores = 0;
 	s->bk = 0;
@@ -220,17 +211,76 @@ void resetsearchinfo(SEARCHINFO *s)
 	s->wm = 0;
 }
 
+SEARCHCONTEXT *newsearchcontext(void)
+{
+	// allocates the tables for one search. cake_getmove can run in several threads
+	// at the same time as long as each of them has its own context in si->context.
+	// the first call initializes cake, so this function itself is not thread-safe.
+	char str[1024];
+	unsigned long long int i;
+	SEARCHCONTEXT *c;
+
+	if(!cakeisinit) 
+		initcake(str);
+
+	c = (SEARCHCONTEXT*)malloc(sizeof(SEARCHCONTEXT));
+	if(c != NULL)
+	{
+		memset(c,0,sizeof(SEARCHCONTEXT));
+		c->iscapture = (int*)malloc(MAXDEPTH*sizeof(int));
+		c->hashmemory = malloc((hashsize+HASHITER)*sizeof(HASHENTRY)+64);
+	}
+	if(c == NULL || c->iscapture == NULL || c->hashmemory == NULL)
+	{
+		sprintf(str,"malloc failure in newsearchcontext (hashtable memory allocation failed)");
+		logtofile(str);
+		exit(0);
+	}
+
+	// align the hashtable on a 64-byte-boundary, like inithashtable
+	i = (unsigned long long int)c->hashmemory;
+	i += (64-(i%64));
+	c->hashtable = (HASHENTRY*)i;
+	c->hashsize = hashsize;
+	memset(c->iscapture,0,MAXDEPTH*sizeof(int));
+	c->randomseed = 1;
+	return c;
+}
+
+void deletesearchcontext(SEARCHCONTEXT *c)
+{
+	if(c == NULL)
+		return;
+	free(c->hashmemory);
+	free(c->iscapture);
+	free(c);
+}
+
+static SEARCHCONTEXT *defaultsearchcontext(void)
+{
+	// the context of analyze, bookgen and cake_getmove calls without one
+	if(defaultcontext == NULL)
+		defaultcontext = newsearchcontext();
+	return defaultcontext;
+}
+
+static int bookrandom(SEARCHCONTEXT *c)
+{
+	// same generator as the rand() in the C standard, but with the state in the
+	// context, so book moves don't depend on other threads
+	c->randomseed = c->randomseed*1103515245 + 12345;
+	return (int)((c->randomseed/65536) % 32768);
+}
+
 
 
 
 int hashreallocate(int x)
 {
 	// TODO: move to little-used functions file
-	// reallocates the hashtable to x MB
-
-	static int currenthashsize;
+	// reallocates the hashtable to x MB. contexts made after this get a hashtable
+	// of the new size, and the default context is made again.
 
-	HASHENTRY *pointer;
 	int newsize;
 
 	hashmegabytes = x;
@@ -240,18 +290,12 @@ int hashreallocate(int x)
 	// with sizeof(HASHENTRY) == 8 bytes, but if i ever change that it will
 	// fail
 
-#ifdef WINMEM
-	VirtualFree(hashtable, 0, MEM_RELEASE);
-	pointer = VirtualAlloc(0, (newsize+HASHITER)*sizeof(HASHENTRY), MEM_COMMIT, PAGE_READWRITE);
-#else
-	pointer = (HASHENTRY*)realloc(hashtable,(newsize+HASHITER)*sizeof(HASHENTRY));
-#endif
-	if(pointer != NULL)
+	hashsize = newsize;
+	if(defaultcontext != NULL)
 	{
-		hashsize = newsize;
-		hashtable = pointer;
+		deletesearchcontext(defaultcontext);
+		defaultcontext = newsearchcontext();
 	}
-	// TODO: do something if pointer == NULLbut what do we do when pointer == 0 here??
 	return 1;
 }
 
@@ -306,6 +350,7 @@ int bookgen(OLDPOSITION *q, int color, int *numberofmoves, int values[MAXMOVES],
 
 	// reset all counters, nodes, database lookups etc 
 	resetsearchinfo(&si);
+	si.context = defaultsearchcontext();
 
 	// allocate memory for repcheck array
 	si.repcheck = (REPETITION*)malloc((MAXDEPTH+HISTORYOFFSET) * sizeof(REPETITION));
@@ -330,15 +375,15 @@ int bookgen(OLDPOSITION *q, int color, int *numberofmoves, int values[MAXMOVES],
 
 #ifdef MOHISTORY
 	// reset history table 
-	memset(history,0,32*32*sizeof(int));
+	memset(si.context->history,0,32*32*sizeof(int));
 #endif
 
 	printboard(&p);
 
 	// clear the hashtable 
-	memset(hashtable,0,(hashsize+HASHITER)*sizeof(HASHENTRY));
+	memset(si.context->hashtable,0,(si.context->hashsize+HASHITER)*sizeof(HASHENTRY));
 
-	norefresh=0;
+	si.context->norefresh=0;
 
 	n = makecapturelist(&p, movelist, values, 0);
 	if(!n)
@@ -457,7 +502,7 @@ int bookgen(OLDPOSITION *q, int color, int *numberofmoves, int values[MAXMOVES],
 
 		lastvalue=value;	// save the value for this iteration 
 		last=best;			// save the best move on this iteration 
-		norefresh=1;
+		si.context->norefresh=1;
 	}
 
 	free(si.repcheck);
@@ -538,6 +583,7 @@ int analyze(POSITION *p, int color, int how, int depth, double searchtime, int *
 	d = getorderedmovelist(p, movelist);
 
 	resetsearchinfo(&si);
+	si.context = defaultsearchcontext();
 
 	// allocate memory for repcheck array
 	si.repcheck = (REPETITION*)malloc((MAXDEPTH+HISTORYOFFSET) * sizeof(REPETITION));
@@ -558,7 +604,7 @@ int analyze(POSITION *p, int color, int how, int depth, double searchtime, int *
 
 #ifdef MOHISTORY
 	// reset history table 
-	memset(history,0,32*32*sizeof(int));
+	memset(si.context->history,0,32*32*sizeof(int));
 #endif
 
 
@@ -570,10 +616,10 @@ int analyze(POSITION *p, int color, int how, int depth, double searchtime, int *
 	//if((analyzedpositions % 100000) == 0)
 	//	{
 	printf("\nresetting hashtable");
-	memset(hashtable,0,(hashsize+HASHITER)*sizeof(HASHENTRY));
+	memset(si.context->hashtable,0,(si.context->hashsize+HASHITER)*sizeof(HASHENTRY));
 	//	}
 
-	norefresh=0;
+	si.context->norefresh=0;
 
 	// initialize hash key 
 	absolutehashkey(p, &(si.hash));
@@ -643,7 +689,7 @@ int analyze(POSITION *p, int color, int how, int depth, double searchtime, int *
 
 		lastvalue=value;	// save the value for this iteration 
 		last=best;			// save the best move on this iteration 
-		norefresh=1;
+		si.context->norefresh=1;
 	}
 
 	free(si.repcheck);
@@ -708,8 +754,12 @@ int cake_getmove(SEARCHINFO *si, POSITION *p, int how,double maximaltime,
 
 	resetsearchinfo(si);
 
+	// callers that don't bring a context of their own share one
+	if(si->context == NULL)
+		si->context = defaultsearchcontext();
+
 	for(i=0;i<MAXDEPTH;i++)
-		iscapture[i] = 0;
+		si->context->iscapture[i] = 0;
 
 
 	*playnow = 0;
@@ -741,12 +791,12 @@ int cake_getmove(SEARCHINFO *si, POSITION *p, int how,double maximaltime,
 #ifdef MOHISTORY
 	// reset history table 
 	fflush(stdout);
-	memset(history,0,32*32*sizeof(int));
+	memset(si->context->history,0,32*32*sizeof(int));
 #endif
 
 	// clear the hashtable 
 	fflush(stdout);
-	memset(hashtable,0,(hashsize+HASHITER)*sizeof(HASHENTRY));
+	memset(si->context->hashtable,0,(si->context->hashsize+HASHITER)*sizeof(HASHENTRY));
 
 	// initialize hash key 
 	absolutehashkey(p, &(si->hash));
@@ -757,7 +807,7 @@ int cake_getmove(SEARCHINFO *si, POSITION *p, int how,double maximaltime,
 #endif
 
 	// what is this doing at all?
-	norefresh=0;
+	si->context->norefresh=0;
 
 	// what is this doing here?
 	n = makecapturelist(p, movelist, values, 0);
@@ -796,7 +846,7 @@ int cake_getmove(SEARCHINFO *si, POSITION *p, int how,double maximaltime,
 		bookfound=0;
 		bookindex=0;
 
-		if(booklookup(p,&booklookupvalue,0,&bookdepth,&bookindex,str))
+		if(booklookup(si,p,&booklookupvalue,0,&bookdepth,&bookindex,str))
 		{
 			// booklookup was successful, it sets bookindex to the index of the move in movelist that it wants to play
 			bookfound = 1;
@@ -929,7 +979,7 @@ int cake_getmove(SEARCHINFO *si, POSITION *p, int how,double maximaltime,
 
 			lastvalue=value;	// save the value for this iteration 
 			last=best;			// save the best move on this iteration 
-			norefresh=1;
+			si->context->norefresh=1;
 		}
 	}
 
@@ -1128,7 +1178,7 @@ int windowsearch(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES], int
 int allscoresearch(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES], int d, CAKE_MOVE *best)
 {
 	int i, j, n;
-	static int values[MAXMOVES];
+	int values[MAXMOVES];
 	int bestindex = 0;
 	char str[256], tmpstr[256], movestr[256];
 	int Lkiller;
@@ -1235,15 +1285,15 @@ int firstnegamax(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES], int
 	--------------------------------------------------------------------------*/
 
 	int i,value,swap=0,bestvalue=-MATE;
-	static int n;
-	static CAKE_MOVE ml2[MAXMOVES];
+	int n;
+	CAKE_MOVE ml2[MAXMOVES];
 	MATERIALCOUNT Lmatcount;
 	int Lalpha=alpha;
 	int forcefirst=0;
 	int Lkiller=0;
-	static POSITION last;
+	POSITION last;
 	CAKE_MOVE tmpmove;
-	static int values[MAXMOVES];	/* holds the values of the respective moves - use to order */
+	int values[MAXMOVES];	/* holds the values of the respective moves - use to order */
 	int refnodes[MAXMOVES];			/* number of nodes searched to refute a move */
 	int statvalues[MAXMOVES];
 	int tmpnodes;
@@ -1319,7 +1369,7 @@ int firstnegamax(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES], int
 	// what if we don't set forcefirst here, i.e. set it to 0?
 	n = makecapturelist(p, ml2, statvalues, 0);
 
-	iscapture[si->realdepth] = n;
+	si->context->iscapture[si->realdepth] = n;
 
 	if(n==0)
 		n = makemovelist(si, p, ml2, statvalues, 0,0);
@@ -1524,7 +1574,7 @@ int negamax(SEARCHINFO *si, POSITION *p, int d, int alpha, int *protokiller, int
 	else
 		n = 0;
 
-	iscapture[si->realdepth] = n;
+	si->context->iscapture[si->realdepth] = n;
 
 	//--------------------------------------------//
 	// check for database use                     // 
@@ -1799,6 +1849,8 @@ void hashstore(SEARCHINFO *si, POSITION *p, int value, int alpha, int depth, CAK
 	int32 index,minindex;
 	int mindepth=1000,iter=0;
 	int from,to;
+	HASHENTRY *hashtable = si->context->hashtable;
+	int hashsize = si->context->hashsize;
 
 	si->hashstores++;
 	//assert(alpha == beta-1);
@@ -1809,13 +1861,13 @@ void hashstore(SEARCHINFO *si, POSITION *p, int value, int alpha, int depth, CAK
 	{
 		from = (best->bm|best->bk)&(p->bm|p->bk);    /* bit set on square from */
 		to   = (best->bm|best->bk)&(~(p->bm|p->bk));
-		history[LSB(from)][LSB(to)]++;
+		si->context->history[LSB(from)][LSB(to)]++;
 	}
 	else
 	{
 		from = (best->wm|best->wk)&(p->wm|p->wk);    /* bit set on square from */
 		to   = (best->wm|best->wk)&(~(p->wm|p->wk));
-		history[LSB(from)][LSB(to)]++;
+		si->context->history[LSB(from)][LSB(to)]++;
 	}
 #endif
 
@@ -1894,6 +1946,8 @@ int hashlookup(SEARCHINFO *si, int *value, int *valuetype, int depth, int *force
 
 	int32 index;
 	int iter=0;
+	HASHENTRY *hashtable = si->context->hashtable;
+	int hashsize = si->context->hashsize;
 
 	index = si->hash.key & (hashsize-1); // expects that hashsize is a power of 2!
 
@@ -1929,6 +1983,8 @@ int pvhashlookup(SEARCHINFO *si, int *value, int *valuetype, int depth, int32 *f
 	// in the hashtable as being part of the PV
 	int32 index;
 	int iter=0;
+	HASHENTRY *hashtable = si->context->hashtable;
+	int hashsize = si->context->hashsize;
 
 	index = si->hash.key & (hashsize-1);
 
@@ -2208,7 +2264,7 @@ void countmaterial(POSITION *p, MATERIALCOUNT *m)
 
 // TODO: put this into book.c
 
-int booklookup(POSITION *p, int *value, int depth, int32 *remainingdepth, int *best, char str[256])
+int booklookup(SEARCHINFO *si, POSITION *p, int *value, int depth, int32 *remainingdepth, int *best, char str[256])
 {
 	/* searches for a position in the book hashtable.
 	*/
@@ -2231,6 +2287,7 @@ int booklookup(POSITION *p, int *value, int depth, int32 *remainingdepth, int *b
 	HASH hash;
 	SEARCHINFO s;
 	resetsearchinfo(&s);
+	s.context = si->context;
 
 	bucketsize = BUCKETSIZEBOOK;
 	pointer = book;
@@ -2388,7 +2445,7 @@ int booklookup(POSITION *p, int *value, int depth, int32 *remainingdepth, int *b
 			if(bookmoves !=0)
 			{
 				//srand( (unsigned)time( NULL ) );
-				i = rand() % bookmoves;
+				i = bookrandom(si->context) % bookmoves;
 				*remainingdepth = depths[i];
 				*value = values[i];
 				*best = indices[i];
@@ -11,9 +11,10 @@
 void absolutehashkey(POSITION *p, HASH *hash);
 int allscoresearch(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES], int d, CAKE_MOVE *best);
 int bitcount(int32 n);
-static int booklookup(POSITION *p, int *value, int depth, int32 *best, int *bestindex, char str[256]);
+static int booklookup(SEARCHINFO *si, POSITION *p, int *value, int depth, int32 *best, int *bestindex, char str[256]);
 int cake_getmove(SEARCHINFO *si, POSITION *p, int how,double maxtime, int depthtosearch,int32 maxnodes, char str[1024], int *playnow, int logging,int reset);
 void countmaterial(POSITION *p, MATERIALCOUNT *m);
+void deletesearchcontext(SEARCHCONTEXT *c);
 int exitcake();
 static int firstnegamax(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES], int d, int alpha, int beta, CAKE_MOVE *best);
 static void getpv(SEARCHINFO *si, POSITION *p, char *str);
@@ -29,6 +30,7 @@ static int mtdf(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES], int f
 //				   int *bestmoveindex, int truncationdepth, int truncationdepth2,int iid);
 static int negamax(SEARCHINFO *si, POSITION *p,int depth, int alpha, int *bestproto, 
 				   int *bestmoveindex, int truncationdepth, int truncationdepth2,int iid);
+SEARCHCONTEXT *newsearchcontext(void);
 int pvhashlookup(SEARCHINFO *si, int *value, int *valuetype, int depth, int32 *forcefirst, int color, int *ispvnode);
 void resetsearchinfo(SEARCHINFO *s);
 int selfstalemate(POSITION *p);
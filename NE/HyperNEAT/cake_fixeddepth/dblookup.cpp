@@ -65,6 +65,14 @@
 #include <algorithm>
 using namespace std;
 
+#ifdef SYS_WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include "cake_misc.h"
 
 // TODO: why are these things redefined here??
@@ -108,6 +116,11 @@ int MSB(unsigned int  x);
 static int recbitcount(unsigned int n);
 static int bitcount(unsigned int n);
 static int parseindexfile(char idxfilename[256],int blockoffset,int fpcount);
+static int dblookupcached(POSITION *q,int cl);
+
+#ifdef MMAPDB
+static int mapdatabases(void);
+#endif
 
 
 #ifdef PRELOAD
@@ -161,6 +174,11 @@ static int maxblockid = 0;  // maximal unique block id, set by initlookup after
 static FILE *dbfp[MAXFP]; // file pointers to db2...dbn - always open.
 static char dbnames[MAXFP][256]; // write in here what each dbfp is pointing to
 
+#ifdef MMAPDB
+static unsigned char *dbmap[MAXFP];	// dbfp[i] mapped read-only, or NULL
+static size_t dbmapsize[MAXFP];
+#endif
+
 // database path
 char DBpath[256];
 
@@ -175,12 +193,39 @@ static int bytesallocated = 0;
 
 static char dbinfo[1024] = "";
 
+// the block cache below is shared by every search, so lookups take turns
+#ifdef MMAPDB
+// the mapped blocks are never written, so there is nothing to lock
+#define LOCKCACHE()
+#define UNLOCKCACHE()
+#elif defined(SYS_WINDOWS)
+static CRITICAL_SECTION cachelock;		// initialized by db_init
+#define LOCKCACHE() EnterCriticalSection(&cachelock)
+#define UNLOCKCACHE() LeaveCriticalSection(&cachelock)
+#else
+static pthread_mutex_t cachelock = PTHREAD_MUTEX_INITIALIZER;
+#define LOCKCACHE() pthread_mutex_lock(&cachelock)
+#define UNLOCKCACHE() pthread_mutex_unlock(&cachelock)
+#endif
+
 int db_getcachesize(void)
 	{
 	return cachesize;
 	}
 
 int dblookup(POSITION *q,int cl)
+	{
+	// dblookup can be called from several threads at the same time
+	int returnvalue;
+
+	LOCKCACHE();
+	returnvalue = dblookupcached(q,cl);
+	UNLOCKCACHE();
+
+	return returnvalue;
+	}
+
+static int dblookupcached(POSITION *q,int cl)
 	{
 	// returns DB_WIN, DB_LOSS,  DB_DRAW or DB_UNKNOWN for a position in a database lookup.
 	// from a compressed database. first, this function computes the index
@@ -435,6 +480,12 @@ int dblookup(POSITION *q,int cl)
 					blocknumber;
 
 
+#ifdef MMAPDB
+	// db_init pointed blockpointer at every block in the maps, there is nothing to load
+	diskblock = blockpointer[uniqueblockid];
+	if(diskblock == NULL)
+		return DB_UNKNOWN;
+#else
 	// check if it is loaded:
 	if(blockpointer[uniqueblockid] != NULL)
 		//yes!
@@ -535,6 +586,7 @@ int dblookup(POSITION *q,int cl)
 	printf("\nblock with ID %i, loaded to address %i",uniqueblockid,diskblock);
 #endif
 		}
+#endif // MMAPDB
 	// the block we were looking for is now pointed to by diskblock
 	// and it has been moved to the head of the linked list
 	// now we decompress the memory block
@@ -792,6 +844,15 @@ int db_exit(void)
     free(cachebaseaddress);
     free(blockpointer);
     free(blockinfo);
+
+#ifdef MMAPDB
+	for(i=0;i<MAXFP;i++)
+		{
+		if(dbmap[i] != NULL)
+			munmap(dbmap[i],dbmapsize[i]);
+		dbmap[i] = NULL;
+		}
+#endif
 	
 	for(i=0;i<50;i++)
 		{
@@ -824,7 +885,9 @@ int db_init(int suggestedMB, char out[256])
 	int memsize;
 	char str[256];
 
-
+#ifdef SYS_WINDOWS
+	InitializeCriticalSection(&cachelock);
+#endif
 	
 	//dblogfp = fopen("dbinit.txt","w");
 	// initialize bitsinword, the number of bits in a word
@@ -1004,6 +1067,10 @@ int db_init(int suggestedMB, char out[256])
 		// the total dblookup ram usage.
 		cachesize = max(cachesize, MINCACHESIZE);
 		}
+#ifdef MMAPDB
+	// the maps take the place of the cache
+	cachesize = 0;
+#endif
 
 	// parse index files
 	// blockoffset is the total number of blocks in all dbs belonging to an index file.
@@ -1082,6 +1149,7 @@ int db_init(int suggestedMB, char out[256])
 	// index files are parsed!
 	
 	
+#ifndef MMAPDB
 	// allocate memory for the cache
 	memsize = cachesize*1024;
 	//cachebaseaddress = VirtualAlloc(0,memsize,MEM_RESERVE|MEM_COMMIT|MEM_TOP_DOWN,PAGE_READWRITE);
@@ -1103,6 +1171,7 @@ int db_init(int suggestedMB, char out[256])
 		}
 	sprintf(str,"\nallocated %i KB for DB cache ",(cachesize));
 	logtofile(str);
+#endif
 
 	// allocate memory for blockpointers
 	// statement below was sizeof(int) which returned 4 even on the 64-bit version of windows?!
@@ -1126,6 +1195,7 @@ int db_init(int suggestedMB, char out[256])
 	for(i=0;i<maxblocknum;i++)
 		blockpointer[i]=NULL;
 	
+#ifndef MMAPDB
 	// allocate memory for doubly linked list LRU
 	memsize = cachesize*sizeof(struct bi);
 	//blockinfo = VirtualAlloc(0,memsize, MEM_RESERVE|MEM_COMMIT|MEM_TOP_DOWN, PAGE_READWRITE);
@@ -1166,6 +1236,7 @@ int db_init(int suggestedMB, char out[256])
 	
 	head=autoloadnum; //0
 	tail = cachesize-1;
+#endif
 
 
 
@@ -1216,10 +1287,75 @@ int db_init(int suggestedMB, char out[256])
 				}
 			}
 		}
+
+#ifdef MMAPDB
+	n = mapdatabases();
+	sprintf(str,"\nmapped %i KB of db blocks",n);
+	logtofile(str);
+#endif
 	
 	return maxpieces;
 	}
 
+#ifdef MMAPDB
+static int mapdatabases(void)
+	{
+	// maps every open db file read-only and builds the block index: blockpointer[id]
+	// points at block id in the map of its file. the index is not changed after this,
+	// so any number of threads can look up at the same time. returns the number of blocks.
+	struct stat filestat;
+	cprsubdb *dbpointer;
+	void *map;
+	size_t offset;
+	int i,j,uniqueblockid,numberofdbs;
+	int blocks = 0;
+	char str[sizeof(dbnames[0])+32];
+
+	for(i=0;i<MAXFP;i++)
+		{
+		dbmap[i] = NULL;
+		dbmapsize[i] = 0;
+		if(dbfp[i] == NULL)
+			continue;
+		if(fstat(fileno(dbfp[i]),&filestat) != 0 || filestat.st_size == 0)
+			continue;
+		map = mmap(NULL,filestat.st_size,PROT_READ,MAP_SHARED,fileno(dbfp[i]),0);
+		if(map == MAP_FAILED)
+			{
+			snprintf(str,sizeof(str),"\ncould not map %s",dbnames[i]);
+			logtofile(str);
+			continue;
+			}
+		dbmap[i] = (unsigned char*)map;
+		dbmapsize[i] = filestat.st_size;
+		}
+
+	dbpointer = &cprsubdatabase[0][0][0][0][0][0][0];
+	numberofdbs = sizeof(cprsubdatabase)/sizeof(cprsubdb);
+	for(i=0;i<numberofdbs;i++,dbpointer++)
+		{
+		if(dbpointer->ispresent == 0 || dbpointer->fp < 0 || dbpointer->fp >= MAXFP || dbmap[dbpointer->fp] == NULL)
+			continue;
+		for(j=0;j<dbpointer->numberofblocks;j++)
+			{
+			uniqueblockid = dbpointer->blockoffset+dbpointer->firstblock+j;
+			offset = (size_t)(dbpointer->firstblock+j)*1024;
+			// a block that starts before the end of the file lies in a page that is
+			// backed by the file, because pages are a multiple of 1024 bytes
+			if(uniqueblockid >= maxblocknum || offset >= dbmapsize[dbpointer->fp])
+				break;
+			if(blockpointer[uniqueblockid] == NULL)
+				{
+				blockpointer[uniqueblockid] = dbmap[dbpointer->fp]+offset;
+				blocks++;
+				}
+			}
+		}
+
+	return blocks;
+	}
+#endif
+
 #ifdef PRELOAD
 static int preload(char out[256])
 	{
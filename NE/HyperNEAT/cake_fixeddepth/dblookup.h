@@ -9,6 +9,13 @@
 
 #define PRELOAD // preload (parts) of db in cache? 
 
+// map the db files read-only instead of reading blocks into a cache of our own.
+// all processes on a machine then share the page cache copy, and lookups need no lock.
+#ifdef SYS_UNIX
+#define MMAPDB
+#undef PRELOAD
+#endif
+
 #define AUTOLOADSIZE 0
 
 #define DB_BLACK 0
@@ -66,6 +66,7 @@ int getorderedmovelist(POSITION *p, CAKE_MOVE movelist[MAXMOVES])
 	int bestindex; 
 
 	resetsearchinfo(&si);
+	si.context = NULL; // no history or advisor at realdepth 0
 
 	//for(i=0;i<MAXMOVES;i++)
 	//	values[i] = (p->color==BLACK) ? -MATE:MATE;
@@ -279,8 +280,6 @@ void CheckersCommon_printBoard(uchar b[8][8])
     }
 }
 
-CheckersAdvisor *checkersAdvisor = NULL;
-
 int makemovelist(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES],int values[MAXMOVES], int bestindex, int32 killer)
 {
 
@@ -548,14 +547,14 @@ int makemovelist(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES],int v
 			}
 		}
 
-        if(checkersAdvisor && si->realdepth>2)
+        if(si->realdepth>2 && si->context->advisor)
         {
             float advisorMoveValue[MAXMOVES];
 
 			unsigned char fromB[8][8];
 			ucharbitboardtoboard(*p,fromB);
 
-            checkersAdvisor->setBoardPosition(fromB);
+            si->context->advisor->setBoardPosition(fromB);
 
             for(int a=0;a<int(n);a++)
             {
@@ -571,7 +570,7 @@ int makemovelist(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES],int v
                 int destX,destY;
                 CheckersCommon_getDestination(fromB,p->color,toB,destX,destY);
 
-                advisorMoveValue[a] = checkersAdvisor->getBoardValue(destX,destY);
+                advisorMoveValue[a] = si->context->advisor->getBoardValue(destX,destY);
             }
 
             for(int a=0;a<int(n);a++)
@@ -859,14 +858,14 @@ int makemovelist(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES],int v
 			}
 		}
 
-        if(checkersAdvisor && si->realdepth>2)
+        if(si->realdepth>2 && si->context->advisor)
         {
             float advisorMoveValue[MAXMOVES];
 
 			unsigned char fromB[8][8];
 			ucharbitboardtoboard(*p,fromB);
 
-            checkersAdvisor->setBoardPosition(fromB);
+            si->context->advisor->setBoardPosition(fromB);
 
             for(int a=0;a<int(n);a++)
             {
@@ -882,7 +881,7 @@ int makemovelist(SEARCHINFO *si, POSITION *p, CAKE_MOVE movelist[MAXMOVES],int v
                 int destX,destY;
                 CheckersCommon_getDestination(fromB,p->color,toB,destX,destY);
 
-                advisorMoveValue[a] = checkersAdvisor->getBoardValue(destX,destY);
+                advisorMoveValue[a] = si->context->advisor->getBoardValue(destX,destY);
             }
 
             for(int a=0;a<int(n);a++)
@@ -930,11 +929,6 @@ void blackorderevaluation(SEARCHINFO *si, POSITION *p,CAKE_MOVE ml[MAXMOVES],int
 	//	eval += (blackbackrankeval[p->bm & 0xFF] - whitebackrankeval[p->wm >> 24]); //2!!
 
 
-#ifdef MOHISTORY
-	extern int32 history[32][32]; /*has entries for how often a move was good */
-	//extern SEARCHINFO si;        /* is the number of entries in history list */
-#endif
-	
 	black = p->bm|p->bk;
 
 	for(i=0;i<n;i++)
@@ -947,7 +941,7 @@ void blackorderevaluation(SEARCHINFO *si, POSITION *p,CAKE_MOVE ml[MAXMOVES],int
 #ifdef MOHISTORY
 		/* history...*/
 		if(si->hashstores>MINHASH) 
-			eval+=( (HISTORY*history[LSB(from)][LSB(to)]) / (si->hashstores));  // vtune: if is loopindependent - take out
+			eval+=( (HISTORY*si->context->history[LSB(from)][LSB(to)]) / (si->hashstores));  // vtune: if is loopindependent - take out
 #endif
 
 #ifdef MOSTATIC
@@ -1076,8 +1070,6 @@ void whiteorderevaluation(SEARCHINFO *si, POSITION *p,CAKE_MOVE ml[MAXMOVES],int
 	int32 white;
 	int i;
 
-	extern int32 history[32][32];
-	//extern SEARCHINFO si;
 	extern char whitebackrankeval[256];
 	
 
@@ -1092,7 +1084,7 @@ void whiteorderevaluation(SEARCHINFO *si, POSITION *p,CAKE_MOVE ml[MAXMOVES],int
 #ifdef MOHISTORY
 		/* history...*/
 		if(si->hashstores > MINHASH)
-			eval+=( (HISTORY*history[LSB(from)][LSB(to)]) / (si->hashstores));
+			eval+=( (HISTORY*si->context->history[LSB(from)][LSB(to)]) / (si->hashstores));
 #endif
 
 #ifdef MOSTATIC
@@ -56,6 +56,8 @@ typedef struct
 	int irreversible;
 	} REPETITION;
 
+struct searchcontext;
+
 typedef struct
 	{
 	int32 negamax;
@@ -89,6 +91,7 @@ typedef struct
 	HASH hash;
 	MATERIALCOUNT matcount;
 	REPETITION *repcheck;
+	struct searchcontext *context;	// the tables this search writes to, see SEARCHCONTEXT
 	double start;
 	double maxtime;
 	double aborttime;
@@ -183,6 +186,22 @@ typedef struct
 	unsigned int valuetype:2;
 	} HASHENTRY;
 
+class CheckersAdvisor;
+
+typedef struct searchcontext
+// everything a search writes to besides the SEARCHINFO itself. searches that run
+// at the same time need a context each, made with newsearchcontext()
+	{
+	HASHENTRY *hashtable;		// aligned on 64 bytes inside hashmemory
+	void *hashmemory;
+	int hashsize;				// number of entries in hashtable, a power of 2
+	int32 history[32][32];		// how often a move was good, for move ordering
+	int *iscapture;				// tells whether move at realdepth was a capture
+	int norefresh;
+	int32 randomseed;			// picks between equivalent book moves
+	CheckersAdvisor *advisor;	// if not NULL, orders the moves deeper in the tree
+	} SEARCHCONTEXT;
+
 
 
 struct bookhashentry
@@ -16,7 +16,7 @@ then
 fi
 
 for D in $CLEANDIR/*; do
-    if [[ ! -f $D/generation150.ser.gz && $FORCECLEAN == false ]]
+    if [[ ! -f $D/generation150.idx && ! -f $D/generation150.ser.gz && $FORCECLEAN == false ]]
     then
         echo -n "[$D]: Not yet finished: "
         ls $D/generation*
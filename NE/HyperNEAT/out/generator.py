@@ -57,7 +57,7 @@ if currentGeneration < 0:
         subprocess.check_call(["./" + generateExec,
                                "-R", str(seed),
                                "-I", dataFile,
-                               "-O", os.path.join(resultsDir,"generation0.ser.gz"),
+                               "-O", os.path.join(resultsDir,"generation0.idx"),
                                "-G", rom])
         currentGeneration = 0
 
@@ -75,8 +75,8 @@ while currentGeneration < maxGeneration:
         time.sleep(5)
 
     # Create next generation
-    currGenFile = os.path.join(resultsDir,"generation"+str(currentGeneration)+".ser.gz")
-    nextGenFile = os.path.join(resultsDir,"generation"+str(currentGeneration+1)+".ser.gz")
+    currGenFile = util.getGenPath(resultsDir,currentGeneration)
+    nextGenFile = os.path.join(resultsDir,"generation"+str(currentGeneration+1)+".idx")
     tmpNextGen  = nextGenFile + ".tmp"
     fitnessRoot = os.path.join(resultsDir,"fitness." + str(currentGeneration)+".")
     subprocess.check_call(["./" + executable,
@@ -28,7 +28,7 @@
 #       ` ^^^~^"W___            ]Raaaamw~`^``^^~
 #                 ^~"~---~~~~~~`
 
-import argparse, os, subprocess, time, sys
+import argparse, os, subprocess, time, sys, util
 user="joel"
 
 # Submits a condor job which starts a worker running
@@ -115,13 +115,11 @@ if not os.path.isdir(resultsDir):
 # Find the generation to start on by incrementally searching for eval files
 currentGeneration = -1
 for f in os.listdir(resultsDir):
-    if f.startswith('generation') and 'tmp' not in f:
-        genNumber = int(f[len('generation'):-len('.ser.gz')])
-        currentGeneration = max(currentGeneration, genNumber)
+    currentGeneration = max(currentGeneration, util.getGenNumber(f))
 
 # Create Generation 0 if it doesnt already exist
 if currentGeneration < 0:
-        gen0Path = os.path.join(resultsDir,"generation0.ser.gz")
+        gen0Path = os.path.join(resultsDir,"generation0.idx")
         subprocess.check_call(["./" + generateExec, "-R", str(seed), "-I", dataFile, "-O", gen0Path, "-G", rom])
         currentGeneration = 0
 elif currentGeneration >= maxGeneration:
@@ -208,8 +206,8 @@ while currentGeneration < maxGeneration:
         time.sleep(10)
 
     # Create next generation
-    currGenFile = os.path.join(resultsDir,"generation"+str(currentGeneration)+".ser.gz")
-    nextGenFile = os.path.join(resultsDir,"generation"+str(currentGeneration+1)+".ser.gz")
+    currGenFile = util.getGenPath(resultsDir,currentGeneration)
+    nextGenFile = os.path.join(resultsDir,"generation"+str(currentGeneration+1)+".idx")
     tmpNextGen  = nextGenFile + ".tmp"
     fitnessRoot = os.path.join(resultsDir,"fitness." + str(currentGeneration)+".")
     subprocess.check_call(["./" + generateExec, "-I", dataFile, "-R", str(seed), "-O", tmpNextGen, "-P", currGenFile,
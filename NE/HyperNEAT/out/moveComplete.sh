@@ -11,7 +11,7 @@ RESDIR=$1
 DEST=$2
 
 for D in $RESDIR/*; do
-    if [ ! -f $D/generation150.ser.gz ]
+    if [ ! -f $D/generation150.idx ] && [ ! -f $D/generation150.ser.gz ]
     then
         echo -n "[$D]: Not yet finished: "
         ls $D/generation*
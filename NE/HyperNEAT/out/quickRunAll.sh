@@ -27,7 +27,7 @@ for D in roms/*; do
 
     if [ $FOUND_ROM = 1 ]
     then
-        if [ -f $D/generation150.ser.gz ]
+        if [ -f $D/generation150.idx ] || [ -f $D/generation150.ser.gz ]
         then
             echo "[$rom] is finished"
             continue
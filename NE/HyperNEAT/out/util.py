@@ -9,13 +9,32 @@ def submitCondorJob(condorFile):
     return procID
 
 
+# Generation files are generationN.idx, or generationN.ser.gz in runs started before
+# the indexed format
+GENERATION_SUFFIXES = ['.idx', '.ser.gz']
+
+def getGenNumber(f):
+    # The generation a results file holds, or -1 if it is not a generation file
+    if not f.startswith('generation') or 'tmp' in f:
+        return -1
+    for suffix in GENERATION_SUFFIXES:
+        if f.endswith(suffix):
+            return int(f[len('generation'):-len(suffix)])
+    return -1
+
+def getGenPath(resultsDir, generation):
+    # The file holding a generation, or the .idx to write it to if there is none yet
+    for suffix in GENERATION_SUFFIXES:
+        path = os.path.join(resultsDir, "generation" + str(generation) + suffix)
+        if os.path.exists(path):
+            return path
+    return os.path.join(resultsDir, "generation" + str(generation) + ".idx")
+
 def getCurrentGen(resultsDir):
     # Detect the current generation
     currentGeneration = -1
     for f in os.listdir(resultsDir):
-        if f.startswith('generation') and 'tmp' not in f:
-            genNumber = int(f[len('generation'):-len('.ser.gz')])
-            currentGeneration = max(currentGeneration, genNumber)
+        currentGeneration = max(currentGeneration, getGenNumber(f))
     return currentGeneration
 
 def getPIDStatus(pid, condor_q):
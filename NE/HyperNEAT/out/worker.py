@@ -24,13 +24,27 @@
 # `--`\____       __..---~~ ~~--..~--------~~   |                  ,'       ,'
 #                                           "Catbus" (from "My Neighbor Totoro")
 
-import argparse, os, random, time, sys
+import argparse, os, random, time, sys, util
+
+# This starts atari_evaluate in daemon mode. The rom and experiment stay loaded
+# and the games are sent to it on stdin, so only the first game pays for startup.
+def start_evaluator(executable, dataFile, seed, rom):
+    from subprocess import Popen, PIPE
+    return Popen(["./" + executable, "-I", dataFile, "-R", seed, "-G", rom, "-D"],
+                 stdin=PIPE, stdout=PIPE, universal_newlines=True)
 
 # This runs a single Atari game.
-def run_game(executable, dataFile, generationFile, individualId, fitnessFile, seed, rom):
-    from subprocess import check_call
-    check_call(["./" + executable, "-I", dataFile, "-P", generationFile, "-N",
-                     str(individualId), "-F", fitnessFile, "-R", seed, "-G", rom])
+def run_game(evaluator, generationFile, individualId, fitnessFile):
+    evaluator.stdin.write(generationFile + " " + str(individualId) + " " + fitnessFile + "\n")
+    evaluator.stdin.flush()
+    while True:
+        line = evaluator.stdout.readline()
+        if not line:
+            sys.stderr.write('atari_evaluate exited unexpectedly\n')
+            sys.exit(1)
+        sys.stdout.write(line)
+        if line.startswith('FITNESS ') or line.startswith('ERROR '):
+            return
                     
 parser = argparse.ArgumentParser(description='Runs Atari games without tire.')
 parser.add_argument('-e', metavar='atari_evaulate', required=True,
@@ -60,22 +74,22 @@ individualsPerGeneration = args.n
 # Detect the current generation
 currentGeneration = -1
 for f in os.listdir(resultsDir):
-    if f.startswith('generation') and 'tmp' not in f:
-        genNumber = int(f[len('generation'):-len('.ser.gz')])
-        currentGeneration = max(currentGeneration, genNumber)
+    currentGeneration = max(currentGeneration, util.getGenNumber(f))
 if currentGeneration < 0:
         sys.stderr.write('Did not find any generation files! Exiting.\n')
         sys.stderr.flush()
         sys.exit(0)
 
+evaluator = start_evaluator(executable, dataFile, seed, rom)
+
 while currentGeneration < maxGeneration:
     # Wait until we see a generation file for the current generation
-    generationFile = "generation" + str(currentGeneration) + ".ser.gz"
-    generationPath = os.path.join(resultsDir,generationFile)
+    generationPath = util.getGenPath(resultsDir,currentGeneration)
 
     start = time.time()
     while not os.path.exists(generationPath):
         time.sleep(5)
+        generationPath = util.getGenPath(resultsDir,currentGeneration)
         if time.time() - start >= 300:
             sys.stderr.write('Reached 5min timeout waiting for new generation... quitting\n')
             sys.stderr.flush()
@@ -86,7 +100,7 @@ while currentGeneration < maxGeneration:
     random.shuffle(individualIds)
     for individualId in individualIds:
         # Break out of this loop if the generation has ended
-        nextGenPath = os.path.join(resultsDir,"generation" + str(currentGeneration+1) + ".ser.gz")
+        nextGenPath = util.getGenPath(resultsDir,currentGeneration+1)
         if os.path.exists(nextGenPath): 
             break
         fitnessFile = "fitness."+str(currentGeneration)+"."+str(individualId)
@@ -94,7 +108,11 @@ while currentGeneration < maxGeneration:
         if os.path.exists(fitnessPath):
             continue
 
-        run_game(executable, dataFile, generationPath, individualId, fitnessPath, seed, rom)
+        run_game(evaluator, generationPath, individualId, fitnessPath)
 
     # By this time all fitness evaluations should be complete
     currentGeneration += 1
+
+evaluator.stdin.write("QUIT\n")
+evaluator.stdin.flush()
+evaluator.wait()